@@ -0,0 +1,38 @@
+# ------------------------------------------------------------------------
+#  Gunrock: Find zlib, bzip2 and zstd for compressed graph inputs, and set
+#  pre-compiler flags
+#
+#  COMPRESSION_LIBRARIES - libraries found, to link against
+# ------------------------------------------------------------------------
+SET(COMPRESSION_LIBRARIES "")
+
+FIND_LIBRARY(ZLIB_LIBRARY z
+  /usr/local/lib
+  /usr/lib
+  )
+FIND_LIBRARY(BZIP2_LIBRARY bz2
+  /usr/local/lib
+  /usr/lib
+  )
+FIND_LIBRARY(ZSTD_LIBRARY zstd
+  /usr/local/lib
+  /usr/lib
+  )
+
+IF (ZLIB_LIBRARY)
+  ADD_DEFINITIONS( -DZLIB_FOUND=true )
+  LIST(APPEND COMPRESSION_LIBRARIES ${ZLIB_LIBRARY})
+  MESSAGE(STATUS "Found zlib: gzip inputs supported")
+ENDIF (ZLIB_LIBRARY)
+
+IF (BZIP2_LIBRARY)
+  ADD_DEFINITIONS( -DBZIP2_FOUND=true )
+  LIST(APPEND COMPRESSION_LIBRARIES ${BZIP2_LIBRARY})
+  MESSAGE(STATUS "Found bzip2: bzip2 inputs supported")
+ENDIF (BZIP2_LIBRARY)
+
+IF (ZSTD_LIBRARY)
+  ADD_DEFINITIONS( -DZSTD_FOUND=true )
+  LIST(APPEND COMPRESSION_LIBRARIES ${ZSTD_LIBRARY})
+  MESSAGE(STATUS "Found zstd: zstd inputs supported")
+ENDIF (ZSTD_LIBRARY)
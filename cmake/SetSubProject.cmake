@@ -38,6 +38,9 @@ target_link_libraries(${PROJECT_NAME} ${Boost_LIBRARIES})
 if (METIS_LIBRARY)
   target_link_libraries(${PROJECT_NAME} ${METIS_LIBRARY})
 endif()
+if (COMPRESSION_LIBRARIES)
+  target_link_libraries(${PROJECT_NAME} ${COMPRESSION_LIBRARIES})
+endif()
 # end /* Link Metis and Boost */
 
 # begin /* Link OpenMP (libomp) for OSX */
@@ -0,0 +1,444 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * autotune.cuh
+ *
+ * @brief Offline auto-tuner for traversal mode, direction-optimization and
+ * advance policy parameters, with per-dataset persistence
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include <gunrock/csr.cuh>
+#include <gunrock/graphio/market.cuh>
+#include <gunrock/util/json_spirit_writer_template.h>
+
+namespace gunrock {
+namespace app {
+
+/**
+ * @brief One point of the tuning space. Defaults match util::Info.
+ */
+struct TuneConfig
+{
+    std::string algorithm     ;
+    std::string traversal_mode;
+    double      do_a          ;
+    double      do_b          ;
+    double      alpha         ;
+    double      beta          ;
+    int         delta_factor  ;
+    double      elapsed       ; // best pilot time in ms, < 0 if not measured
+
+    TuneConfig() :
+        algorithm     (""   ),
+        traversal_mode("LB" ),
+        do_a          (0.001),
+        do_b          (0.200),
+        alpha         (6.0  ),
+        beta          (6.0  ),
+        delta_factor  (16   ),
+        elapsed       (-1.0 )
+    {
+    }
+
+    /**
+     * @brief Reads a tune file written by Save.
+     *
+     * @param[in] filename Tune file name.
+     *
+     * \return true if the file exists and was parsed.
+     */
+    bool Load(const std::string &filename)
+    {
+        std::ifstream fin(filename.c_str());
+        if (!fin.is_open()) return false;
+        std::string line;
+        while (std::getline(fin, line))
+        {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream str_stream(line);
+            std::string key;
+            str_stream >> key;
+            if      (key == "algorithm"     ) str_stream >> algorithm;
+            else if (key == "traversal_mode") str_stream >> traversal_mode;
+            else if (key == "do_a"          ) str_stream >> do_a;
+            else if (key == "do_b"          ) str_stream >> do_b;
+            else if (key == "alpha"         ) str_stream >> alpha;
+            else if (key == "beta"          ) str_stream >> beta;
+            else if (key == "delta_factor"  ) str_stream >> delta_factor;
+            else if (key == "elapsed"       ) str_stream >> elapsed;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Writes the configuration as "key value" lines.
+     *
+     * @param[in] filename Tune file name.
+     *
+     * \return true on success.
+     */
+    bool Save(const std::string &filename) const
+    {
+        FILE *fout = fopen(filename.c_str(), "w");
+        if (fout == NULL) return false;
+        fprintf(fout, "# gunrock tuned parameters\n");
+        fprintf(fout, "algorithm %s\n"     , algorithm.c_str());
+        fprintf(fout, "traversal_mode %s\n", traversal_mode.c_str());
+        fprintf(fout, "do_a %.9g\n"        , do_a);
+        fprintf(fout, "do_b %.9g\n"        , do_b);
+        fprintf(fout, "alpha %.9g\n"       , alpha);
+        fprintf(fout, "beta %.9g\n"        , beta);
+        fprintf(fout, "delta_factor %d\n"  , delta_factor);
+        fprintf(fout, "elapsed %.6f\n"     , elapsed);
+        fclose(fout);
+        return true;
+    }
+
+    void ToJson(json_spirit::mObject &obj) const
+    {
+        obj["traversal_mode"] = traversal_mode;
+        obj["do_a"          ] = do_a;
+        obj["do_b"          ] = do_b;
+        obj["alpha"         ] = alpha;
+        obj["beta"          ] = beta;
+        obj["delta_factor"  ] = delta_factor;
+        obj["elapsed"       ] = elapsed;
+    }
+};
+
+/**
+ * @brief Tune file sitting next to the binary graph cache of a market file,
+ * named like the other sidecars: the cache name with its "bin" suffix
+ * replaced by <algorithm>.tune.
+ *
+ * @param[in] cache_name Binary cache file, from graphio::MarketBinaryFileName.
+ * @param[in] algorithm Algorithm name as stored in Info.
+ *
+ * \return Tune file name.
+ */
+inline std::string TuneFileName(
+    const std::string &cache_name,
+    const std::string &algorithm)
+{
+    char tune_file[256];
+    graphio::CacheSidecarFileName(cache_name.c_str(),
+        (algorithm + ".tune").c_str(), tune_file);
+    return std::string(tune_file);
+}
+
+/**
+ * @brief Shape of a graph as far as the cost model cares.
+ */
+struct GraphProfile
+{
+    long long nodes;
+    long long edges;
+    double    average_degree;
+    double    stddev_degree;
+    long long max_degree;
+    int       depth; // BFS depth from the highest-degree vertex
+
+    template <typename VertexId, typename SizeT, typename Value>
+    void Build(const Csr<VertexId, SizeT, Value> &graph)
+    {
+        nodes          = graph.nodes;
+        edges          = graph.edges;
+        average_degree = nodes > 0 ? (double)edges / nodes : 0;
+        double sum_sq  = 0;
+        max_degree     = 0;
+        VertexId hub   = 0;
+        for (SizeT v = 0; v < graph.nodes; v++)
+        {
+            long long degree = graph.row_offsets[v+1] - graph.row_offsets[v];
+            sum_sq += (degree - average_degree) * (degree - average_degree);
+            if (degree > max_degree) { max_degree = degree; hub = v; }
+        }
+        stddev_degree = nodes > 0 ? sqrt(sum_sq / nodes) : 0;
+
+        depth = 0;
+        if (nodes == 0) return;
+        std::vector<VertexId> labels(graph.nodes, -1);
+        std::vector<VertexId> frontier(1, hub), next_frontier;
+        labels[hub] = 0;
+        while (!frontier.empty())
+        {
+            next_frontier.clear();
+            for (size_t i = 0; i < frontier.size(); i++)
+            {
+                VertexId v = frontier[i];
+                for (SizeT e = graph.row_offsets[v]; e < graph.row_offsets[v+1]; e++)
+                {
+                    VertexId u = graph.column_indices[e];
+                    if (labels[u] != -1) continue;
+                    labels[u] = depth + 1;
+                    next_frontier.push_back(u);
+                }
+            }
+            frontier.swap(next_frontier);
+            if (!frontier.empty()) depth ++;
+        }
+    }
+
+    /**
+     * @brief Mesh-like graphs: low, even degree and a deep BFS tree
+     * (road networks, delaunay, rgg).
+     */
+    bool IsMeshLike() const
+    {
+        return average_degree < 8 && stddev_degree < 2 * average_degree + 1
+            && depth > 100;
+    }
+
+    void ToJson(json_spirit::mObject &obj) const
+    {
+        obj["nodes"         ] = (int64_t)nodes;
+        obj["edges"         ] = (int64_t)edges;
+        obj["average_degree"] = average_degree;
+        obj["stddev_degree" ] = stddev_degree;
+        obj["max_degree"    ] = (int64_t)max_degree;
+        obj["depth"         ] = depth;
+    }
+};
+
+/**
+ * @brief Model-guided coordinate search over the tuning space.
+ *
+ * A prior from the graph profile orders the candidates of each dimension
+ * (traversal mode, then alpha, beta or do_a, do_b, then delta_factor);
+ * each dimension is swept in that order with timed pilot runs, keeping the
+ * best point and stopping a sweep after max_misses consecutive candidates
+ * that do not improve on it. The pilot is any functor
+ *     double operator()(const TuneConfig &config)
+ * returning the elapsed ms of one run, or a negative value on failure.
+ */
+struct AutoTuner
+{
+    bool   tune_traversal_mode;
+    bool   tune_direction     ;
+    bool   tune_ratio         ; // do_a / do_b instead of alpha / beta
+    bool   tune_delta_factor  ;
+    int    num_repeats        ; // pilot runs per candidate, min time is used
+    int    max_misses         ;
+    bool   quiet              ;
+    json_spirit::mArray pilots; // log of all pilot runs
+
+    AutoTuner() :
+        tune_traversal_mode(true ),
+        tune_direction     (false),
+        tune_ratio         (false),
+        tune_delta_factor  (false),
+        num_repeats        (2    ),
+        max_misses         (2    ),
+        quiet              (false)
+    {
+    }
+
+    template <typename PilotT>
+    TuneConfig Tune(
+        const GraphProfile &profile,
+        const TuneConfig   &initial,
+        PilotT             &pilot)
+    {
+        TuneConfig best = initial;
+        pilots.clear();
+        best.elapsed = Measure(best, pilot);
+
+        if (tune_traversal_mode)
+        {
+            std::vector<TuneConfig> candidates;
+            std::vector<std::string> modes = ModePrior(profile);
+            for (size_t i = 0; i < modes.size(); i++)
+            {
+                TuneConfig config = best;
+                config.traversal_mode = modes[i];
+                candidates.push_back(config);
+            }
+            Sweep(candidates, best, pilot);
+        }
+
+        if (tune_direction && tune_ratio)
+        {
+            std::vector<double> grid_a = DoAPrior(profile);
+            std::vector<TuneConfig> candidates;
+            for (size_t i = 0; i < grid_a.size(); i++)
+            {
+                TuneConfig config = best;
+                config.do_a = grid_a[i];
+                candidates.push_back(config);
+            }
+            Sweep(candidates, best, pilot);
+
+            candidates.clear();
+            const double grid_b[] = {0.2, 0.1, 0.5, 0.05, 1.0, 0.02, 2.0};
+            for (int i = 0; i < 7; i++)
+            {
+                TuneConfig config = best;
+                config.do_b = grid_b[i];
+                candidates.push_back(config);
+            }
+            Sweep(candidates, best, pilot);
+        } else if (tune_direction)
+        {
+            std::vector<double> grid_alpha = AlphaPrior(profile);
+            std::vector<TuneConfig> candidates;
+            for (size_t i = 0; i < grid_alpha.size(); i++)
+            {
+                TuneConfig config = best;
+                config.alpha = grid_alpha[i];
+                candidates.push_back(config);
+            }
+            Sweep(candidates, best, pilot);
+
+            candidates.clear();
+            const double grid_beta[] = {6, 18, 24, 3, 50, 100};
+            for (int i = 0; i < 6; i++)
+            {
+                TuneConfig config = best;
+                config.beta = grid_beta[i];
+                candidates.push_back(config);
+            }
+            Sweep(candidates, best, pilot);
+        }
+
+        if (tune_delta_factor)
+        {
+            std::vector<TuneConfig> candidates;
+            // larger deltas suit low-diameter graphs, smaller ones meshes
+            const int mesh_order [] = {4, 8, 2, 16, 1, 32, 64};
+            const int small_order[] = {16, 32, 8, 64, 4, 128, 2};
+            const int *order = profile.IsMeshLike() ? mesh_order : small_order;
+            for (int i = 0; i < 7; i++)
+            {
+                TuneConfig config = best;
+                config.delta_factor = order[i];
+                candidates.push_back(config);
+            }
+            Sweep(candidates, best, pilot);
+        }
+        return best;
+    }
+
+private:
+    std::vector<std::string> ModePrior(const GraphProfile &profile)
+    {
+        std::vector<std::string> modes;
+        // mirrors Info's default: TWC for sparse graphs, LB for denser or
+        // skewed ones, culling variants next
+        if (profile.average_degree <= 5)
+        {
+            modes.push_back("TWC");
+            modes.push_back("LB_LIGHT");
+            modes.push_back("LB");
+            modes.push_back("LB_CULL");
+            modes.push_back("LB_LIGHT_CULL");
+        } else {
+            modes.push_back("LB");
+            modes.push_back("LB_CULL");
+            modes.push_back("LB_LIGHT");
+            modes.push_back("LB_LIGHT_CULL");
+            modes.push_back("TWC");
+        }
+        return modes;
+    }
+
+    std::vector<double> AlphaPrior(const GraphProfile &profile)
+    {
+        std::vector<double> grid;
+        if (profile.IsMeshLike())
+        {
+            // a small alpha keeps meshes in push mode
+            const double mesh[] = {1, 2, 6, 15};
+            grid.assign(mesh, mesh + 4);
+        } else {
+            const double small[] = {6, 15, 30, 3, 60, 100};
+            grid.assign(small, small + 6);
+        }
+        return grid;
+    }
+
+    std::vector<double> DoAPrior(const GraphProfile &profile)
+    {
+        std::vector<double> grid;
+        if (profile.IsMeshLike())
+        {
+            // pull rarely pays off on meshes; try almost-never first
+            const double mesh[] = {0.00001, 0.0001, 0.001, 0.01};
+            grid.assign(mesh, mesh + 4);
+        } else {
+            const double small[] = {0.001, 0.01, 0.0001, 0.1, 0.00001, 1.0};
+            grid.assign(small, small + 6);
+        }
+        return grid;
+    }
+
+    template <typename PilotT>
+    double Measure(TuneConfig &config, PilotT &pilot)
+    {
+        double best = -1;
+        for (int i = 0; i < num_repeats; i++)
+        {
+            double elapsed = pilot(config);
+            if (elapsed < 0) return -1;
+            if (best < 0 || elapsed < best) best = elapsed;
+        }
+        config.elapsed = best;
+        json_spirit::mObject entry;
+        config.ToJson(entry);
+        pilots.push_back(entry);
+        if (!quiet)
+            printf("pilot: mode = %s, alpha = %g, beta = %g, do_a = %g, "
+                "do_b = %g, delta_factor = %d : %.4f ms\n",
+                config.traversal_mode.c_str(), config.alpha, config.beta,
+                config.do_a, config.do_b, config.delta_factor, best);
+        return best;
+    }
+
+    template <typename PilotT>
+    void Sweep(
+        std::vector<TuneConfig> &candidates,
+        TuneConfig              &best,
+        PilotT                  &pilot)
+    {
+        int misses = 0;
+        for (size_t i = 0; i < candidates.size() && misses < max_misses; i++)
+        {
+            TuneConfig &config = candidates[i];
+            if (config.traversal_mode == best.traversal_mode &&
+                config.do_a == best.do_a && config.do_b == best.do_b &&
+                config.alpha == best.alpha && config.beta == best.beta &&
+                config.delta_factor == best.delta_factor)
+                continue;
+            double elapsed = Measure(config, pilot);
+            if (elapsed >= 0 && (best.elapsed < 0 || elapsed < best.elapsed))
+            {
+                best = config;
+                misses = 0;
+            } else misses ++;
+        }
+    }
+};
+
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -38,6 +38,10 @@ public:
     bool   enable_idempotence;  // enable idempotence operation
     bool   direction_optimized; // enable direction optimization
     double max_queue_sizing1 ;  // maximum queue sizing factor
+    float  alpha             ;  // push to pull threshold
+    float  beta              ;  // pull to push threshold
+    float  do_a              ;  // direction optimization parameter
+    float  do_b              ;  // direction optimization parameter
 
     BFS_Parameter()
     {
@@ -45,6 +49,10 @@ public:
         enable_idempotence = false;
         direction_optimized = false;
         max_queue_sizing1  = -1.0f;
+        alpha              = 6.0;
+        beta               = 6.0;
+        do_a               = 0.001;
+        do_b               = 0.200;
     }
 
     ~BFS_Parameter()
@@ -206,6 +214,10 @@ float runBFS(GRGraph* output, BFS_Parameter *parameter)
     util::GRError(
         enactor->Init(context, problem, max_grid_size, traversal_mode),
         "BFS Enactor init failed", __FILE__, __LINE__);
+    enactor -> alpha = parameter -> alpha;
+    enactor -> beta  = parameter -> beta;
+    enactor -> do_a  = parameter -> do_a;
+    enactor -> do_b  = parameter -> do_b;
 
     CpuTimer cpu_timer;
     float elapsed = 0.0f;
@@ -281,6 +293,26 @@ float dispatch_bfs(
     parameter->gpu_idx  = config -> device_list;
     parameter->mark_predecessors  = config -> mark_predecessors;
     parameter->enable_idempotence = config -> enable_idempotence;
+    if (config -> traversal_mode != NULL)
+        parameter->traversal_mode = config -> traversal_mode;
+    if (config -> tune_file != NULL)
+    {
+        // as Info::ApplyTuneFile, the tuned values only fill what the
+        // caller left at its default; InitSetup's traversal mode is "LB"
+        gunrock::app::TuneConfig tuned;
+        BFS_Parameter            defaults;
+        if (tuned.Load(config -> tune_file))
+        {
+            if (config -> traversal_mode == NULL ||
+                strcmp(config -> traversal_mode, "LB") == 0)
+                parameter->traversal_mode = tuned.traversal_mode;
+            if (parameter->alpha == defaults.alpha) parameter->alpha = tuned.alpha;
+            if (parameter->beta  == defaults.beta ) parameter->beta  = tuned.beta ;
+            if (parameter->do_a  == defaults.do_a ) parameter->do_a  = tuned.do_a ;
+            if (parameter->do_b  == defaults.do_b ) parameter->do_b  = tuned.do_b ;
+        }
+        else fprintf(stderr, "Cannot read tune file %s\n", config -> tune_file);
+    }
 
     float elapsed_time;
 
@@ -620,6 +620,37 @@ __global__ void Inverse_Expand(
     }
 }
 
+/*
+ * @brief Sums the out-degrees of the frontier vertices, for the direction
+ * switching policy.
+ */
+template <typename Problem, typename KernelPolicy>
+__global__ void Frontier_Degree_Sum(
+    typename Problem::SizeT     num_elements,
+    typename Problem::VertexId *d_keys,
+    typename Problem::SizeT    *d_row_offsets,
+    typename Problem::SizeT    *d_degree_sum)
+{
+    typedef typename Problem::SizeT    SizeT;
+    typedef typename Problem::VertexId VertexId;
+    typedef util::Block_Scan<SizeT, KernelPolicy::CUDA_ARCH, KernelPolicy::LOG_THREADS> BlockScanT;
+
+    __shared__ typename BlockScanT::Temp_Space scan_space;
+    SizeT x = (SizeT)blockIdx.x * blockDim.x + threadIdx.x;
+    const SizeT STRIDE = (SizeT)blockDim.x * gridDim.x;
+    SizeT thread_sum = 0, thread_out = 0, block_sum = 0;
+
+    while (x < num_elements)
+    {
+        VertexId v = _ldg(d_keys + x);
+        thread_sum += _ldg(d_row_offsets + v + 1) - _ldg(d_row_offsets + v);
+        x += STRIDE;
+    }
+    BlockScanT::Scan(thread_sum, thread_out, scan_space, block_sum);
+    if (threadIdx.x == 0 && block_sum != 0)
+        atomicAdd(d_degree_sum, block_sum);
+}
+
 template <typename Problem>
 __global__ void Update_Mask_Kernel(
     typename Problem::SizeT num_nodes,
@@ -852,32 +883,42 @@ struct BFSIteration : public IterationBase <
          //if (data_slice -> previous_direction == FORWARD)
             data_slice -> num_visited_vertices += frontier_attribute -> queue_length;
         data_slice -> num_unvisited_vertices = graph_slice -> nodes - data_slice -> num_visited_vertices;
-        float predicted_backward_visits = data_slice -> num_visited_vertices == 0 ?
-            std::numeric_limits<float>::infinity() :
-            data_slice -> num_unvisited_vertices * 1.0 * graph_slice -> nodes / data_slice -> num_visited_vertices;
-        //predicted_reverse_edge_visits /= enactor -> num_gpus;
-        float predicted_forward_visits = frontier_attribute -> queue_length * 1.0 * graph_slice -> edges / graph_slice -> nodes;
-        //printf("%d\t %d\t %d\t queue_length = %d, output_length = %d, visited = %d, rev = %f\n",
-        //    data_slice -> gpu_idx, enactor_stats -> iteration, peer_,
-        //    frontier_attribute -> queue_length,
-        //    frontier_attribute -> output_length[0],
-        //    data_slice -> num_visited_vertices,
-        //    rev);
         long long iteration_ = enactor_stats -> iteration % 4;
         if (enactor -> direction_optimized)
         {
-            if (data_slice -> previous_direction == FORWARD)
+            // exact out-degree sum of the newly visited vertices
+            SizeT frontier_edges = 0;
+            if (frontier_attribute -> queue_length > 0)
             {
-                if (predicted_forward_visits > predicted_backward_visits * enactor -> do_a &&
-                    !data_slice -> been_in_backward)
-                     data_slice -> direction_votes[iteration_] = BACKWARD;
-                else data_slice -> direction_votes[iteration_] = FORWARD;
-            } else {
-                data_slice -> been_in_backward = true;
-                if (predicted_forward_visits > predicted_backward_visits * enactor -> do_b)
-                     data_slice -> direction_votes[iteration_] = BACKWARD;
-                else data_slice -> direction_votes[iteration_] = FORWARD;
+                int num_blocks = frontier_attribute -> queue_length / AdvanceKernelPolicy::THREADS + 1;
+                if (num_blocks > 480) num_blocks = 480;
+                data_slice -> frontier_edges[0] = 0;
+                data_slice -> frontier_edges.Move(util::HOST, util::DEVICE, 1, 0, stream);
+                Frontier_Degree_Sum<Problem, AdvanceKernelPolicy>
+                    <<<num_blocks, AdvanceKernelPolicy::THREADS, 0, stream>>>(
+                    frontier_attribute -> queue_length,
+                    frontier_queue -> keys[frontier_attribute -> selector].GetPointer(util::DEVICE),
+                    graph_slice -> row_offsets.GetPointer(util::DEVICE),
+                    data_slice -> frontier_edges.GetPointer(util::DEVICE));
+                data_slice -> frontier_edges.Move(util::DEVICE, util::HOST, 1, 0, stream);
+                if (enactor_stats -> retval = util::GRError(cudaStreamSynchronize(stream),
+                    "cudaStreamSynchronize failed", __FILE__, __LINE__))
+                    return;
+                frontier_edges = data_slice -> frontier_edges[0];
             }
+
+            DirectionPolicy<SizeT> &policy = data_slice -> direction_policy;
+            policy.heuristic = enactor -> do_heuristic;
+            policy.alpha     = enactor -> alpha;
+            policy.beta      = enactor -> beta;
+            policy.do_a      = enactor -> do_a;
+            policy.do_b      = enactor -> do_b;
+            policy.direction = data_slice -> previous_direction;
+            data_slice -> direction_votes[iteration_] = policy.Decide(
+                enactor_stats -> iteration,
+                frontier_attribute -> queue_length, frontier_edges);
+            if (data_slice -> direction_votes[iteration_] == BACKWARD)
+                data_slice -> been_in_backward = true;
         } else data_slice -> direction_votes[iteration_] = FORWARD;
         data_slice -> direction_votes[(iteration_+1)%4] = UNDECIDED;
 
@@ -917,26 +958,17 @@ struct BFSIteration : public IterationBase <
         else {
             data_slice -> current_direction = data_slice -> direction_votes[iteration_];
         }
-        if (false) //(thread_num == 0 && enactor -> direction_optimized)
-            printf("%d\t %lld\t \t queue = %lld,\t pre_output = %lld,\t visited = %lld,\t "
-                "unvisited = %lld,\t predicted_forward = %.0f,\t predicted_backward = %.0f,\t "
-                "direction = %s, ratio = %.8f\n",
-                //" ratio2 = %.4f, ratio3 = %.4f, %.4f, ratio4 = %.4f, ratio5 = %.4f\n",
+        if (enactor -> debug && enactor -> direction_optimized &&
+            !data_slice -> direction_policy.trace.empty())
+        {
+            const DirectionDecision &decision = data_slice -> direction_policy.trace.back();
+            printf("%d\t %lld\t \t frontier = %lld,\t frontier_edges = %lld,\t "
+                "unexplored_edges = %lld,\t unvisited = %lld,\t direction = %s\n",
                 thread_num, enactor_stats -> iteration,
-                (long long)frontier_attribute -> queue_length,
-                (long long)frontier_attribute -> output_length[0],
-                (long long)data_slice -> num_visited_vertices,
-                (long long)data_slice -> num_unvisited_vertices,
-                predicted_forward_visits,
-                predicted_backward_visits,
-                data_slice -> current_direction == FORWARD ? "FORWARD" : "BACKWARD",
-                predicted_forward_visits / predicted_backward_visits);
-                //data_slice -> num_visited_vertices * 1.0 / data_slice -> nodes,
-                //data_slice -> num_visited_vertices * 1.0 / data_slice -> num_unvisited_vertices,
-                //data_slice -> num_unvisited_vertices * 1.0 / data_slice -> num_visited_vertices,
-                //frontier_attribute -> queue_length * 1.0 / data_slice -> num_unvisited_vertices,
-                //frontier_attribute -> queue_length * 1.0 * data_slice -> edges / data_slice -> nodes /
-                //(data_slice -> num_unvisited_vertices * 1.0 * data_slice -> nodes / data_slice -> num_visited_vertices));
+                decision.frontier_vertices, decision.frontier_edges,
+                decision.unexplored_edges, decision.unvisited_vertices,
+                data_slice -> current_direction == FORWARD ? "FORWARD" : "BACKWARD");
+        }
     }
 
     /*
@@ -1806,6 +1838,8 @@ public:
     typedef BFSEnactor<Problem>        Enactor;
 
     bool direction_optimized;
+    DirectionHeuristic do_heuristic;
+    float alpha, beta;
     float do_a, do_b;
     // Methods
 
@@ -1826,6 +1860,9 @@ public:
         thread_Ids    (NULL),
         problem       (NULL),
         direction_optimized (_direction_optimized),
+        do_heuristic  (BEAMER_HEURISTIC),
+        alpha         (6.0  ),
+        beta          (6.0  ),
         do_a          (0.001),
         do_b          (0.200)
     {
@@ -0,0 +1,211 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * bfs_host.cuh
+ *
+ * @brief BFS on the host, expressed with the VertexSubset operators, and
+ * a bit-parallel multi-source BFS
+ */
+
+#pragma once
+
+#include <gunrock/csr.cuh>
+#include <gunrock/oprtr/host/edge_map.cuh>
+
+namespace gunrock {
+namespace app {
+namespace bfs {
+
+/**
+ * @brief Labels an unvisited destination with the next depth.
+ */
+template <typename VertexId>
+struct HostBFSFunctor
+{
+    VertexId *labels;
+    VertexId  depth;
+
+    bool CondDst(VertexId d)
+    {
+        return labels[d] == -1;
+    }
+
+    bool ApplyEdge(VertexId s, VertexId d)
+    {
+        labels[d] = depth + 1;
+        return true;
+    }
+
+    bool ApplyEdgeAtomic(VertexId s, VertexId d)
+    {
+        return __sync_bool_compare_and_swap(labels + d, (VertexId)-1, depth + 1);
+    }
+};
+
+/**
+ * @brief BFS driven by EdgeMap, which picks push or pull each level from
+ * the frontier size and its out-degree sum.
+ *
+ * @param[in] graph Graph (out-edges).
+ * @param[in] inv_graph Inverse graph (in-edges), NULL if graph is symmetric.
+ * @param[in] src Source vertex.
+ * @param[out] labels Search depth of each vertex, -1 if unreached.
+ * @param[out] num_pulls Number of levels expanded by pulling, if not NULL.
+ *
+ * \return Search depth.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+VertexId HostVertexSubsetBFS(
+    const Csr<VertexId, SizeT, Value> &graph,
+    const Csr<VertexId, SizeT, Value> *inv_graph,
+    VertexId                           src,
+    VertexId                          *labels,
+    int                               *num_pulls = NULL)
+{
+    typedef oprtr::host::VertexSubset<VertexId, SizeT> Subset;
+    Subset frontier, next_frontier;
+    HostBFSFunctor<VertexId> functor;
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < graph.nodes; v++)
+        labels[v] = -1;
+    labels[src] = 0;
+    functor.labels = labels;
+    functor.depth  = 0;
+    frontier.InitSingle(graph.nodes, src);
+    if (num_pulls != NULL) *num_pulls = 0;
+
+    while (!frontier.Empty())
+    {
+        oprtr::host::EdgeMapMode mode = oprtr::host::EdgeMap(
+            graph, inv_graph, frontier, next_frontier, functor);
+        if (mode == oprtr::host::EDGE_MAP_PULL && num_pulls != NULL)
+            (*num_pulls) ++;
+        frontier.Swap(next_frontier);
+        next_frontier.Release();
+        if (!frontier.Empty()) functor.depth ++;
+    }
+    return functor.depth;
+}
+
+/**
+ * @brief Up to 64 BFS at once: bit i of a vertex's masks belongs to source
+ * i, so one scan of the adjacency advances every search. Levels with few
+ * active vertices push their masks with an atomic OR; larger ones pull
+ * the masks of the in-neighbors, which needs no atomics.
+ *
+ * @param[in] graph Graph (out-edges).
+ * @param[in] inv_graph Inverse graph (in-edges), NULL if graph is symmetric.
+ * @param[in] sources Source vertices.
+ * @param[in] num_sources Number of sources, at most 64.
+ * @param[out] labels Search depth of each vertex from each source, -1 if
+ * unreached; labels[i * nodes + v] for source i.
+ *
+ * \return Largest search depth.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+VertexId HostMultiSourceBFS(
+    const Csr<VertexId, SizeT, Value> &graph,
+    const Csr<VertexId, SizeT, Value> *inv_graph,
+    const VertexId                    *sources,
+    int                                num_sources,
+    VertexId                          *labels)
+{
+    typedef unsigned long long Mask;
+    const Csr<VertexId, SizeT, Value> &in_graph =
+        (inv_graph == NULL) ? graph : *inv_graph;
+    SizeT nodes    = graph.nodes;
+    Mask *seen     = (Mask*) malloc(sizeof(Mask) * nodes);
+    Mask *frontier = (Mask*) malloc(sizeof(Mask) * nodes);
+    Mask *next     = (Mask*) malloc(sizeof(Mask) * nodes);
+    VertexId depth = 0;
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < nodes; v++)
+    {
+        seen[v] = frontier[v] = next[v] = 0;
+        for (int i = 0; i < num_sources; i++)
+            labels[(SizeT)i * nodes + v] = -1;
+    }
+    for (int i = 0; i < num_sources; i++)
+    {
+        seen    [sources[i]] |= (Mask)1 << i;
+        frontier[sources[i]] |= (Mask)1 << i;
+        labels[(SizeT)i * nodes + sources[i]] = 0;
+    }
+
+    while (true)
+    {
+        SizeT frontier_edges = 0;
+        #pragma omp parallel for reduction(+:frontier_edges)
+        for (SizeT v = 0; v < nodes; v++)
+            if (frontier[v])
+                frontier_edges += graph.row_offsets[v+1] - graph.row_offsets[v];
+        if (frontier_edges == 0) break;
+
+        if (frontier_edges > graph.edges / 20)
+        {
+            #pragma omp parallel for schedule(dynamic, 1024)
+            for (SizeT v = 0; v < nodes; v++)
+            {
+                Mask mask = 0;
+                for (SizeT e = in_graph.row_offsets[v];
+                    e < in_graph.row_offsets[v+1]; e++)
+                    mask |= frontier[in_graph.column_indices[e]];
+                next[v] = mask & ~seen[v];
+            }
+        } else {
+            #pragma omp parallel for schedule(dynamic, 1024)
+            for (SizeT u = 0; u < nodes; u++)
+            {
+                Mask mask = frontier[u];
+                if (mask == 0) continue;
+                for (SizeT e = graph.row_offsets[u];
+                    e < graph.row_offsets[u+1]; e++)
+                {
+                    VertexId v = graph.column_indices[e];
+                    if ((mask & ~seen[v] & ~next[v]) != 0)
+                        __sync_fetch_and_or(next + v, mask & ~seen[v]);
+                }
+            }
+        }
+
+        depth ++;
+        bool active = false;
+        #pragma omp parallel for reduction(||:active)
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            Mask mask   = next[v] & ~seen[v];
+            frontier[v] = mask;
+            next    [v] = 0;
+            if (mask == 0) continue;
+            seen[v] |= mask;
+            active = true;
+            for (int i = 0; i < num_sources; i++)
+                if ((mask >> i) & 1)
+                    labels[(SizeT)i * nodes + v] = depth;
+        }
+        if (!active) { depth --; break; }
+    }
+
+    free(seen    ); seen     = NULL;
+    free(frontier); frontier = NULL;
+    free(next    ); next     = NULL;
+    return depth;
+}
+
+} // namespace bfs
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,103 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * bfs_ooc.cuh
+ *
+ * @brief Out-of-core BFS over a BlockGraph: labels stay in memory, and
+ * each level reads only the blocks holding frontier vertices.
+ */
+
+#pragma once
+
+#include <vector>
+#include <gunrock/block_graph.cuh>
+
+namespace gunrock {
+namespace app {
+namespace bfs {
+
+/**
+ * @brief Labels the unvisited neighbors of frontier vertices, and marks
+ * and prefetches their blocks for the next level.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+struct BlockBFSOp
+{
+    BlockGraph<VertexId, SizeT, Value> *graph;
+    VertexId *labels;
+    VertexId  depth;
+    char     *next_active;  // per block
+    bool      discovered;
+
+    void operator()(SizeT e, VertexId from, VertexId to)
+    {
+        if (labels[from] != depth || labels[to] != -1) return;
+        if (!__sync_bool_compare_and_swap(labels + to, (VertexId)-1, depth + 1))
+            return;
+        discovered = true;
+        int b = graph->BlockOf(to);
+        if (next_active[b] == 0 &&
+            __sync_bool_compare_and_swap(next_active + b, (char)0, (char)1))
+            graph->Prefetch(b);
+    }
+};
+
+/**
+ * @brief Level-synchronous BFS over a block graph.
+ *
+ * @param[in] graph Block graph (out-edges).
+ * @param[in] src Source vertex.
+ * @param[out] labels Search depth of each vertex, -1 if unreached.
+ * @param[out] blocks_visited Number of block visits, if not NULL.
+ *
+ * \return Search depth.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+VertexId BlockBFS(
+    BlockGraph<VertexId, SizeT, Value> &graph,
+    VertexId                            src,
+    VertexId                           *labels,
+    SizeT                              *blocks_visited = NULL)
+{
+    std::vector<char> active(graph.num_blocks, 0), next_active(graph.num_blocks, 0);
+    BlockBFSOp<VertexId, SizeT, Value> op;
+    SizeT visits = 0;
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < graph.nodes; v++)
+        labels[v] = -1;
+    labels[src] = 0;
+    active[graph.BlockOf(src)] = 1;
+    op.graph       = &graph;
+    op.labels      = labels;
+    op.depth       = 0;
+
+    while (true)
+    {
+        op.next_active = &next_active[0];
+        op.discovered  = false;
+        visits += graph.ForAllEdges(op, &active[0]);
+        if (!op.discovered) break;
+        active.swap(next_active);
+        std::fill(next_active.begin(), next_active.end(), 0);
+        op.depth ++;
+    }
+    if (blocks_visited != NULL) *blocks_visited = visits;
+    return op.depth;
+}
+
+} // namespace bfs
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
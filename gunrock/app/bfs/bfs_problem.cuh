@@ -17,17 +17,12 @@
 #include <gunrock/app/problem_base.cuh>
 #include <gunrock/util/memset_kernel.cuh>
 #include <gunrock/util/array_utils.cuh>
+#include <gunrock/app/bfs/direction_policy.cuh>
 
 namespace gunrock {
 namespace app {
 namespace bfs {
 
-enum DIRECTION {
-    FORWARD  = 0,
-    BACKWARD = 1,
-    UNDECIDED= 2,
-};
-
 /**
  * @brief Breadth-First Search Problem structure stores device-side vectors for doing BFS computing on the GPU.
  *
@@ -86,6 +81,8 @@ struct BFSProblem : ProblemBase<VertexId, SizeT, Value,
         util::Array1D<SizeT, DIRECTION     > direction_votes;
         util::Array1D<SizeT, MaskT         > old_mask;
         util::Array1D<SizeT, MaskT*        > in_masks;
+        util::Array1D<SizeT, SizeT         > frontier_edges;
+        DirectionPolicy<SizeT> direction_policy;
 
         /*
          * @brief Default constructor
@@ -107,6 +104,7 @@ struct BFSProblem : ProblemBase<VertexId, SizeT, Value,
             direction_votes.SetName("direction_votes");
             old_mask.SetName("old_mask");
             in_masks.SetName("in_masks");
+            frontier_edges.SetName("frontier_edges");
         }
 
         /*
@@ -137,6 +135,7 @@ struct BFSProblem : ProblemBase<VertexId, SizeT, Value,
             if (retval = direction_votes.Release()) return retval;
             if (retval = old_mask.Release()) return retval;
             if (retval = in_masks.Release()) return retval;
+            if (retval = frontier_edges.Release()) return retval;
             return retval;
         }
 
@@ -196,6 +195,8 @@ struct BFSProblem : ProblemBase<VertexId, SizeT, Value,
             if (retval = split_lengths.Init(2, util::HOST | util::DEVICE, true, cudaHostAllocMapped | cudaHostAllocPortable))
                 return retval;
             if (retval = direction_votes.Allocate(4, util::HOST));
+            if (retval = frontier_edges.Allocate(1, util::HOST | util::DEVICE))
+                return retval;
 
             if (MARK_PREDECESSORS)
             {
@@ -288,6 +289,7 @@ struct BFSProblem : ProblemBase<VertexId, SizeT, Value,
             been_in_backward = false;
             current_direction = FORWARD;
             previous_direction = FORWARD;
+            direction_policy.Init(nodes, edges);
             if (queue_sizing1 < 0) queue_sizing1 = queue_sizing;
 
             if (retval = util::SetDevice( this -> gpu_idx)) return retval;
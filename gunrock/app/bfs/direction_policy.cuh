@@ -0,0 +1,317 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * direction_policy.cuh
+ *
+ * @brief Push / pull switching policy for direction-optimizing BFS, shared
+ * by the host reference and the GPU enactor
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <gunrock/csr.cuh>
+#include <gunrock/util/simd_utils.cuh>
+#include <gunrock/util/json_spirit_writer_template.h>
+
+namespace gunrock {
+namespace app {
+namespace bfs {
+
+enum DIRECTION {
+    FORWARD  = 0,
+    BACKWARD = 1,
+    UNDECIDED= 2,
+};
+
+enum DirectionHeuristic {
+    BEAMER_HEURISTIC = 0, // exact unexplored-edge counts, alpha / beta
+    RATIO_HEURISTIC  = 1, // average-degree estimates, do_a / do_b
+};
+
+/**
+ * @brief Inputs and outcome of one switching decision.
+ */
+struct DirectionDecision
+{
+    long long iteration;
+    long long frontier_vertices;
+    long long frontier_edges;
+    long long unexplored_edges;
+    long long unvisited_vertices;
+    DIRECTION direction;
+
+    void ToJson(json_spirit::mObject &obj) const
+    {
+        obj["iteration"         ] = (int64_t)iteration;
+        obj["frontier_vertices" ] = (int64_t)frontier_vertices;
+        obj["frontier_edges"    ] = (int64_t)frontier_edges;
+        obj["unexplored_edges"  ] = (int64_t)unexplored_edges;
+        obj["unvisited_vertices"] = (int64_t)unvisited_vertices;
+        obj["direction"         ] = direction == FORWARD ? "push" : "pull";
+    }
+};
+
+/**
+ * @brief Decides the direction of each BFS iteration.
+ *
+ * The caller reports the newly visited vertices (the frontier) and the sum
+ * of their out-degrees; the policy keeps the unexplored edge count
+ * m_u = edges - (degree sum of visited vertices) incrementally from these.
+ * With the Beamer heuristic it switches push -> pull when
+ *     m_f > m_u / alpha   and the frontier is growing,
+ * and pull -> push when
+ *     n_f < n / beta      and the frontier is shrinking;
+ * the growing / shrinking conditions keep it from oscillating around the
+ * thresholds.
+ *
+ * @tparam SizeT
+ */
+template <typename SizeT>
+struct DirectionPolicy
+{
+    DirectionHeuristic heuristic;
+    double alpha, beta;   // Beamer thresholds
+    double do_a , do_b ;  // ratio thresholds
+    bool   record_trace;
+
+    SizeT  nodes, edges;
+    SizeT  visited_vertices;
+    SizeT  unexplored_edges;
+    SizeT  previous_frontier;
+    bool   been_in_backward;
+    DIRECTION direction;
+    std::vector<DirectionDecision> trace;
+
+    DirectionPolicy() :
+        heuristic        (BEAMER_HEURISTIC),
+        alpha            (6.0  ),
+        beta             (6.0  ),
+        do_a             (0.001),
+        do_b             (0.200),
+        record_trace     (true ),
+        nodes            (0    ),
+        edges            (0    ),
+        visited_vertices (0    ),
+        unexplored_edges (0    ),
+        previous_frontier(0    ),
+        been_in_backward (false),
+        direction        (FORWARD)
+    {
+    }
+
+    /**
+     * @brief Sets the graph the policy runs on; call Reset before each run.
+     *
+     * @param[in] _nodes Number of vertices of the (sub-)graph.
+     * @param[in] _edges Number of edges of the (sub-)graph.
+     */
+    void Init(SizeT _nodes, SizeT _edges)
+    {
+        nodes = _nodes;
+        edges = _edges;
+        Reset();
+    }
+
+    void Reset()
+    {
+        visited_vertices  = 0;
+        unexplored_edges  = edges;
+        previous_frontier = 0;
+        been_in_backward  = false;
+        direction         = FORWARD;
+        trace.clear();
+    }
+
+    /**
+     * @brief Chooses the direction of the next expansion.
+     *
+     * @param[in] iteration Current iteration.
+     * @param[in] frontier_vertices Number of newly visited vertices.
+     * @param[in] frontier_edges Sum of the out-degrees of those vertices.
+     *
+     * \return Direction of the next expansion.
+     */
+    DIRECTION Decide(
+        long long iteration,
+        SizeT     frontier_vertices,
+        SizeT     frontier_edges)
+    {
+        visited_vertices += frontier_vertices;
+        if (visited_vertices > nodes) visited_vertices = nodes;
+        unexplored_edges  = (unexplored_edges > frontier_edges) ?
+            unexplored_edges - frontier_edges : 0;
+        SizeT unvisited_vertices = nodes - visited_vertices;
+
+        if (heuristic == BEAMER_HEURISTIC)
+        {
+            if (direction == FORWARD)
+            {
+                if (frontier_vertices > previous_frontier &&
+                    frontier_edges > unexplored_edges / alpha)
+                    direction = BACKWARD;
+            } else {
+                if (frontier_vertices < previous_frontier &&
+                    frontier_vertices < nodes / beta)
+                    direction = FORWARD;
+            }
+        } else {
+            double predicted_backward = visited_vertices == 0 ?
+                std::numeric_limits<double>::infinity() :
+                unvisited_vertices * 1.0 * nodes / visited_vertices;
+            double predicted_forward = nodes == 0 ? 0 :
+                frontier_vertices * 1.0 * edges / nodes;
+            if (direction == FORWARD)
+            {
+                direction = (predicted_forward > predicted_backward * do_a &&
+                    !been_in_backward) ? BACKWARD : FORWARD;
+            } else {
+                been_in_backward = true;
+                direction = (predicted_forward > predicted_backward * do_b) ?
+                    BACKWARD : FORWARD;
+            }
+        }
+        previous_frontier = frontier_vertices;
+
+        if (record_trace)
+        {
+            DirectionDecision decision;
+            decision.iteration          = iteration;
+            decision.frontier_vertices  = frontier_vertices;
+            decision.frontier_edges     = frontier_edges;
+            decision.unexplored_edges   = unexplored_edges;
+            decision.unvisited_vertices = unvisited_vertices;
+            decision.direction          = direction;
+            trace.push_back(decision);
+        }
+        return direction;
+    }
+
+    /**
+     * @brief Number of direction changes in the recorded trace.
+     */
+    int NumSwitches() const
+    {
+        int num_switches = 0;
+        for (size_t i = 1; i < trace.size(); i++)
+            if (trace[i].direction != trace[i-1].direction) num_switches ++;
+        if (!trace.empty() && trace[0].direction != FORWARD) num_switches ++;
+        return num_switches;
+    }
+
+    void ToJson(json_spirit::mObject &obj) const
+    {
+        json_spirit::mArray decisions;
+        for (size_t i = 0; i < trace.size(); i++)
+        {
+            json_spirit::mObject decision;
+            trace[i].ToJson(decision);
+            decisions.push_back(decision);
+        }
+        obj["heuristic"] = heuristic == BEAMER_HEURISTIC ? "beamer" : "ratio";
+        obj["alpha"    ] = alpha;
+        obj["beta"     ] = beta;
+        obj["do_a"     ] = do_a;
+        obj["do_b"     ] = do_b;
+        obj["switches" ] = NumSwitches();
+        obj["decisions"] = decisions;
+    }
+};
+
+/**
+ * @brief Parses the --do-heuristic value.
+ */
+inline DirectionHeuristic GetDirectionHeuristic(std::string name)
+{
+    return (name == "ratio") ? RATIO_HEURISTIC : BEAMER_HEURISTIC;
+}
+
+/**
+ * @brief Direction-optimizing BFS on the host, driven by the same policy
+ * as the GPU enactor.
+ *
+ * @param[in] graph Graph (out-edges).
+ * @param[in] inv_graph Inverse graph (in-edges), NULL if graph is symmetric.
+ * @param[in] src Source vertex.
+ * @param[out] labels Search depth of each vertex, -1 if unreached.
+ * @param[in,out] policy Switching policy; its trace is filled.
+ *
+ * \return Search depth.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+VertexId HostDirectionOptimizedBFS(
+    const Csr<VertexId, SizeT, Value> &graph,
+    const Csr<VertexId, SizeT, Value> *inv_graph,
+    VertexId                           src,
+    VertexId                          *labels,
+    DirectionPolicy<SizeT>            &policy)
+{
+    const Csr<VertexId, SizeT, Value> &in_graph =
+        (inv_graph == NULL) ? graph : *inv_graph;
+    std::vector<VertexId> frontier, next_frontier;
+    VertexId depth = 0;
+
+    for (SizeT v = 0; v < graph.nodes; v++) labels[v] = -1;
+    policy.Init(graph.nodes, graph.edges);
+    labels[src] = 0;
+    frontier.push_back(src);
+
+    while (!frontier.empty())
+    {
+        SizeT frontier_edges = 0;
+        for (size_t i = 0; i < frontier.size(); i++)
+            frontier_edges += graph.row_offsets[frontier[i] + 1]
+                            - graph.row_offsets[frontier[i]];
+        DIRECTION direction = policy.Decide(
+            depth, (SizeT)frontier.size(), frontier_edges);
+
+        next_frontier.clear();
+        if (direction == FORWARD)
+        {
+            for (size_t i = 0; i < frontier.size(); i++)
+            {
+                VertexId v = frontier[i];
+                for (SizeT e = graph.row_offsets[v]; e < graph.row_offsets[v+1]; e++)
+                {
+                    VertexId u = graph.column_indices[e];
+                    if (labels[u] != -1) continue;
+                    labels[u] = depth + 1;
+                    next_frontier.push_back(u);
+                }
+            }
+        } else {
+            for (SizeT u = 0; u < graph.nodes; u++)
+            {
+                if (labels[u] != -1) continue;
+                SizeT degree = in_graph.row_offsets[u+1] - in_graph.row_offsets[u];
+                if (util::simd::GatherFind(
+                    in_graph.column_indices + in_graph.row_offsets[u],
+                    (SizeT)0, degree, labels, depth,
+                    util::simd::GATHER_EQUAL) == degree) continue;
+                labels[u] = depth + 1;
+                next_frontier.push_back(u);
+            }
+        }
+        frontier.swap(next_frontier);
+        if (!frontier.empty()) depth ++;
+    }
+    return depth;
+}
+
+} // namespace bfs
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,148 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * cc_host.cuh
+ *
+ * @brief Connected components on the host: edge-centric hooking, and
+ * min-label propagation over the CSR
+ */
+
+#pragma once
+
+#include <gunrock/csr.cuh>
+#include <gunrock/edge_list.cuh>
+#include <gunrock/util/simd_utils.cuh>
+
+namespace gunrock {
+namespace app {
+namespace cc {
+
+/**
+ * @brief Hooks the larger root of each edge onto the smaller one.
+ */
+template <typename VertexId, typename SizeT>
+struct HookOp
+{
+    VertexId *component_ids;
+    int       changed;  // set atomically, ForAllEdges shares one op
+
+    void operator()(SizeT e, VertexId from, VertexId to)
+    {
+        VertexId from_root = component_ids[from];
+        VertexId to_root   = component_ids[to  ];
+        if (from_root == to_root) return;
+        VertexId high = from_root > to_root ? from_root : to_root;
+        VertexId low  = from_root > to_root ? to_root   : from_root;
+        // only roots are hooked; a lost race is retried next round
+        if (component_ids[high] == high &&
+            __sync_bool_compare_and_swap(component_ids + high, high, low))
+            __sync_fetch_and_or(&changed, 1);
+    }
+};
+
+/**
+ * @brief Connected components by hooking over the edge list and pointer
+ * jumping, as the GPU primitive does over froms / tos.
+ *
+ * @param[in] edge_list Edge list of a symmetric graph.
+ * @param[out] component_ids Component of each vertex: its smallest vertex.
+ *
+ * \return Number of components.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+SizeT HostCC(
+    const EdgeList<VertexId, SizeT, Value> &edge_list,
+    VertexId                               *component_ids)
+{
+    SizeT nodes = edge_list.nodes;
+    HookOp<VertexId, SizeT> hook;
+    hook.component_ids = component_ids;
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < nodes; v++)
+        component_ids[v] = v;
+
+    do {
+        hook.changed = 0;
+        edge_list.ForAllEdges(hook);
+
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            VertexId root = component_ids[v];
+            while (component_ids[root] != root) root = component_ids[root];
+            component_ids[v] = root;
+        }
+    } while (hook.changed != 0);
+
+    SizeT num_components = 0;
+    #pragma omp parallel for reduction(+:num_components)
+    for (SizeT v = 0; v < nodes; v++)
+        if (component_ids[v] == v) num_components ++;
+    return num_components;
+}
+
+/**
+ * @brief Connected components by min-label propagation: every vertex pulls
+ * the smallest label among its neighbors, a SIMD gather over its neighbor
+ * list, then shortcuts through the label of that label. Labels only
+ * decrease and always name a vertex of the same component, so a round
+ * that changes nothing leaves each vertex labeled by the smallest vertex
+ * of its component, i.e. ConvertIDs' labeling.
+ *
+ * @param[in] graph CSR of a symmetric graph.
+ * @param[out] component_ids Component of each vertex: its smallest vertex.
+ *
+ * \return Number of components.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+SizeT HostLabelPropagationCC(
+    const Csr<VertexId, SizeT, Value> &graph,
+    VertexId                          *component_ids)
+{
+    SizeT nodes = graph.nodes;
+    bool  changed = true;
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < nodes; v++)
+        component_ids[v] = v;
+
+    while (changed)
+    {
+        changed = false;
+        #pragma omp parallel for schedule(dynamic, 1024) reduction(||:changed)
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            SizeT start = graph.row_offsets[v];
+            VertexId label = util::simd::GatherMin(
+                graph.column_indices + start, graph.row_offsets[v + 1] - start,
+                component_ids, component_ids[v], (VertexId)-1);
+            while (component_ids[label] < label) label = component_ids[label];
+            if (label >= component_ids[v]) continue;
+            component_ids[v] = label;
+            changed = true;
+        }
+    }
+
+    SizeT num_components = 0;
+    #pragma omp parallel for reduction(+:num_components)
+    for (SizeT v = 0; v < nodes; v++)
+        if (component_ids[v] == v) num_components ++;
+    return num_components;
+}
+
+} // namespace cc
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
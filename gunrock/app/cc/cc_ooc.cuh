@@ -0,0 +1,108 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * cc_ooc.cuh
+ *
+ * @brief Out-of-core connected components over a BlockGraph: one pass of
+ * lock-free union-find over the blocks, so each block is read once.
+ */
+
+#pragma once
+
+#include <gunrock/block_graph.cuh>
+
+namespace gunrock {
+namespace app {
+namespace cc {
+
+/**
+ * @brief Root of v, halving the path on the way.
+ */
+template <typename VertexId>
+VertexId FindRoot(VertexId *parents, VertexId v)
+{
+    while (true)
+    {
+        VertexId parent = parents[v];
+        if (parent == v) return v;
+        VertexId grand_parent = parents[parent];
+        if (grand_parent != parent)
+            __sync_bool_compare_and_swap(parents + v, parent, grand_parent);
+        v = grand_parent;
+    }
+}
+
+/**
+ * @brief Links the larger root of each edge under the smaller one, so a
+ * root is always the smallest vertex of its tree.
+ */
+template <typename VertexId, typename SizeT>
+struct UnionOp
+{
+    VertexId *parents;
+
+    void operator()(SizeT e, VertexId from, VertexId to)
+    {
+        while (true)
+        {
+            VertexId from_root = FindRoot(parents, from);
+            VertexId to_root   = FindRoot(parents, to  );
+            if (from_root == to_root) return;
+            VertexId high = from_root > to_root ? from_root : to_root;
+            VertexId low  = from_root > to_root ? to_root   : from_root;
+            // fails if high was linked meanwhile; retry from the new roots
+            if (__sync_bool_compare_and_swap(parents + high, high, low)) return;
+        }
+    }
+};
+
+/**
+ * @brief Connected components of a block graph, edges taken as undirected.
+ *
+ * @param[in] graph Block graph.
+ * @param[out] component_ids Component of each vertex: its smallest vertex,
+ * as HostCC.
+ *
+ * \return Number of components.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+SizeT BlockCC(
+    BlockGraph<VertexId, SizeT, Value> &graph,
+    VertexId                           *component_ids)
+{
+    SizeT nodes = graph.nodes;
+    UnionOp<VertexId, SizeT> op;
+    op.parents = component_ids;
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < nodes; v++)
+        component_ids[v] = v;
+    graph.ForAllEdges(op);
+
+    // roots are final after the pass, so paths can be compressed in parallel
+    #pragma omp parallel for
+    for (SizeT v = 0; v < nodes; v++)
+        component_ids[v] = FindRoot(component_ids, (VertexId)v);
+
+    SizeT num_components = 0;
+    #pragma omp parallel for reduction(+:num_components)
+    for (SizeT v = 0; v < nodes; v++)
+        if (component_ids[v] == v) num_components ++;
+    return num_components;
+}
+
+} // namespace cc
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -480,17 +480,21 @@ struct CCProblem : ProblemBase<VertexId, SizeT, Value,
      * @param[in] h_component_ids host-side vector stores  component ids.
      * @param[out] h_roots host-side vector to store root node id for each component.
      * @param[out] h_histograms host-side vector to store histograms.
+     * @param[in] num_nodes Length of h_component_ids, when it is not the
+     * problem's graph, e.g. labels expanded from a kernel graph; 0 for nodes.
      *
      */
     void ComputeCCHistogram(
         VertexId *h_component_ids, 
         VertexId *h_roots, 
-        SizeT    *h_histograms)
+        SizeT    *h_histograms,
+        SizeT     num_nodes = 0)
     {
+        if (num_nodes == 0) num_nodes = this->nodes;
         //Get roots for each component and the total number of component
         //VertexId *min_nodes = new VertexId[this->nodes];
-        VertexId *counter   = new VertexId[this->nodes];
-        for (SizeT i = 0; i < this->nodes; i++)
+        VertexId *counter   = new VertexId[num_nodes];
+        for (SizeT i = 0; i < num_nodes; i++)
         {
             //min_nodes[i] = this->nodes;
             counter  [i] = 0;
@@ -498,7 +502,7 @@ struct CCProblem : ProblemBase<VertexId, SizeT, Value,
         //for (int i = 0; i < this->nodes; i++)
         //    if (min_nodes[h_component_ids[i]] > i) min_nodes[h_component_ids[i]] = i;
         num_components = 0;
-        for (SizeT i = 0; i < this->nodes; i++)
+        for (SizeT i = 0; i < num_nodes; i++)
         {
             if (counter[h_component_ids[i]]==0)
             {
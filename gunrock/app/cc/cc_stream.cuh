@@ -0,0 +1,361 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * cc_stream.cuh
+ *
+ * @brief Connected components computed while a MARKET file is parsed: the
+ * parsing threads run lock-free union-find on each edge as it is read, so
+ * no COO or CSR is built. A second pass over the file can extract the
+ * largest component as a graph for the other primitives.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <omp.h>
+
+#include <gunrock/coo.cuh>
+#include <gunrock/csr.cuh>
+#include <gunrock/graphio/edge_stream.cuh>
+#include <gunrock/graphio/edge_weights.cuh>
+#include <gunrock/util/host/scan.cuh>
+#include <gunrock/util/host/histogram.cuh>
+#include <gunrock/app/cc/cc_ooc.cuh>
+
+namespace gunrock {
+namespace app {
+namespace cc {
+
+/**
+ * @brief Unions the endpoints of each streamed edge.
+ */
+template <typename VertexId, typename SizeT>
+struct StreamUnionOp
+{
+    UnionOp<VertexId, SizeT> unite;
+
+    void operator()(int thread_num, long long src, long long dst, double value)
+    {
+        unite(0, (VertexId)src, (VertexId)dst);
+    }
+};
+
+template <typename VertexId>
+struct ComponentBinOp
+{
+    const VertexId *component_ids;
+    VertexId operator()(VertexId v) const { return component_ids[v]; }
+};
+
+/**
+ * @brief Collects the edges of one component, renumbered, per thread.
+ */
+template <typename VertexId, typename Value>
+struct ComponentEdgeOp
+{
+    typedef Coo<VertexId, Value> EdgeTupleType;
+
+    const VertexId *component_ids;
+    const VertexId *new_ids;
+    VertexId        component;
+    bool            undirected;
+    bool            reversed;
+    bool            skew;
+    std::vector<std::vector<EdgeTupleType> > *parts;
+
+    void operator()(int thread_num, long long src, long long dst, double value)
+    {
+        if (component_ids[src] != component) return;
+        std::vector<EdgeTupleType> &part = (*parts)[thread_num];
+        EdgeTupleType edge;
+        edge.row = new_ids[reversed && !undirected ? dst : src];
+        edge.col = new_ids[reversed && !undirected ? src : dst];
+        edge.val = (Value)value;
+        part.push_back(edge);
+        if (undirected)
+        {
+            std::swap(edge.row, edge.col);
+            if (skew) edge.val = -edge.val;
+            part.push_back(edge);
+        }
+    }
+};
+
+/**
+ * @brief Streaming connected components of a MARKET file, edges taken as
+ * undirected.
+ */
+template <typename VertexId, typename SizeT>
+struct StreamCC
+{
+    SizeT      nodes;
+    long long  edges;              // edges read
+    SizeT      num_components;
+    VertexId  *component_ids;      // smallest vertex of the component, as HostCC
+    SizeT     *component_sizes;    // vertices of the component rooted at v
+    VertexId   largest_component;  // smallest of the largest, on ties
+    SizeT      largest_size;
+    graphio::MarketEdgeStream stream;
+
+    StreamCC() :
+        nodes            (0),
+        edges            (0),
+        num_components   (0),
+        component_ids    (NULL),
+        component_sizes  (NULL),
+        largest_component(0),
+        largest_size     (0)
+    {
+    }
+
+    ~StreamCC()
+    {
+        Release();
+    }
+
+    void Release()
+    {
+        if (component_ids  ) { free(component_ids  ); component_ids   = NULL; }
+        if (component_sizes) { free(component_sizes); component_sizes = NULL; }
+        stream.Close();
+    }
+
+    /**
+     * @brief Reads a MARKET file, plain or compressed, and labels its
+     * components.
+     *
+     * @param[in] file_name Input file.
+     * @param[in] quiet Don't print out anything.
+     * @param[in] num_threads Parsing threads, 0 for the OpenMP thread count.
+     *
+     * \return 0 on success, -1 otherwise.
+     */
+    int Run(const char *file_name, bool quiet = false, int num_threads = 0)
+    {
+        Release();
+        if (stream.Open(file_name, num_threads) != 0)
+        {
+            fprintf(stderr, "Unable to read %s: %s\n",
+                file_name, stream.error.c_str());
+            return -1;
+        }
+        nodes = stream.nodes;
+        component_ids   = (VertexId*) malloc(sizeof(VertexId) * (nodes + 1));
+        component_sizes = (SizeT   *) malloc(sizeof(SizeT   ) * (nodes + 1));
+
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            component_ids[v] = v;
+        StreamUnionOp<VertexId, SizeT> op;
+        op.unite.parents = component_ids;
+        if (!stream.template ForAllEdges<false>(op))
+        {
+            fprintf(stderr, "Unable to read %s: %s\n",
+                file_name, stream.error.c_str());
+            return -1;
+        }
+        edges = stream.edges_read;
+        if (stream.edges_read + stream.edges_invalid < stream.entries)
+        {
+            fprintf(stderr, "Error parsing MARKET graph %s: only %lld/%lld"
+                " edges read\n", file_name,
+                stream.edges_read + stream.edges_invalid, stream.entries);
+            return -1;
+        }
+        if (!quiet && stream.edges_invalid > 0)
+            printf("Skipped %lld malformed or out-of-range edges\n",
+                stream.edges_invalid);
+
+        // roots are final after the pass, so paths can be compressed in parallel
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            component_ids[v] = FindRoot(component_ids, (VertexId)v);
+
+        ComponentBinOp<VertexId> bin_of;
+        bin_of.component_ids = component_ids;
+        util::host::Histogram(nodes, bin_of, component_sizes, nodes);
+
+        SizeT    num_roots = 0;
+        VertexId largest   = 0;
+        #pragma omp parallel reduction(+:num_roots)
+        {
+            VertexId thread_largest = 0;
+            #pragma omp for
+            for (SizeT v = 0; v < nodes; v++)
+            {
+                if (component_ids[v] != v) continue;
+                num_roots ++;
+                if (component_sizes[v] > component_sizes[thread_largest] ||
+                    (component_sizes[v] == component_sizes[thread_largest] &&
+                     v < thread_largest))
+                    thread_largest = v;
+            }
+            #pragma omp critical
+            if (component_sizes[thread_largest] > component_sizes[largest] ||
+                (component_sizes[thread_largest] == component_sizes[largest] &&
+                 thread_largest < largest))
+                largest = thread_largest;
+        }
+        num_components    = num_roots;
+        largest_component = largest;
+        largest_size      = nodes > 0 ? component_sizes[largest] : 0;
+        return 0;
+    }
+
+    /**
+     * @brief Reads the file again for the edges of the largest component,
+     * with its vertices renumbered 0..largest_size-1 in ID order.
+     *
+     * @param[out] coo Edges, malloc()ed, to be freed by the caller.
+     * @param[out] coo_edges Number of edges.
+     * @param[out] original_ids Original ID of each new vertex, malloc()ed;
+     * not returned if NULL.
+     * @param[in] undirected Add the reverse of every edge.
+     * @param[in] reversed Reverse the edges of a directed graph.
+     *
+     * \return 0 on success, -1 otherwise.
+     */
+    template <bool LOAD_VALUES, typename Value>
+    int ExtractLargest(
+        Coo<VertexId, Value> *&coo,
+        SizeT                 &coo_edges,
+        VertexId             **original_ids = NULL,
+        bool                   undirected   = false,
+        bool                   reversed     = false)
+    {
+        typedef Coo<VertexId, Value> EdgeTupleType;
+        VertexId *new_ids = (VertexId*) malloc(sizeof(VertexId) * (nodes + 1));
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            new_ids[v] = (component_ids[v] == largest_component) ? 1 : 0;
+        util::host::ExclusiveScan(new_ids, new_ids, nodes);
+        if (original_ids != NULL)
+        {
+            *original_ids = (VertexId*) malloc(sizeof(VertexId) * (largest_size + 1));
+            #pragma omp parallel for
+            for (SizeT v = 0; v < nodes; v++)
+                if (component_ids[v] == largest_component)
+                    (*original_ids)[new_ids[v]] = v;
+        }
+
+        // one part per parsing thread, which may be more than OpenMP's
+        std::vector<std::vector<EdgeTupleType> > parts(stream.NumThreads());
+        ComponentEdgeOp<VertexId, Value> op;
+        op.component_ids = component_ids;
+        op.new_ids       = new_ids;
+        op.component     = largest_component;
+        op.undirected    = undirected;
+        op.reversed      = reversed;
+        op.skew          = stream.skew;
+        op.parts         = &parts;
+        bool read = stream.template ForAllEdges<LOAD_VALUES>(op);
+        free(new_ids); new_ids = NULL;
+        if (!read)
+        {
+            fprintf(stderr, "Unable to read the edges again: %s\n",
+                stream.error.c_str());
+            return -1;
+        }
+        if (stream.edges_read + stream.edges_invalid < stream.entries)
+        {
+            // the file changed, or was cut, since Run()
+            fprintf(stderr, "Error parsing MARKET graph: only %lld/%lld"
+                " edges read again\n",
+                stream.edges_read + stream.edges_invalid, stream.entries);
+            return -1;
+        }
+
+        std::vector<SizeT> offsets(parts.size() + 1, 0);
+        for (size_t t = 0; t < parts.size(); t++)
+            offsets[t+1] = offsets[t] + parts[t].size();
+        coo_edges = offsets[parts.size()];
+        coo = (EdgeTupleType*) malloc(sizeof(EdgeTupleType) * (coo_edges + 1));
+        #pragma omp parallel for
+        for (int t = 0; t < (int)parts.size(); t++)
+        {
+            if (!parts[t].empty())
+                memcpy(coo + offsets[t], &parts[t][0],
+                    sizeof(EdgeTupleType) * parts[t].size());
+            std::vector<EdgeTupleType>().swap(parts[t]);
+        }
+        return 0;
+    }
+};
+
+/**
+ * @brief Loads the largest connected component of a MARKET file as a CSR
+ * graph, straight from the edge stream: the components are found while
+ * parsing, and only the edges of the largest are kept on the second pass.
+ *
+ * @param[in] mm_filename Graph file name, may be compressed.
+ * @param[in] csr_graph Reference to CSR graph object. @see Csr
+ * @param[in] undirected Is the graph undirected or not?
+ * @param[in] reversed Is the graph reversed or not?
+ * @param[in] quiet If true, print no output
+ * @param[in] weights Synthetic weights for edges without a value.
+ *
+ * \return 0 on success, -1 otherwise.
+ */
+template <bool LOAD_VALUES, typename VertexId, typename SizeT, typename Value>
+int BuildLargestComponentGraph(
+    char *mm_filename,
+    Csr<VertexId, SizeT, Value> &csr_graph,
+    bool undirected,
+    bool reversed,
+    bool quiet = false,
+    const graphio::EdgeWeightConfig &weights = graphio::EdgeWeightConfig())
+{
+    typedef Coo<VertexId, Value> EdgeTupleType;
+    StreamCC<VertexId, SizeT> stream_cc;
+    time_t mark0 = time(NULL);
+    if (!quiet)
+    {
+        printf("  Streaming components of %s", mm_filename);
+        fflush(stdout);
+    }
+    if (stream_cc.Run(mm_filename, quiet) != 0) return -1;
+    if (!quiet)
+    {
+        printf(" (%lld nodes, %lld edges): %lld components, largest %lld nodes"
+            " (%ds).\n", (long long)stream_cc.nodes, stream_cc.edges,
+            (long long)stream_cc.num_components, (long long)stream_cc.largest_size,
+            (int)(time(NULL) - mark0));
+    }
+
+    undirected = undirected || stream_cc.stream.symmetric;
+    EdgeTupleType *coo = NULL;
+    SizeT coo_edges = 0;
+    if (stream_cc.template ExtractLargest<LOAD_VALUES>(
+        coo, coo_edges, NULL, undirected, reversed) != 0)
+    {
+        if (coo) free(coo);
+        return -1;
+    }
+    bool synthesize_weights = LOAD_VALUES && stream_cc.stream.pattern;
+    csr_graph.template FromCoo<LOAD_VALUES>(NULL, coo,
+        stream_cc.largest_size, coo_edges, false, undirected, reversed, quiet);
+    free(coo); coo = NULL;
+    if (synthesize_weights)
+        graphio::AssignEdgeWeights(weights, csr_graph.nodes,
+            csr_graph.row_offsets, csr_graph.column_indices,
+            csr_graph.edge_values, undirected, reversed && !undirected);
+    return 0;
+}
+
+} // namespace cc
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -23,6 +23,8 @@
 #include <gunrock/util/test_utils.cuh>
 #include <gunrock/util/array_utils.cuh>
 #include <gunrock/util/sharedmem.cuh>
+#include <gunrock/app/autotune.cuh>
+#include <gunrock/app/cc/cc_stream.cuh>
 #include <gunrock/util/info.cuh>
 #include <gunrock/app/problem_base.cuh>
 
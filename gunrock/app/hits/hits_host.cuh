@@ -0,0 +1,94 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * hits_host.cuh
+ *
+ * @brief HITS over cache-blocked (segmented) CSRs on the host
+ */
+
+#pragma once
+
+#include <gunrock/segmented_csr.cuh>
+
+namespace gunrock {
+namespace app {
+namespace hits {
+
+/**
+ * @brief HITS as HITSEnactor computes it, rooted at a source vertex:
+ *   authority(v) = sum over u -> v of hub(u) / out_degree(u),
+ *   hub(u)       = (1 - delta) * sum over u -> v of authority(v) / in_degree(v)
+ *                  + delta if u is the source and has out-edges,
+ * starting from hub 1 at the source and 0 elsewhere. The new ranks
+ * replace the old ones as they are, without normalization, as the
+ * enactor's NormalizeRank does.
+ *
+ * @param[in] in_edges Segmented CSR of the graph built with reverse = true.
+ * @param[in] out_edges Segmented CSR of the graph built with reverse = false.
+ * @param[in] out_degrees Out-degree of each vertex.
+ * @param[in] in_degrees In-degree of each vertex.
+ * @param[in] src Source vertex.
+ * @param[in] delta Weight of the return to the source.
+ * @param[out] hrank Hub rank of each vertex.
+ * @param[out] arank Authority rank of each vertex.
+ * @param[in] max_iteration Number of iterations; like the enactor, at
+ * least one is run.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+void HostHITS(
+    const SegmentedCsr<VertexId, SizeT, Value> &in_edges,
+    const SegmentedCsr<VertexId, SizeT, Value> &out_edges,
+    const SizeT                                *out_degrees,
+    const SizeT                                *in_degrees,
+    VertexId                                    src,
+    Value                                       delta,
+    Value                                      *hrank,
+    Value                                      *arank,
+    SizeT                                       max_iteration)
+{
+    SizeT  nodes  = in_edges.nodes;
+    Value *shares = (Value*) malloc(sizeof(Value) * nodes);
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < nodes; v++)
+    {
+        hrank[v] = (v == src) ? 1 : 0;
+        arank[v] = 0;
+    }
+
+    SizeT iteration = 0;
+    do {
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            shares[v] = hrank[v] / (out_degrees[v] > 0 ? out_degrees[v] : 1);
+        in_edges .Gather(shares, arank);
+
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            shares[v] = in_degrees[v] == 0 ? 0 : arank[v] / in_degrees[v];
+        out_edges.Gather(shares, hrank);
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            hrank[v] *= 1 - delta;
+        if (out_degrees[src] > 0) hrank[src] += delta;
+        iteration ++;
+    } while (iteration < max_iteration);
+
+    free(shares); shares = NULL;
+}
+
+} // namespace hits
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,182 @@
+// ----------------------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------------------
+
+/**
+ * @file landmark_app.cu
+ *
+ * @brief Landmark distance sketch application: builds the sketch on the
+ * host, from CSR arrays or from a MARKET file, whose sketch is kept next
+ * to its binary cache, and answers distance bound queries.
+ */
+
+#include <gunrock/gunrock.h>
+
+// graph construction utilities
+#include <gunrock/graphio/market.cuh>
+
+// landmark sketch includes
+#include <gunrock/app/landmark/landmark_sketch.cuh>
+
+#include <unistd.h>
+
+using namespace gunrock;
+using namespace gunrock::app::landmark;
+
+/**
+ * @brief The sketch behind the public handle.
+ */
+struct GRLandmarkSketch
+{
+    LandmarkSketch<int, int> sketch;
+};
+
+static LandmarkSelection ToSelection(enum LandmarkMode landmark_mode)
+{
+    return landmark_mode == landmark_degree ? LANDMARK_DEGREE : LANDMARK_COVERAGE;
+}
+
+/*
+ * @brief Builds the sketch of a graph given as CSR arrays.
+ *
+ * @param[in] num_nodes     Number of nodes of the input graph
+ * @param[in] num_edges     Number of edges of the input graph
+ * @param[in] row_offsets   CSR-formatted graph input row offsets
+ * @param[in] col_indices   CSR-formatted graph input column indices
+ * @param[in] edge_values   Edge weights, NULL for hop counts
+ * @param[in] undirected    Whether the arrays hold both directions of every edge
+ * @param[in] num_landmarks Number of landmarks
+ * @param[in] landmark_mode How the landmarks are picked
+ */
+struct GRLandmarkSketch* landmark_sketch(
+    const int           num_nodes,
+    const int           num_edges,
+    const int*          row_offsets,
+    const int*          col_indices,
+    const unsigned int* edge_values,
+    const bool          undirected,
+    const int           num_landmarks,
+    enum LandmarkMode   landmark_mode)
+{
+    Csr<int, int, int> csr(false), csc(false);
+    csr.nodes = num_nodes;
+    csr.edges = num_edges;
+    csr.row_offsets    = (int*)row_offsets;
+    csr.column_indices = (int*)col_indices;
+    csr.edge_values    = (int*)edge_values;
+    if (!undirected)
+        csc.template CsrToCsc<Coo<int, int> >(csc, csr);
+
+    GRLandmarkSketch *handle = new GRLandmarkSketch;
+    int retval = handle -> sketch.Build(csr, undirected ? NULL : &csc,
+        num_landmarks, ToSelection(landmark_mode), edge_values != NULL, true);
+
+    // reset for free memory
+    csr.row_offsets    = NULL;
+    csr.column_indices = NULL;
+    csr.edge_values    = NULL;
+    if (retval != 0)
+    {
+        delete handle; handle = NULL;
+    }
+    return handle;
+}
+
+/**
+ * @brief Loads one direction of a MARKET graph through its binary cache.
+ */
+template <bool LOAD_VALUES>
+static int LoadMarketCache(
+    char *market_file, bool undirected, bool reversed,
+    Csr<int, int, int> &graph, char *cache_name, bool quiet)
+{
+    graphio::MarketBinaryFileName<LOAD_VALUES, int, int, int>(
+        market_file, undirected, reversed, cache_name);
+    return graphio::BuildMarketGraph<LOAD_VALUES>(market_file, cache_name,
+        graph, undirected, reversed, quiet);
+}
+
+/*
+ * @brief Sketch of a MARKET graph, read from the file next to its binary
+ * cache, or built and saved there if missing or built with other settings.
+ *
+ * @param[in] market_file   MARKET graph file
+ * @param[in] undirected    Treat the graph as undirected
+ * @param[in] weighted      Distances over the edge values, or hop counts
+ * @param[in] num_landmarks Number of landmarks
+ * @param[in] landmark_mode How the landmarks are picked
+ * @param[in] quiet         Don't print out anything
+ */
+struct GRLandmarkSketch* landmark_sketch_market(
+    const char*       market_file,
+    const bool        undirected,
+    const bool        weighted,
+    const int         num_landmarks,
+    enum LandmarkMode landmark_mode,
+    const bool        quiet)
+{
+    char *file_name = strdup(market_file);
+    char  cache_name[256], inv_cache_name[256], sketch_name[256];
+    Csr<int, int, int> csr(false), csc(false);
+    int retval = weighted ?
+        LoadMarketCache<true >(file_name, undirected, false, csr, cache_name, quiet) :
+        LoadMarketCache<false>(file_name, undirected, false, csr, cache_name, quiet);
+    if (retval == 0 && !undirected)
+        retval = weighted ?
+            LoadMarketCache<true >(file_name, false, true, csc, inv_cache_name, quiet) :
+            LoadMarketCache<false>(file_name, false, true, csc, inv_cache_name, quiet);
+    free(file_name); file_name = NULL;
+    if (retval != 0) return NULL;
+
+    GRLandmarkSketch *handle = new GRLandmarkSketch;
+    LandmarkSelection selection = ToSelection(landmark_mode);
+    LandmarkSketchFileName(cache_name, sketch_name);
+    if (handle -> sketch.Load(sketch_name, csr.nodes, csr.edges,
+        num_landmarks, selection, weighted, !undirected) == 0)
+        return handle;
+
+    if (handle -> sketch.Build(csr, undirected ? NULL : &csc,
+        num_landmarks, selection, weighted, quiet) != 0)
+    {
+        delete handle;
+        return NULL;
+    }
+    if (handle -> sketch.Save(sketch_name) != 0 && !quiet)
+        printf("Cannot write %s, the sketch is not kept\n", sketch_name);
+    return handle;
+}
+
+/*
+ * @brief Distance bounds of many (source, target) pairs.
+ *
+ * @param[in]  sketch      Sketch of the graph
+ * @param[in]  num_queries Number of pairs
+ * @param[in]  sources     Source of each pair
+ * @param[in]  targets     Target of each pair
+ * @param[out] lower       Lower bound of each distance
+ * @param[out] upper       Upper bound of each distance
+ */
+void landmark_bounds(
+    const struct GRLandmarkSketch* sketch,
+    const int     num_queries,
+    const int*    sources,
+    const int*    targets,
+    unsigned int* lower,
+    unsigned int* upper)
+{
+    sketch -> sketch.Bounds(num_queries, sources, targets, lower, upper);
+}
+
+void landmark_sketch_free(struct GRLandmarkSketch* sketch)
+{
+    delete sketch;
+}
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,467 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * landmark_sketch.cuh
+ *
+ * @brief Landmark distance sketch: the distances of every vertex to and
+ * from k landmarks, in the narrowest unsigned type that holds them, give
+ * lower and upper bounds on the distance between any two vertices in
+ * O(k) by the triangle inequality. The sketch is saved next to the
+ * graph's binary cache.
+ */
+
+#pragma once
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <omp.h>
+
+#include <gunrock/csr.cuh>
+#include <gunrock/graphio/market.cuh>
+#include <gunrock/util/simd_utils.cuh>
+#include <gunrock/app/bfs/bfs_host.cuh>
+#include <gunrock/app/sssp/sssp_host.cuh>
+
+namespace gunrock {
+namespace app {
+namespace landmark {
+
+#define GR_LANDMARK_MAGIC    0x4b4d4c47u  // "GLMK"
+#define GR_LANDMARK_VERSION  1u
+#define GR_LANDMARK_INFINITY 0xffffffffu  // no bound / unreachable
+#define GR_LANDMARK_BATCH    64           // landmarks searched at once
+
+enum LandmarkSelection
+{
+    LANDMARK_DEGREE   = 0,  // highest degree
+    LANDMARK_COVERAGE = 1,  // highest degree outside the landmarks' neighbors
+};
+
+/**
+ * @brief Name of the sketch file of a binary graph cache.
+ */
+inline void LandmarkSketchFileName(const char *cache_name, char *sketch_name)
+{
+    graphio::CacheSidecarFileName(cache_name, "lmk", sketch_name);
+}
+
+/**
+ * @brief Landmark distance sketch.
+ *
+ * Row v of from_rows holds d(landmark i, v) for each i, row v of to_rows
+ * d(v, landmark i); for an undirected graph they are the same rows. A
+ * distance takes distance_bytes, the width chosen so that the sum of two
+ * finite distances stays below the largest value, which means unreached.
+ * For landmark L, d(u, v) <= d(u, L) + d(L, v), and d(u, v) is at least
+ * d(L, v) - d(L, u) and d(u, L) - d(v, L); a difference involving an
+ * unreached landmark exceeds every finite distance and proves v is not
+ * reachable from u.
+ */
+template <typename VertexId, typename SizeT>
+struct LandmarkSketch
+{
+    SizeT          nodes;
+    SizeT          edges;
+    int            num_landmarks;
+    int            distance_bytes;  // 1, 2 or 4
+    bool           directed;        // to_rows kept apart from from_rows
+    bool           weighted;        // edge values, or hop counts
+    int            selection;       // LandmarkSelection
+    unsigned int   max_distance;    // largest finite distance stored
+    VertexId      *landmarks;
+    unsigned char *from_rows;       // nodes x num_landmarks distances
+    unsigned char *to_rows;         // from_rows if undirected
+
+    LandmarkSketch() :
+        nodes         (0),
+        edges         (0),
+        num_landmarks (0),
+        distance_bytes(1),
+        directed      (false),
+        weighted      (false),
+        selection     (LANDMARK_DEGREE),
+        max_distance  (0),
+        landmarks     (NULL),
+        from_rows     (NULL),
+        to_rows       (NULL)
+    {
+    }
+
+    ~LandmarkSketch()
+    {
+        Release();
+    }
+
+    void Release()
+    {
+        if (to_rows != from_rows && to_rows) free(to_rows);
+        to_rows = NULL;
+        if (from_rows) { free(from_rows); from_rows = NULL; }
+        if (landmarks) { free(landmarks); landmarks = NULL; }
+        nodes = edges = 0;
+        num_landmarks = 0;
+        max_distance  = 0;
+    }
+
+    /**
+     * @brief Builds the sketch of a graph.
+     *
+     * @param[in] graph Graph (out-edges); weighted distances take integer
+     * edge values.
+     * @param[in] inv_graph Inverse graph (in-edges), with the edge values
+     * if weighted; NULL if graph is symmetric.
+     * @param[in] k Number of landmarks.
+     * @param[in] landmark_selection How the landmarks are picked.
+     * @param[in] use_weights Distances over edge values, or hop counts.
+     * @param[in] quiet Don't print out anything.
+     *
+     * \return 0 on success, -1 if a distance does not fit 31 bits.
+     */
+    template <typename Value>
+    int Build(
+        const Csr<VertexId, SizeT, Value> &graph,
+        const Csr<VertexId, SizeT, Value> *inv_graph,
+        int               k,
+        LandmarkSelection landmark_selection = LANDMARK_COVERAGE,
+        bool              use_weights        = false,
+        bool              quiet              = false)
+    {
+        Release();
+        time_t mark0 = time(NULL);
+        nodes         = graph.nodes;
+        edges         = graph.edges;
+        num_landmarks = std::max(0, (int)std::min((SizeT)k, nodes));
+        directed      = inv_graph != NULL;
+        weighted      = use_weights;
+        selection     = landmark_selection;
+        landmarks     = (VertexId*) malloc(sizeof(VertexId) * (num_landmarks + 1));
+        SelectLandmarks(graph, inv_graph);
+
+        // full-width distances first, narrowed once the largest is known
+        size_t    size = (size_t)nodes * num_landmarks;
+        uint32_t *from = (uint32_t*) malloc(sizeof(uint32_t) * (size + 1));
+        uint32_t *to   = directed ?
+            (uint32_t*) malloc(sizeof(uint32_t) * (size + 1)) : from;
+        bool fits = ComputeDistances(graph, inv_graph, from);
+        if (directed && fits)
+            fits = ComputeDistances(*inv_graph, &graph, to);
+        if (fits)
+        {
+            max_distance   = std::max(MaxFinite(from, size),
+                directed ? MaxFinite(to, size) : 0u);
+            distance_bytes = max_distance < 0x80u   ? 1 :
+                             max_distance < 0x8000u ? 2 : 4;
+            from_rows = Narrow(from, size);
+            to_rows   = directed ? Narrow(to, size) : from_rows;
+        }
+        if (to != from) free(to);
+        free(from); from = NULL; to = NULL;
+        if (!fits)
+        {
+            fprintf(stderr, "Landmark distances exceed 31 bits\n");
+            Release();
+            return -1;
+        }
+        if (!quiet)
+        {
+            printf("  Landmark sketch: %d landmarks, %d-byte distances up to"
+                " %u (%ds)\n", num_landmarks, distance_bytes, max_distance,
+                (int)(time(NULL) - mark0));
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Bounds on the distance from u to v. lower is GR_LANDMARK_INFINITY
+     * if v is provably unreachable from u, upper if no landmark path joins
+     * them; lower == upper means the distance is exact.
+     */
+    void Bounds(VertexId u, VertexId v,
+        unsigned int &lower, unsigned int &upper) const
+    {
+        if (u == v) { lower = upper = 0; return; }
+        if (distance_bytes == 1)
+            RowBounds<uint8_t >(u, v, lower, upper);
+        else if (distance_bytes == 2)
+            RowBounds<uint16_t>(u, v, lower, upper);
+        else RowBounds<uint32_t>(u, v, lower, upper);
+        if (lower > max_distance) lower = GR_LANDMARK_INFINITY;
+    }
+
+    /**
+     * @brief Bounds of many queries, in parallel.
+     */
+    void Bounds(
+        SizeT           num_queries,
+        const VertexId *sources,
+        const VertexId *targets,
+        unsigned int   *lowers,
+        unsigned int   *uppers) const
+    {
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (SizeT i = 0; i < num_queries; i++)
+            Bounds(sources[i], targets[i], lowers[i], uppers[i]);
+    }
+
+    /**
+     * @brief Writes the sketch.
+     *
+     * \return 0 on success, -1 otherwise.
+     */
+    int Save(const char *file_name) const
+    {
+        FILE *f_out = fopen(file_name, "wb");
+        if (f_out == NULL) return -1;
+        int64_t header[10] = {
+            ((int64_t)GR_LANDMARK_MAGIC << 32) | GR_LANDMARK_VERSION,
+            nodes, edges, num_landmarks, distance_bytes, directed ? 1 : 0,
+            weighted ? 1 : 0, selection, max_distance,
+            (int64_t)sizeof(VertexId)};
+        size_t size = (size_t)nodes * num_landmarks * distance_bytes;
+        bool ok = fwrite(header, sizeof(header), 1, f_out) == 1 &&
+            Write(f_out, landmarks, num_landmarks) &&
+            Write(f_out, from_rows, size) &&
+            (!directed || Write(f_out, to_rows, size));
+        if (fclose(f_out) != 0) ok = false;
+        return ok ? 0 : -1;
+    }
+
+    /**
+     * @brief Reads a sketch written by Save, if it was built for a graph
+     * of this size with these parameters.
+     *
+     * \return 0 on success, -1 if the file is missing or does not match.
+     */
+    int Load(
+        const char       *file_name,
+        SizeT             graph_nodes,
+        SizeT             graph_edges,
+        int               k,
+        LandmarkSelection landmark_selection,
+        bool              use_weights,
+        bool              is_directed)
+    {
+        Release();
+        FILE *f_in = fopen(file_name, "rb");
+        if (f_in == NULL) return -1;
+        int64_t header[10];
+        bool ok = fread(header, sizeof(header), 1, f_in) == 1 &&
+            header[0] == (((int64_t)GR_LANDMARK_MAGIC << 32) | GR_LANDMARK_VERSION) &&
+            header[1] == graph_nodes && header[2] == graph_edges &&
+            header[3] == std::min((SizeT)k, graph_nodes) &&
+            (header[4] == 1 || header[4] == 2 || header[4] == 4) &&
+            header[5] == (is_directed ? 1 : 0) &&
+            header[6] == (use_weights ? 1 : 0) &&
+            header[7] == landmark_selection &&
+            header[9] == (int64_t)sizeof(VertexId);
+        if (ok)
+        {
+            nodes          = header[1];
+            edges          = header[2];
+            num_landmarks  = header[3];
+            distance_bytes = header[4];
+            directed       = header[5] != 0;
+            weighted       = header[6] != 0;
+            selection      = header[7];
+            max_distance   = header[8];
+            size_t size = (size_t)nodes * num_landmarks * distance_bytes;
+            ok = Read(f_in, landmarks, num_landmarks) &&
+                Read(f_in, from_rows, size);
+            if (ok && directed) ok = Read(f_in, to_rows, size);
+            else to_rows = from_rows;
+        }
+        fclose(f_in);
+        if (!ok)
+        {
+            Release();
+            return -1;
+        }
+        return 0;
+    }
+
+private:
+    template <typename T>
+    static bool Write(FILE *f_out, const T *array, size_t size)
+    {
+        return size == 0 || fwrite(array, sizeof(T), size, f_out) == size;
+    }
+
+    template <typename T>
+    static bool Read(FILE *f_in, T *&array, size_t size)
+    {
+        array = (T*) malloc(sizeof(T) * (size + 1));
+        return size == 0 || fread(array, sizeof(T), size, f_in) == size;
+    }
+
+    template <typename T>
+    void RowBounds(VertexId u, VertexId v,
+        unsigned int &lower, unsigned int &upper) const
+    {
+        const T *from = (const T*)from_rows;
+        const T *to   = (const T*)to_rows;
+        size_t   k    = num_landmarks;
+        T low, up;
+        util::simd::LandmarkBounds(to + u * k, from + u * k,
+            to + v * k, from + v * k, num_landmarks, low, up);
+        lower = low;
+        upper = (up == std::numeric_limits<T>::max()) ?
+            GR_LANDMARK_INFINITY : up;
+    }
+
+    /**
+     * @brief Picks the landmarks by degree (in plus out). For coverage,
+     * a vertex next to an earlier landmark is passed over while others
+     * remain, so the landmarks spread over the graph.
+     */
+    template <typename Value>
+    void SelectLandmarks(
+        const Csr<VertexId, SizeT, Value> &graph,
+        const Csr<VertexId, SizeT, Value> *inv_graph)
+    {
+        std::vector<std::pair<SizeT, VertexId> > order(nodes);
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            SizeT degree = graph.row_offsets[v+1] - graph.row_offsets[v];
+            if (inv_graph != NULL)
+                degree += inv_graph->row_offsets[v+1] - inv_graph->row_offsets[v];
+            order[v] = std::make_pair(-degree, (VertexId)v);
+        }
+        if (selection == LANDMARK_DEGREE)
+        {
+            std::partial_sort(order.begin(), order.begin() + num_landmarks,
+                order.end());
+            for (int i = 0; i < num_landmarks; i++)
+                landmarks[i] = order[i].second;
+            return;
+        }
+
+        std::sort(order.begin(), order.end());
+        std::vector<bool> covered(nodes, false), taken(nodes, false);
+        int count = 0;
+        for (SizeT i = 0; i < nodes && count < num_landmarks; i++)
+        {
+            VertexId v = order[i].second;
+            if (covered[v]) continue;
+            landmarks[count++] = v;
+            taken  [v] = true;
+            covered[v] = true;
+            for (SizeT e = graph.row_offsets[v]; e < graph.row_offsets[v+1]; e++)
+                covered[graph.column_indices[e]] = true;
+            if (inv_graph != NULL)
+                for (SizeT e = inv_graph->row_offsets[v];
+                    e < inv_graph->row_offsets[v+1]; e++)
+                    covered[inv_graph->column_indices[e]] = true;
+        }
+        // too few uncovered vertices: fill up by degree
+        for (SizeT i = 0; i < nodes && count < num_landmarks; i++)
+            if (!taken[order[i].second])
+                landmarks[count++] = order[i].second;
+    }
+
+    /**
+     * @brief Distances from the landmarks over graph, GR_LANDMARK_BATCH
+     * landmarks at a time, into rows[v * num_landmarks + i]; over the
+     * inverse graph they are the distances to the landmarks.
+     *
+     * \return false if a weighted distance does not fit 31 bits.
+     */
+    template <typename Value>
+    bool ComputeDistances(
+        const Csr<VertexId, SizeT, Value> &graph,
+        const Csr<VertexId, SizeT, Value> *inv_graph,
+        uint32_t                          *rows)
+    {
+        int    batch  = std::min(GR_LANDMARK_BATCH, std::max(num_landmarks, 1));
+        size_t label_bytes = weighted ? sizeof(Value) : sizeof(VertexId);
+        void  *labels = malloc(label_bytes * nodes * batch + 1);
+        bool   fits   = true;
+        for (int begin = 0; begin < num_landmarks; begin += batch)
+        {
+            int num_sources = std::min(batch, num_landmarks - begin);
+            if (weighted)
+                sssp::HostMultiSourceSSSP(graph, landmarks + begin,
+                    num_sources, (Value*)labels);
+            else
+                bfs::HostMultiSourceBFS(graph, inv_graph,
+                    landmarks + begin, num_sources, (VertexId*)labels);
+
+            bool batch_fits = true;
+            #pragma omp parallel for reduction(&&:batch_fits)
+            for (SizeT v = 0; v < nodes; v++)
+            {
+                uint32_t *row = rows + (size_t)v * num_landmarks + begin;
+                for (int i = 0; i < num_sources; i++)
+                {
+                    size_t index = (size_t)i * nodes + v;
+                    if (weighted)
+                    {
+                        Value d = ((Value*)labels)[index];
+                        if (d == util::MaxValue<Value>())
+                            row[i] = GR_LANDMARK_INFINITY;
+                        else if (d < 0 || (double)d >= 0x7fffffff)
+                            batch_fits = false;
+                        else row[i] = (uint32_t)d;
+                    } else {
+                        VertexId d = ((VertexId*)labels)[index];
+                        row[i] = d < 0 ? GR_LANDMARK_INFINITY : (uint32_t)d;
+                    }
+                }
+            }
+            fits = fits && batch_fits;
+        }
+        free(labels); labels = NULL;
+        return fits;
+    }
+
+    static unsigned int MaxFinite(const uint32_t *rows, size_t size)
+    {
+        unsigned int largest = 0;
+        #pragma omp parallel for reduction(max:largest)
+        for (size_t i = 0; i < size; i++)
+            if (rows[i] != GR_LANDMARK_INFINITY && rows[i] > largest)
+                largest = rows[i];
+        return largest;
+    }
+
+    /**
+     * @brief Copy of full-width distances in distance_bytes each,
+     * unreached mapped to the largest value of the narrow type.
+     */
+    unsigned char* Narrow(const uint32_t *rows, size_t size) const
+    {
+        unsigned char *narrow = (unsigned char*) malloc(size * distance_bytes + 1);
+        #pragma omp parallel for
+        for (size_t i = 0; i < size; i++)
+        {
+            uint32_t d = rows[i];
+            if (distance_bytes == 1)
+                ((uint8_t *)narrow)[i] = d == GR_LANDMARK_INFINITY ? 0xff   : d;
+            else if (distance_bytes == 2)
+                ((uint16_t*)narrow)[i] = d == GR_LANDMARK_INFINITY ? 0xffff : d;
+            else ((uint32_t*)narrow)[i] = d;
+        }
+        return narrow;
+    }
+};
+
+} // namespace landmark
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
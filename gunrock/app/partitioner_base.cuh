@@ -75,6 +75,8 @@ public:
     bool            enable_backward;
     bool            keep_order     ;
     bool            keep_node_num  ;
+    bool            narrow_local_ids; // store sub-graph adjacency as 32-bit
+                                      // local ids when VertexId is wider
 
     // Methods
 
@@ -126,6 +128,7 @@ public:
         enable_backward      (_enable_backward),
         keep_order           (_keep_order),
         keep_node_num        (_keep_node_num),
+        narrow_local_ids     (false),
         Status               ( 0   ),
         num_gpus             ( 0   ),
         graph                ( NULL),
@@ -347,6 +350,8 @@ public:
         else if (graph->node_values == NULL && graph->edge_values != NULL)
              sub_graph->template FromScratch < true  , false  >(num_nodes,num_edges);
         else sub_graph->template FromScratch < true  , true   >(num_nodes,num_edges);
+        if (graph->edge_values == NULL && graph->edge_value_codes != NULL)
+            sub_graph->AllocateEdgeValueCodes(graph->edge_value_codec, num_edges);
 
         if (convertion_table1[0] != NULL) free(convertion_table1[0]);
         if (partition_table1 [0] != NULL) free(partition_table1 [0]);
@@ -401,6 +406,9 @@ public:
 
                 sub_graph->column_indices[edge_counter] = neibor_;
                 if (graph->edge_values !=NULL) sub_graph->edge_values[edge_counter]=graph->edge_values[edge];
+                else if (graph->edge_value_codes != NULL)
+                    graph->edge_value_codec.CopyCode(sub_graph->edge_value_codes,
+                        edge_counter, graph->edge_value_codes, edge);
                 if (peer != gpu && !keep_node_num)
                 {
                     sub_graph->row_offsets[neibor_]=num_edges;
@@ -534,6 +542,17 @@ public:
 
         cutWaitForThreads(thread_Ids,num_gpus);
 
+        // Without keep_node_num, a sub-graph numbers its vertices locally
+        // (hosted ones first, then proxies of remote neighbors), so its
+        // column indices fit in 32 bits even when VertexId is 64-bit;
+        // original_vertexes keeps the way back to the global ids. With
+        // keep_node_num, they only fit if the whole graph does.
+        if (narrow_local_ids)
+        {
+            for (int gpu = 0; gpu < num_gpus; gpu++)
+                sub_graphs[gpu].NarrowColumnIndices();
+        }
+
         util::cpu_mt::DestoryBarrier(&cpu_barrier);
         delete[] thread_Ids ;thread_Ids =NULL;
         delete[] thread_data;thread_data=NULL;
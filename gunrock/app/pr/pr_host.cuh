@@ -0,0 +1,442 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * pr_host.cuh
+ *
+ * @brief Host PageRank: push over an edge list, or pull over a
+ * cache-blocked (segmented) CSR; personalized PageRank pulled over a CSC,
+ * one seed at a time or many personalization vectors at once
+ */
+
+#pragma once
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include <omp.h>
+#include <gunrock/csr.cuh>
+#include <gunrock/edge_list.cuh>
+#include <gunrock/segmented_csr.cuh>
+#include <gunrock/util/simd_utils.cuh>
+
+namespace gunrock {
+namespace app {
+namespace pr {
+
+/**
+ * @brief Scatters each source's rank share to its destination.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+struct PushOp
+{
+    Value *rank_shares;
+    Value *rank_next;
+
+    void operator()(SizeT e, VertexId from, VertexId to)
+    {
+        Value share = rank_shares[from];
+        #pragma omp atomic
+        rank_next[to] += share;
+    }
+};
+
+/**
+ * @brief PageRank with rank pushed along the edge stream,
+ * rank(v) = base + delta * sum(rank(u) / out_degree(u)).
+ *
+ * @param[in] edge_list Edge list of the graph.
+ * @param[out] rank Rank of each vertex.
+ * @param[in] delta Damping factor.
+ * @param[in] error Stop when no rank changes by more than error.
+ * @param[in] max_iteration Maximum number of iterations.
+ * @param[in] normalized Whether ranks sum to 1 (base = (1 - delta) / n)
+ * or to n (base = 1 - delta).
+ *
+ * \return Number of iterations run.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+SizeT HostPageRankPush(
+    const EdgeList<VertexId, SizeT, Value> &edge_list,
+    Value                                  *rank,
+    Value                                   delta,
+    Value                                   error,
+    SizeT                                   max_iteration,
+    bool                                    normalized = false)
+{
+    SizeT  nodes       = edge_list.nodes;
+    SizeT *out_degrees = (SizeT*) malloc(sizeof(SizeT) * nodes);
+    Value *rank_shares = (Value*) malloc(sizeof(Value) * nodes);
+    Value *rank_next   = (Value*) malloc(sizeof(Value) * nodes);
+    Value  base        = normalized ? (1 - delta) / nodes : (1 - delta);
+    Value  init        = normalized ? (Value)1.0  / nodes : (Value)1.0;
+    SizeT  iteration   = 0;
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < nodes; v++)
+    {
+        out_degrees[v] = 0;
+        rank       [v] = init;
+    }
+    for (SizeT e = 0; e < edge_list.edges; e++)
+        out_degrees[edge_list.froms[e]] ++;
+
+    PushOp<VertexId, SizeT, Value> push;
+    push.rank_shares = rank_shares;
+    push.rank_next   = rank_next;
+    while (iteration < max_iteration)
+    {
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            rank_shares[v] = out_degrees[v] == 0 ? 0 :
+                rank[v] / out_degrees[v];
+            rank_next  [v] = 0;
+        }
+        edge_list.ForAllEdges(push);
+
+        bool converged = true;
+        #pragma omp parallel for reduction(&&:converged)
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            Value new_rank = base + delta * rank_next[v];
+            if (fabs(new_rank - rank[v]) > error) converged = false;
+            rank[v] = new_rank;
+        }
+        iteration ++;
+        if (converged) break;
+    }
+
+    free(out_degrees); out_degrees = NULL;
+    free(rank_shares); rank_shares = NULL;
+    free(rank_next  ); rank_next   = NULL;
+    return iteration;
+}
+
+/**
+ * @brief PageRank with rank pulled over the in-edges of a segmented CSR,
+ * same fixed point as HostPageRankPush. Every segment reads a cache-sized
+ * slice of the rank shares, so no random access leaves the cache and no
+ * atomics are needed.
+ *
+ * @param[in] in_edges Segmented CSR built with reverse = true.
+ * @param[in] out_degrees Out-degree of each vertex.
+ * @param[out] rank Rank of each vertex.
+ * @param[in] delta Damping factor.
+ * @param[in] error Stop when no rank changes by more than error.
+ * @param[in] max_iteration Maximum number of iterations.
+ * @param[in] normalized Whether ranks sum to 1 or to n.
+ * @param[in] initialized Start from the ranks passed in instead of the
+ * uniform 1 or 1 / n.
+ *
+ * \return Number of iterations run.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+SizeT HostPageRankPull(
+    const SegmentedCsr<VertexId, SizeT, Value> &in_edges,
+    const SizeT                                *out_degrees,
+    Value                                      *rank,
+    Value                                       delta,
+    Value                                       error,
+    SizeT                                       max_iteration,
+    bool                                        normalized  = false,
+    bool                                        initialized = false)
+{
+    SizeT  nodes       = in_edges.nodes;
+    Value *rank_shares = (Value*) malloc(sizeof(Value) * nodes);
+    Value *rank_next   = (Value*) malloc(sizeof(Value) * nodes);
+    Value  base        = normalized ? (1 - delta) / nodes : (1 - delta);
+    Value  init        = normalized ? (Value)1.0  / nodes : (Value)1.0;
+    SizeT  iteration   = 0;
+
+    if (!initialized)
+    {
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            rank[v] = init;
+    }
+
+    while (iteration < max_iteration)
+    {
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            rank_shares[v] = out_degrees[v] == 0 ? 0 :
+                rank[v] / out_degrees[v];
+        in_edges.Gather(rank_shares, rank_next);
+
+        bool converged = true;
+        #pragma omp parallel for reduction(&&:converged)
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            Value new_rank = base + delta * rank_next[v];
+            if (fabs(new_rank - rank[v]) > error) converged = false;
+            rank[v] = new_rank;
+        }
+        iteration ++;
+        if (converged) break;
+    }
+
+    free(rank_shares); rank_shares = NULL;
+    free(rank_next  ); rank_next   = NULL;
+    return iteration;
+}
+
+/**
+ * @brief Personalized PageRank of one seed vertex by power iteration,
+ * pulled over the in-edges: rank = (1 - delta) * e_seed + delta * sum of
+ * rank(u) / out_degree(u). Rank reaching dangling vertices restarts at
+ * the seed, so the ranks sum to 1.
+ *
+ * @tparam Rank Rank type, independent of the graph's Value.
+ *
+ * @param[in] in_graph In-edges (CSC), or the graph itself if symmetric.
+ * @param[in] out_degrees Out-degree of each vertex.
+ * @param[in] seed Personalization vertex.
+ * @param[out] rank Rank of each vertex.
+ * @param[in] delta Damping factor.
+ * @param[in] error Stop when the L1 change of the ranks is at most error.
+ * @param[in] max_iteration Maximum number of iterations.
+ *
+ * \return Number of iterations run.
+ */
+template <typename VertexId, typename SizeT, typename Value, typename Rank>
+SizeT HostPersonalizedPageRank(
+    const Csr<VertexId, SizeT, Value> &in_graph,
+    const SizeT                       *out_degrees,
+    VertexId                           seed,
+    Rank                              *rank,
+    Rank                               delta,
+    Rank                               error,
+    SizeT                              max_iteration)
+{
+    SizeT  nodes       = in_graph.nodes;
+    Rank  *rank_shares = (Rank*) malloc(sizeof(Rank) * nodes);
+    SizeT  iteration   = 0;
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < nodes; v++)
+        rank[v] = (v == seed) ? 1 : 0;
+
+    while (iteration < max_iteration)
+    {
+        Rank dangling = 0;
+        #pragma omp parallel for reduction(+:dangling)
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            if (out_degrees[v] == 0)
+            {
+                dangling      += rank[v];
+                rank_shares[v] = 0;
+            } else rank_shares[v] = rank[v] / out_degrees[v];
+        }
+
+        Rank change = 0;
+        #pragma omp parallel for schedule(dynamic, 1024) reduction(+:change)
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            Rank sum = 0;
+            for (SizeT e = in_graph.row_offsets[v];
+                e < in_graph.row_offsets[v+1]; e++)
+                sum += rank_shares[in_graph.column_indices[e]];
+            Rank new_rank = delta * sum;
+            if (v == seed) new_rank += (1 - delta) + delta * dangling;
+            change += fabs(new_rank - rank[v]);
+            rank[v] = new_rank;
+        }
+        iteration ++;
+        if (change <= error) break;
+    }
+
+    free(rank_shares); rank_shares = NULL;
+    return iteration;
+}
+
+/**
+ * @brief Personalized PageRank of many personalization vectors at once,
+ * each the uniform distribution over a seed set (one vertex, or the
+ * vertices of a topic). Same iteration and stopping rule per column as
+ * HostPersonalizedPageRank.
+ *
+ * The ranks form a nodes x num_columns row-major matrix. The columns
+ * still iterating are packed into a row-major block of rank shares, so
+ * every in-edge scan adds one whole row of shares, with SIMD, instead of
+ * a single value: one pass over the graph serves all the columns. A
+ * column that converges is retired, and the block narrows.
+ *
+ * @tparam Rank Rank type, independent of the graph's Value.
+ *
+ * @param[in] in_graph In-edges (CSC), or the graph itself if symmetric.
+ * @param[in] out_degrees Out-degree of each vertex.
+ * @param[in] num_columns Number of personalization vectors.
+ * @param[in] seed_offsets Column c's seeds are seeds[seed_offsets[c] ..
+ * seed_offsets[c+1]); duplicates count twice.
+ * @param[in] seeds Seed vertices of all the columns.
+ * @param[out] ranks Rank of vertex v for column c at v * num_columns + c.
+ * @param[in] delta Damping factor.
+ * @param[in] error Stop a column when its L1 change is at most error.
+ * @param[in] max_iteration Maximum number of iterations.
+ * @param[out] column_iterations Iterations run by each column; not
+ * returned if NULL.
+ *
+ * \return Number of iterations run, by the slowest column.
+ */
+template <typename VertexId, typename SizeT, typename Value, typename Rank>
+SizeT HostBatchedPersonalizedPageRank(
+    const Csr<VertexId, SizeT, Value> &in_graph,
+    const SizeT                       *out_degrees,
+    int                                num_columns,
+    const SizeT                       *seed_offsets,
+    const VertexId                    *seeds,
+    Rank                              *ranks,
+    Rank                               delta,
+    Rank                               error,
+    SizeT                              max_iteration,
+    SizeT                             *column_iterations = NULL)
+{
+    SizeT  nodes     = in_graph.nodes;
+    SizeT  k         = num_columns;
+    SizeT  iteration = 0;
+
+    // seeds by vertex, so each row finds its teleport terms
+    SizeT    num_seeds    = seed_offsets[num_columns];
+    SizeT   *seed_rows    = (SizeT   *) malloc(sizeof(SizeT   ) * (nodes + 1));
+    int     *seed_columns = (int     *) malloc(sizeof(int     ) * (num_seeds + 1));
+    Rank    *seed_weights = (Rank    *) malloc(sizeof(Rank    ) * (num_seeds + 1));
+    memset(seed_rows, 0, sizeof(SizeT) * (nodes + 1));
+    for (SizeT i = 0; i < num_seeds; i++)
+        seed_rows[seeds[i] + 1] ++;
+    for (SizeT v = 0; v < nodes; v++)
+        seed_rows[v + 1] += seed_rows[v];
+    {
+        std::vector<SizeT> fill(seed_rows, seed_rows + nodes);
+        for (int c = 0; c < num_columns; c++)
+        {
+            SizeT size = seed_offsets[c + 1] - seed_offsets[c];
+            for (SizeT i = seed_offsets[c]; i < seed_offsets[c + 1]; i++)
+            {
+                SizeT pos = fill[seeds[i]] ++;
+                seed_columns[pos] = c;
+                seed_weights[pos] = (Rank)1.0 / size;
+            }
+        }
+    }
+
+    // active columns packed in slots; the block width is padded to 16 so
+    // the SIMD paths apply at any count
+    std::vector<int> active, slots(num_columns, -1);
+    for (int c = 0; c < num_columns; c++)
+    {
+        if (column_iterations != NULL) column_iterations[c] = 0;
+        if (seed_offsets[c + 1] == seed_offsets[c]) continue;  // all zero
+        slots[c] = active.size();
+        active.push_back(c);
+    }
+    SizeT  max_width   = ((SizeT)active.size() + 15) / 16 * 16;
+    Rank  *rank_shares = (Rank*) malloc(sizeof(Rank) * ((size_t)nodes * max_width + 1));
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < nodes; v++)
+    {
+        Rank *row = ranks + (size_t)v * k;
+        for (SizeT c = 0; c < k; c++) row[c] = 0;
+        for (SizeT i = seed_rows[v]; i < seed_rows[v + 1]; i++)
+            row[seed_columns[i]] += seed_weights[i];
+    }
+
+    while (iteration < max_iteration && !active.empty())
+    {
+        SizeT num_active = active.size();
+        SizeT width      = (num_active + 15) / 16 * 16;
+        std::vector<Rank> dangling(num_active, 0), change(num_active, 0);
+
+        #pragma omp parallel
+        {
+            std::vector<Rank> thread_dangling(num_active, 0);
+            #pragma omp for
+            for (SizeT v = 0; v < nodes; v++)
+            {
+                const Rank *row   = ranks + (size_t)v * k;
+                Rank       *share = rank_shares + (size_t)v * width;
+                if (out_degrees[v] == 0)
+                {
+                    for (SizeT j = 0; j < num_active; j++)
+                        thread_dangling[j] += row[active[j]];
+                    for (SizeT j = 0; j < width; j++) share[j] = 0;
+                    continue;
+                }
+                for (SizeT j = 0; j < num_active; j++)
+                    share[j] = row[active[j]] / out_degrees[v];
+                for (SizeT j = num_active; j < width; j++) share[j] = 0;
+            }
+            #pragma omp critical
+            for (SizeT j = 0; j < num_active; j++)
+                dangling[j] += thread_dangling[j];
+        }
+
+        #pragma omp parallel
+        {
+            std::vector<Rank> sum(width), thread_change(num_active, 0);
+            #pragma omp for schedule(dynamic, 1024)
+            for (SizeT v = 0; v < nodes; v++)
+            {
+                SizeT start = in_graph.row_offsets[v];
+                for (SizeT j = 0; j < width; j++) sum[j] = 0;
+                util::simd::GatherAddRows(in_graph.column_indices + start,
+                    in_graph.row_offsets[v + 1] - start, rank_shares, width, &sum[0]);
+                for (SizeT j = 0; j < num_active; j++)
+                    sum[j] *= delta;
+                for (SizeT i = seed_rows[v]; i < seed_rows[v + 1]; i++)
+                {
+                    int slot = slots[seed_columns[i]];
+                    if (slot >= 0)
+                        sum[slot] += seed_weights[i] *
+                            ((1 - delta) + delta * dangling[slot]);
+                }
+                Rank *row = ranks + (size_t)v * k;
+                for (SizeT j = 0; j < num_active; j++)
+                {
+                    thread_change[j] += fabs(sum[j] - row[active[j]]);
+                    row[active[j]] = sum[j];
+                }
+            }
+            #pragma omp critical
+            for (SizeT j = 0; j < num_active; j++)
+                change[j] += thread_change[j];
+        }
+        iteration ++;
+
+        // retire the converged columns
+        std::vector<int> still_active;
+        for (SizeT j = 0; j < num_active; j++)
+        {
+            int c = active[j];
+            if (column_iterations != NULL) column_iterations[c] = iteration;
+            slots[c] = -1;
+            if (change[j] > error) still_active.push_back(c);
+        }
+        active.swap(still_active);
+        for (size_t j = 0; j < active.size(); j++)
+            slots[active[j]] = j;
+    }
+
+    free(seed_rows   ); seed_rows    = NULL;
+    free(seed_columns); seed_columns = NULL;
+    free(seed_weights); seed_weights = NULL;
+    free(rank_shares ); rank_shares  = NULL;
+    return iteration;
+}
+
+} // namespace pr
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,140 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * pr_ooc.cuh
+ *
+ * @brief Out-of-core PageRank over a BlockGraph, pushing rank changes:
+ * a vertex pushes only once its unpushed change exceeds the error, and
+ * blocks with no such vertex are not read.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <vector>
+#include <gunrock/block_graph.cuh>
+
+namespace gunrock {
+namespace app {
+namespace pr {
+
+/**
+ * @brief Scatters the share of each pushing source to its destination.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+struct DeltaPushOp
+{
+    const Value *shares;  // 0 for vertices not pushing
+    Value       *sums;
+
+    void operator()(SizeT e, VertexId from, VertexId to)
+    {
+        Value share = shares[from];
+        if (share == 0) return;
+        #pragma omp atomic
+        sums[to] += share;
+    }
+};
+
+/**
+ * @brief PageRank with rank changes pushed over a block graph; converges
+ * to the fixed point of HostPageRankPush, within about error / (1 - delta).
+ * Each vertex keeps the part of its rank not pushed yet; a vertex pushes it
+ * when it exceeds error, so late iterations touch only the blocks around
+ * the vertices still changing.
+ *
+ * @param[in] graph Block graph (out-edges).
+ * @param[out] rank Rank of each vertex.
+ * @param[in] delta Damping factor.
+ * @param[in] error Smallest change a vertex pushes.
+ * @param[in] max_iteration Maximum number of iterations.
+ * @param[in] normalized Whether ranks sum to 1 or to n.
+ * @param[out] blocks_visited Number of block visits, if not NULL.
+ *
+ * \return Number of iterations run.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+SizeT BlockPageRank(
+    BlockGraph<VertexId, SizeT, Value> &graph,
+    Value                              *rank,
+    Value                               delta,
+    Value                               error,
+    SizeT                               max_iteration,
+    bool                                normalized     = false,
+    SizeT                              *blocks_visited = NULL)
+{
+    SizeT  nodes     = graph.nodes;
+    Value *pending   = (Value*) malloc(sizeof(Value) * nodes);
+    Value *shares    = (Value*) malloc(sizeof(Value) * nodes);
+    Value *sums      = (Value*) malloc(sizeof(Value) * nodes);
+    Value  base      = normalized ? (1 - delta) / nodes : (1 - delta);
+    Value  init      = normalized ? (Value)1.0  / nodes : (Value)1.0;
+    SizeT  iteration = 0, visits = 0;
+    std::vector<char> active(graph.num_blocks, 0);
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < nodes; v++)
+    {
+        rank   [v] = init;
+        pending[v] = init;
+        sums   [v] = 0;
+    }
+
+    DeltaPushOp<VertexId, SizeT, Value> push;
+    push.shares = shares;
+    push.sums   = sums;
+    while (iteration < max_iteration)
+    {
+        // the first iteration pushes every rank
+        bool any_active = false;
+        std::fill(active.begin(), active.end(), 0);
+        #pragma omp parallel for schedule(dynamic, 1) reduction(||:any_active)
+        for (long long b = 0; b < (long long)graph.num_blocks; b++)
+        {
+            for (VertexId v = graph.block_starts[b]; v < (VertexId)graph.block_starts[b+1]; v++)
+            {
+                SizeT out_degree = graph.row_offsets[v+1] - graph.row_offsets[v];
+                shares[v] = 0;
+                if (out_degree == 0) continue;
+                if (iteration != 0 && fabs(pending[v]) <= error) continue;
+                shares [v] = pending[v] / out_degree;
+                pending[v] = 0;
+                active [b] = 1;
+                any_active = true;
+            }
+        }
+        if (!any_active) break;
+        visits += graph.ForAllEdges(push, &active[0]);
+
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            Value new_rank = base + delta * sums[v];
+            pending[v] += new_rank - rank[v];
+            rank   [v]  = new_rank;
+        }
+        iteration ++;
+    }
+
+    free(pending); pending = NULL;
+    free(shares ); shares  = NULL;
+    free(sums   ); sums    = NULL;
+    if (blocks_visited != NULL) *blocks_visited = visits;
+    return iteration;
+}
+
+} // namespace pr
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
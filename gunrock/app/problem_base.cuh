@@ -221,7 +221,8 @@ struct GraphSlice
         if (out_offset       != NULL) this->out_offset         .SetPointer(out_offset           , num_gpus + 1);
         if (out_counter      != NULL) this->out_counter        .SetPointer(out_counter          , num_gpus + 1);
         this->row_offsets        .SetPointer(graph->row_offsets   , nodes + 1   );
-        this->column_indices     .SetPointer(graph->column_indices, edges     );
+        if (graph->column_indices != NULL)
+            this->column_indices .SetPointer(graph->column_indices, edges     );
         if (inverstgraph != NULL)
         {
             this->column_offsets .SetPointer(inverstgraph->row_offsets, nodes + 1);
@@ -237,7 +238,27 @@ struct GraphSlice
 
         // Allocate and initialize column_indices
         if (retval = this->column_indices.Allocate(edges     , util::DEVICE)) return retval;
-        if (retval = this->column_indices.Move    (util::HOST, util::DEVICE)) return retval;
+        if (graph->column_indices != NULL)
+        {
+            if (retval = this->column_indices.Move(util::HOST, util::DEVICE)) return retval;
+        } else {
+            // 32-bit local ids on the host, widened chunk by chunk on the way up
+            SizeT     chunk  = 1 << 22;
+            VertexId *buffer = (VertexId*) malloc(sizeof(VertexId) * chunk);
+            for (SizeT start = 0; start < edges && retval == cudaSuccess; start += chunk)
+            {
+                SizeT size = (edges - start < chunk) ? edges - start : chunk;
+                #pragma omp parallel for
+                for (SizeT e = 0; e < size; e++)
+                    buffer[e] = graph->local_column_indices[start + e];
+                retval = util::GRError(cudaMemcpy(
+                    this->column_indices.GetPointer(util::DEVICE) + start,
+                    buffer, sizeof(VertexId) * size, cudaMemcpyHostToDevice),
+                    "GraphSlice cudaMemcpy column_indices failed", __FILE__, __LINE__);
+            }
+            free(buffer); buffer = NULL;
+            if (retval) return retval;
+        }
 
         // Allocate out degrees for each node
         if (retval = this->out_degrees   .Allocate(nodes     , util::DEVICE)) return retval;
@@ -1676,6 +1697,8 @@ struct ProblemBase
             {
                 util::GRError("partition_method invalid", __FILE__, __LINE__);
             }
+            // 64-bit graphs keep their partitions with 32-bit local ids
+            partitioner->narrow_local_ids = (sizeof(VertexId) > sizeof(unsigned int));
             cpu_timer.Start();
             retval = partitioner->Partition(
                 sub_graphs,
@@ -0,0 +1,353 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * queue_planner.cuh
+ *
+ * @brief Host-side planner for frontier queue and in-buffer sizing factors
+ */
+
+#pragma once
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <functional>
+
+#include <gunrock/csr.cuh>
+#include <gunrock/util/sort_omp.cuh>
+#include <gunrock/app/sim/partition_sim.cuh>
+
+namespace gunrock {
+namespace app {
+
+/**
+ * @brief Predicts max_queue_sizing, max_queue_sizing1 and max_in_sizing
+ * before any device allocation, so the enactor neither reallocates in
+ * Check_Queue_Size / Check_Size nor reserves much more than it needs.
+ *
+ * Frontier peaks come from BFS level profiles of a few sampled sources,
+ * split by partition the same way the multi-GPU enactor splits them; the
+ * degree distribution caps the advance-output prediction, and the
+ * per-peer in/out counts turn peaks into the sizing factors ProblemBase
+ * multiplies with. Without a partition table, multi-GPU plans assume the
+ * random partitioner and draw an equivalent vertex assignment.
+ *
+ * @tparam VertexId
+ * @tparam SizeT
+ * @tparam Value
+ */
+template <
+    typename VertexId,
+    typename SizeT,
+    typename Value>
+struct QueuePlanner
+{
+    typedef Csr<VertexId, SizeT, Value> GraphT;
+
+    // Parameters
+    int          num_samples; // number of sampled BFS sources
+    double       margin     ; // safety factor applied to sampled peaks
+    unsigned int seed       ;
+
+    // Predictions
+    int          num_gpus;
+    double       queue_sizing ;
+    double       queue_sizing1;
+    double       in_sizing    ;
+    std::vector<SizeT> owned_nodes;   // [gpu]
+    std::vector<SizeT> in_nodes;      // [gpu * num_gpus + peer], remote vertices peer sends to gpu
+    std::vector<SizeT> peak_frontier; // [gpu]
+    std::vector<SizeT> peak_advance;  // [gpu]
+    std::vector<SizeT> peak_in;       // [gpu * num_gpus + peer]
+    std::vector<SizeT> peak_sub_advance; // [gpu * num_gpus + peer]
+    int          max_depth;
+
+    QueuePlanner() :
+        num_samples  (4   ),
+        margin       (1.25),
+        seed         (0   ),
+        num_gpus     (1   ),
+        queue_sizing (-1  ),
+        queue_sizing1(-1  ),
+        in_sizing    (-1  ),
+        max_depth    (0   )
+    {
+    }
+
+    /**
+     * @brief Computes the sizing plan.
+     *
+     * @param[in] graph Input graph.
+     * @param[in] num_gpus Number of GPUs the graph will be split over.
+     * @param[in] partition_table Owner of each vertex, NULL to assume the
+     *            random partitioner.
+     * @param[in] src Source that will be used, included in the samples if valid.
+     */
+    void Plan(
+        const GraphT &graph,
+        int           num_gpus,
+        const int    *partition_table = NULL,
+        VertexId      src             = -1)
+    {
+        this -> num_gpus = num_gpus;
+        std::vector<int> table;
+        if (partition_table == NULL)
+        {
+            table.resize(graph.nodes);
+            MakeRandomTable(graph.nodes, num_gpus, &table[0]);
+            partition_table = &table[0];
+        }
+
+        CountBoundary(graph, partition_table);
+
+        peak_frontier   .assign(num_gpus, 0);
+        peak_advance    .assign(num_gpus, 0);
+        peak_in         .assign(num_gpus * num_gpus, 0);
+        peak_sub_advance.assign(num_gpus * num_gpus, 0);
+        max_depth = 0;
+
+        std::vector<VertexId> sources;
+        SampleSources(graph, src, sources);
+        for (size_t i = 0; i < sources.size(); i++)
+        {
+            sim::SimTrace<VertexId, SizeT, Value> trace;
+            trace.FromBFS(graph, partition_table, num_gpus, sources[i]);
+            max_depth = std::max(max_depth, (int)trace.iterations.size());
+            for (size_t it = 0; it < trace.iterations.size(); it++)
+            {
+                const sim::SimIteration<SizeT> &iteration = trace.iterations[it];
+                for (int gpu = 0; gpu < num_gpus; gpu++)
+                {
+                    peak_frontier[gpu] = std::max(peak_frontier[gpu], iteration.vertices[gpu]);
+                    peak_advance [gpu] = std::max(peak_advance [gpu], iteration.edges   [gpu]);
+                    for (int peer = 0; peer < num_gpus; peer++)
+                    {
+                        if (peer == gpu) continue;
+                        SizeT &in  = peak_in         [gpu * num_gpus + peer];
+                        SizeT &adv = peak_sub_advance[gpu * num_gpus + peer];
+                        in  = std::max(in , iteration.messages     [peer * num_gpus + gpu]);
+                        adv = std::max(adv, iteration.message_edges[peer * num_gpus + gpu]);
+                    }
+                }
+            }
+        }
+
+        ComputeFactors(graph);
+    }
+
+    /**
+     * @brief Stores predictions into a json_spirit::mObject.
+     *
+     * @param[in] plan Object to write into.
+     */
+    void ToJson(json_spirit::mObject &plan)
+    {
+        json_spirit::mArray frontier, advance, owned, in, peak_in_;
+        for (int gpu = 0; gpu < num_gpus; gpu++)
+        {
+            frontier.push_back((int64_t)peak_frontier[gpu]);
+            advance .push_back((int64_t)peak_advance [gpu]);
+            owned   .push_back((int64_t)owned_nodes  [gpu]);
+        }
+        for (size_t i = 0; i < in_nodes.size(); i++)
+        {
+            in      .push_back((int64_t)in_nodes[i]);
+            peak_in_.push_back((int64_t)peak_in [i]);
+        }
+        plan["num_samples"      ] = num_samples;
+        plan["margin"           ] = margin;
+        plan["max_depth"        ] = max_depth;
+        plan["max_queue_sizing" ] = queue_sizing;
+        plan["max_queue_sizing1"] = queue_sizing1;
+        plan["max_in_sizing"    ] = in_sizing;
+        plan["owned_nodes"      ] = owned;
+        plan["in_nodes"         ] = in;
+        plan["peak_frontier"    ] = frontier;
+        plan["peak_advance"     ] = advance;
+        plan["peak_in"          ] = peak_in_;
+    }
+
+    /**
+     * @brief Records the predicted allocations next to what the queues
+     * hold after a run. A queue larger than planned was grown by
+     * Check_Queue_Size / Check_Size mid-run.
+     *
+     * @tparam ProblemT Problem type whose data slices derive from DataSliceBase.
+     *
+     * @param[in] problem Problem after Enact.
+     * @param[in] plan Object to write into.
+     */
+    template <typename ProblemT>
+    void RecordActual(ProblemT *problem, json_spirit::mObject &plan)
+    {
+        json_spirit::mArray predicted, actual, predicted_in, actual_in;
+        int num_reallocations = 0;
+        for (int gpu = 0; gpu < num_gpus; gpu++)
+        {
+            int num_queues = num_gpus > 1 ? num_gpus + 1 : 1;
+            for (int peer = 0; peer < num_queues; peer++)
+            for (int i = 0; i < 2; i++)
+            {
+                SizeT base = num_gpus == 1 ? problem -> nodes :
+                    problem -> graph_slices[gpu] -> in_counter[peer];
+                long long planned = (long long)(base *
+                    (i == 0 ? queue_sizing : queue_sizing1)) + 2;
+                long long size = problem -> data_slices[gpu] ->
+                    frontier_queues[peer].keys[i].GetSize();
+                predicted.push_back((int64_t)planned);
+                actual   .push_back((int64_t)size   );
+                if (size > planned) num_reallocations ++;
+            }
+            for (int peer = 1; peer < num_gpus; peer++)
+            {
+                long long planned = (long long)(problem -> graph_slices[gpu]
+                    -> in_counter[peer] * in_sizing);
+                long long size = problem -> data_slices[gpu] ->
+                    keys_in[0][peer].GetSize();
+                predicted_in.push_back((int64_t)planned);
+                actual_in   .push_back((int64_t)size   );
+                if (size > planned) num_reallocations ++;
+            }
+        }
+        plan["predicted_queue_sizes"] = predicted;
+        plan["actual_queue_sizes"   ] = actual;
+        plan["predicted_in_sizes"   ] = predicted_in;
+        plan["actual_in_sizes"      ] = actual_in;
+        plan["num_reallocations"    ] = num_reallocations;
+    }
+
+private:
+    void MakeRandomTable(SizeT nodes, int num_gpus, int *table)
+    {
+        #pragma omp parallel
+        {
+            int thread_num  = omp_get_thread_num();
+            int num_threads = omp_get_num_threads();
+            SizeT i_start   = (long long)(nodes) * thread_num / num_threads;
+            SizeT i_end     = (long long)(nodes) * (thread_num + 1) / num_threads;
+            std::mt19937 engine(seed + 754 * thread_num);
+            std::uniform_int_distribution<int> distribution(0, num_gpus - 1);
+            for (SizeT i = i_start; i < i_end; i++)
+                table[i] = distribution(engine);
+        }
+    }
+
+    /**
+     * @brief Owned and per-peer remote vertex counts, matching the
+     * partitioner's out_counter / in_counter.
+     */
+    void CountBoundary(const GraphT &graph, const int *partition_table)
+    {
+        std::vector<SizeT> out_nodes(num_gpus * num_gpus, 0);
+        owned_nodes.assign(num_gpus, 0);
+        in_nodes   .assign(num_gpus * num_gpus, 0);
+
+        #pragma omp parallel for
+        for (int gpu = 0; gpu < num_gpus; gpu++)
+        {
+            std::vector<bool> marker(num_gpus > 1 ? graph.nodes : 0, false);
+            for (SizeT v = 0; v < graph.nodes; v++)
+            {
+                if (partition_table[v] != gpu) continue;
+                owned_nodes[gpu] ++;
+                if (num_gpus == 1) continue;
+                for (SizeT e = graph.row_offsets[v]; e < graph.row_offsets[v+1]; e++)
+                {
+                    VertexId u = graph.column_indices[e];
+                    int peer = partition_table[u];
+                    if (peer == gpu || marker[u]) continue;
+                    marker[u] = true;
+                    out_nodes[gpu * num_gpus + peer] ++;
+                }
+            }
+        }
+        for (int gpu = 0; gpu < num_gpus; gpu++)
+        for (int peer = 0; peer < num_gpus; peer++)
+            in_nodes[gpu * num_gpus + peer] = out_nodes[peer * num_gpus + gpu];
+    }
+
+    void SampleSources(
+        const GraphT          &graph,
+        VertexId               src,
+        std::vector<VertexId> &sources)
+    {
+        std::mt19937 engine(seed);
+        std::uniform_int_distribution<long long> distribution(0, graph.nodes - 1);
+        int max_tries = num_samples * 16;
+
+        if (src >= 0 && src < graph.nodes)
+            sources.push_back(src);
+        while ((int)sources.size() < num_samples && max_tries-- > 0)
+        {
+            VertexId v = distribution(engine);
+            if (graph.row_offsets[v] == graph.row_offsets[v+1]) continue;
+            sources.push_back(v);
+        }
+        if (sources.empty()) sources.push_back(0);
+    }
+
+    /**
+     * @brief Turns peaks into the factors ProblemBase multiplies with:
+     * frontier queue of peer 0 is sized by owned nodes (all nodes on one
+     * GPU), sub-queues of peer k by in_nodes of k, keys_in by in_nodes.
+     */
+    void ComputeFactors(const GraphT &graph)
+    {
+        // The largest advance output a frontier of k vertices can produce
+        // is the sum of the k largest degrees.
+        std::vector<SizeT> degrees(graph.nodes);
+        #pragma omp parallel for
+        for (SizeT v = 0; v < graph.nodes; v++)
+            degrees[v] = graph.row_offsets[v+1] - graph.row_offsets[v];
+        util::omp_sort(degrees.data(), graph.nodes, std::greater<SizeT>());
+        for (SizeT v = 1; v < graph.nodes; v++)
+            degrees[v] += degrees[v-1];
+
+        double advance_ratio  = 0;
+        double frontier_ratio = 0;
+        double in_ratio       = 0;
+        for (int gpu = 0; gpu < num_gpus; gpu++)
+        {
+            SizeT base = num_gpus > 1 ? owned_nodes[gpu] : graph.nodes;
+            if (base == 0) continue;
+            SizeT k = std::min((SizeT)(peak_frontier[gpu] * margin), graph.nodes);
+            double advance = std::max(
+                (double)peak_advance[gpu],
+                std::min(peak_advance[gpu] * margin,
+                    (double)(k > 0 ? degrees[k-1] : 0)));
+            advance_ratio  = std::max(advance_ratio , advance / base);
+            frontier_ratio = std::max(frontier_ratio, peak_frontier[gpu] * margin / base);
+
+            for (int peer = 0; peer < num_gpus; peer++)
+            {
+                SizeT in = in_nodes[gpu * num_gpus + peer];
+                if (peer == gpu || in == 0) continue;
+                double peak_in_ = peak_in[gpu * num_gpus + peer] * margin;
+                advance_ratio = std::max(advance_ratio,
+                    peak_sub_advance[gpu * num_gpus + peer] * margin / in);
+                in_ratio = std::max(in_ratio, peak_in_ / in);
+            }
+        }
+
+        // advance output lands in either ping-pong buffer depending on the
+        // selector, so both must hold it; the frontier alone never exceeds it
+        queue_sizing  = std::max(advance_ratio, frontier_ratio);
+        queue_sizing1 = queue_sizing;
+        in_sizing     = num_gpus > 1 ? in_ratio : 0;
+    }
+};
+
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
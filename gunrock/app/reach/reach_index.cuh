@@ -0,0 +1,686 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * reach_index.cuh
+ *
+ * @brief Reachability index of a directed graph: its strongly connected
+ * components condensed into a DAG, labeled with GRAIL intervals from a few
+ * randomized DFS traversals. Most "can u reach v" queries are answered
+ * from the labels alone; the rest by a bidirectional search the labels
+ * prune. The index is saved next to the graph's binary cache.
+ */
+
+#pragma once
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <omp.h>
+
+#include <gunrock/csr.cuh>
+#include <gunrock/graphio/market.cuh>
+#include <gunrock/util/host/scan.cuh>
+
+namespace gunrock {
+namespace app {
+namespace reach {
+
+#define GR_REACH_INDEX_MAGIC   0x49524752u  // "GRRI"
+#define GR_REACH_INDEX_VERSION 1u
+#define GR_REACH_NUM_HUBS      64   // bits of hubs_reached / hubs_reaching
+
+/**
+ * @brief Name of the index file of a binary graph cache: its name with
+ * the "bin" suffix replaced by "reach".
+ *
+ * @param[in] cache_name Binary cache file, e.g. from MarketBinaryFileName.
+ * @param[out] index_name Index file name, 256 chars.
+ */
+inline void ReachIndexFileName(const char *cache_name, char *index_name)
+{
+    graphio::CacheSidecarFileName(cache_name, "reach", index_name);
+}
+
+/**
+ * @brief Per-thread scratch space of the fallback search, and counts of
+ * how the queries were answered.
+ */
+template <typename VertexId>
+struct ReachSearchBuffer
+{
+    std::vector<uint32_t> forward_marks;   // == epoch: reached from the source
+    std::vector<uint32_t> backward_marks;  // == epoch: reaches the target
+    std::vector<VertexId> forward_queue;
+    std::vector<VertexId> backward_queue;
+    std::vector<VertexId> next_queue;
+    uint32_t  epoch;
+    long long num_queries;
+    long long num_searches;   // queries the labels could not answer
+
+    ReachSearchBuffer() :
+        epoch       (0),
+        num_queries (0),
+        num_searches(0)
+    {
+    }
+};
+
+/**
+ * @brief Reachability index.
+ *
+ * Components are numbered in topological order, so an edge of the DAG
+ * always goes to a higher number. For each of num_labels traversals,
+ * highs[] is the DFS post-order rank of a component and lows[] the
+ * smallest rank below it: if u reaches v, v's interval lies within u's in
+ * every traversal. The first traversal's DFS forest also answers yes for
+ * tree descendants: tree_pres[] holds its pre-order ranks. Yes is also
+ * certain when u reaches a hub, one of the best connected components,
+ * that reaches v: each component keeps a bit per hub of either kind.
+ */
+template <typename VertexId, typename SizeT>
+struct ReachIndex
+{
+    SizeT     nodes;           // of the graph
+    SizeT     edges;
+    SizeT     num_components;
+    SizeT     dag_edges;
+    int       num_labels;
+    VertexId *component_ids;   // topological number of v's component
+    VertexId *levels;          // longest path from a DAG source
+    SizeT    *out_offsets;     // DAG, and its reverse
+    VertexId *out_neighbors;
+    SizeT    *in_offsets;
+    VertexId *in_neighbors;
+    VertexId *lows;            // num_labels x num_components
+    VertexId *highs;
+    VertexId *tree_pres;
+    uint64_t *hubs_reached;    // hubs the component reaches
+    uint64_t *hubs_reaching;   // hubs that reach the component
+
+    ReachIndex() :
+        nodes         (0),
+        edges         (0),
+        num_components(0),
+        dag_edges     (0),
+        num_labels    (0),
+        component_ids (NULL),
+        levels        (NULL),
+        out_offsets   (NULL),
+        out_neighbors (NULL),
+        in_offsets    (NULL),
+        in_neighbors  (NULL),
+        lows          (NULL),
+        highs         (NULL),
+        tree_pres     (NULL),
+        hubs_reached  (NULL),
+        hubs_reaching (NULL)
+    {
+    }
+
+    ~ReachIndex()
+    {
+        Release();
+    }
+
+    void Release()
+    {
+        if (component_ids) { free(component_ids); component_ids = NULL; }
+        if (levels       ) { free(levels       ); levels        = NULL; }
+        if (out_offsets  ) { free(out_offsets  ); out_offsets   = NULL; }
+        if (out_neighbors) { free(out_neighbors); out_neighbors = NULL; }
+        if (in_offsets   ) { free(in_offsets   ); in_offsets    = NULL; }
+        if (in_neighbors ) { free(in_neighbors ); in_neighbors  = NULL; }
+        if (lows         ) { free(lows         ); lows          = NULL; }
+        if (highs        ) { free(highs        ); highs         = NULL; }
+        if (tree_pres    ) { free(tree_pres    ); tree_pres     = NULL; }
+        if (hubs_reached ) { free(hubs_reached ); hubs_reached  = NULL; }
+        if (hubs_reaching) { free(hubs_reaching); hubs_reaching = NULL; }
+        nodes = edges = num_components = dag_edges = 0;
+        num_labels = 0;
+    }
+
+    /**
+     * @brief Builds the index of a graph.
+     *
+     * @param[in] graph Directed graph; an undirected one gives its
+     * connected components.
+     * @param[in] labels GRAIL traversals; more prune more queries.
+     * @param[in] seed Seed of the traversal orders.
+     * @param[in] quiet Don't print out anything.
+     */
+    template <typename Value>
+    void Build(
+        const Csr<VertexId, SizeT, Value> &graph,
+        int          labels = 5,
+        unsigned int seed   = 0,
+        bool         quiet  = false)
+    {
+        Release();
+        time_t mark0 = time(NULL);
+        nodes      = graph.nodes;
+        edges      = graph.edges;
+        num_labels = labels < 1 ? 1 : labels;
+        component_ids = (VertexId*) malloc(sizeof(VertexId) * (nodes + 1));
+
+        FindComponents(graph);
+        BuildDag(graph);
+        BuildLabels(seed);
+        BuildHubs();
+        if (!quiet)
+        {
+            printf("  Reachability index: %lld components, %lld DAG edges,"
+                " %d labels (%ds)\n", (long long)num_components,
+                (long long)dag_edges, num_labels, (int)(time(NULL) - mark0));
+        }
+    }
+
+    /**
+     * @brief Whether u reaches v.
+     *
+     * @param[in] u Source vertex.
+     * @param[in] v Target vertex.
+     * @param[in] buffer Scratch space, one per thread.
+     */
+    bool Reachable(VertexId u, VertexId v, ReachSearchBuffer<VertexId> &buffer) const
+    {
+        buffer.num_queries ++;
+        VertexId cu = component_ids[u], cv = component_ids[v];
+        if (cu == cv) return true;
+        if (!MayReach(cu, cv)) return false;
+        if (TreeReaches(cu, cv) ||
+            (hubs_reached[cu] & hubs_reaching[cv]) != 0) return true;
+        buffer.num_searches ++;
+        return Search(cu, cv, buffer);
+    }
+
+    /**
+     * @brief Answers many queries, in parallel.
+     *
+     * @param[in] num_queries Number of queries.
+     * @param[in] sources Source of each query.
+     * @param[in] targets Target of each query.
+     * @param[out] results 1 if the source reaches the target, 0 otherwise.
+     *
+     * \return Number of queries that needed a search.
+     */
+    long long Reachable(
+        SizeT           num_queries,
+        const VertexId *sources,
+        const VertexId *targets,
+        char           *results) const
+    {
+        long long num_searches = 0;
+        #pragma omp parallel reduction(+:num_searches)
+        {
+            ReachSearchBuffer<VertexId> buffer;
+            #pragma omp for schedule(dynamic, 256)
+            for (SizeT i = 0; i < num_queries; i++)
+                results[i] = Reachable(sources[i], targets[i], buffer) ? 1 : 0;
+            num_searches += buffer.num_searches;
+        }
+        return num_searches;
+    }
+
+    /**
+     * @brief Writes the index.
+     *
+     * \return 0 on success, -1 otherwise.
+     */
+    int Save(const char *file_name) const
+    {
+        FILE *f_out = fopen(file_name, "wb");
+        if (f_out == NULL) return -1;
+        int64_t header[8] = {
+            ((int64_t)GR_REACH_INDEX_VERSION << 32) | GR_REACH_INDEX_MAGIC,
+            (int64_t)nodes, (int64_t)edges, (int64_t)num_components,
+            (int64_t)dag_edges, (int64_t)num_labels,
+            (int64_t)sizeof(VertexId), (int64_t)sizeof(SizeT)};
+        size_t labels_size = (size_t)num_labels * num_components;
+        bool written =
+            fwrite(header, sizeof(header), 1, f_out) == 1 &&
+            Write(f_out, component_ids, nodes             ) &&
+            Write(f_out, levels       , num_components    ) &&
+            Write(f_out, out_offsets  , num_components + 1) &&
+            Write(f_out, out_neighbors, dag_edges         ) &&
+            Write(f_out, in_offsets   , num_components + 1) &&
+            Write(f_out, in_neighbors , dag_edges         ) &&
+            Write(f_out, lows         , labels_size       ) &&
+            Write(f_out, highs        , labels_size       ) &&
+            Write(f_out, tree_pres    , num_components    ) &&
+            Write(f_out, hubs_reached , num_components    ) &&
+            Write(f_out, hubs_reaching, num_components    );
+        if (fclose(f_out) != 0) written = false;
+        if (!written) remove(file_name);
+        return written ? 0 : -1;
+    }
+
+    /**
+     * @brief Reads an index written by Save for a graph of the given size.
+     *
+     * \return 0 on success, -1 if the file is missing, from another build
+     * or for another graph.
+     */
+    int Load(const char *file_name, SizeT graph_nodes, SizeT graph_edges)
+    {
+        Release();
+        FILE *f_in = fopen(file_name, "rb");
+        if (f_in == NULL) return -1;
+        int64_t header[8];
+        bool read = fread(header, sizeof(header), 1, f_in) == 1 &&
+            header[0] == (((int64_t)GR_REACH_INDEX_VERSION << 32) | GR_REACH_INDEX_MAGIC) &&
+            header[1] == (int64_t)graph_nodes && header[2] == (int64_t)graph_edges &&
+            header[6] == (int64_t)sizeof(VertexId) && header[7] == (int64_t)sizeof(SizeT);
+        if (read)
+        {
+            nodes          = header[1];
+            edges          = header[2];
+            num_components = header[3];
+            dag_edges      = header[4];
+            num_labels     = header[5];
+            size_t labels_size = (size_t)num_labels * num_components;
+            read =
+                Read(f_in, component_ids, nodes             ) &&
+                Read(f_in, levels       , num_components    ) &&
+                Read(f_in, out_offsets  , num_components + 1) &&
+                Read(f_in, out_neighbors, dag_edges         ) &&
+                Read(f_in, in_offsets   , num_components + 1) &&
+                Read(f_in, in_neighbors , dag_edges         ) &&
+                Read(f_in, lows         , labels_size       ) &&
+                Read(f_in, highs        , labels_size       ) &&
+                Read(f_in, tree_pres    , num_components    ) &&
+                Read(f_in, hubs_reached , num_components    ) &&
+                Read(f_in, hubs_reaching, num_components    );
+        }
+        fclose(f_in);
+        if (!read) Release();
+        return read ? 0 : -1;
+    }
+
+private:
+    template <typename T>
+    static bool Write(FILE *f_out, const T *array, size_t size)
+    {
+        return size == 0 || fwrite(array, sizeof(T), size, f_out) == size;
+    }
+
+    template <typename T>
+    static bool Read(FILE *f_in, T *&array, size_t size)
+    {
+        array = (T*) malloc(sizeof(T) * (size + 1));
+        return size == 0 || fread(array, sizeof(T), size, f_in) == size;
+    }
+
+    /**
+     * @brief Whether the labels allow cu to reach cv; exact for no.
+     */
+    bool MayReach(VertexId cu, VertexId cv) const
+    {
+        if (cu > cv || levels[cu] >= levels[cv]) return false;
+        for (int i = 0; i < num_labels; i++)
+        {
+            size_t offset = (size_t)i * num_components;
+            if (lows [offset + cv] < lows [offset + cu] ||
+                highs[offset + cv] > highs[offset + cu]) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Whether cv is below cu in the first DFS forest.
+     */
+    bool TreeReaches(VertexId cu, VertexId cv) const
+    {
+        return tree_pres[cu] <= tree_pres[cv] && highs[cv] <= highs[cu];
+    }
+
+    /**
+     * @brief Bidirectional BFS over the DAG, the smaller frontier expanded
+     * first; components the labels rule out are not visited.
+     */
+    bool Search(VertexId cu, VertexId cv, ReachSearchBuffer<VertexId> &buffer) const
+    {
+        if (buffer.forward_marks.size() != (size_t)num_components)
+        {
+            buffer.forward_marks .assign(num_components, 0);
+            buffer.backward_marks.assign(num_components, 0);
+            buffer.epoch = 0;
+        }
+        if (++buffer.epoch == 0)
+        {
+            std::fill(buffer.forward_marks .begin(), buffer.forward_marks .end(), 0);
+            std::fill(buffer.backward_marks.begin(), buffer.backward_marks.end(), 0);
+            buffer.epoch = 1;
+        }
+        uint32_t epoch = buffer.epoch;
+        std::vector<VertexId> &forward  = buffer.forward_queue;
+        std::vector<VertexId> &backward = buffer.backward_queue;
+        std::vector<VertexId> &next     = buffer.next_queue;
+        forward .assign(1, cu);
+        backward.assign(1, cv);
+        buffer.forward_marks [cu] = epoch;
+        buffer.backward_marks[cv] = epoch;
+
+        while (!forward.empty() && !backward.empty())
+        {
+            next.clear();
+            if (forward.size() <= backward.size())
+            {
+                for (size_t i = 0; i < forward.size(); i++)
+                {
+                    VertexId c = forward[i];
+                    for (SizeT e = out_offsets[c]; e < out_offsets[c + 1]; e++)
+                    {
+                        VertexId d = out_neighbors[e];
+                        if (buffer.backward_marks[d] == epoch) return true;
+                        if (buffer.forward_marks [d] == epoch) continue;
+                        buffer.forward_marks[d] = epoch;
+                        if (!MayReach(d, cv)) continue;
+                        if (TreeReaches(d, cv) ||
+                            (hubs_reached[d] & hubs_reaching[cv]) != 0) return true;
+                        next.push_back(d);
+                    }
+                }
+                forward.swap(next);
+            } else {
+                for (size_t i = 0; i < backward.size(); i++)
+                {
+                    VertexId c = backward[i];
+                    for (SizeT e = in_offsets[c]; e < in_offsets[c + 1]; e++)
+                    {
+                        VertexId d = in_neighbors[e];
+                        if (buffer.forward_marks [d] == epoch) return true;
+                        if (buffer.backward_marks[d] == epoch) continue;
+                        buffer.backward_marks[d] = epoch;
+                        if (!MayReach(cu, d)) continue;
+                        if (TreeReaches(cu, d) ||
+                            (hubs_reached[cu] & hubs_reaching[d]) != 0) return true;
+                        next.push_back(d);
+                    }
+                }
+                backward.swap(next);
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Strongly connected components by iterative Tarjan, numbered
+     * in topological order.
+     */
+    template <typename Value>
+    void FindComponents(const Csr<VertexId, SizeT, Value> &graph)
+    {
+        VertexId *orders = (VertexId*) malloc(sizeof(VertexId) * (nodes + 1));
+        VertexId *lowest = (VertexId*) malloc(sizeof(VertexId) * (nodes + 1));
+        char     *on_stack = (char*) malloc(sizeof(char) * (nodes + 1));
+        std::vector<VertexId> stack;
+        std::vector<std::pair<VertexId, SizeT> > calls;
+        VertexId  counter = 0, components = 0;
+
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            orders  [v] = -1;
+            on_stack[v] = 0;
+        }
+        for (SizeT s = 0; s < nodes; s++)
+        {
+            if (orders[s] != -1) continue;
+            orders[s] = lowest[s] = counter++;
+            stack.push_back(s);
+            on_stack[s] = 1;
+            calls.push_back(std::make_pair((VertexId)s, graph.row_offsets[s]));
+            while (!calls.empty())
+            {
+                VertexId v = calls.back().first;
+                SizeT    e = calls.back().second;
+                if (e < graph.row_offsets[v + 1])
+                {
+                    calls.back().second ++;
+                    VertexId w = graph.column_indices[e];
+                    if (orders[w] == -1)
+                    {
+                        orders[w] = lowest[w] = counter++;
+                        stack.push_back(w);
+                        on_stack[w] = 1;
+                        calls.push_back(std::make_pair(w, graph.row_offsets[w]));
+                    } else if (on_stack[w] && orders[w] < lowest[v])
+                        lowest[v] = orders[w];
+                    continue;
+                }
+                calls.pop_back();
+                if (!calls.empty() && lowest[v] < lowest[calls.back().first])
+                    lowest[calls.back().first] = lowest[v];
+                if (lowest[v] != orders[v]) continue;
+                // v roots a component; Tarjan finishes sinks first
+                VertexId w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    on_stack[w] = 0;
+                    component_ids[w] = components;
+                } while (w != v);
+                components ++;
+            }
+        }
+        num_components = components;
+
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            component_ids[v] = num_components - 1 - component_ids[v];
+        free(orders  ); orders   = NULL;
+        free(lowest  ); lowest   = NULL;
+        free(on_stack); on_stack = NULL;
+    }
+
+    /**
+     * @brief Condensed DAG, its reverse and the levels.
+     */
+    template <typename Value>
+    void BuildDag(const Csr<VertexId, SizeT, Value> &graph)
+    {
+        SizeT    *member_offsets = (SizeT   *) malloc(sizeof(SizeT   ) * (num_components + 1));
+        VertexId *members        = (VertexId*) malloc(sizeof(VertexId) * (nodes + 1));
+        memset(member_offsets, 0, sizeof(SizeT) * (num_components + 1));
+        for (SizeT v = 0; v < nodes; v++)
+            member_offsets[component_ids[v]] ++;
+        util::host::ExclusiveScan(member_offsets, member_offsets, num_components + 1);
+        {
+            std::vector<SizeT> fill(member_offsets, member_offsets + num_components);
+            for (SizeT v = 0; v < nodes; v++)
+                members[fill[component_ids[v]] ++] = v;
+        }
+
+        // distinct neighbor components of each component, counted then written
+        out_offsets = (SizeT*) malloc(sizeof(SizeT) * (num_components + 1));
+        for (int pass = 0; pass < 2; pass++)
+        {
+            #pragma omp parallel
+            {
+                std::vector<VertexId> targets;
+                #pragma omp for schedule(dynamic, 256)
+                for (SizeT c = 0; c < num_components; c++)
+                {
+                    targets.clear();
+                    for (SizeT i = member_offsets[c]; i < member_offsets[c + 1]; i++)
+                    {
+                        VertexId u = members[i];
+                        for (SizeT e = graph.row_offsets[u]; e < graph.row_offsets[u + 1]; e++)
+                        {
+                            VertexId d = component_ids[graph.column_indices[e]];
+                            if (d != (VertexId)c) targets.push_back(d);
+                        }
+                    }
+                    std::sort(targets.begin(), targets.end());
+                    targets.erase(std::unique(targets.begin(), targets.end()),
+                        targets.end());
+                    if (pass == 0) out_offsets[c] = targets.size();
+                    else if (!targets.empty())
+                        memcpy(out_neighbors + out_offsets[c], &targets[0],
+                            sizeof(VertexId) * targets.size());
+                }
+            }
+            if (pass == 0)
+            {
+                out_offsets[num_components] = 0;
+                dag_edges = util::host::ExclusiveScan(
+                    out_offsets, out_offsets, num_components + 1);
+                out_neighbors = (VertexId*) malloc(sizeof(VertexId) * (dag_edges + 1));
+            }
+        }
+        free(member_offsets); member_offsets = NULL;
+        free(members       ); members        = NULL;
+
+        // reverse DAG; sources in increasing order, since c walks up
+        in_offsets   = (SizeT   *) malloc(sizeof(SizeT   ) * (num_components + 1));
+        in_neighbors = (VertexId*) malloc(sizeof(VertexId) * (dag_edges + 1));
+        levels       = (VertexId*) malloc(sizeof(VertexId) * (num_components + 1));
+        memset(in_offsets, 0, sizeof(SizeT) * (num_components + 1));
+        for (SizeT e = 0; e < dag_edges; e++)
+            in_offsets[out_neighbors[e]] ++;
+        util::host::ExclusiveScan(in_offsets, in_offsets, num_components + 1);
+        std::vector<SizeT> fill(in_offsets, in_offsets + num_components);
+        for (SizeT c = 0; c < num_components; c++)
+            for (SizeT e = out_offsets[c]; e < out_offsets[c + 1]; e++)
+                in_neighbors[fill[out_neighbors[e]] ++] = c;
+
+        // in topological order, every in-neighbor has its level already
+        for (SizeT c = 0; c < num_components; c++)
+        {
+            VertexId level = 0;
+            for (SizeT e = in_offsets[c]; e < in_offsets[c + 1]; e++)
+                if (levels[in_neighbors[e]] + 1 > level)
+                    level = levels[in_neighbors[e]] + 1;
+            levels[c] = level;
+        }
+    }
+
+    /**
+     * @brief GRAIL labels, one traversal per thread: DFS from the DAG
+     * sources in a shuffled order, each component's children visited from
+     * a random start.
+     */
+    void BuildLabels(unsigned int seed)
+    {
+        size_t labels_size = (size_t)num_labels * num_components;
+        lows      = (VertexId*) malloc(sizeof(VertexId) * (labels_size + 1));
+        highs     = (VertexId*) malloc(sizeof(VertexId) * (labels_size + 1));
+        tree_pres = (VertexId*) malloc(sizeof(VertexId) * (num_components + 1));
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int label = 0; label < num_labels; label++)
+        {
+            size_t    offset = (size_t)label * num_components;
+            VertexId *low    = lows  + offset;
+            VertexId *high   = highs + offset;
+            unsigned int state = seed * 2654435761u + label * 40503u + 1;
+            std::vector<VertexId> roots;
+            for (SizeT c = 0; c < num_components; c++)
+                if (in_offsets[c] == in_offsets[c + 1]) roots.push_back(c);
+            for (size_t i = roots.size(); i > 1; i--)
+            {
+                state = state * 1103515245u + 12345u;
+                std::swap(roots[i - 1], roots[(state >> 8) % i]);
+            }
+
+            // (component, children visited); high[] is -1 until visited
+            std::vector<std::pair<VertexId, SizeT> > calls;
+            for (SizeT c = 0; c < num_components; c++) high[c] = -1;
+            VertexId pre = 0, post = 0;
+            for (size_t r = 0; r < roots.size(); r++)
+            {
+                calls.push_back(std::make_pair(roots[r], (SizeT)0));
+                high[roots[r]] = 0;
+                if (label == 0) tree_pres[roots[r]] = pre;
+                pre ++;
+                while (!calls.empty())
+                {
+                    VertexId c      = calls.back().first;
+                    SizeT    degree = out_offsets[c + 1] - out_offsets[c];
+                    if (calls.back().second < degree)
+                    {
+                        // the rotation is fixed per component and traversal
+                        SizeT i = calls.back().second ++;
+                        SizeT start = (label == 0) ? 0 :
+                            (SizeT)((c * 2654435761u + label * 97u) % degree);
+                        VertexId d = out_neighbors[out_offsets[c] + (start + i) % degree];
+                        if (high[d] != -1) continue;
+                        high[d] = 0;
+                        if (label == 0) tree_pres[d] = pre;
+                        pre ++;
+                        calls.push_back(std::make_pair(d, (SizeT)0));
+                        continue;
+                    }
+                    high[c] = post++;
+                    calls.pop_back();
+                }
+            }
+
+            // children are numbered higher, so they are final first
+            for (SizeT c = num_components; c-- > 0; )
+            {
+                VertexId lowest = high[c];
+                for (SizeT e = out_offsets[c]; e < out_offsets[c + 1]; e++)
+                    if (low[out_neighbors[e]] < lowest)
+                        lowest = low[out_neighbors[e]];
+                low[c] = lowest;
+            }
+        }
+    }
+
+    /**
+     * @brief Picks the components with the most DAG paths through them,
+     * by in-degree times out-degree, as hubs, and propagates their bits:
+     * down the topological order for the hubs reaching a component, up it
+     * for the hubs it reaches.
+     */
+    void BuildHubs()
+    {
+        hubs_reached  = (uint64_t*) malloc(sizeof(uint64_t) * (num_components + 1));
+        hubs_reaching = (uint64_t*) malloc(sizeof(uint64_t) * (num_components + 1));
+        std::vector<std::pair<double, VertexId> > scores(num_components);
+        #pragma omp parallel for
+        for (SizeT c = 0; c < num_components; c++)
+        {
+            scores[c].first  = -(double)(in_offsets [c + 1] - in_offsets [c]) *
+                                (double)(out_offsets[c + 1] - out_offsets[c]);
+            scores[c].second = c;
+            hubs_reached [c] = 0;
+            hubs_reaching[c] = 0;
+        }
+        SizeT num_hubs = std::min((SizeT)GR_REACH_NUM_HUBS, num_components);
+        std::partial_sort(scores.begin(), scores.begin() + num_hubs, scores.end());
+        for (SizeT h = 0; h < num_hubs; h++)
+        {
+            hubs_reached [scores[h].second] |= (uint64_t)1 << h;
+            hubs_reaching[scores[h].second] |= (uint64_t)1 << h;
+        }
+
+        for (SizeT c = 0; c < num_components; c++)
+            for (SizeT e = in_offsets[c]; e < in_offsets[c + 1]; e++)
+                hubs_reaching[c] |= hubs_reaching[in_neighbors[e]];
+        for (SizeT c = num_components; c-- > 0; )
+            for (SizeT e = out_offsets[c]; e < out_offsets[c + 1]; e++)
+                hubs_reached[c] |= hubs_reached[out_neighbors[e]];
+    }
+};
+
+} // namespace reach
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
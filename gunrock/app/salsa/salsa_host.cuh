@@ -0,0 +1,105 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * salsa_host.cuh
+ *
+ * @brief SALSA over cache-blocked (segmented) CSRs on the host
+ */
+
+#pragma once
+
+#include <gunrock/segmented_csr.cuh>
+
+namespace gunrock {
+namespace app {
+namespace salsa {
+
+/**
+ * @brief SALSA with the updates of the GPU enactor: two independent
+ * two-step walks,
+ *   hub(u)       = sum over u -> v, w -> v of hub(w) / (in_degree(v) * out_degree(w)),
+ *   authority(v) = sum over u -> v, u -> x of authority(x) / (out_degree(u) * in_degree(x)),
+ * starting from 1 / (vertices with out-edges) and 1 / (vertices with
+ * in-edges). Each walk is two gathers, the inner one summed per middle
+ * vertex before it is divided by that vertex's degree.
+ *
+ * @param[in] in_edges Segmented CSR of the graph built with reverse = true.
+ * @param[in] out_edges Segmented CSR of the graph built with reverse = false.
+ * @param[in] out_degrees Out-degree of each vertex.
+ * @param[in] in_degrees In-degree of each vertex.
+ * @param[out] hrank Hub rank of each vertex.
+ * @param[out] arank Authority rank of each vertex.
+ * @param[in] max_iteration Number of iterations; like the enactor, at
+ * least one is run.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+void HostSALSA(
+    const SegmentedCsr<VertexId, SizeT, Value> &in_edges,
+    const SegmentedCsr<VertexId, SizeT, Value> &out_edges,
+    const SizeT                                *out_degrees,
+    const SizeT                                *in_degrees,
+    Value                                      *hrank,
+    Value                                      *arank,
+    SizeT                                       max_iteration)
+{
+    SizeT  nodes  = in_edges.nodes;
+    Value *shares = (Value*) malloc(sizeof(Value) * nodes);
+    Value *sums   = (Value*) malloc(sizeof(Value) * nodes);
+    SizeT  out_nodes = 0, in_nodes = 0;
+    #pragma omp parallel for reduction(+:out_nodes, in_nodes)
+    for (SizeT v = 0; v < nodes; v++)
+    {
+        if (out_degrees[v] != 0) out_nodes ++;
+        if (in_degrees [v] != 0) in_nodes  ++;
+    }
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < nodes; v++)
+    {
+        hrank[v] = out_nodes == 0 ? 0 : (Value)1.0 / out_nodes;
+        arank[v] = in_nodes  == 0 ? 0 : (Value)1.0 / in_nodes ;
+    }
+
+    SizeT iteration = 0;
+    do {
+        // hub: back over the in-edges of the middle vertex, then to the source
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            shares[v] = out_degrees[v] == 0 ? 0 : hrank[v] / out_degrees[v];
+        in_edges .Gather(shares, sums);
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            shares[v] = in_degrees [v] == 0 ? 0 : sums [v] / in_degrees [v];
+        out_edges.Gather(shares, hrank);
+
+        // authority: forward over the out-edges of the middle vertex
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            shares[v] = in_degrees [v] == 0 ? 0 : arank[v] / in_degrees [v];
+        out_edges.Gather(shares, sums);
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            shares[v] = out_degrees[v] == 0 ? 0 : sums [v] / out_degrees[v];
+        in_edges .Gather(shares, arank);
+        iteration ++;
+    } while (iteration < max_iteration);
+
+    free(shares); shares = NULL;
+    free(sums  ); sums   = NULL;
+}
+
+} // namespace salsa
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
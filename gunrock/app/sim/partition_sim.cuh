@@ -0,0 +1,553 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * partition_sim.cuh
+ *
+ * @brief Host-side discrete-event simulator for multi-partition execution
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <queue>
+#include <string>
+#include <algorithm>
+
+#include <gunrock/csr.cuh>
+#include <gunrock/util/basic_utils.h>
+#include <gunrock/util/types.cuh>
+#include <gunrock/util/json_spirit_writer_template.h>
+
+namespace gunrock {
+namespace app {
+namespace sim {
+
+/**
+ * @brief Cost model used by the simulator. All times are in microseconds,
+ * rates are per microsecond.
+ */
+struct SimParameters
+{
+    double compute_rate      ; // edges visited per us per partition
+    double vertex_rate       ; // frontier vertices processed per us
+    double iteration_overhead; // fixed per-iteration cost (kernel launches)
+    double link_bandwidth    ; // bytes per us on one peer link
+    double link_latency      ; // setup cost of one peer transfer
+    bool   shared_bus        ; // all transfers share a single link
+    int    bytes_per_vertex  ; // vertex id plus associated values
+    float  communicate_multipy; // scales transfer volume, as in the enactor
+    double communicate_latency; // extra cost per transfer
+    double expand_latency    ; // extra cost per received sub-queue
+    double subqueue_latency  ; // extra cost per sub-queue iteration
+    double fullqueue_latency ; // extra cost per full-queue iteration
+    double makeout_latency   ; // extra cost to build outgoing frontiers
+
+    SimParameters() :
+        compute_rate      (1000.0),
+        vertex_rate       (4000.0),
+        iteration_overhead(  20.0),
+        link_bandwidth    (10000.0),
+        link_latency      (  10.0),
+        shared_bus        (false ),
+        bytes_per_vertex  (   4  ),
+        communicate_multipy( -1.0f),
+        communicate_latency(  0.0),
+        expand_latency    (   0.0),
+        subqueue_latency  (   0.0),
+        fullqueue_latency (   0.0),
+        makeout_latency   (   0.0)
+    {
+    }
+
+    /**
+     * @brief Picks up the latency knobs from an Info object. The enactor
+     * counts them in load-kernel repeats; here each repeat is taken as
+     * repeat_us microseconds.
+     *
+     * @param[in] info json_spirit::mObject of a util::Info.
+     * @param[in] repeat_us Microseconds per latency repeat.
+     */
+    void FromInfo(json_spirit::mObject &info, double repeat_us = 1.0)
+    {
+        communicate_latency = info["communicate_latency"].get_int() * repeat_us;
+        communicate_multipy = info["communicate_multipy"].get_real();
+        expand_latency      = info["expand_latency"     ].get_int() * repeat_us;
+        subqueue_latency    = info["subqueue_latency"   ].get_int() * repeat_us;
+        fullqueue_latency   = info["fullqueue_latency"  ].get_int() * repeat_us;
+        makeout_latency     = info["makeout_latency"    ].get_int() * repeat_us;
+    }
+};
+
+/**
+ * @brief Work and traffic of one super-step, per partition.
+ *
+ * @tparam SizeT
+ */
+template <typename SizeT>
+struct SimIteration
+{
+    std::vector<SizeT> vertices; // frontier vertices owned by each partition
+    std::vector<SizeT> edges   ; // edges expanded by each partition
+    std::vector<SizeT> messages; // [sender * num_parts + receiver] vertices sent
+    std::vector<SizeT> message_edges; // out-degree sum of the vertices sent
+
+    void Init(int num_parts)
+    {
+        vertices     .assign(num_parts, 0);
+        edges        .assign(num_parts, 0);
+        messages     .assign(num_parts * num_parts, 0);
+        message_edges.assign(num_parts * num_parts, 0);
+    }
+};
+
+/**
+ * @brief Per-iteration profile of a traversal, split by partition.
+ *
+ * @tparam VertexId
+ * @tparam SizeT
+ * @tparam Value
+ */
+template <
+    typename VertexId,
+    typename SizeT,
+    typename Value>
+struct SimTrace
+{
+    typedef Csr<VertexId, SizeT, Value> GraphT;
+
+    int num_parts;
+    std::vector<SimIteration<SizeT> > iterations;
+
+    SimTrace() : num_parts(0) {}
+
+    SizeT TotalMessages() const
+    {
+        SizeT total = 0;
+        for (size_t i = 0; i < iterations.size(); i++)
+        for (size_t j = 0; j < iterations[i].messages.size(); j++)
+            total += iterations[i].messages[j];
+        return total;
+    }
+
+    /**
+     * @brief Replays a level-synchronous BFS from src. A partition sends a
+     * vertex to its owner whenever it discovers it, once per iteration.
+     *
+     * @param[in] graph Input graph.
+     * @param[in] partition_table Owner of each vertex.
+     * @param[in] num_parts Number of partitions.
+     * @param[in] src Source vertex.
+     */
+    void FromBFS(
+        const GraphT &graph,
+        const int    *partition_table,
+        int           num_parts,
+        VertexId      src)
+    {
+        this->num_parts = num_parts;
+        iterations.clear();
+        std::vector<VertexId> labels(graph.nodes, util::InvalidValue<VertexId>());
+        std::vector<long long> marker(graph.nodes, -1);
+        std::vector<VertexId> frontier, next_frontier;
+        VertexId level = 0;
+
+        labels[src] = 0;
+        frontier.push_back(src);
+        while (!frontier.empty())
+        {
+            SimIteration<SizeT> iteration;
+            iteration.Init(num_parts);
+            next_frontier.clear();
+
+            for (size_t i = 0; i < frontier.size(); i++)
+            {
+                VertexId v = frontier[i];
+                for (SizeT e = graph.row_offsets[v]; e < graph.row_offsets[v+1]; e++)
+                {
+                    VertexId u = graph.column_indices[e];
+                    if (labels[u] != util::InvalidValue<VertexId>()) continue;
+                    labels[u] = level + 1;
+                    next_frontier.push_back(u);
+                }
+            }
+
+            // group the frontier by owner so the per-sender marker works
+            std::vector<std::vector<VertexId> > owned(num_parts);
+            for (size_t i = 0; i < frontier.size(); i++)
+                owned[partition_table[frontier[i]]].push_back(frontier[i]);
+
+            for (int p = 0; p < num_parts; p++)
+            {
+                long long stamp = (long long)level * num_parts + p;
+                for (size_t i = 0; i < owned[p].size(); i++)
+                {
+                    VertexId v = owned[p][i];
+                    iteration.vertices[p] ++;
+                    iteration.edges   [p] += graph.row_offsets[v+1] - graph.row_offsets[v];
+                    for (SizeT e = graph.row_offsets[v]; e < graph.row_offsets[v+1]; e++)
+                    {
+                        VertexId u = graph.column_indices[e];
+                        int q = partition_table[u];
+                        if (q == p || labels[u] != level + 1 || marker[u] == stamp)
+                            continue;
+                        marker[u] = stamp;
+                        iteration.messages     [p * num_parts + q] ++;
+                        iteration.message_edges[p * num_parts + q] +=
+                            graph.row_offsets[u+1] - graph.row_offsets[u];
+                    }
+                }
+            }
+            iterations.push_back(iteration);
+            frontier.swap(next_frontier);
+            level ++;
+        }
+    }
+
+    /**
+     * @brief Replays a frontier-based Bellman-Ford SSSP from src, the way
+     * the SSSP enactor advances: each iteration relaxes the out-edges of
+     * vertices whose distance improved in the previous one.
+     *
+     * @param[in] graph Input graph, unit weights if edge_values is NULL.
+     * @param[in] partition_table Owner of each vertex.
+     * @param[in] num_parts Number of partitions.
+     * @param[in] src Source vertex.
+     */
+    void FromSSSP(
+        const GraphT &graph,
+        const int    *partition_table,
+        int           num_parts,
+        VertexId      src)
+    {
+        this->num_parts = num_parts;
+        iterations.clear();
+        std::vector<Value    > distances(graph.nodes, util::MaxValue<Value>());
+        std::vector<long long> in_next  (graph.nodes, -1);
+        std::vector<long long> marker   (graph.nodes, -1);
+        std::vector<VertexId > frontier, next_frontier;
+        long long iter = 0;
+
+        distances[src] = 0;
+        frontier.push_back(src);
+        while (!frontier.empty())
+        {
+            SimIteration<SizeT> iteration;
+            iteration.Init(num_parts);
+            next_frontier.clear();
+
+            // group the frontier by owner so the per-sender marker works
+            std::vector<std::vector<VertexId> > owned(num_parts);
+            for (size_t i = 0; i < frontier.size(); i++)
+                owned[partition_table[frontier[i]]].push_back(frontier[i]);
+
+            for (int p = 0; p < num_parts; p++)
+            {
+                long long stamp = iter * num_parts + p;
+                for (size_t i = 0; i < owned[p].size(); i++)
+                {
+                    VertexId v = owned[p][i];
+                    iteration.vertices[p] ++;
+                    iteration.edges   [p] += graph.row_offsets[v+1] - graph.row_offsets[v];
+                    for (SizeT e = graph.row_offsets[v]; e < graph.row_offsets[v+1]; e++)
+                    {
+                        VertexId u = graph.column_indices[e];
+                        Value weight = graph.edge_values == NULL ? 1 : graph.edge_values[e];
+                        Value new_distance = distances[v] + weight;
+                        if (new_distance >= distances[u]) continue;
+                        distances[u] = new_distance;
+                        if (in_next[u] != iter)
+                        {
+                            in_next[u] = iter;
+                            next_frontier.push_back(u);
+                        }
+                        int q = partition_table[u];
+                        if (q != p && marker[u] != stamp)
+                        {
+                            marker[u] = stamp;
+                            iteration.messages     [p * num_parts + q] ++;
+                            iteration.message_edges[p * num_parts + q] +=
+                                graph.row_offsets[u+1] - graph.row_offsets[u];
+                        }
+                    }
+                }
+            }
+            iterations.push_back(iteration);
+            frontier.swap(next_frontier);
+            iter ++;
+        }
+    }
+
+    /**
+     * @brief Builds a fixed trace for all-active primitives (e.g. PageRank),
+     * where every iteration touches all local vertices and pushes every
+     * remote copy back to its owner. Volumes come straight from the
+     * partitioner's counters.
+     *
+     * @param[in] sub_graphs Partitioned sub-graphs.
+     * @param[in] out_counter Partitioner out_counter, local peer indexing.
+     * @param[in] num_parts Number of partitions.
+     * @param[in] num_iterations Number of iterations to replay.
+     */
+    void FromCounters(
+        const GraphT *sub_graphs,
+        SizeT       **out_counter,
+        int           num_parts,
+        int           num_iterations)
+    {
+        this->num_parts = num_parts;
+        iterations.clear();
+        SimIteration<SizeT> iteration;
+        iteration.Init(num_parts);
+        for (int p = 0; p < num_parts; p++)
+        {
+            iteration.vertices[p] = out_counter[p][0];
+            iteration.edges   [p] = sub_graphs[p].edges;
+            for (int q = 0; q < num_parts; q++)
+            {
+                if (q == p) continue;
+                int q_ = q < p ? q + 1 : q;
+                iteration.messages[p * num_parts + q] = out_counter[p][q_];
+            }
+        }
+        iterations.assign(num_iterations, iteration);
+    }
+};
+
+/**
+ * @brief Simulation output.
+ */
+struct SimResult
+{
+    double              makespan;
+    int                 num_iterations;
+    long long           total_bytes;
+    std::vector<double> busy_time;   // compute and expand time per partition
+    std::vector<double> idle_time;   // makespan minus busy time
+    std::vector<double> comm_time;   // time spent pushing to peers
+    std::vector<double> finish_time; // when each partition left its loop
+
+    /**
+     * @brief Stores the result into a json_spirit::mObject, e.g. Info::info.
+     *
+     * @param[in] info Object to write into.
+     * @param[in] prefix Key prefix.
+     */
+    void ToJson(json_spirit::mObject &info, std::string prefix = "sim_")
+    {
+        json_spirit::mArray busy, idle, comm;
+        for (size_t p = 0; p < busy_time.size(); p++)
+        {
+            busy.push_back(busy_time[p]);
+            idle.push_back(idle_time[p]);
+            comm.push_back(comm_time[p]);
+        }
+        info[prefix + "makespan"      ] = makespan;
+        info[prefix + "iterations"    ] = num_iterations;
+        info[prefix + "total_bytes"   ] = (int64_t)total_bytes;
+        info[prefix + "busy_time"     ] = busy;
+        info[prefix + "idle_time"     ] = idle;
+        info[prefix + "comm_time"     ] = comm;
+    }
+
+    void Print(const char *name = "")
+    {
+        printf("%s makespan = %.3f us, %d iterations, %lld bytes exchanged\n",
+            name, makespan, num_iterations, total_bytes);
+        for (size_t p = 0; p < busy_time.size(); p++)
+            printf("  partition %d: busy = %.3f us, comm = %.3f us, idle = %.3f us (%.1f%%)\n",
+                (int)p, busy_time[p], comm_time[p], idle_time[p],
+                makespan > 0 ? idle_time[p] * 100.0 / makespan : 0.0);
+    }
+};
+
+/**
+ * @brief Discrete-event simulator. Each partition runs the enactor loop:
+ * compute its frontier, push one sub-queue to every peer, then wait for
+ * all peers' sub-queues of the same iteration before expanding them and
+ * starting the next one. Transfers from one partition are serialized on
+ * its outgoing link (or on one bus for all partitions if shared_bus).
+ */
+class Simulator
+{
+    enum EventType
+    {
+        COMPUTE_DONE = 0,
+        ARRIVAL      = 1,
+    };
+
+    struct Event
+    {
+        double time;
+        int    type;
+        int    part;
+        int    iteration;
+        int    sender;
+        long long seq;
+
+        bool operator<(const Event &rhs) const
+        {
+            // std::priority_queue is a max-heap; earliest time first,
+            // then insertion order for determinism
+            if (time != rhs.time) return time > rhs.time;
+            return seq > rhs.seq;
+        }
+    };
+
+    SimParameters                parameters;
+    std::priority_queue<Event>   events;
+    long long                    event_counter;
+
+    void Push(double time, int type, int part, int iteration, int sender = -1)
+    {
+        Event event;
+        event.time      = time;
+        event.type      = type;
+        event.part      = part;
+        event.iteration = iteration;
+        event.sender    = sender;
+        event.seq       = event_counter ++;
+        events.push(event);
+    }
+
+public:
+    Simulator(const SimParameters &parameters) :
+        parameters   (parameters),
+        event_counter(0)
+    {
+    }
+
+    /**
+     * @brief Runs the simulation over a trace.
+     *
+     * @param[in] trace Per-iteration profile, e.g. from SimTrace::FromBFS.
+     * @param[out] result Predicted makespan and per-partition times.
+     */
+    template <typename VertexId, typename SizeT, typename Value>
+    void Run(
+        const SimTrace<VertexId, SizeT, Value> &trace,
+        SimResult &result)
+    {
+        const SimParameters &P = parameters;
+        int num_parts      = trace.num_parts;
+        int num_iterations = trace.iterations.size();
+        // a peer can run at most one iteration ahead (it needs our
+        // sub-queue of the current one), so arrivals are kept per parity
+        std::vector<int   > arrived       (num_parts * 2, 0);
+        std::vector<double> last_arrival  (num_parts * 2, 0);
+        std::vector<double> pending_expand(num_parts * 2, 0);
+        std::vector<int   > current       (num_parts, 0);
+        std::vector<double> compute_done  (num_parts, 0);
+        std::vector<bool  > computed      (num_parts, false);
+        std::vector<double> link_free     (num_parts, 0);
+        double bus_free = 0;
+        double volume_scale = P.communicate_multipy > 0 ? P.communicate_multipy : 1.0;
+
+        result.makespan       = 0;
+        result.num_iterations = num_iterations;
+        result.total_bytes    = 0;
+        result.busy_time  .assign(num_parts, 0);
+        result.idle_time  .assign(num_parts, 0);
+        result.comm_time  .assign(num_parts, 0);
+        result.finish_time.assign(num_parts, 0);
+        while (!events.empty()) events.pop();
+        if (num_iterations == 0 || num_parts == 0) return;
+
+        // iteration 0 starts on every partition at time 0
+        for (int p = 0; p < num_parts; p++)
+        {
+            double cost = ComputeCost(trace.iterations[0], p, num_parts);
+            result.busy_time[p] += cost;
+            Push(cost, COMPUTE_DONE, p, 0);
+        }
+
+        while (!events.empty())
+        {
+            Event event = events.top(); events.pop();
+            int p = event.part;
+            const SimIteration<SizeT> &it = trace.iterations[event.iteration];
+
+            if (event.type == COMPUTE_DONE)
+            {
+                computed    [p] = true;
+                compute_done[p] = event.time;
+                for (int q = 0; q < num_parts && num_parts > 1; q++)
+                {
+                    if (q == p) continue;
+                    long long bytes = (long long)(it.messages[p * num_parts + q]
+                        * volume_scale * P.bytes_per_vertex);
+                    double duration = P.link_latency + P.communicate_latency
+                        + bytes / P.link_bandwidth;
+                    double &free_at = P.shared_bus ? bus_free : link_free[p];
+                    double start = std::max(event.time, free_at);
+                    free_at = start + duration;
+                    result.comm_time[p] += duration;
+                    result.total_bytes  += bytes;
+                    Push(start + duration, ARRIVAL, q, event.iteration, p);
+                }
+            } else { // ARRIVAL
+                int slot = p * 2 + (event.iteration & 1);
+                arrived     [slot] ++;
+                last_arrival[slot] = std::max(last_arrival[slot], event.time);
+                pending_expand[slot] += P.expand_latency
+                    + it.messages[event.sender * num_parts + p] * volume_scale / P.vertex_rate;
+            }
+
+            int iteration = current[p];
+            int slot = p * 2 + (iteration & 1);
+            if (!computed[p] || arrived[slot] < num_parts - 1) continue;
+
+            // all sub-queues of this iteration are in; expand and move on
+            double ready = std::max(compute_done[p], last_arrival[slot])
+                + pending_expand[slot];
+            result.busy_time[p] += pending_expand[slot];
+            computed      [p   ] = false;
+            arrived       [slot] = 0;
+            last_arrival  [slot] = 0;
+            pending_expand[slot] = 0;
+            current       [p   ] ++;
+            if (iteration + 1 >= num_iterations)
+            {
+                result.finish_time[p] = ready;
+                result.makespan = std::max(result.makespan, ready);
+                continue;
+            }
+            double cost = ComputeCost(trace.iterations[iteration + 1], p, num_parts);
+            result.busy_time[p] += cost;
+            Push(ready + cost, COMPUTE_DONE, p, iteration + 1);
+        }
+
+        for (int p = 0; p < num_parts; p++)
+            result.idle_time[p] = result.makespan - result.busy_time[p];
+    }
+
+private:
+    template <typename SizeT>
+    double ComputeCost(const SimIteration<SizeT> &it, int p, int num_parts)
+    {
+        const SimParameters &P = parameters;
+        double cost = P.iteration_overhead + P.fullqueue_latency
+            + it.vertices[p] / P.vertex_rate
+            + it.edges   [p] / P.compute_rate;
+        if (num_parts > 1)
+            cost += P.subqueue_latency + P.makeout_latency;
+        return cost;
+    }
+};
+
+} // namespace sim
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
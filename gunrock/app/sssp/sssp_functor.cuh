@@ -70,8 +70,11 @@ struct SSSPFunctor {
 
         util::io::ModifiedLoad<Problem::COLUMN_READ_MODIFIER>::Ld(
             pred_distance, d_data_slice->distances + s_id);
-        util::io::ModifiedLoad<Problem::COLUMN_READ_MODIFIER>::Ld(
-            edge_weight, d_data_slice->weights + edge_id);
+        if (d_data_slice->weight_codec.type == util::QUANTIZED_NONE)
+            util::io::ModifiedLoad<Problem::COLUMN_READ_MODIFIER>::Ld(
+                edge_weight, d_data_slice->weights + edge_id);
+        else edge_weight = d_data_slice->weight_codec.template Decode<Value>(
+            d_data_slice->weight_codes.GetPointer(util::DEVICE), edge_id);
         Value new_distance = pred_distance + edge_weight;
 
         // Check if the destination node has been claimed as someone's child
@@ -0,0 +1,105 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * sssp_host.cuh
+ *
+ * @brief Single-source shortest path on the host
+ */
+
+#pragma once
+
+#include <queue>
+#include <vector>
+#include <functional>
+#include <gunrock/csr.cuh>
+#include <gunrock/util/types.cuh>
+
+namespace gunrock {
+namespace app {
+namespace sssp {
+
+/**
+ * @brief Dijkstra with a binary heap and lazy deletion. Sequential; run
+ * several sources in parallel with HostMultiSourceSSSP.
+ *
+ * @param[in] graph Graph with non-negative edge values, full or narrow.
+ * @param[in] src Source vertex.
+ * @param[out] distances Distance of each vertex, MaxValue if unreached.
+ * @param[out] preds Predecessor of each vertex, -1 for none; may be NULL.
+ *
+ * \return Number of vertices reached.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+SizeT HostSSSP(
+    const Csr<VertexId, SizeT, Value> &graph,
+    VertexId                           src,
+    Value                             *distances,
+    VertexId                          *preds = NULL)
+{
+    typedef std::pair<Value, VertexId> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > heap;
+    SizeT num_reached = 0;
+
+    for (SizeT v = 0; v < graph.nodes; v++)
+    {
+        distances[v] = util::MaxValue<Value>();
+        if (preds != NULL) preds[v] = -1;
+    }
+    distances[src] = 0;
+    heap.push(Entry(0, src));
+
+    while (!heap.empty())
+    {
+        Entry top = heap.top();
+        heap.pop();
+        VertexId u = top.second;
+        if (top.first > distances[u]) continue;  // stale entry
+        num_reached ++;
+        for (SizeT e = graph.row_offsets[u]; e < graph.row_offsets[u+1]; e++)
+        {
+            VertexId v        = graph.column_indices[e];
+            Value    distance = distances[u] + graph.EdgeValue(e);
+            if (distance >= distances[v]) continue;
+            distances[v] = distance;
+            if (preds != NULL) preds[v] = u;
+            heap.push(Entry(distance, v));
+        }
+    }
+    return num_reached;
+}
+
+/**
+ * @brief HostSSSP from several sources, one source per thread.
+ *
+ * @param[in] graph Graph with non-negative edge values.
+ * @param[in] sources Source vertices.
+ * @param[in] num_sources Number of sources.
+ * @param[out] distances distances[i * nodes + v] from source i.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+void HostMultiSourceSSSP(
+    const Csr<VertexId, SizeT, Value> &graph,
+    const VertexId                    *sources,
+    int                                num_sources,
+    Value                             *distances)
+{
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int i = 0; i < num_sources; i++)
+        HostSSSP(graph, sources[i], distances + (SizeT)i * graph.nodes);
+}
+
+} // namespace sssp
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -65,6 +65,8 @@ struct SSSPProblem : ProblemBase<VertexId, SizeT, Value,
         // device storage arrays
         util::Array1D<SizeT, Value       >    distances  ;     /**< Used for source distance */
         util::Array1D<SizeT, Value       >    weights    ;     /**< Used for storing edge weights */
+        util::Array1D<SizeT, unsigned char>   weight_codes;    /**< Narrow edge weights, used instead of weights */
+        util::QuantizedValueCodec             weight_codec;    /**< Decoder of weight_codes, type QUANTIZED_NONE if unused */
         //util::Array1D<SizeT, VertexId    >    visit_lookup;    /**< Used for check duplicate */
         //util::Array1D<SizeT, float       >    delta;
         //util::Array1D<SizeT, int         >    sssp_marker;
@@ -77,6 +79,7 @@ struct SSSPProblem : ProblemBase<VertexId, SizeT, Value,
         {
             distances       .SetName("distances"       );
             weights         .SetName("weights"         );
+            weight_codes    .SetName("weight_codes"    );
             original_vertex .SetName("original_vertex" );
             //visit_lookup    .SetName("visit_lookup"    );
             //delta           .SetName("delta"           );
@@ -98,6 +101,7 @@ struct SSSPProblem : ProblemBase<VertexId, SizeT, Value,
             if (retval = BaseDataSlice::Release()) return retval;
             if (retval = distances     .Release()) return retval;
             if (retval = weights       .Release()) return retval;
+            if (retval = weight_codes  .Release()) return retval;
             //if (retval = visit_lookup  .Release()) return retval;
             //if (retval = delta         .Release()) return retval;
             //if (retval = sssp_marker   .Release()) return retval;
@@ -105,10 +109,10 @@ struct SSSPProblem : ProblemBase<VertexId, SizeT, Value,
             return retval;
         }
 
-        bool HasNegativeValue(Value* vals, size_t len)
+        bool HasNegativeValue(Csr<VertexId, SizeT, Value> *graph)
         {
-            for (int i = 0; i < len; ++i)
-                if (vals[i] < 0.0) return true;
+            for (SizeT i = 0; i < graph->edges; ++i)
+                if (graph->EdgeValue(i) < 0.0) return true;
             return false;
         }
 
@@ -147,7 +151,7 @@ struct SSSPProblem : ProblemBase<VertexId, SizeT, Value,
             cudaError_t retval  = cudaSuccess;
 
             // Check if there are negative weights.
-            if (HasNegativeValue(graph->edge_values, graph->edges)) {
+            if (HasNegativeValue(graph)) {
                 GRError(gunrock::util::GR_UNSUPPORTED_INPUT_DATA,
                         "Contains edges with negative weights. Dijkstra's algorithm"
                         "doesn't support the input data.",
@@ -166,11 +170,21 @@ struct SSSPProblem : ProblemBase<VertexId, SizeT, Value,
                 skip_makeout_selection)) return retval;
 
             if (retval = distances   .Allocate(graph->nodes, util::DEVICE)) return retval;
-            if (retval = weights     .Allocate(graph->edges, util::DEVICE)) return retval;
             if (retval = this->labels.Allocate(graph->nodes, util::DEVICE)) return retval;
 
-            weights.SetPointer(graph->edge_values, graph->edges, util::HOST);
-            if (retval = weights.Move(util::HOST, util::DEVICE)) return retval;
+            if (graph->edge_values == NULL && graph->edge_value_codes != NULL)
+            {
+                // narrow weights stay narrow on the device, decoded by the functor
+                SizeT code_bytes = graph->edge_value_codec.CodeBytes(graph->edges);
+                weight_codec = graph->edge_value_codec;
+                if (retval = weight_codes.Allocate(code_bytes, util::DEVICE)) return retval;
+                weight_codes.SetPointer(graph->edge_value_codes, code_bytes, util::HOST);
+                if (retval = weight_codes.Move(util::HOST, util::DEVICE)) return retval;
+            } else {
+                if (retval = weights .Allocate(graph->edges, util::DEVICE)) return retval;
+                weights.SetPointer(graph->edge_values, graph->edges, util::HOST);
+                if (retval = weights.Move(util::HOST, util::DEVICE)) return retval;
+            }
 
 
             if (MARK_PATHS)
@@ -0,0 +1,128 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * tc_host.cuh
+ *
+ * @brief Per-edge triangle support on the host, over an edge list or the
+ * CSR
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <gunrock/csr.cuh>
+#include <gunrock/edge_list.cuh>
+#include <gunrock/util/simd_utils.cuh>
+
+namespace gunrock {
+namespace app {
+namespace tc {
+
+/**
+ * @brief Counts the common neighbours of each edge's end points.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+struct SupportOp
+{
+    const Csr<VertexId, SizeT, Value> *graph;
+    SizeT                             *supports;
+
+    void operator()(SizeT e, VertexId from, VertexId to)
+    {
+        const SizeT *row_offsets = graph -> row_offsets;
+        supports[e] = util::simd::IntersectCount(
+            graph -> column_indices + row_offsets[from],
+            row_offsets[from + 1] - row_offsets[from],
+            graph -> column_indices + row_offsets[to],
+            row_offsets[to + 1] - row_offsets[to]);
+    }
+};
+
+/**
+ * @brief Triangle support of every edge, i.e. the number of triangles the
+ * edge is in, the basis of k-truss decomposition.
+ *
+ * @param[in] graph Symmetric CSR graph with sorted, duplicate-free neighbor
+ * lists.
+ * @param[in] edge_list Edge list of the same graph.
+ * @param[out] supports Support of each edge, in edge_list order.
+ *
+ * \return Number of triangles in the graph.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+long long HostTriangleSupport(
+    const Csr     <VertexId, SizeT, Value> &graph,
+    const EdgeList<VertexId, SizeT, Value> &edge_list,
+    SizeT                                  *supports)
+{
+    SupportOp<VertexId, SizeT, Value> support_op;
+    support_op.graph    = &graph;
+    support_op.supports = supports;
+    edge_list.ForAllEdges(support_op);
+
+    long long total = 0;
+    #pragma omp parallel for reduction(+:total)
+    for (SizeT e = 0; e < edge_list.edges; e++)
+        total += supports[e];
+    // each triangle is seen from its 3 edges in both directions
+    return total / 6;
+}
+
+/**
+ * @brief Triangle support of every edge of the CSR, in CSR order. An edge
+ * and its reverse have the same support, so with the reverse edge map
+ * only the edges from the smaller end are intersected, and each result is
+ * copied to the reverse edge.
+ *
+ * @param[in] graph Symmetric CSR graph with sorted, duplicate-free neighbor
+ * lists, and reverse_edges if built.
+ * @param[out] supports Support of each edge, by CSR edge id.
+ *
+ * \return Number of triangles in the graph.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+long long HostCsrTriangleSupport(
+    const Csr<VertexId, SizeT, Value> &graph,
+    SizeT                             *supports)
+{
+    const SizeT    *row_offsets    = graph.row_offsets;
+    const VertexId *column_indices = graph.column_indices;
+    const SizeT    *reverse_edges  = graph.reverse_edges;
+
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (SizeT u = 0; u < graph.nodes; u++)
+    {
+        for (SizeT e = row_offsets[u]; e < row_offsets[u + 1]; e++)
+        {
+            VertexId v = column_indices[e];
+            SizeT    r = (reverse_edges == NULL) ? -1 : reverse_edges[e];
+            if (r != -1 && v < u) continue;  // done from v's side
+            supports[e] = util::simd::IntersectCount(
+                column_indices + row_offsets[u], row_offsets[u + 1] - row_offsets[u],
+                column_indices + row_offsets[v], row_offsets[v + 1] - row_offsets[v]);
+            if (r != -1) supports[r] = supports[e];
+        }
+    }
+
+    long long total = 0;
+    #pragma omp parallel for reduction(+:total)
+    for (SizeT e = 0; e < graph.edges; e++)
+        total += supports[e];
+    return total / 6;
+}
+
+} // namespace tc
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
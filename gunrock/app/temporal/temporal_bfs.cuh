@@ -0,0 +1,203 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * temporal_bfs.cuh
+ *
+ * @brief Traversals of a temporal CSR on the host, restricted to a time
+ * window: BFS over the edges of the window, and time-respecting BFS
+ * giving the earliest arrival time at every vertex
+ */
+
+#pragma once
+
+#include <string.h>
+#include <queue>
+#include <vector>
+#include <functional>
+#include <omp.h>
+
+#include <gunrock/temporal_csr.cuh>
+#include <gunrock/util/types.cuh>
+#include <gunrock/util/simd_utils.cuh>
+
+namespace gunrock {
+namespace app {
+namespace temporal {
+
+/**
+ * @brief Level-synchronous BFS over the edges with timestamps in [t0, t1],
+ * ignoring their order in time. Each row's window is found by binary
+ * search, so no per-window graph is built, and is a contiguous slice of
+ * column_indices, which a SIMD test-and-set against the visited bitmap
+ * turns into the next frontier in one pass.
+ *
+ * @param[in] graph Temporal graph.
+ * @param[in] src Source vertex.
+ * @param[in] t0 Window start, inclusive.
+ * @param[in] t1 Window end, inclusive.
+ * @param[out] labels Search depth of each vertex, -1 if unreached.
+ *
+ * \return Number of levels expanded.
+ */
+template <typename VertexId, typename SizeT, typename Value, typename Time>
+VertexId HostWindowBFS(
+    const TemporalCsr<VertexId, SizeT, Value, Time> &graph,
+    VertexId  src,
+    Time      t0,
+    Time      t1,
+    VertexId *labels)
+{
+    SizeT         bitmap_size   = (graph.nodes + 31) / 32;
+    unsigned int *visited       = (unsigned int*) malloc(sizeof(unsigned int) * bitmap_size);
+    VertexId     *frontier      = (VertexId*) malloc(sizeof(VertexId) * graph.nodes);
+    VertexId     *next_frontier = (VertexId*) malloc(sizeof(VertexId) * graph.nodes);
+
+    #pragma omp parallel for
+    for (SizeT v = 0; v < graph.nodes; v++)
+        labels[v] = -1;
+    memset(visited, 0, sizeof(unsigned int) * bitmap_size);
+    visited[src >> 5] |= 1u << (src & 31);
+    labels[src] = 0;
+    frontier[0] = src;
+    SizeT    frontier_size = 1;
+    VertexId depth = 0;
+
+    while (frontier_size > 0)
+    {
+        SizeT next_size = 0;
+        for (SizeT i = 0; i < frontier_size; i++)
+        {
+            SizeT begin, end;
+            graph.WindowRange(frontier[i], t0, t1, begin, end);
+            next_size += util::simd::TestAndSet(graph.column_indices + begin,
+                end - begin, visited, next_frontier + next_size);
+        }
+
+        #pragma omp parallel for
+        for (SizeT i = 0; i < next_size; i++)
+            labels[next_frontier[i]] = depth + 1;
+        VertexId *temp = frontier; frontier = next_frontier; next_frontier = temp;
+        frontier_size = next_size;
+        depth ++;
+    }
+
+    free(visited      ); visited       = NULL;
+    free(frontier     ); frontier      = NULL;
+    free(next_frontier); next_frontier = NULL;
+    return depth;
+}
+
+/**
+ * @brief Time-respecting BFS: earliest arrival at every vertex leaving src
+ * at t0. An edge (u, v, t) can be taken once u is reached, i.e. when
+ * arrival[u] <= t, and lands at v at t plus its duration, which must not
+ * be after t1. Vertices are settled in order of arrival as in Dijkstra;
+ * the rows being sorted by time, the edges usable from a settled vertex
+ * start at a binary search for its arrival, and every edge is looked at
+ * once.
+ *
+ * @param[in] graph Temporal graph.
+ * @param[in] src Source vertex.
+ * @param[in] t0 Window start, the departure time from src.
+ * @param[in] t1 Window end, the latest arrival.
+ * @param[out] arrivals Earliest arrival of each vertex, MaxValue if unreached.
+ * @param[out] preds Predecessor on an earliest path, -1 for none; may be NULL.
+ * @param[in] use_durations Edge values are durations; otherwise traversals
+ * are instantaneous.
+ *
+ * \return Number of vertices reached.
+ */
+template <typename VertexId, typename SizeT, typename Value, typename Time>
+SizeT HostEarliestArrival(
+    const TemporalCsr<VertexId, SizeT, Value, Time> &graph,
+    VertexId  src,
+    Time      t0,
+    Time      t1,
+    Time     *arrivals,
+    VertexId *preds = NULL,
+    bool      use_durations = false)
+{
+    typedef std::pair<Time, VertexId> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > heap;
+    SizeT num_reached = 0;
+    use_durations = use_durations && graph.edge_values != NULL;
+
+    for (SizeT v = 0; v < graph.nodes; v++)
+    {
+        arrivals[v] = util::MaxValue<Time>();
+        if (preds != NULL) preds[v] = -1;
+    }
+    arrivals[src] = t0;
+    heap.push(Entry(t0, src));
+
+    while (!heap.empty())
+    {
+        Entry top = heap.top();
+        heap.pop();
+        VertexId u = top.second;
+        if (top.first > arrivals[u]) continue;  // stale entry
+        num_reached ++;
+
+        SizeT begin, end;
+        graph.WindowRange(u, arrivals[u], t1, begin, end);
+        for (SizeT e = begin; e < end; e++)
+        {
+            VertexId v       = graph.column_indices[e];
+            Time     arrival = graph.timestamps[e];
+            if (use_durations)
+            {
+                arrival += (Time)graph.edge_values[e];
+                if (arrival > t1) continue;
+            }
+            if (arrival >= arrivals[v]) continue;
+            arrivals[v] = arrival;
+            if (preds != NULL) preds[v] = u;
+            heap.push(Entry(arrival, v));
+        }
+    }
+    return num_reached;
+}
+
+/**
+ * @brief HostEarliestArrival over several windows, one window per thread,
+ * all on the same temporal CSR.
+ *
+ * @param[in] graph Temporal graph.
+ * @param[in] src Source vertex.
+ * @param[in] t0s Start of each window.
+ * @param[in] t1s End of each window.
+ * @param[in] num_windows Number of windows.
+ * @param[out] arrivals arrivals[i * nodes + v] within window i.
+ * @param[in] use_durations Edge values are durations.
+ */
+template <typename VertexId, typename SizeT, typename Value, typename Time>
+void HostMultiWindowEarliestArrival(
+    const TemporalCsr<VertexId, SizeT, Value, Time> &graph,
+    VertexId    src,
+    const Time *t0s,
+    const Time *t1s,
+    int         num_windows,
+    Time       *arrivals,
+    bool        use_durations = false)
+{
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int i = 0; i < num_windows; i++)
+        HostEarliestArrival(graph, src, t0s[i], t1s[i],
+            arrivals + (SizeT)i * graph.nodes, (VertexId*)NULL, use_durations);
+}
+
+} // namespace temporal
+} // namespace app
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
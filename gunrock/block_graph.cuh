@@ -0,0 +1,881 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * block_graph.cuh
+ *
+ * @brief Out-of-core CSR: the adjacency lives on disk in vertex-range
+ * blocks and is read on demand into an LRU cache with a memory budget,
+ * while the row offsets and all vertex state stay in memory. Blocks are
+ * read by a pool of I/O threads with pread, ahead of their use; only the
+ * blocks holding active vertices are visited.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <omp.h>
+
+#include <gunrock/csr.cuh>
+#include <gunrock/graphio/edge_stream.cuh>
+#include <gunrock/util/json_spirit_writer_template.h>
+
+namespace gunrock {
+
+// Block files start with a 4 KB header, then the row offsets, the first
+// vertex and the file offset of each block (num_blocks + 1 entries each,
+// as unsigned long long), then the blocks, each 4 KB aligned: column
+// indices padded to 8 bytes, followed by the edge values, if any.
+#define GR_BLOCK_MAGIC   0x4b425247  // "GRBK"
+#define GR_BLOCK_VERSION 1
+#define GR_BLOCK_ALIGN   4096
+
+struct BlockGraphHeader
+{
+    unsigned int       magic;
+    unsigned int       version;
+    unsigned int       vertex_id_bytes;
+    unsigned int       size_bytes;
+    unsigned int       value_bytes;       // 0 without edge values
+    unsigned int       reserved;
+    unsigned long long nodes;
+    unsigned long long edges;
+    unsigned long long num_blocks;
+    unsigned long long row_offsets_offset;
+    unsigned long long directory_offset;
+};
+
+/**
+ * @brief I/O counters of a BlockGraph.
+ */
+struct BlockIoStats
+{
+    long long blocks_read;       // blocks read from the file
+    long long bytes_read;
+    long long hits;              // acquired blocks that were in the cache
+    long long misses;            // acquired blocks read on the spot
+    long long prefetches;        // blocks queued for the I/O threads
+    long long prefetch_hits;     // acquired blocks a prefetch had read or
+                                 // was reading
+    long long prefetch_dropped;  // prefetches skipped for lack of room
+    long long evictions;
+    long long over_budget;       // reads that had to exceed the budget
+    double    read_seconds;      // time spent in pread, all threads
+    double    wait_seconds;      // time workers waited for blocks
+
+    BlockIoStats() { Reset(); }
+
+    void Reset()
+    {
+        blocks_read = bytes_read = hits = misses = 0;
+        prefetches = prefetch_hits = prefetch_dropped = 0;
+        evictions = over_budget = 0;
+        read_seconds = wait_seconds = 0;
+    }
+
+    void ToJson(json_spirit::mObject &json) const
+    {
+        json["blocks_read"     ] = (int64_t)blocks_read;
+        json["bytes_read"      ] = (int64_t)bytes_read;
+        json["cache_hits"      ] = (int64_t)hits;
+        json["cache_misses"    ] = (int64_t)misses;
+        json["prefetches"      ] = (int64_t)prefetches;
+        json["prefetch_hits"   ] = (int64_t)prefetch_hits;
+        json["prefetch_dropped"] = (int64_t)prefetch_dropped;
+        json["evictions"       ] = (int64_t)evictions;
+        json["over_budget"     ] = (int64_t)over_budget;
+        json["read_seconds"    ] = read_seconds;
+        json["wait_seconds"    ] = wait_seconds;
+    }
+};
+
+/**
+ * @brief Writes a graph as a block file.
+ *
+ * @param[in] graph Graph; its edge values, full or narrow, are stored at
+ * full width if with_values is set.
+ * @param[in] file_name Output file.
+ * @param[in] block_bytes Target adjacency bytes per block; a block holds
+ * whole neighbor lists, so a hub can make it larger.
+ * @param[in] with_values Whether to store the edge values.
+ *
+ * \return 0 on success, errno otherwise.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+int WriteBlockGraph(
+    const Csr<VertexId, SizeT, Value> &graph,
+    const char                        *file_name,
+    size_t                             block_bytes,
+    bool                               with_values)
+{
+    size_t value_bytes = with_values ? sizeof(Value) : 0;
+    size_t edge_bytes  = sizeof(VertexId) + value_bytes;
+    std::vector<unsigned long long> block_starts, block_offsets;
+
+    // cut the vertex range greedily into blocks of about block_bytes
+    block_starts.push_back(0);
+    for (SizeT v = 0; v < graph.nodes; )
+    {
+        SizeT first = v;
+        while (v < graph.nodes && (v == first ||
+            (size_t)(graph.row_offsets[v+1] - graph.row_offsets[first]) * edge_bytes
+                <= block_bytes))
+            v++;
+        block_starts.push_back(v);
+    }
+    size_t num_blocks = block_starts.size() - 1;
+
+    BlockGraphHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic              = GR_BLOCK_MAGIC;
+    header.version            = GR_BLOCK_VERSION;
+    header.vertex_id_bytes    = sizeof(VertexId);
+    header.size_bytes         = sizeof(SizeT);
+    header.value_bytes        = value_bytes;
+    header.nodes              = graph.nodes;
+    header.edges              = graph.edges;
+    header.num_blocks         = num_blocks;
+    header.row_offsets_offset = GR_BLOCK_ALIGN;
+    header.directory_offset   = GR_BLOCK_ALIGN + sizeof(SizeT) * (graph.nodes + 1);
+
+    unsigned long long offset = header.directory_offset
+        + 2 * sizeof(unsigned long long) * (num_blocks + 1);
+    for (size_t b = 0; b <= num_blocks; b++)
+    {
+        offset = (offset + GR_BLOCK_ALIGN - 1) / GR_BLOCK_ALIGN * GR_BLOCK_ALIGN;
+        block_offsets.push_back(offset);
+        if (b == num_blocks) break;
+        SizeT edges = graph.row_offsets[block_starts[b+1]]
+            - graph.row_offsets[block_starts[b]];
+        offset += (sizeof(VertexId) * edges + 7) / 8 * 8 + value_bytes * edges;
+    }
+
+    FILE *file = fopen(file_name, "wb");
+    if (file == NULL) return errno;
+    char *padding = (char*) calloc(GR_BLOCK_ALIGN, 1);
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(padding, GR_BLOCK_ALIGN - sizeof(header), 1, file);
+    fwrite(graph.row_offsets, sizeof(SizeT), graph.nodes + 1, file);
+    fwrite(&block_starts [0], sizeof(unsigned long long), num_blocks + 1, file);
+    fwrite(&block_offsets[0], sizeof(unsigned long long), num_blocks + 1, file);
+
+    std::vector<VertexId> columns;
+    std::vector<Value>    values;
+    for (size_t b = 0; b < num_blocks; b++)
+    {
+        long long position = ftell(file);
+        fwrite(padding, block_offsets[b] - position, 1, file);
+        SizeT first_edge = graph.row_offsets[block_starts[b]];
+        SizeT edges      = graph.row_offsets[block_starts[b+1]] - first_edge;
+        columns.resize(edges + 1);
+        for (SizeT e = 0; e < edges; e++)
+            columns[e] = graph.ColumnIndex(first_edge + e);
+        fwrite(&columns[0], sizeof(VertexId), edges, file);
+        fwrite(padding, (sizeof(VertexId) * edges + 7) / 8 * 8
+            - sizeof(VertexId) * edges, 1, file);
+        if (value_bytes == 0) continue;
+        values.resize(edges + 1);
+        for (SizeT e = 0; e < edges; e++)
+            values[e] = graph.EdgeValue(first_edge + e);
+        fwrite(&values[0], sizeof(Value), edges, file);
+    }
+    fwrite(padding, block_offsets[num_blocks] - ftell(file), 1, file);
+    free(padding); padding = NULL;
+    int retval = ferror(file) ? EIO : 0;
+    if (fclose(file) != 0 && retval == 0) retval = errno;
+    return retval;
+}
+
+/**
+ * @brief Edge of a window of StreamBlockGraph, sorted by column within its
+ * row.
+ */
+template <typename VertexId, typename Value>
+struct BlockEdge
+{
+    VertexId column;
+    Value    value;
+
+    bool operator<(const BlockEdge &other) const
+    {
+        return column < other.column;
+    }
+};
+
+/**
+ * @brief Counts the out-degrees of a MARKET stream, self-loops aside and
+ * repeated edges included.
+ */
+template <typename SizeT>
+struct BlockDegreeOp
+{
+    SizeT *degrees;     // updated atomically
+    bool   undirected;
+
+    void operator()(int thread_num, long long src, long long dst, double value)
+    {
+        if (src == dst) return;
+        __sync_fetch_and_add(degrees + src, (SizeT)1);
+        if (undirected) __sync_fetch_and_add(degrees + dst, (SizeT)1);
+    }
+};
+
+/**
+ * @brief Places the edges of a MARKET stream whose source is in
+ * [first_vertex, end_vertex) into their rows of the window.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+struct BlockFillOp
+{
+    long long                   first_vertex;
+    long long                   end_vertex;
+    SizeT                      *fill;        // next slot of each row,
+                                             // updated atomically
+    BlockEdge<VertexId, Value> *window;
+    bool                        undirected;
+    bool                        skew;
+
+    void Place(long long src, long long dst, Value value)
+    {
+        if (src < first_vertex || src >= end_vertex) return;
+        SizeT slot = __sync_fetch_and_add(fill + (src - first_vertex), (SizeT)1);
+        window[slot].column = (VertexId)dst;
+        window[slot].value  = value;
+    }
+
+    void operator()(int thread_num, long long src, long long dst, double value)
+    {
+        if (src == dst) return;
+        Place(src, dst, (Value)value);
+        if (undirected) Place(dst, src, (Value)(skew ? -value : value));
+    }
+};
+
+/**
+ * @brief Writes a MARKET stream as a block file without loading the graph:
+ * a first pass counts the degrees and cuts the blocks, then each further
+ * pass gathers the rows of the blocks that fit in window_bytes, sorts them
+ * and drops self-loops and repeated edges, as Csr::FromCoo does, and
+ * appends them to the file. Only the row offsets and one window are in
+ * memory; a graph of W windows takes W + 1 passes over the stream.
+ *
+ * @param[in] stream Opened MARKET stream; its values, or 0 for lines
+ * without one, are stored if with_values is set. Synthetic weights are
+ * not drawn for pattern files.
+ * @param[in] file_name Output file.
+ * @param[in] block_bytes Target adjacency bytes per block, counted before
+ * repeated edges are dropped.
+ * @param[in] window_bytes Memory for the edges gathered per pass; a block
+ * larger than it is gathered on its own.
+ * @param[in] with_values Whether to store the edge values.
+ * @param[in] undirected Whether to add the reverse of each edge, as for
+ * symmetric files.
+ *
+ * \return 0 on success, errno otherwise, EINVAL for malformed edges.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+int StreamBlockGraph(
+    graphio::MarketEdgeStream &stream,
+    const char                *file_name,
+    size_t                     block_bytes,
+    size_t                     window_bytes,
+    bool                       with_values,
+    bool                       undirected)
+{
+    typedef BlockEdge<VertexId, Value> EdgeT;
+    SizeT  nodes       = stream.nodes;
+    size_t value_bytes = with_values ? sizeof(Value) : 0;
+    size_t edge_bytes  = sizeof(VertexId) + value_bytes;
+    undirected = undirected || stream.symmetric;
+    std::vector<unsigned long long> block_starts, block_offsets;
+
+    // pass 1: the degrees bound the rows, before repeats are dropped
+    SizeT *bounds      = (SizeT*) calloc(nodes + 1, sizeof(SizeT));
+    SizeT *row_offsets = (SizeT*) malloc(sizeof(SizeT) * (nodes + 1));
+    BlockDegreeOp<SizeT> count;
+    count.degrees    = bounds;
+    count.undirected = undirected;
+    if (!stream.template ForAllEdges<false>(count) || stream.edges_invalid != 0)
+    {
+        int retval = stream.Failed() ? EIO : EINVAL;
+        free(bounds     ); bounds      = NULL;
+        free(row_offsets); row_offsets = NULL;
+        return retval;
+    }
+    bounds[nodes] = util::host::ExclusiveScan(bounds, bounds, nodes);
+
+    // cut the vertex range greedily into blocks of about block_bytes
+    block_starts.push_back(0);
+    for (SizeT v = 0; v < nodes; )
+    {
+        SizeT first = v;
+        while (v < nodes && (v == first ||
+            (size_t)(bounds[v+1] - bounds[first]) * edge_bytes <= block_bytes))
+            v++;
+        block_starts.push_back(v);
+    }
+    size_t num_blocks = block_starts.size() - 1;
+
+    FILE *file = fopen(file_name, "wb");
+    if (file == NULL)
+    {
+        int retval = errno;
+        free(bounds     ); bounds      = NULL;
+        free(row_offsets); row_offsets = NULL;
+        return retval;
+    }
+    char *padding = (char*) calloc(GR_BLOCK_ALIGN, 1);
+    unsigned long long directory_offset = GR_BLOCK_ALIGN + sizeof(SizeT) * (nodes + 1);
+    unsigned long long offset = directory_offset
+        + 2 * sizeof(unsigned long long) * (num_blocks + 1);
+    fseek(file, offset, SEEK_SET);
+
+    // further passes: gather, sort and append the blocks a window holds
+    std::vector<VertexId> columns;
+    std::vector<Value>    values;
+    row_offsets[0] = 0;
+    int retval = 0;
+    for (size_t b = 0; b < num_blocks; )
+    {
+        size_t end_block = b + 1;
+        while (end_block < num_blocks &&
+            (size_t)(bounds[block_starts[end_block+1]] - bounds[block_starts[b]])
+                * sizeof(EdgeT) <= window_bytes)
+            end_block++;
+        SizeT first_vertex = block_starts[b];
+        SizeT end_vertex   = block_starts[end_block];
+        SizeT first_bound  = bounds[first_vertex];
+        EdgeT *window = (EdgeT*) malloc(sizeof(EdgeT) *
+            std::max(bounds[end_vertex] - first_bound, (SizeT)1));
+        SizeT *fill   = (SizeT*) malloc(sizeof(SizeT) * (end_vertex - first_vertex));
+        for (SizeT v = first_vertex; v < end_vertex; v++)
+            fill[v - first_vertex] = bounds[v] - first_bound;
+
+        BlockFillOp<VertexId, SizeT, Value> place;
+        place.first_vertex = first_vertex;
+        place.end_vertex   = end_vertex;
+        place.fill         = fill;
+        place.window       = window;
+        place.undirected   = undirected;
+        place.skew         = stream.skew;
+        bool read = with_values ?
+            stream.template ForAllEdges<true >(place) :
+            stream.template ForAllEdges<false>(place);
+        if (!read || stream.edges_invalid != 0)
+        {
+            retval = stream.Failed() ? EIO : EINVAL;
+            free(window); window = NULL;
+            free(fill  ); fill   = NULL;
+            break;
+        }
+
+        // sort each row and keep the first of each column; fill then holds
+        // the row lengths
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (SizeT v = first_vertex; v < end_vertex; v++)
+        {
+            EdgeT *row = window + (bounds[v] - first_bound);
+            SizeT  length = bounds[v+1] - bounds[v], kept = 0;
+            std::stable_sort(row, row + length);
+            for (SizeT i = 0; i < length; i++)
+                if (kept == 0 || row[i].column != row[kept-1].column)
+                    row[kept++] = row[i];
+            fill[v - first_vertex] = kept;
+        }
+        for (SizeT v = first_vertex; v < end_vertex; v++)
+            row_offsets[v+1] = row_offsets[v] + fill[v - first_vertex];
+
+        for (; b < end_block; b++)
+        {
+            offset = (offset + GR_BLOCK_ALIGN - 1) / GR_BLOCK_ALIGN * GR_BLOCK_ALIGN;
+            fwrite(padding, offset - ftell(file), 1, file);
+            block_offsets.push_back(offset);
+            SizeT edges = row_offsets[block_starts[b+1]]
+                - row_offsets[block_starts[b]];
+            columns.resize(edges + 1);
+            values .resize(with_values ? edges + 1 : 0);
+            SizeT e = 0;
+            for (SizeT v = block_starts[b]; v < block_starts[b+1]; v++)
+            {
+                const EdgeT *row = window + (bounds[v] - first_bound);
+                for (SizeT i = 0; i < fill[v - first_vertex]; i++, e++)
+                {
+                    columns[e] = row[i].column;
+                    if (with_values) values[e] = row[i].value;
+                }
+            }
+            fwrite(&columns[0], sizeof(VertexId), edges, file);
+            fwrite(padding, (sizeof(VertexId) * edges + 7) / 8 * 8
+                - sizeof(VertexId) * edges, 1, file);
+            if (with_values) fwrite(&values[0], sizeof(Value), edges, file);
+            offset += (sizeof(VertexId) * edges + 7) / 8 * 8 + value_bytes * edges;
+        }
+        free(window); window = NULL;
+        free(fill  ); fill   = NULL;
+    }
+    offset = (offset + GR_BLOCK_ALIGN - 1) / GR_BLOCK_ALIGN * GR_BLOCK_ALIGN;
+    block_offsets.push_back(offset);
+    if (retval == 0)
+    {
+        fwrite(padding, offset - ftell(file), 1, file);
+
+        // the header and the directory go before the blocks
+        BlockGraphHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic              = GR_BLOCK_MAGIC;
+        header.version            = GR_BLOCK_VERSION;
+        header.vertex_id_bytes    = sizeof(VertexId);
+        header.size_bytes         = sizeof(SizeT);
+        header.value_bytes        = value_bytes;
+        header.nodes              = nodes;
+        header.edges              = row_offsets[nodes];
+        header.num_blocks         = num_blocks;
+        header.row_offsets_offset = GR_BLOCK_ALIGN;
+        header.directory_offset   = directory_offset;
+        fseek(file, 0, SEEK_SET);
+        fwrite(&header, sizeof(header), 1, file);
+        fwrite(padding, GR_BLOCK_ALIGN - sizeof(header), 1, file);
+        fwrite(row_offsets, sizeof(SizeT), nodes + 1, file);
+        fwrite(&block_starts [0], sizeof(unsigned long long), num_blocks + 1, file);
+        fwrite(&block_offsets[0], sizeof(unsigned long long), num_blocks + 1, file);
+        if (ferror(file)) retval = EIO;
+    }
+    free(padding    ); padding     = NULL;
+    free(bounds     ); bounds      = NULL;
+    free(row_offsets); row_offsets = NULL;
+    if (fclose(file) != 0 && retval == 0) retval = errno;
+    if (retval != 0) remove(file_name);
+    return retval;
+}
+
+/**
+ * @brief Out-of-core graph over a block file. Acquire / Release are thread
+ * safe; the algorithms visit blocks through ForAllEdges.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+struct BlockGraph
+{
+    /**
+     * @brief A block pinned in the cache.
+     */
+    struct Block
+    {
+        VertexId        first_vertex;
+        VertexId        end_vertex;
+        SizeT           first_edge;     // global id of the first edge
+        const VertexId *column_indices; // indexed by e - first_edge
+        const Value    *edge_values;    // likewise, NULL without values
+    };
+
+    enum SlotState { SLOT_EMPTY, SLOT_LOADING, SLOT_READY };
+
+    struct Slot
+    {
+        SlotState  state;
+        char      *data;
+        int        pins;
+        long long  last_use;
+        bool       unused_prefetch;  // read ahead and not acquired yet
+    };
+
+    SizeT  nodes;
+    SizeT  edges;
+    SizeT *row_offsets;       // in memory
+    size_t num_blocks;
+    bool   has_values;
+
+    std::vector<unsigned long long> block_starts;   // first vertex
+    std::vector<unsigned long long> block_offsets;  // file offset
+
+    size_t       memory_budget;
+    size_t       memory_used;
+    size_t       prefetch_window;  // blocks read ahead by ForAllEdges
+    BlockIoStats stats;
+
+    int                    fd;
+    std::vector<Slot>      slots;
+    long long              clock;
+    std::deque<int>        queue;       // blocks for the I/O threads
+    std::vector<pthread_t> io_threads;
+    bool                   stopping;
+    pthread_mutex_t        mutex;
+    pthread_cond_t         ready_cond;  // a block became ready
+    pthread_cond_t         queue_cond;  // the queue got work
+
+    BlockGraph() :
+        nodes          (0),
+        edges          (0),
+        row_offsets    (NULL),
+        num_blocks     (0),
+        has_values     (false),
+        memory_budget  (0),
+        memory_used    (0),
+        prefetch_window(0),
+        fd             (-1),
+        clock          (0),
+        stopping       (false)
+    {
+        pthread_mutex_init(&mutex, NULL);
+        pthread_cond_init (&ready_cond, NULL);
+        pthread_cond_init (&queue_cond, NULL);
+    }
+
+    ~BlockGraph()
+    {
+        Close();
+        pthread_mutex_destroy(&mutex);
+        pthread_cond_destroy (&ready_cond);
+        pthread_cond_destroy (&queue_cond);
+    }
+
+    static double Seconds()
+    {
+        struct timeval now;
+        gettimeofday(&now, NULL);
+        return now.tv_sec + now.tv_usec * 1e-6;
+    }
+
+    /**
+     * @brief Opens a block file written by WriteBlockGraph.
+     *
+     * @param[in] file_name Block file.
+     * @param[in] budget Bytes of blocks kept in memory.
+     * @param[in] num_io_threads Reader threads.
+     *
+     * \return 0 on success, errno or EINVAL for a file of other types.
+     */
+    int Open(const char *file_name, size_t budget, int num_io_threads = 4)
+    {
+        Close();
+        BlockGraphHeader header;
+        fd = open(file_name, O_RDONLY);
+        if (fd < 0) return errno;
+        if (!ReadAll((char*)&header, sizeof(header), 0) ||
+            header.magic != GR_BLOCK_MAGIC || header.version != GR_BLOCK_VERSION ||
+            header.vertex_id_bytes != sizeof(VertexId) ||
+            header.size_bytes != sizeof(SizeT) ||
+            (header.value_bytes != 0 && header.value_bytes != sizeof(Value)))
+        {
+            Close();
+            return EINVAL;
+        }
+        nodes      = header.nodes;
+        edges      = header.edges;
+        num_blocks = header.num_blocks;
+        has_values = header.value_bytes != 0;
+        row_offsets = (SizeT*) malloc(sizeof(SizeT) * (nodes + 1));
+        block_starts .resize(num_blocks + 1);
+        block_offsets.resize(num_blocks + 1);
+        size_t directory_bytes = sizeof(unsigned long long) * (num_blocks + 1);
+        if (!ReadAll((char*)row_offsets, sizeof(SizeT) * (nodes + 1),
+                header.row_offsets_offset) ||
+            !ReadAll((char*)&block_starts[0], directory_bytes,
+                header.directory_offset) ||
+            !ReadAll((char*)&block_offsets[0], directory_bytes,
+                header.directory_offset + directory_bytes))
+        {
+            Close();
+            return EIO;
+        }
+
+        Slot empty = {SLOT_EMPTY, NULL, 0, 0, false};
+        slots.assign(num_blocks, empty);
+        memory_budget   = budget;
+        memory_used     = 0;
+        // read ahead by at most half the budget, so blocks read ahead are
+        // not pushed out by the ones in use before being reached
+        size_t average_bytes = (num_blocks == 0) ? 1 :
+            (block_offsets[num_blocks] - block_offsets[0]) / num_blocks + 1;
+        prefetch_window = std::min((size_t)(2 * num_io_threads),
+            budget / 2 / average_bytes);
+        stats.Reset();
+        stopping = false;
+        io_threads.resize(num_io_threads);
+        for (int i = 0; i < num_io_threads; i++)
+            pthread_create(&io_threads[i], NULL, IoThread, this);
+        return 0;
+    }
+
+    void Close()
+    {
+        pthread_mutex_lock(&mutex);
+        stopping = true;
+        pthread_cond_broadcast(&queue_cond);
+        pthread_mutex_unlock(&mutex);
+        for (size_t i = 0; i < io_threads.size(); i++)
+            pthread_join(io_threads[i], NULL);
+        io_threads.clear();
+        queue.clear();
+        for (size_t b = 0; b < slots.size(); b++)
+            if (slots[b].data) { free(slots[b].data); slots[b].data = NULL; }
+        slots.clear();
+        memory_used = 0;
+        if (row_offsets) { free(row_offsets); row_offsets = NULL; }
+        if (fd >= 0) { close(fd); fd = -1; }
+    }
+
+    size_t PayloadBytes(size_t b) const
+    {
+        SizeT edges = row_offsets[block_starts[b+1]] - row_offsets[block_starts[b]];
+        return (sizeof(VertexId) * edges + 7) / 8 * 8
+            + (has_values ? sizeof(Value) * edges : 0);
+    }
+
+    /**
+     * @brief Block holding vertex v.
+     */
+    int BlockOf(VertexId v) const
+    {
+        return std::upper_bound(block_starts.begin(), block_starts.end(),
+            (unsigned long long)v) - block_starts.begin() - 1;
+    }
+
+    /**
+     * @brief Queues a block for reading if it is not cached. A prefetch
+     * only takes free room or room of blocks already used, so it never
+     * pushes out blocks read ahead for the same pass.
+     */
+    void Prefetch(int b)
+    {
+        pthread_mutex_lock(&mutex);
+        if (slots[b].state == SLOT_EMPTY)
+        {
+            if (MakeRoom(PayloadBytes(b), true))
+            {
+                slots[b].state = SLOT_LOADING;
+                slots[b].unused_prefetch = true;
+                memory_used += PayloadBytes(b);
+                queue.push_back(b);
+                stats.prefetches ++;
+                pthread_cond_signal(&queue_cond);
+            } else stats.prefetch_dropped ++;
+        }
+        pthread_mutex_unlock(&mutex);
+    }
+
+    /**
+     * @brief Pins a block, reading it if needed.
+     */
+    Block Acquire(int b)
+    {
+        bool load = false;
+        pthread_mutex_lock(&mutex);
+        Slot &slot = slots[b];
+        // pinned first, so the block is not evicted between being read by
+        // another thread and this one waking up
+        slot.pins ++;
+        if (slot.unused_prefetch) stats.prefetch_hits ++;
+        if (slot.state == SLOT_READY) stats.hits ++;
+        else if (slot.state == SLOT_LOADING)
+        {
+            double start = Seconds();
+            while (slot.state != SLOT_READY)
+                pthread_cond_wait(&ready_cond, &mutex);
+            stats.wait_seconds += Seconds() - start;
+        } else {
+            stats.misses ++;
+            if (!MakeRoom(PayloadBytes(b), false)) stats.over_budget ++;
+            memory_used += PayloadBytes(b);
+            slot.state = SLOT_LOADING;
+            load = true;
+        }
+        slot.unused_prefetch = false;
+        slot.last_use = ++clock;
+        pthread_mutex_unlock(&mutex);
+
+        if (load)
+        {
+            double start = Seconds();
+            char *data = ReadBlock(b);
+            pthread_mutex_lock(&mutex);
+            stats.wait_seconds += Seconds() - start;
+            slot.data  = data;
+            slot.state = SLOT_READY;
+            pthread_cond_broadcast(&ready_cond);
+            pthread_mutex_unlock(&mutex);
+        }
+
+        Block block;
+        SizeT block_edges = row_offsets[block_starts[b+1]] - row_offsets[block_starts[b]];
+        block.first_vertex   = block_starts[b];
+        block.end_vertex     = block_starts[b+1];
+        block.first_edge     = row_offsets[block_starts[b]];
+        block.column_indices = (const VertexId*)slot.data;
+        block.edge_values    = has_values ? (const Value*)(slot.data +
+            (sizeof(VertexId) * block_edges + 7) / 8 * 8) : NULL;
+        return block;
+    }
+
+    void Release(int b)
+    {
+        pthread_mutex_lock(&mutex);
+        slots[b].pins --;
+        pthread_mutex_unlock(&mutex);
+    }
+
+    /**
+     * @brief Calls op(e, from, to) for the edges of the active blocks,
+     * blocks in parallel. The blocks are read in order, prefetch_window
+     * blocks ahead of the workers.
+     *
+     * @param[in] op Edge functor.
+     * @param[in] active Flag of each block, NULL for all blocks.
+     *
+     * \return Number of blocks visited.
+     */
+    template <typename OpT>
+    SizeT ForAllEdges(OpT &op, const char *active = NULL)
+    {
+        std::vector<int> blocks;
+        for (size_t b = 0; b < num_blocks; b++)
+            if (active == NULL || active[b]) blocks.push_back(b);
+        for (size_t i = 0; i < blocks.size() && i < prefetch_window; i++)
+            Prefetch(blocks[i]);
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (long long i = 0; i < (long long)blocks.size(); i++)
+        {
+            if (i + prefetch_window < blocks.size())
+                Prefetch(blocks[i + prefetch_window]);
+            Block block = Acquire(blocks[i]);
+            for (VertexId v = block.first_vertex; v < block.end_vertex; v++)
+            {
+                for (SizeT e = row_offsets[v]; e < row_offsets[v+1]; e++)
+                    op(e, v, block.column_indices[e - block.first_edge]);
+            }
+            Release(blocks[i]);
+        }
+        return blocks.size();
+    }
+
+    /**
+     * @brief Csr with the row offsets only, for code that needs degrees.
+     * The arrays are shared; the caller must reset them before the Csr is
+     * freed.
+     */
+    void Skeleton(Csr<VertexId, SizeT, Value> &graph) const
+    {
+        graph.nodes       = nodes;
+        graph.edges       = edges;
+        graph.row_offsets = row_offsets;
+    }
+
+private:
+    bool ReadAll(char *buffer, size_t size, unsigned long long offset)
+    {
+        while (size > 0)
+        {
+            ssize_t got = pread(fd, buffer, size, offset);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) return false;
+            buffer += got;
+            size   -= got;
+            offset += got;
+        }
+        return true;
+    }
+
+    char* ReadBlock(int b)
+    {
+        size_t bytes = PayloadBytes(b);
+        char  *data  = (char*) malloc(bytes > 0 ? bytes : 1);
+        double start = Seconds();
+        if (!ReadAll(data, bytes, block_offsets[b]))
+        {
+            fprintf(stderr, "Block graph: reading block %d failed.\n", b);
+            exit(EXIT_FAILURE);
+        }
+        double seconds = Seconds() - start;
+        pthread_mutex_lock(&mutex);
+        stats.blocks_read  ++;
+        stats.bytes_read   += bytes;
+        stats.read_seconds += seconds;
+        pthread_mutex_unlock(&mutex);
+        return data;
+    }
+
+    /**
+     * @brief Evicts least recently used, unpinned, ready blocks until bytes
+     * more fit in the budget. Called with the mutex held.
+     *
+     * @param[in] bytes Room needed.
+     * @param[in] for_prefetch Whether to spare blocks read ahead and not
+     * used yet; otherwise they go only after all the others.
+     *
+     * \return Whether the room was made.
+     */
+    bool MakeRoom(size_t bytes, bool for_prefetch)
+    {
+        while (memory_used + bytes > memory_budget)
+        {
+            int victim = -1;
+            for (size_t b = 0; b < slots.size(); b++)
+            {
+                const Slot &slot = slots[b];
+                if (slot.state != SLOT_READY || slot.pins > 0) continue;
+                if (for_prefetch && slot.unused_prefetch) continue;
+                if (victim < 0 ||
+                    (slots[victim].unused_prefetch && !slot.unused_prefetch) ||
+                    (slots[victim].unused_prefetch == slot.unused_prefetch &&
+                     slot.last_use < slots[victim].last_use))
+                    victim = b;
+            }
+            if (victim < 0) return false;
+            free(slots[victim].data);
+            slots[victim].data  = NULL;
+            slots[victim].state = SLOT_EMPTY;
+            slots[victim].unused_prefetch = false;
+            memory_used -= PayloadBytes(victim);
+            stats.evictions ++;
+        }
+        return true;
+    }
+
+    static void* IoThread(void *graph_)
+    {
+        BlockGraph *graph = (BlockGraph*)graph_;
+        pthread_mutex_lock(&graph->mutex);
+        while (true)
+        {
+            while (!graph->stopping && graph->queue.empty())
+                pthread_cond_wait(&graph->queue_cond, &graph->mutex);
+            if (graph->stopping) break;
+            int b = graph->queue.front();
+            graph->queue.pop_front();
+            pthread_mutex_unlock(&graph->mutex);
+
+            char *data = graph->ReadBlock(b);
+
+            pthread_mutex_lock(&graph->mutex);
+            graph->slots[b].data  = data;
+            graph->slots[b].state = SLOT_READY;
+            graph->slots[b].last_use = ++graph->clock;
+            pthread_cond_broadcast(&graph->ready_cond);
+        }
+        pthread_mutex_unlock(&graph->mutex);
+        return NULL;
+    }
+};
+
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
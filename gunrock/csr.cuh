@@ -23,15 +23,82 @@
 #include <algorithm>
 #include <iterator>
 #include <omp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <gunrock/util/test_utils.cuh>
 #include <gunrock/util/error_utils.cuh>
 #include <gunrock/util/multithread_utils.cuh>
 #include <gunrock/util/sort_omp.cuh>
+#include <gunrock/util/host/scan.cuh>
+#include <gunrock/util/host/compact.cuh>
+#include <gunrock/util/host/histogram.cuh>
+#include <gunrock/util/host/segmented_sort.cuh>
+#include <gunrock/util/quantized_values.cuh>
 #include <gunrock/coo.cuh>
+#include <gunrock/graphio/edge_weights.cuh>
 
 namespace gunrock {
 
+// Binary CSR files end with a {flags, magic} footer; files written before
+// the footer existed lack it and read as flags = 0.
+#define GR_BINARY_MAGIC      0x46435247  // "GRCF"
+#define GR_BINARY_ROWS_SORTED 0x1        // neighbor lists are ascending
+#define GR_BINARY_EDGE_MAPS   0x2        // reverse / csc-to-csr edge maps follow
+                                         // the arrays, just before the footer
+#define GR_BINARY_QUANTIZED   0x4        // edge values are stored as their
+                                         // QuantizedValueCodec, then codes
+                                         // padded to 8 bytes
+
+/**
+ * @brief Keeps the tuples of a row-sorted COO that are neither self-loops
+ * nor repeats of the tuple before them.
+ */
+template <typename Tuple, typename SizeT>
+struct CooKeepOp
+{
+    const Tuple *coo;
+
+    bool operator()(SizeT e) const
+    {
+        if (coo[e].row == coo[e].col) return false;
+        return e == 0 || coo[e].row != coo[e-1].row || coo[e].col != coo[e-1].col;
+    }
+};
+
+/**
+ * @brief Row of a COO tuple, the bin of the row length histogram.
+ */
+template <typename Tuple, typename SizeT>
+struct CooRowOp
+{
+    const Tuple *coo;
+
+    SizeT operator()(SizeT e) const { return coo[e].row; }
+};
+
+/**
+ * @brief Hash table capacity of a vertex: the power of two >= 2 * degree
+ * for hubs, so probes stay short, and 0 for other vertices.
+ */
+template <typename SizeT>
+struct HubCapacityOp
+{
+    const SizeT *row_offsets;
+    SizeT        min_degree;
+
+    SizeT operator()(SizeT v) const
+    {
+        SizeT degree   = row_offsets[v+1] - row_offsets[v];
+        SizeT capacity = 0;
+        if (degree >= min_degree)
+            for (capacity = 1; capacity < degree * 2; capacity <<= 1);
+        return capacity;
+    }
+};
+
 /**
  * @brief CSR data structure which uses Compressed Sparse Row
  * format to store a graph. It is a compressed way to present
@@ -57,10 +124,34 @@ struct Csr
     Value    *edge_values;    // List of values attached to edges in the graph
     Value    *node_values;    // List of values attached to nodes in the graph
 
+    unsigned int  *local_column_indices;  // 32-bit column indices, used when
+                                          // column_indices is NULL
+
+    unsigned char *edge_value_codes;  // Narrow edge values, used when
+                                      // edge_values is NULL
+    util::QuantizedValueCodec edge_value_codec;
+
     Value average_edge_value;
     Value average_node_value;
 
     bool  pinned;  // Whether to use pinned memory
+    bool  rows_sorted;  // Whether every neighbor list is ascending
+    bool  quantize_binary;  // Whether WriteBinary may store edge values as
+                            // narrow codes; such files need a reader that
+                            // knows GR_BINARY_QUANTIZED, so callers opt in
+                            // and keep them under names of their own
+
+    SizeT     hub_degree;   // Minimum degree of a hashed hub, 0 for none
+    SizeT    *hub_offsets;  // [nodes + 1], hash table slots of each vertex
+    VertexId *hub_table;    // Open-addressing tables of all hubs
+
+    SizeT    *reverse_edges;     // [edges], id of edge v -> u for edge u -> v,
+                                 // -1 if there is none
+    SizeT    *csc_to_csr_edges;  // [edges], csr id of each edge of the csc
+                                 // (rows sorted) built from this graph
+
+    char     *mapped_base;  // Binary file mapped by FromCsrMapped, or NULL
+    size_t    mapped_size;
 
     /**
      * @brief CSR Constructor
@@ -81,7 +172,18 @@ struct Csr
         column_indices = NULL;
         edge_values = NULL;
         node_values = NULL;
+        local_column_indices = NULL;
+        edge_value_codes = NULL;
         this->pinned = pinned;
+        rows_sorted = false;
+        quantize_binary = false;
+        hub_degree  = 0;
+        hub_offsets = NULL;
+        hub_table   = NULL;
+        reverse_edges    = NULL;
+        csc_to_csr_edges = NULL;
+        mapped_base = NULL;
+        mapped_size = 0;
     }
 
     void FromCsr(Csr<VertexId, SizeT, Value> &source)
@@ -92,6 +194,7 @@ struct Csr
         average_edge_value = source.average_edge_value;
         average_node_value = source.average_node_value;
         out_nodes = source.out_nodes;
+        rows_sorted = source.rows_sorted;
         if (source.row_offsets == NULL)
         {
             row_offsets = NULL;
@@ -106,6 +209,12 @@ struct Csr
             column_indices = (VertexId*) malloc(sizeof(VertexId) * source.edges); 
             memcpy(column_indices, source.column_indices, sizeof(VertexId) * source.edges);
         }
+        if (source.local_column_indices != NULL)
+        {
+            local_column_indices = (unsigned int*) malloc(sizeof(unsigned int) * source.edges);
+            memcpy(local_column_indices, source.local_column_indices,
+                sizeof(unsigned int) * source.edges);
+        }
         if (source.edge_values == NULL)
         {
             edge_values = NULL;
@@ -113,6 +222,21 @@ struct Csr
             edge_values = (Value*) malloc(sizeof(Value) * source.edges);
             memcpy(edge_values, source.edge_values, sizeof(Value) * source.edges);
         }
+        if (source.edge_value_codes != NULL)
+        {
+            AllocateEdgeValueCodes(source.edge_value_codec, source.edges);
+            memcpy(edge_value_codes, source.edge_value_codes,
+                source.edge_value_codec.CodeBytes(source.edges));
+        }
+        if (source.reverse_edges != NULL)
+        {
+            reverse_edges    = (SizeT*) malloc(sizeof(SizeT) * source.edges);
+            csc_to_csr_edges = (SizeT*) malloc(sizeof(SizeT) * source.edges);
+            memcpy(reverse_edges, source.reverse_edges,
+                sizeof(SizeT) * source.edges);
+            memcpy(csc_to_csr_edges, source.csc_to_csr_edges,
+                sizeof(SizeT) * source.edges);
+        }
         if (source.node_values == NULL)
         {
             node_values = NULL;
@@ -142,10 +266,11 @@ struct Csr
                 {
                     coo[idx].row = source.column_indices[j];
                     coo[idx].col = i;
-                    coo[idx++].val = (source.edge_values == NULL) ? 0 : source.edge_values[j];
+                    coo[idx++].val = (source.edge_values == NULL &&
+                        source.edge_value_codes == NULL) ? 0 : source.EdgeValue(j);
                 }
             }
-            if (source.edge_values == NULL)
+            if (source.edge_values == NULL && source.edge_value_codes == NULL)
                 target.template FromCoo<false>(NULL, coo, nodes, edges);
             else
                 target.template FromCoo<true>(NULL, coo, nodes, edges);
@@ -167,6 +292,8 @@ struct Csr
     {
         this->nodes = nodes;
         this->edges = edges;
+        rows_sorted = false;
+        FreeEdgeMaps();
 
         if (pinned)
         {
@@ -217,6 +344,15 @@ struct Csr
         }
     }
 
+    /**
+     * @brief Bytes taken by stored edge value codes, padded to 8.
+     */
+    static size_t QuantizedBytes(
+        const util::QuantizedValueCodec &codec, SizeT e)
+    {
+        return (codec.CodeBytes(e) + 7) / 8 * 8;
+    }
+
     void WriteBinary_SM(
 	char *file_name,
 	SizeT v,
@@ -238,7 +374,11 @@ struct Csr
      * @param[in] e Number of edges in input graph.
      * @param[in] row Row-offsets array store row pointers.
      * @param[in] col Column-indices array store destinations.
-     * @param[in] edge_values Per edge weight values associated.
+     * @param[in] edge_values Per edge weight values associated; stored as
+     * narrow codes when quantize_binary is set and a lossless code fits them.
+     * @param[in] sorted Whether the neighbor lists are ascending.
+     * @param[in] reverse_edges Reverse edge map, stored if not NULL.
+     * @param[in] csc_to_csr_edges CSC-to-CSR edge map, stored with the above.
      *
      */
     void WriteBinary(
@@ -247,8 +387,20 @@ struct Csr
         SizeT e,
         SizeT *row,
         VertexId *col,
-        Value *edge_values = NULL)
+        Value *edge_values = NULL,
+        bool   sorted = false,
+        SizeT *reverse_edges = NULL,
+        SizeT *csc_to_csr_edges = NULL)
     {
+        bool edge_maps = (reverse_edges != NULL && csc_to_csr_edges != NULL);
+        util::QuantizedValueCodec codec;
+        if (edge_values != NULL && quantize_binary)
+            codec = util::FindQuantization(edge_values, e);
+        bool quantized = (codec.type != util::QUANTIZED_NONE);
+        unsigned int footer[2] = {
+            (sorted    ? GR_BINARY_ROWS_SORTED : 0u) |
+            (edge_maps ? GR_BINARY_EDGE_MAPS   : 0u) |
+            (quantized ? GR_BINARY_QUANTIZED   : 0u), GR_BINARY_MAGIC};
         std::ofstream fout(file_name);
         if (fout.is_open())
         {
@@ -256,11 +408,27 @@ struct Csr
             fout.write(reinterpret_cast<const char*>(&e), sizeof(SizeT));
             fout.write(reinterpret_cast<const char*>(row), (v + 1)*sizeof(SizeT));
             fout.write(reinterpret_cast<const char*>(col), e * sizeof(VertexId));
-            if (edge_values != NULL)
+            if (quantized)
+            {
+                size_t code_bytes = QuantizedBytes(codec, e);
+                unsigned char *codes = (unsigned char*) calloc(code_bytes, 1);
+                util::Quantize(codec, edge_values, e, codes);
+                fout.write(reinterpret_cast<const char*>(&codec), sizeof(codec));
+                fout.write(reinterpret_cast<const char*>(codes), code_bytes);
+                free(codes); codes = NULL;
+            } else if (edge_values != NULL)
             {
                 fout.write(reinterpret_cast<const char*>(edge_values),
                            e * sizeof(Value));
             }
+            if (edge_maps)
+            {
+                fout.write(reinterpret_cast<const char*>(reverse_edges),
+                           e * sizeof(SizeT));
+                fout.write(reinterpret_cast<const char*>(csc_to_csr_edges),
+                           e * sizeof(SizeT));
+            }
+            fout.write(reinterpret_cast<const char*>(footer), sizeof(footer));
             fout.close();
         }
     }
@@ -392,7 +560,9 @@ struct Csr
                     }
                     else
                     {
-                        fout3 << " " << rand() % 64 << std::endl;
+                        fout3 << " " << graphio::EdgeWeight<Value>(
+                            graphio::EdgeWeightConfig(), col[j], (VertexId)i,
+                            true) << std::endl;
                     }
                 }
             }
@@ -427,11 +597,48 @@ struct Csr
 
         input.read(reinterpret_cast<char*>(row_offsets), (v + 1)*sizeof(SizeT));
         input.read(reinterpret_cast<char*>(column_indices), e * sizeof(VertexId));
-        if (LOAD_EDGE_VALUES)
+
+        // footer, if any
+        unsigned int footer[2] = {0, 0};
+        std::streamoff arrays_end = sizeof(SizeT) * (v + 3)
+            + sizeof(VertexId) * (std::streamoff)e;
+        input.seekg(0, std::ios::end);
+        std::streamoff file_size = input.tellg();
+        if (file_size >= arrays_end + (std::streamoff)sizeof(footer))
+        {
+            input.seekg(file_size - (std::streamoff)sizeof(footer));
+            input.read(reinterpret_cast<char*>(footer), sizeof(footer));
+        }
+        if (footer[1] != GR_BINARY_MAGIC) footer[0] = 0;
+        rows_sorted = (footer[0] & GR_BINARY_ROWS_SORTED) != 0;
+
+        input.seekg(arrays_end);
+        if (LOAD_EDGE_VALUES && (footer[0] & GR_BINARY_QUANTIZED))
+        {
+            // codec and narrow codes, decoded to full values
+            util::QuantizedValueCodec codec;
+            input.read(reinterpret_cast<char*>(&codec), sizeof(codec));
+            unsigned char *codes = (unsigned char*) malloc(codec.CodeBytes(e));
+            input.read(reinterpret_cast<char*>(codes), codec.CodeBytes(e));
+            util::Dequantize(codec, codes, e, edge_values);
+            free(codes); codes = NULL;
+        } else if (LOAD_EDGE_VALUES)
         {
             input.read(reinterpret_cast<char*>(edge_values), e * sizeof(Value));
         }
 
+        // edge maps sit right before the footer, after any edge values
+        std::streamoff maps_size = 2 * sizeof(SizeT) * (std::streamoff)e;
+        if ((footer[0] & GR_BINARY_EDGE_MAPS) &&
+            file_size >= arrays_end + maps_size + (std::streamoff)sizeof(footer))
+        {
+            reverse_edges    = (SizeT*) malloc(sizeof(SizeT) * e);
+            csc_to_csr_edges = (SizeT*) malloc(sizeof(SizeT) * e);
+            input.seekg(file_size - (std::streamoff)sizeof(footer) - maps_size);
+            input.read(reinterpret_cast<char*>(reverse_edges), e * sizeof(SizeT));
+            input.read(reinterpret_cast<char*>(csc_to_csr_edges), e * sizeof(SizeT));
+        }
+
         time_t mark2 = time(NULL);
         if (!quiet)
         {
@@ -450,6 +657,106 @@ struct Csr
         out_nodes = out_node;
     }
 
+    /**
+     * @brief Maps a binary CSR file into memory instead of reading it. The
+     * arrays point into a private copy-on-write mapping, so pages are only
+     * read when touched and stay shared with the page cache until written.
+     *
+     * @tparam LOAD_EDGE_VALUES Whether the file holds edge values.
+     *
+     * @param[in] f_in Input file name.
+     * @param[in] quiet Don't print out anything.
+     *
+     * \return false if the file cannot be mapped or is too short.
+     */
+    template <bool LOAD_EDGE_VALUES>
+    bool FromCsrMapped(char *f_in, bool quiet = false)
+    {
+        Free();
+        int fd = open(f_in, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0 ||
+            file_stat.st_size < (off_t)(2 * sizeof(SizeT)))
+        {
+            close(fd);
+            return false;
+        }
+        void *base = mmap(NULL, file_stat.st_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED) return false;
+
+        char  *ptr  = (char*)base;
+        SizeT  v    = ((SizeT*)ptr)[0];
+        SizeT  e    = ((SizeT*)ptr)[1];
+        size_t size = sizeof(SizeT) * (v + 3) + sizeof(VertexId) * e;
+        unsigned int footer[2] = {0, 0};
+        if ((size_t)file_stat.st_size >= size + sizeof(footer))
+            memcpy(footer, ptr + file_stat.st_size - sizeof(footer),
+                sizeof(footer));
+        if (footer[1] != GR_BINARY_MAGIC) footer[0] = 0;
+
+        // edge values are either full width or a codec and its codes
+        util::QuantizedValueCodec codec;
+        if (LOAD_EDGE_VALUES && (footer[0] & GR_BINARY_QUANTIZED) &&
+            (size_t)file_stat.st_size >= size + sizeof(codec))
+        {
+            memcpy(&codec, ptr + size, sizeof(codec));
+            size += sizeof(codec) + QuantizedBytes(codec, e);
+        } else if (LOAD_EDGE_VALUES)
+            size += sizeof(Value) * e;
+        if ((size_t)file_stat.st_size < size)
+        {
+            munmap(base, file_stat.st_size);
+            return false;
+        }
+        mapped_base    = ptr;
+        mapped_size    = file_stat.st_size;
+        nodes          = v;
+        edges          = e;
+        row_offsets    = (SizeT*)(ptr + sizeof(SizeT) * 2);
+        column_indices = (VertexId*)(ptr + sizeof(SizeT) * (v + 3));
+        ptr = (char*)(column_indices + e);
+        if (LOAD_EDGE_VALUES && codec.type != util::QUANTIZED_NONE)
+        {
+            // kept narrow, read through EdgeValue()
+            edge_value_codec = codec;
+            edge_value_codes = (unsigned char*)(ptr + sizeof(codec));
+        } else if (LOAD_EDGE_VALUES) edge_values = (Value*)ptr;
+
+        rows_sorted = (footer[0] & GR_BINARY_ROWS_SORTED) != 0;
+        size_t maps_size = 2 * sizeof(SizeT) * e;
+        if ((footer[0] & GR_BINARY_EDGE_MAPS) &&
+            mapped_size >= size + maps_size + sizeof(footer))
+        {
+            reverse_edges = (SizeT*)(mapped_base + mapped_size
+                - sizeof(footer) - maps_size);
+            csc_to_csr_edges = reverse_edges + e;
+        }
+        if (!quiet)
+        {
+            printf("  Mapped binary CSR arrays: %lld vertices, %lld edges\n",
+                (long long)nodes, (long long)edges);
+        }
+
+        SizeT out_node = 0;
+        #pragma omp parallel for reduction(+:out_node)
+        for (SizeT node = 0; node < nodes; node++)
+            if (row_offsets[node + 1] > row_offsets[node]) ++out_node;
+        out_nodes = out_node;
+        return true;
+    }
+
+    /**
+     * @brief Whether ptr points into the mapped binary file.
+     */
+    bool IsMapped(const void *ptr) const
+    {
+        return mapped_base != NULL && (const char*)ptr >= mapped_base &&
+            (const char*)ptr < mapped_base + mapped_size;
+    }
+
     /**
      * @brief (Specific for SM) Read from stored row_offsets, column_indices arrays.
      *
@@ -520,7 +827,8 @@ struct Csr
     /**
      * @brief Build CSR graph from COO graph, sorted or unsorted
      *
-     * @param[in] output_file Output file to dump the graph topology info
+     * @param[in] output_file Output file to dump the graph topology info,
+     * NULL for none
      * @param[in] coo Pointer to COO-format graph
      * @param[in] coo_nodes Number of nodes in COO-format graph
      * @param[in] coo_edges Number of edges in COO-format graph
@@ -561,106 +869,29 @@ struct Csr
             util::omp_sort(coo, coo_edges, RowFirstTupleCompare<Tuple>);
         }
 
-        SizeT *edge_offsets = NULL;
-        SizeT *edge_counts  = NULL;
-        #pragma omp parallel
-        {
-            int num_threads  = omp_get_num_threads();
-            int thread_num   = omp_get_thread_num();
-            if (thread_num == 0)
-            {
-                edge_offsets = new SizeT[num_threads+1];
-                edge_counts  = new SizeT[num_threads+1];
-            }
-            #pragma omp barrier
-
-            SizeT edge_start = (long long)(coo_edges) * thread_num / num_threads;
-            SizeT edge_end   = (long long)(coo_edges) * (thread_num + 1) / num_threads;
-            SizeT node_start = (long long)(coo_nodes) * thread_num / num_threads;
-            SizeT node_end   = (long long)(coo_nodes) * (thread_num + 1) / num_threads;
-            Tuple *new_coo   = (Tuple*) malloc (sizeof(Tuple) * (edge_end - edge_start));
-            SizeT edge       = edge_start;
-            SizeT new_edge   = 0;
-            for (edge = edge_start; edge < edge_end; edge++)
-            {
-                VertexId col = coo[edge].col;
-                VertexId row = coo[edge].row;
-                if ((col != row) && (edge == 0 || col != coo[edge - 1].col || row != coo[edge - 1].row))
-                {
-                    new_coo[new_edge].col = col;
-                    new_coo[new_edge].row = row;
-                    new_coo[new_edge].val = coo[edge].val;
-                    new_edge++;
-                }
-            }
-            edge_counts[thread_num] = new_edge;
-            for (VertexId node = node_start; node < node_end; node++)
-                row_offsets[node] = -1;
+        // drop self-loops and duplicates, keeping the order; the row offsets
+        // are then the scanned histogram of the remaining rows
+        Tuple *new_coo = (Tuple*) malloc(sizeof(Tuple) * std::max(coo_edges, (SizeT)1));
+        CooKeepOp<Tuple, SizeT> keep;
+        keep.coo = coo;
+        edges = util::host::Compact(coo, coo_edges, new_coo, keep);
 
-            #pragma omp barrier
-            #pragma omp single
-            {
-                edge_offsets[0] = 0;
-                for (int i = 0; i < num_threads; i++)
-                    edge_offsets[i + 1] = edge_offsets[i] + edge_counts[i];
-                //util::cpu_mt::PrintCPUArray("edge_offsets", edge_offsets, num_threads+1);
-                row_offsets[0] = 0;
-            }
-
-            SizeT edge_offset = edge_offsets[thread_num];
-            VertexId first_row = new_edge > 0 ? new_coo[0].row : -1;
-            //VertexId last_row = new_edge > 0? new_coo[new_edge-1].row : -1;
-            SizeT pointer = -1;
-            for (edge = 0; edge < new_edge; edge++)
-            {
-                SizeT edge_  = edge + edge_offset;
-                VertexId row = new_coo[edge].row;
-                row_offsets[row + 1] = edge_ + 1;
-                if (row == first_row) pointer = edge_ + 1;
-                // Fill in rows up to and including the current row
-                //for (VertexId row = prev_row + 1; row <= current_row; row++) {
-                //    row_offsets[row] = edge;
-                //}
-                //prev_row = current_row;
-
-                column_indices[edge + edge_offset] = new_coo[edge].col;
-                if (LOAD_EDGE_VALUES)
-                {
-                    //new_coo[edge].Val(edge_values[edge]);
-                    edge_values[edge + edge_offset] = new_coo[edge].val;
-                }
-            }
-            #pragma omp barrier
-            //if (first_row != last_row)
-            if (edge_start > 0 && coo[edge_start].row == coo[edge_start - 1].row) // same row as previous thread
-                if (edge_end == coo_edges || coo[edge_end].row != coo[edge_start].row) // first row ends at this thread
-                {
-                    row_offsets[first_row + 1] = pointer;
-                }
-            #pragma omp barrier
-            // Fill out any trailing edgeless nodes (and the end-of-list element)
-            //for (VertexId row = prev_row + 1; row <= nodes; row++) {
-            //    row_offsets[row] = real_edge;
-            //}
-            if (row_offsets[node_start] == -1)
-            {
-                VertexId i = node_start;
-                while (row_offsets[i] == -1) i--;
-                row_offsets[node_start] = row_offsets[i];
-            }
-            for (VertexId node = node_start + 1; node < node_end; node++)
-                if (row_offsets[node] == -1)
-                {
-                    row_offsets[node] = row_offsets[node - 1];
-                }
-            if (thread_num == 0) edges = edge_offsets[num_threads];
-
-            free(new_coo); new_coo = NULL;
+        #pragma omp parallel for
+        for (SizeT edge = 0; edge < edges; edge++)
+        {
+            column_indices[edge] = new_coo[edge].col;
+            if (LOAD_EDGE_VALUES)
+                edge_values[edge] = new_coo[edge].val;
         }
+        CooRowOp<Tuple, SizeT> row_of;
+        row_of.coo = new_coo;
+        util::host::Histogram(edges, row_of, row_offsets, nodes);
+        row_offsets[nodes] = util::host::ExclusiveScan(row_offsets, row_offsets, nodes);
+        free(new_coo); new_coo = NULL;
 
-        row_offsets[nodes] = edges;
-        delete[] edge_offsets; edge_offsets = NULL;
-        delete[] edge_counts ; edge_counts  = NULL;
+        // RowFirstTupleCompare also orders the columns within each row
+        if (ordered_rows) CheckRowsSorted();
+        else rows_sorted = true;
 
         time_t mark2 = time(NULL);
         if (!quiet)
@@ -669,20 +900,15 @@ struct Csr
         }
 
         // Write offsets, indices, node, edges etc. into file
-        if (LOAD_EDGE_VALUES)
+        if (output_file != NULL)
         {
-            WriteBinary(output_file, nodes, edges,
-                        row_offsets, column_indices, edge_values);
+            WriteBinary(output_file, nodes, edges, row_offsets, column_indices,
+                        LOAD_EDGE_VALUES ? edge_values : NULL, rows_sorted);
             //WriteCSR(output_file, nodes, edges,
             //         row_offsets, column_indices, edge_values);
             //WriteToLigraFile(output_file, nodes, edges,
             //                 row_offsets, column_indices, edge_values);
         }
-        else
-        {
-            WriteBinary(output_file, nodes, edges,
-                        row_offsets, column_indices);
-        }
 
         // Compute out_nodes
         SizeT out_node = 0;
@@ -825,6 +1051,19 @@ struct Csr
      */
     bool CheckValue()
     {
+        if (edge_values == NULL) return true;
+        if (reverse_edges != NULL)
+        {
+            bool symmetric = true;
+            #pragma omp parallel for reduction(&&:symmetric)
+            for (SizeT edge = 0; edge < edges; ++edge)
+            {
+                SizeT r_edge = reverse_edges[edge];
+                if (r_edge != -1 && edge_values[r_edge] != edge_values[edge])
+                    symmetric = false;
+            }
+            return symmetric;
+        }
         for (SizeT node = 0; node < nodes; ++node)
         {
             for (SizeT edge = row_offsets[node];
@@ -983,11 +1222,366 @@ struct Csr
 
     /**@}*/
 
+    /**
+     * @brief Checks whether every neighbor list is ascending and records
+     * the result in rows_sorted.
+     */
+    bool CheckRowsSorted()
+    {
+        bool sorted = true;
+        #pragma omp parallel for reduction(&&:sorted)
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            for (SizeT e = row_offsets[v] + 1; e < row_offsets[v+1]; e++)
+                if (column_indices[e] < column_indices[e-1])
+                {
+                    sorted = false;
+                    break;
+                }
+        }
+        rows_sorted = sorted;
+        return sorted;
+    }
+
+    /**
+     * @brief Sorts every neighbor list ascending, moving edge values
+     * along, unless the lists are known or found to be sorted already.
+     */
+    void SortRows()
+    {
+        if (rows_sorted || CheckRowsSorted()) return;
+        FreeEdgeMaps();  // edge ids change
+
+        bool narrow = (edge_values == NULL && edge_value_codes != NULL);
+        if (narrow) DequantizeEdgeValues();
+        if (edge_values == NULL)
+            util::host::SegmentedSort(column_indices, row_offsets, nodes);
+        else
+            util::host::SegmentedSortPairs(
+                column_indices, edge_values, row_offsets, nodes);
+        if (narrow) QuantizeEdgeValues(
+            (util::QuantizedValueType)edge_value_codec.type);
+        rows_sorted = true;
+    }
+
+    /**
+     * @brief Destination of edge e, from the full or the 32-bit indices.
+     */
+    VertexId ColumnIndex(SizeT e) const
+    {
+        return column_indices != NULL ? column_indices[e] :
+            (VertexId)local_column_indices[e];
+    }
+
+    /**
+     * @brief Replaces 64-bit column indices by 32-bit ones, for graphs whose
+     * vertex ids all fit, such as the sub-graphs of a partitioned graph.
+     * Pinned and mapped graphs are left as they are.
+     *
+     * \return Whether the indices are now 32-bit.
+     */
+    bool NarrowColumnIndices()
+    {
+        if (column_indices == NULL) return local_column_indices != NULL;
+        if (sizeof(VertexId) <= sizeof(unsigned int) || pinned ||
+            IsMapped(column_indices) ||
+            (unsigned long long)nodes > 0x100000000ull) return false;
+
+        local_column_indices = (unsigned int*) malloc(sizeof(unsigned int) * edges);
+        #pragma omp parallel for
+        for (SizeT e = 0; e < edges; e++)
+            local_column_indices[e] = (unsigned int)column_indices[e];
+        free(column_indices); column_indices = NULL;
+        return true;
+    }
+
+    /**
+     * @brief Replaces 32-bit column indices by full ones.
+     */
+    void WidenColumnIndices()
+    {
+        if (column_indices != NULL || local_column_indices == NULL) return;
+        column_indices = (VertexId*) malloc(sizeof(VertexId) * edges);
+        #pragma omp parallel for
+        for (SizeT e = 0; e < edges; e++)
+            column_indices[e] = (VertexId)local_column_indices[e];
+        free(local_column_indices); local_column_indices = NULL;
+    }
+
+    /**
+     * @brief Value of edge e, from the full or the narrow values.
+     */
+    Value EdgeValue(SizeT e) const
+    {
+        return edge_values != NULL ? edge_values[e] :
+            edge_value_codec.template Decode<Value>(edge_value_codes, e);
+    }
+
+    /**
+     * @brief Allocates room for the narrow codes of edges edge values.
+     */
+    void AllocateEdgeValueCodes(
+        const util::QuantizedValueCodec &codec, SizeT edges)
+    {
+        if (edge_value_codes && !IsMapped(edge_value_codes))
+            free(edge_value_codes);
+        edge_value_codec = codec;
+        edge_value_codes = (unsigned char*) malloc(codec.CodeBytes(edges));
+    }
+
+    /**
+     * @brief Replaces the edge values by narrow codes, which EdgeValue() and
+     * the primitives decode on the fly.
+     *
+     * @param[in] type Code type; QUANTIZED_AUTO only picks a lossless code,
+     * the explicit types may round.
+     *
+     * \return Whether the values are now narrow.
+     */
+    bool QuantizeEdgeValues(
+        util::QuantizedValueType type = util::QUANTIZED_AUTO)
+    {
+        if (edge_values == NULL) return edge_value_codes != NULL;
+        util::QuantizedValueCodec codec =
+            util::FindQuantization(edge_values, edges, type);
+        if (codec.type == util::QUANTIZED_NONE) return false;
+
+        AllocateEdgeValueCodes(codec, edges);
+        util::Quantize(codec, edge_values, edges, edge_value_codes);
+        if (!IsMapped(edge_values)) free(edge_values);
+        edge_values = NULL;
+        return true;
+    }
+
+    /**
+     * @brief Replaces narrow edge values by full ones.
+     */
+    void DequantizeEdgeValues()
+    {
+        if (edge_values != NULL || edge_value_codes == NULL) return;
+        edge_values = (Value*) malloc(sizeof(Value) * edges);
+        util::Dequantize(edge_value_codec, edge_value_codes, edges, edge_values);
+        if (!IsMapped(edge_value_codes)) free(edge_value_codes);
+        edge_value_codes = NULL;
+        edge_value_codec = util::QuantizedValueCodec();
+    }
+
+    /**
+     * @brief Builds an open-addressing hash table of the neighbors of every
+     * vertex with at least min_degree neighbors, for O(1) HasEdge on hubs.
+     *
+     * @param[in] min_degree Smallest degree to hash; 0 drops the index.
+     */
+    void BuildHubIndex(SizeT min_degree)
+    {
+        if (hub_offsets) { free(hub_offsets); hub_offsets = NULL; }
+        if (hub_table  ) { free(hub_table  ); hub_table   = NULL; }
+        hub_degree = min_degree;
+        if (min_degree <= 0) return;
+
+        HubCapacityOp<SizeT> capacity_of;
+        capacity_of.row_offsets = row_offsets;
+        capacity_of.min_degree  = min_degree;
+        hub_offsets = (SizeT*) malloc(sizeof(SizeT) * (nodes + 1));
+        hub_offsets[nodes] = util::host::ExclusiveScanOf(
+            nodes, capacity_of, hub_offsets, (SizeT)0);
+        hub_table = (VertexId*) malloc(sizeof(VertexId) *
+            (hub_offsets[nodes] > 0 ? hub_offsets[nodes] : 1));
+
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            SizeT capacity = hub_offsets[v+1] - hub_offsets[v];
+            if (capacity == 0) continue;
+            VertexId *table = hub_table + hub_offsets[v];
+            for (SizeT slot = 0; slot < capacity; slot++)
+                table[slot] = (VertexId)-1;
+            for (SizeT e = row_offsets[v]; e < row_offsets[v+1]; e++)
+            {
+                VertexId u    = ColumnIndex(e);
+                SizeT    slot = HubHash(u) & (capacity - 1);
+                while (table[slot] != (VertexId)-1 && table[slot] != u)
+                    slot = (slot + 1) & (capacity - 1);
+                table[slot] = u;
+            }
+        }
+    }
+
+    static SizeT HubHash(VertexId v)
+    {
+        return (SizeT)(((unsigned long long)v * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+    /**
+     * @brief Whether the edge u -> v exists: a hash probe for hubs, a
+     * binary search for sorted rows, a linear scan otherwise.
+     */
+    bool HasEdge(VertexId u, VertexId v) const
+    {
+        if (hub_offsets != NULL && hub_offsets[u+1] > hub_offsets[u])
+        {
+            SizeT           mask  = hub_offsets[u+1] - hub_offsets[u] - 1;
+            const VertexId *table = hub_table + hub_offsets[u];
+            for (SizeT slot = HubHash(v) & mask; ; slot = (slot + 1) & mask)
+            {
+                if (table[slot] == v) return true;
+                if (table[slot] == (VertexId)-1) return false;
+            }
+        }
+        if (column_indices != NULL) return RowHas(column_indices, u, v);
+        return RowHas(local_column_indices, u, (unsigned int)v);
+    }
+
+    /**
+     * @brief Whether the row of u in indices, full or 32-bit, holds v.
+     */
+    template <typename IndexT>
+    bool RowHas(const IndexT *indices, VertexId u, IndexT v) const
+    {
+        const IndexT *begin = indices + row_offsets[u];
+        const IndexT *end   = indices + row_offsets[u+1];
+        if (rows_sorted) return std::binary_search(begin, end, v);
+        return std::find(begin, end, v) != end;
+    }
+
+    /**
+     * @brief Builds reverse_edges and csc_to_csr_edges, sorting the neighbor
+     * lists first if needed. The in-edges of every vertex are ordered by
+     * (destination, source) with a parallel sort, which gives the csc
+     * numbering; the out-list and the in-list of each vertex are then merged,
+     * and every match pairs edge u -> v with its reverse v -> u. Parallel
+     * edges are paired in order of their ids.
+     */
+    void BuildEdgeMaps()
+    {
+        struct InEdge
+        {
+            unsigned long long key;  // destination * nodes + source
+            SizeT              edge;
+        };
+        struct InEdgeLess
+        {
+            bool operator()(const InEdge &a, const InEdge &b) const
+            {
+                return (a.key < b.key) || (a.key == b.key && a.edge < b.edge);
+            }
+        };
+
+        SortRows();
+        FreeEdgeMaps();
+        reverse_edges    = (SizeT*) malloc(sizeof(SizeT) * edges);
+        csc_to_csr_edges = (SizeT*) malloc(sizeof(SizeT) * edges);
+        InEdge *in_edges   = (InEdge*) malloc(sizeof(InEdge) * edges);
+        SizeT  *in_offsets = (SizeT* ) malloc(sizeof(SizeT ) * (nodes + 1));
+
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (SizeT u = 0; u < nodes; u++)
+        {
+            for (SizeT e = row_offsets[u]; e < row_offsets[u+1]; e++)
+            {
+                in_edges[e].key  = (unsigned long long)column_indices[e]
+                    * nodes + u;
+                in_edges[e].edge = e;
+            }
+        }
+        util::omp_sort(in_edges, edges, InEdgeLess());
+
+        for (SizeT v = 0; v <= nodes; v++) in_offsets[v] = 0;
+        for (SizeT e = 0; e < edges; e++)
+            in_offsets[in_edges[e].key / nodes + 1] ++;
+        for (SizeT v = 0; v < nodes; v++)
+            in_offsets[v+1] += in_offsets[v];
+
+        #pragma omp parallel for
+        for (SizeT e = 0; e < edges; e++)
+            csc_to_csr_edges[e] = in_edges[e].edge;
+
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (SizeT u = 0; u < nodes; u++)
+        {
+            // out-neighbors of u against in-neighbors of u, both ascending
+            SizeT e = row_offsets[u], p = in_offsets[u];
+            while (e < row_offsets[u+1])
+            {
+                VertexId v = column_indices[e];
+                while (p < in_offsets[u+1] &&
+                    (VertexId)(in_edges[p].key % nodes) < v) p++;
+                if (p < in_offsets[u+1] &&
+                    (VertexId)(in_edges[p].key % nodes) == v)
+                {
+                    reverse_edges[e] = in_edges[p].edge;
+                    p++;
+                }
+                else reverse_edges[e] = -1;
+                e++;
+            }
+        }
+
+        free(in_edges  ); in_edges   = NULL;
+        free(in_offsets); in_offsets = NULL;
+    }
+
+    /**
+     * @brief Checks the edge maps: every paired edge u -> v has a reverse
+     * v -> u that maps back to it, and csc_to_csr_edges lists the edges by
+     * ascending destination.
+     *
+     * \return Number of edges failing a check, 0 if there are no maps.
+     */
+    SizeT CheckEdgeMaps() const
+    {
+        if (reverse_edges == NULL || csc_to_csr_edges == NULL) return 0;
+        SizeT num_errors = 0;
+        #pragma omp parallel for schedule(dynamic, 1024) reduction(+:num_errors)
+        for (SizeT u = 0; u < nodes; u++)
+        {
+            for (SizeT e = row_offsets[u]; e < row_offsets[u+1]; e++)
+            {
+                SizeT r = reverse_edges[e];
+                if (r == -1) continue;
+                VertexId v = column_indices[e];
+                if (r >= edges || reverse_edges[r] != e ||
+                    column_indices[r] != u ||
+                    r < row_offsets[v] || r >= row_offsets[v+1])
+                    num_errors ++;
+            }
+        }
+        #pragma omp parallel for reduction(+:num_errors)
+        for (SizeT e = 1; e < edges; e++)
+            if (column_indices[csc_to_csr_edges[e]] <
+                column_indices[csc_to_csr_edges[e-1]])
+                num_errors ++;
+        return num_errors;
+    }
+
+    void FreeEdgeMaps()
+    {
+        if (reverse_edges   && !IsMapped(reverse_edges   )) free(reverse_edges   );
+        if (csc_to_csr_edges && !IsMapped(csc_to_csr_edges)) free(csc_to_csr_edges);
+        reverse_edges    = NULL;
+        csc_to_csr_edges = NULL;
+    }
+
     /**
      * @brief Deallocates CSR graph
      */
     void Free()
     {
+        if (mapped_base)
+        {
+            // arrays point into the mapping, nothing else to free
+            FreeEdgeMaps();
+            if (edge_values && !IsMapped(edge_values)) free(edge_values);
+            if (edge_value_codes && !IsMapped(edge_value_codes))
+                free(edge_value_codes);
+            row_offsets    = NULL;
+            column_indices = NULL;
+            edge_values    = NULL;
+            edge_value_codes = NULL;
+            munmap(mapped_base, mapped_size);
+            mapped_base = NULL;
+            mapped_size = 0;
+        }
         if (row_offsets)
         {
             if (pinned)
@@ -1026,9 +1620,21 @@ struct Csr
         {
             free (node_values); node_values = NULL;
         }
+        if (edge_value_codes)
+        {
+            free (edge_value_codes); edge_value_codes = NULL;
+        }
+        if (local_column_indices)
+        {
+            free (local_column_indices); local_column_indices = NULL;
+        }
+        edge_value_codec = util::QuantizedValueCodec();
+        BuildHubIndex(0);
+        FreeEdgeMaps();
 
         nodes = 0;
         edges = 0;
+        rows_sorted = false;
     }
 
     /**
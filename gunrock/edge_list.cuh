@@ -0,0 +1,220 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * edge_list.cuh
+ *
+ * @brief Edge-list (COO) view of a CSR graph, for edge-centric host
+ * primitives
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+
+#include <gunrock/csr.cuh>
+#include <gunrock/util/sort_omp.cuh>
+
+namespace gunrock {
+
+/**
+ * @brief Order of the edges in an EdgeList.
+ */
+enum EdgeOrder {
+    SOURCE_ORDER  = 0, // sorted by source, as the CSR rows
+    HILBERT_ORDER = 1, // along a Hilbert curve over the adjacency matrix
+};
+
+/**
+ * @brief Position of (x, y) along the Hilbert curve filling an n x n grid,
+ * n being a power of two.
+ */
+inline unsigned long long HilbertKey(
+    unsigned long long n,
+    unsigned long long x,
+    unsigned long long y)
+{
+    unsigned long long d = 0;
+    for (unsigned long long s = n / 2; s > 0; s /= 2)
+    {
+        unsigned long long rx = (x & s) > 0;
+        unsigned long long ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            unsigned long long t = x; x = y; y = t;
+        }
+    }
+    return d;
+}
+
+/**
+ * @brief Edge list of a graph: parallel froms / tos arrays.
+ *
+ * In Hilbert order consecutive edges touch nearby sources and destinations,
+ * so an edge stream split into contiguous chunks keeps each thread's
+ * random reads and writes within a small vertex range.
+ *
+ * @tparam VertexId Vertex identifier.
+ * @tparam SizeT Graph size type.
+ * @tparam Value Associated value type.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+struct EdgeList
+{
+    SizeT      nodes;
+    SizeT      edges;
+    VertexId  *froms;
+    VertexId  *tos;
+    Value     *edge_values;
+    EdgeOrder  order;
+
+    EdgeList() :
+        nodes      (0   ),
+        edges      (0   ),
+        froms      (NULL),
+        tos        (NULL),
+        edge_values(NULL),
+        order      (SOURCE_ORDER)
+    {
+    }
+
+    ~EdgeList()
+    {
+        Free();
+    }
+
+    /**
+     * @brief Builds the edge list from a CSR graph.
+     *
+     * @param[in] graph Source CSR graph.
+     * @param[in] _order Edge order.
+     */
+    void FromCsr(
+        const Csr<VertexId, SizeT, Value> &graph,
+        EdgeOrder _order = SOURCE_ORDER)
+    {
+        Free();
+        nodes = graph.nodes;
+        edges = graph.edges;
+        order = SOURCE_ORDER;
+        froms = (VertexId*) malloc(sizeof(VertexId) * edges);
+        tos   = (VertexId*) malloc(sizeof(VertexId) * edges);
+        if (graph.edge_values != NULL || graph.edge_value_codes != NULL)
+            edge_values = (Value*) malloc(sizeof(Value) * edges);
+
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            for (SizeT e = graph.row_offsets[v]; e < graph.row_offsets[v+1]; e++)
+            {
+                froms[e] = v;
+                tos  [e] = graph.column_indices[e];
+                if (edge_values != NULL)
+                    edge_values[e] = graph.EdgeValue(e);
+            }
+        }
+        if (_order == HILBERT_ORDER) HilbertSort();
+    }
+
+    /**
+     * @brief Reorders the edges along a Hilbert curve.
+     */
+    void HilbertSort()
+    {
+        struct EdgeKey
+        {
+            unsigned long long key;
+            SizeT              edge;
+        };
+        struct KeyLess
+        {
+            bool operator()(const EdgeKey &a, const EdgeKey &b) const
+            {
+                return a.key < b.key;
+            }
+        };
+
+        unsigned long long n = 1;
+        while (n < (unsigned long long)nodes) n <<= 1;
+        EdgeKey *keys = (EdgeKey*) malloc(sizeof(EdgeKey) * edges);
+        #pragma omp parallel for
+        for (SizeT e = 0; e < edges; e++)
+        {
+            keys[e].key  = HilbertKey(n, froms[e], tos[e]);
+            keys[e].edge = e;
+        }
+        util::omp_sort(keys, edges, KeyLess());
+
+        VertexId *new_froms = (VertexId*) malloc(sizeof(VertexId) * edges);
+        VertexId *new_tos   = (VertexId*) malloc(sizeof(VertexId) * edges);
+        Value    *new_values = (edge_values == NULL) ? NULL :
+            (Value*) malloc(sizeof(Value) * edges);
+        #pragma omp parallel for
+        for (SizeT e = 0; e < edges; e++)
+        {
+            SizeT org = keys[e].edge;
+            new_froms[e] = froms[org];
+            new_tos  [e] = tos  [org];
+            if (new_values != NULL) new_values[e] = edge_values[org];
+        }
+        free(keys ); keys  = NULL;
+        free(froms); froms = new_froms;
+        free(tos  ); tos   = new_tos;
+        if (edge_values != NULL)
+        {
+            free(edge_values); edge_values = new_values;
+        }
+        order = HILBERT_ORDER;
+    }
+
+    /**
+     * @brief Applies op(edge, from, to) to every edge in parallel. Each
+     * thread gets a contiguous range of the edge stream.
+     *
+     * @tparam OpT Edge operation.
+     * @param[in] op Edge operation.
+     */
+    template <typename OpT>
+    void ForAllEdges(OpT &op) const
+    {
+        #pragma omp parallel
+        {
+            int   thread_num  = omp_get_thread_num();
+            int   num_threads = omp_get_num_threads();
+            SizeT edge_start  = (long long)edges * thread_num / num_threads;
+            SizeT edge_end    = (long long)edges * (thread_num + 1) / num_threads;
+            for (SizeT e = edge_start; e < edge_end; e++)
+                op(e, froms[e], tos[e]);
+        }
+    }
+
+    void Free()
+    {
+        if (froms      ) { free(froms      ); froms       = NULL; }
+        if (tos        ) { free(tos        ); tos         = NULL; }
+        if (edge_values) { free(edge_values); edge_values = NULL; }
+        nodes = 0;
+        edges = 0;
+    }
+};
+
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,851 @@
+// ----------------------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------------------
+
+/**
+ * @file
+ * compressed.cuh
+ *
+ * @brief Reads gzip, bzip2 and zstd compressed graph files, and tar
+ * archives of them, without unpacking them to disk. The compressed file is
+ * split into independently decodable units -- BGZF blocks (bgzip), bzip2
+ * streams (pbzip2), zstd frames (zstd -T, pzstd) -- which a pool of
+ * threads decodes in parallel, ahead of the reader; files of a single unit
+ * are decoded by one thread, still overlapped with the parsing. Support
+ * for each format is compiled in with ZLIB_FOUND, BZIP2_FOUND and
+ * ZSTD_FOUND.
+ */
+
+#pragma once
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // fopencookie
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <omp.h>
+
+#ifdef ZLIB_FOUND
+  #include <zlib.h>
+#endif
+#ifdef BZIP2_FOUND
+  #include <bzlib.h>
+#endif
+#ifdef ZSTD_FOUND
+  #include <zstd.h>
+#endif
+
+namespace gunrock {
+namespace graphio {
+
+#define COMPRESSED_CHUNK_BYTES (4 << 20)  // decoded bytes per chunk
+#define COMPRESSED_UNIT_CHUNKS 4          // chunks a unit buffers ahead
+#define TAR_BLOCK_BYTES        512
+
+enum CompressionType
+{
+    COMPRESSION_NONE  = 0,
+    COMPRESSION_GZIP  = 1,
+    COMPRESSION_BZIP2 = 2,
+    COMPRESSION_ZSTD  = 3,
+};
+
+inline const char* CompressionName(CompressionType type)
+{
+    return type == COMPRESSION_GZIP  ? "gzip"  :
+          (type == COMPRESSION_BZIP2 ? "bzip2" :
+          (type == COMPRESSION_ZSTD  ? "zstd"  : "none"));
+}
+
+/**
+ * @brief Whether support for a compression type is compiled in.
+ */
+inline bool CompressionSupported(CompressionType type)
+{
+    switch (type)
+    {
+    case COMPRESSION_NONE : return true;
+#ifdef ZLIB_FOUND
+    case COMPRESSION_GZIP : return true;
+#endif
+#ifdef BZIP2_FOUND
+    case COMPRESSION_BZIP2: return true;
+#endif
+#ifdef ZSTD_FOUND
+    case COMPRESSION_ZSTD : return true;
+#endif
+    default: return false;
+    }
+}
+
+/**
+ * @brief Compression of a buffer, from its magic number.
+ */
+inline CompressionType DetectCompression(const unsigned char *head, size_t size)
+{
+    if (size >= 3 && head[0] == 0x1f && head[1] == 0x8b && head[2] == 8)
+        return COMPRESSION_GZIP;
+    if (size >= 4 && head[0] == 'B' && head[1] == 'Z' && head[2] == 'h' &&
+        head[3] >= '1' && head[3] <= '9')
+        return COMPRESSION_BZIP2;
+    if (size >= 4 && head[0] == 0x28 && head[1] == 0xb5 && head[2] == 0x2f &&
+        head[3] == 0xfd)
+        return COMPRESSION_ZSTD;
+    return COMPRESSION_NONE;
+}
+
+/**
+ * @brief Compression of a file, from its first bytes.
+ */
+inline CompressionType DetectFileCompression(const char *file_name)
+{
+    unsigned char head[4];
+    FILE *file = fopen(file_name, "rb");
+    if (file == NULL) return COMPRESSION_NONE;
+    size_t size = fread(head, 1, sizeof(head), file);
+    fclose(file);
+    return DetectCompression(head, size);
+}
+
+/**
+ * @brief Length of the compression and archive extensions ending a file
+ * name (.gz, .tgz, .bz2, .zst, each possibly after .tar), 0 if none.
+ */
+inline size_t CompressedExtensionLength(const std::string &name)
+{
+    static const char *extensions[] = {
+        ".tar.gz", ".tar.bz2", ".tar.zst", ".tgz", ".gz", ".bz2", ".zst", NULL};
+    for (int i = 0; extensions[i] != NULL; i++)
+    {
+        size_t length = strlen(extensions[i]);
+        if (name.size() > length &&
+            name.compare(name.size() - length, length, extensions[i]) == 0)
+            return length;
+    }
+    return 0;
+}
+
+/**
+ * @brief Sequential reader of the decoded content of a compressed file.
+ * Decoding runs in background threads; Read() returns the bytes in order.
+ * For a tar archive, only the selected member is returned: by default the
+ * matrix <dir>/<dir>.mtx of the SuiteSparse archives, or the first .mtx
+ * member of an archive without directories.
+ */
+class CompressedReader
+{
+public:
+    CompressionType type;
+    size_t          num_units;     // independently decoded units
+    std::string     member_name;   // tar member read, if any
+    std::string     error;         // set once a read fails
+
+    CompressedReader() :
+        type        (COMPRESSION_NONE),
+        num_units   (0),
+        data        (NULL),
+        data_size   (0),
+        head        (0),
+        next_unit   (0),
+        window      (0),
+        stopping    (false),
+        failed      (false),
+        tar_mode    (false),
+        tar_checked (false),
+        tar_remaining(0),
+        stream      (NULL)
+    {
+        pthread_mutex_init(&mutex, NULL);
+        pthread_cond_init (&chunk_cond, NULL);
+        pthread_cond_init (&space_cond, NULL);
+    }
+
+    ~CompressedReader()
+    {
+        Close();
+        pthread_mutex_destroy(&mutex);
+        pthread_cond_destroy (&chunk_cond);
+        pthread_cond_destroy (&space_cond);
+    }
+
+    /**
+     * @brief Opens a compressed file and starts decoding it.
+     *
+     * @param[in] file_name Compressed file.
+     * @param[in] num_threads Decoding threads, 0 for the OpenMP thread count.
+     * @param[in] untar Whether to read a tar archive's matrix member
+     * instead of the archive.
+     *
+     * \return 0 on success, -1 with error set otherwise.
+     */
+    int Open(const char *file_name, int num_threads = 0, bool untar = true)
+    {
+        Close();
+        int fd = open(file_name, O_RDONLY);
+        struct stat file_stat;
+        if (fd < 0 || fstat(fd, &file_stat) != 0)
+        {
+            if (fd >= 0) close(fd);
+            return Fail(std::string("cannot open ") + file_name);
+        }
+        data_size = file_stat.st_size;
+        data = data_size == 0 ? NULL : (const unsigned char*)
+            mmap(NULL, data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+        {
+            data = NULL;
+            return Fail(std::string("cannot map ") + file_name);
+        }
+        if (data_size > 0) madvise((void*)data, data_size, MADV_SEQUENTIAL);
+
+        type = DetectCompression(data, data_size);
+        if (type == COMPRESSION_NONE)
+            return Fail(std::string(file_name) + " is not compressed");
+        if (!CompressionSupported(type))
+            return Fail(std::string(CompressionName(type)) +
+                " support is not compiled in (" + file_name + ")");
+        FindUnits();
+        num_units = units.size();
+
+        if (num_threads <= 0) num_threads = omp_get_max_threads();
+        if ((size_t)num_threads > num_units) num_threads = num_units;
+        window      = 2 * num_threads;
+        tar_checked = !untar;
+        threads.resize(num_threads);
+        for (int i = 0; i < num_threads; i++)
+            pthread_create(&threads[i], NULL, DecodeThread, this);
+        return 0;
+    }
+
+    void Close()
+    {
+        if (stream != NULL) { fclose(stream); stream = NULL; }
+        pthread_mutex_lock(&mutex);
+        stopping = true;
+        pthread_cond_broadcast(&space_cond);
+        pthread_mutex_unlock(&mutex);
+        for (size_t i = 0; i < threads.size(); i++)
+            pthread_join(threads[i], NULL);
+        threads.clear();
+        for (size_t u = 0; u < units.size(); u++)
+            for (size_t c = 0; c < units[u].chunks.size(); c++)
+                free(units[u].chunks[c].data);
+        units.clear();
+        if (data != NULL) { munmap((void*)data, data_size); data = NULL; }
+        data_size = 0;
+        head = next_unit = 0;
+        stopping = failed = false;
+        tar_mode = tar_checked = false;
+        tar_remaining = 0;
+        tar_buffer.clear();
+        type      = COMPRESSION_NONE;
+        num_units = 0;
+        member_name.clear();
+        error.clear();
+    }
+
+    /**
+     * @brief Reads the next decoded bytes.
+     *
+     * \return Bytes read; 0 at the end or after an error (error is set).
+     */
+    size_t Read(char *buffer, size_t size)
+    {
+        if (!tar_checked) CheckTar();
+        if (tar_mode)
+        {
+            size = (size_t) std::min((unsigned long long)size, tar_remaining);
+            size = BufferedRead(buffer, size);
+            tar_remaining -= size;
+            return size;
+        }
+        return BufferedRead(buffer, size);
+    }
+
+    bool Failed() const { return !error.empty(); }
+
+    /**
+     * @brief The decoded content as a FILE*, e.g. for ReadMarketStream();
+     * owned by the reader and closed by Close().
+     */
+    FILE* Stream()
+    {
+        if (stream != NULL) return stream;
+        cookie_io_functions_t functions;
+        memset(&functions, 0, sizeof(functions));
+        functions.read = CookieRead;
+        stream = fopencookie(this, "r", functions);
+        return stream;
+    }
+
+    /**
+     * @brief Reads all the decoded content into a malloc()ed buffer, for
+     * parsers that split their input.
+     *
+     * @param[out] content Decoded bytes, NUL terminated, to be freed by the
+     * caller.
+     * @param[out] size Number of decoded bytes.
+     *
+     * \return Whether the whole content was decoded.
+     */
+    bool ReadAll(char *&content, size_t &size)
+    {
+        size_t capacity = std::max(data_size * 4, (size_t)COMPRESSED_CHUNK_BYTES);
+        content = (char*) malloc(capacity + 1);
+        size    = 0;
+        while (content != NULL)
+        {
+            if (size == capacity)
+            {
+                capacity *= 2;
+                char *grown = (char*) realloc(content, capacity + 1);
+                if (grown == NULL) { free(content); content = NULL; break; }
+                content = grown;
+            }
+            size_t got = Read(content + size, capacity - size);
+            if (got == 0) break;
+            size += got;
+        }
+        if (content == NULL) Fail("out of memory");
+        else content[size] = '\0';
+        return !Failed();
+    }
+
+private:
+    struct Chunk
+    {
+        char  *data;
+        size_t size;
+        size_t offset;  // bytes already read
+    };
+
+    struct Unit
+    {
+        size_t            begin;   // compressed range
+        size_t            end;
+        std::deque<Chunk> chunks;  // decoded, not read yet
+        bool              done;
+    };
+
+    const unsigned char   *data;       // compressed file, mapped
+    size_t                 data_size;
+    std::vector<Unit>      units;
+    size_t                 head;       // unit being read
+    size_t                 next_unit;  // next unit to decode
+    size_t                 window;     // units decoded ahead of head
+    std::vector<pthread_t> threads;
+    bool                   stopping;
+    bool                   failed;
+    pthread_mutex_t        mutex;
+    pthread_cond_t         chunk_cond;  // a chunk was decoded, or a unit done
+    pthread_cond_t         space_cond;  // a chunk was read, or head moved
+
+    bool                   tar_mode;
+    bool                   tar_checked;
+    unsigned long long     tar_remaining;  // bytes left of the member
+    std::string            tar_buffer;     // bytes read while checking
+    FILE                  *stream;
+
+    int Fail(const std::string &message)
+    {
+        pthread_mutex_lock(&mutex);
+        if (error.empty()) error = message;
+        failed = true;
+        pthread_cond_broadcast(&chunk_cond);
+        pthread_cond_broadcast(&space_cond);
+        pthread_mutex_unlock(&mutex);
+        return -1;
+    }
+
+    /**
+     * @brief Splits the file into units that decode independently.
+     */
+    void FindUnits()
+    {
+        std::vector<size_t> starts;
+        if (type == COMPRESSION_GZIP)
+        {
+            // BGZF blocks carry their size in a BC extra field; other gzip
+            // members can only be found by decoding, so the rest of the
+            // file is one unit
+            size_t p = 0;
+            while (p < data_size)
+            {
+                starts.push_back(p);
+                size_t block_size = BgzfBlockSize(p);
+                if (block_size == 0 || p + block_size > data_size) break;
+                p += block_size;
+            }
+        } else if (type == COMPRESSION_ZSTD) {
+#ifdef ZSTD_FOUND
+            size_t p = 0;
+            while (p < data_size)
+            {
+                starts.push_back(p);
+                size_t frame_size = ZSTD_findFrameCompressedSize(
+                    data + p, data_size - p);
+                if (ZSTD_isError(frame_size) || frame_size == 0) break;
+                p += frame_size;
+            }
+#endif
+        } else if (type == COMPRESSION_BZIP2) {
+            FindBzip2Streams(starts);
+        }
+        if (starts.empty()) starts.push_back(0);
+
+        units.resize(starts.size());
+        for (size_t u = 0; u < starts.size(); u++)
+        {
+            units[u].begin = starts[u];
+            units[u].end   = (u + 1 < starts.size()) ? starts[u+1] : data_size;
+            units[u].done  = false;
+        }
+    }
+
+    /**
+     * @brief Size of the BGZF block at p, 0 if it is not one.
+     */
+    size_t BgzfBlockSize(size_t p) const
+    {
+        const unsigned char *h = data + p;
+        if (p + 18 > data_size || h[0] != 0x1f || h[1] != 0x8b || h[2] != 8 ||
+            (h[3] & 4) == 0)
+            return 0;
+        size_t extra_length = h[10] | (h[11] << 8);
+        const unsigned char *field = h + 12, *extra_end = field + extra_length;
+        if (p + 12 + extra_length > data_size) return 0;
+        while (field + 4 <= extra_end)
+        {
+            size_t field_length = field[2] | (field[3] << 8);
+            if (field[0] == 'B' && field[1] == 'C' && field_length == 2 &&
+                field + 6 <= extra_end)
+                return (size_t)(field[4] | (field[5] << 8)) + 1;
+            field += 4 + field_length;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Byte-aligned stream headers of a bzip2 file, as written by
+     * concatenating or by pbzip2: "BZh<level>" then the block magic (pi) or
+     * the end-of-stream magic (sqrt(pi)). Found by a parallel scan.
+     */
+    void FindBzip2Streams(std::vector<size_t> &starts) const
+    {
+        static const unsigned char block_magic[6] = {0x31, 0x41, 0x59, 0x26, 0x53, 0x59};
+        static const unsigned char end_magic  [6] = {0x17, 0x72, 0x45, 0x38, 0x50, 0x90};
+        int num_threads = omp_get_max_threads();
+        std::vector<std::vector<size_t> > parts(num_threads);
+
+        #pragma omp parallel num_threads(num_threads)
+        {
+            int thread_num = omp_get_thread_num();
+            size_t begin = data_size * thread_num / num_threads;
+            size_t end   = data_size * (thread_num + 1) / num_threads;
+            for (size_t p = begin; p < end && p + 10 <= data_size; )
+            {
+                const unsigned char *b = (const unsigned char*)
+                    memchr(data + p, 'B', end - p);
+                if (b == NULL) break;
+                p = b - data;
+                if (p + 10 <= data_size && b[1] == 'Z' && b[2] == 'h' &&
+                    b[3] >= '1' && b[3] <= '9' &&
+                    (memcmp(b + 4, block_magic, 6) == 0 ||
+                     memcmp(b + 4, end_magic  , 6) == 0))
+                    parts[thread_num].push_back(p);
+                p++;
+            }
+        }
+        for (int t = 0; t < num_threads; t++)
+            starts.insert(starts.end(), parts[t].begin(), parts[t].end());
+        if (starts.empty() || starts[0] != 0) starts.insert(starts.begin(), 0);
+    }
+
+    /**
+     * @brief Hands a decoded chunk to the reader; waits while the unit has
+     * COMPRESSED_UNIT_CHUNKS chunks unread.
+     *
+     * \return false if decoding should stop.
+     */
+    bool PushChunk(size_t u, char *chunk_data, size_t size)
+    {
+        pthread_mutex_lock(&mutex);
+        while (!stopping && !failed &&
+            units[u].chunks.size() >= COMPRESSED_UNIT_CHUNKS)
+            pthread_cond_wait(&space_cond, &mutex);
+        bool go_on = !stopping && !failed;
+        if (go_on && size > 0)
+        {
+            Chunk chunk = {chunk_data, size, 0};
+            units[u].chunks.push_back(chunk);
+            pthread_cond_broadcast(&chunk_cond);
+        } else free(chunk_data);
+        pthread_mutex_unlock(&mutex);
+        return go_on;
+    }
+
+    /**
+     * @brief Decodes one unit into chunks.
+     *
+     * \return false on a decoding error.
+     */
+    bool DecodeUnit(size_t u)
+    {
+        const unsigned char *in = data + units[u].begin;
+        size_t in_size = units[u].end - units[u].begin;
+        char  *out     = (char*) malloc(COMPRESSED_CHUNK_BYTES);
+        size_t out_size = 0;
+        bool   ok = false;
+        bool   stopped = false;
+
+        // hands out full chunks; decoding loops call it with out_size
+        // reaching COMPRESSED_CHUNK_BYTES. On a stop it leaves the loop, so
+        // the decoder's stream is still ended below
+        #define COMPRESSED_FLUSH()                                           \
+            if (out_size == COMPRESSED_CHUNK_BYTES) {                        \
+                if (!PushChunk(u, out, out_size)) {                          \
+                    out = NULL; stopped = true; break;                       \
+                }                                                            \
+                out = (char*) malloc(COMPRESSED_CHUNK_BYTES);                \
+                out_size = 0;                                                \
+            }
+
+        if (type == COMPRESSION_GZIP)
+        {
+#ifdef ZLIB_FOUND
+            z_stream z;
+            memset(&z, 0, sizeof(z));
+            inflateInit2(&z, 15 + 16);
+            size_t used = 0;
+            int status = Z_OK;
+            while (true)
+            {
+                z.next_in   = (Bytef*)(in + used);
+                z.avail_in  = (uInt) std::min(in_size - used, (size_t)1 << 30);
+                z.next_out  = (Bytef*)(out + out_size);
+                z.avail_out = COMPRESSED_CHUNK_BYTES - out_size;
+                uInt avail_in = z.avail_in;
+                status = inflate(&z, Z_NO_FLUSH);
+                used    += avail_in - z.avail_in;
+                out_size = COMPRESSED_CHUNK_BYTES - z.avail_out;
+                if (status == Z_STREAM_END)
+                {
+                    // concatenated members; anything else after is ignored,
+                    // as gzip does
+                    if (used + 2 <= in_size && in[used] == 0x1f && in[used+1] == 0x8b)
+                    {
+                        inflateReset(&z);
+                        COMPRESSED_FLUSH();
+                        continue;
+                    }
+                    ok = true;
+                    break;
+                }
+                if (status != Z_OK && status != Z_BUF_ERROR) break;
+                if (status == Z_BUF_ERROR && z.avail_out != 0) break;  // truncated
+                COMPRESSED_FLUSH();
+            }
+            inflateEnd(&z);
+#endif
+        } else if (type == COMPRESSION_BZIP2) {
+#ifdef BZIP2_FOUND
+            bz_stream z;
+            memset(&z, 0, sizeof(z));
+            BZ2_bzDecompressInit(&z, 0, 0);
+            size_t used = 0;
+            while (true)
+            {
+                z.next_in   = (char*)(in + used);
+                z.avail_in  = (unsigned int) std::min(in_size - used, (size_t)1 << 30);
+                z.next_out  = out + out_size;
+                z.avail_out = COMPRESSED_CHUNK_BYTES - out_size;
+                unsigned int avail_in = z.avail_in, avail_out = z.avail_out;
+                int status = BZ2_bzDecompress(&z);
+                used    += avail_in - z.avail_in;
+                out_size = COMPRESSED_CHUNK_BYTES - z.avail_out;
+                if (status == BZ_STREAM_END)
+                {
+                    if (used + 4 <= in_size && DetectCompression(in + used, 4)
+                        == COMPRESSION_BZIP2)
+                    {
+                        BZ2_bzDecompressEnd(&z);
+                        memset(&z, 0, sizeof(z));
+                        BZ2_bzDecompressInit(&z, 0, 0);
+                        COMPRESSED_FLUSH();
+                        continue;
+                    }
+                    ok = true;
+                    break;
+                }
+                if (status != BZ_OK) break;
+                if (avail_in == z.avail_in && avail_out == z.avail_out) break;  // truncated
+                COMPRESSED_FLUSH();
+            }
+            BZ2_bzDecompressEnd(&z);
+#endif
+        } else if (type == COMPRESSION_ZSTD) {
+#ifdef ZSTD_FOUND
+            ZSTD_DStream *z = ZSTD_createDStream();
+            ZSTD_initDStream(z);
+            ZSTD_inBuffer input = {in, in_size, 0};
+            size_t status = 0;
+            while (true)
+            {
+                ZSTD_outBuffer output = {out, COMPRESSED_CHUNK_BYTES, out_size};
+                size_t pos = input.pos;
+                status   = ZSTD_decompressStream(z, &output, &input);
+                out_size = output.pos;
+                if (ZSTD_isError(status)) break;
+                if (input.pos == in_size && status == 0) { ok = true; break; }
+                if (input.pos == pos && output.pos < output.size &&
+                    input.pos == in_size)
+                    break;  // truncated
+                COMPRESSED_FLUSH();
+            }
+            ZSTD_freeDStream(z);
+#endif
+        }
+        #undef COMPRESSED_FLUSH
+
+        if (stopped) return true;
+        if (!PushChunk(u, out, out_size)) return true;
+        return ok;
+    }
+
+    static void* DecodeThread(void *reader_)
+    {
+        CompressedReader *reader = (CompressedReader*)reader_;
+        pthread_mutex_lock(&reader->mutex);
+        while (true)
+        {
+            while (!reader->stopping && !reader->failed &&
+                reader->next_unit < reader->units.size() &&
+                reader->next_unit >= reader->head + reader->window)
+                pthread_cond_wait(&reader->space_cond, &reader->mutex);
+            if (reader->stopping || reader->failed ||
+                reader->next_unit >= reader->units.size())
+                break;
+            size_t u = reader->next_unit ++;
+            pthread_mutex_unlock(&reader->mutex);
+
+            bool ok = reader->DecodeUnit(u);
+
+            if (!ok)
+            {
+                char message[128];
+                sprintf(message, "corrupt or truncated %s data (unit %lld of %lld)",
+                    CompressionName(reader->type),
+                    (long long)u, (long long)reader->units.size());
+                reader->Fail(message);
+            }
+            pthread_mutex_lock(&reader->mutex);
+            reader->units[u].done = true;
+            pthread_cond_broadcast(&reader->chunk_cond);
+        }
+        pthread_mutex_unlock(&reader->mutex);
+        return NULL;
+    }
+
+    /**
+     * @brief Reads decoded bytes, ignoring tar.
+     */
+    size_t RawRead(char *buffer, size_t size)
+    {
+        size_t total = 0;
+        pthread_mutex_lock(&mutex);
+        while (total < size && head < units.size() && !failed)
+        {
+            Unit &unit = units[head];
+            if (unit.chunks.empty())
+            {
+                if (unit.done)
+                {
+                    head ++;
+                    pthread_cond_broadcast(&space_cond);
+                } else pthread_cond_wait(&chunk_cond, &mutex);
+                continue;
+            }
+            Chunk &chunk = unit.chunks.front();
+            size_t length = std::min(size - total, chunk.size - chunk.offset);
+            memcpy(buffer + total, chunk.data + chunk.offset, length);
+            chunk.offset += length;
+            total        += length;
+            if (chunk.offset == chunk.size)
+            {
+                free(chunk.data);
+                unit.chunks.pop_front();
+                pthread_cond_broadcast(&space_cond);
+            }
+        }
+        if (failed) total = 0;
+        pthread_mutex_unlock(&mutex);
+        return total;
+    }
+
+    /**
+     * @brief Reads size raw bytes, or up to the end, the ones kept by
+     * CheckTar() first.
+     */
+    size_t BufferedRead(char *buffer, size_t size)
+    {
+        size_t total = std::min(size, tar_buffer.size());
+        if (total > 0)
+        {
+            memcpy(buffer, tar_buffer.data(), total);
+            tar_buffer.erase(0, total);
+        }
+        while (total < size)
+        {
+            size_t got = RawRead(buffer + total, size - total);
+            if (got == 0) break;
+            total += got;
+        }
+        return total;
+    }
+
+    bool TarSkip(unsigned long long size)
+    {
+        char buffer[1 << 16];
+        while (size > 0)
+        {
+            size_t want = (size_t) std::min(size, (unsigned long long)sizeof(buffer));
+            if (BufferedRead(buffer, want) != want) return false;
+            size -= want;
+        }
+        return true;
+    }
+
+    static bool IsTarHeader(const unsigned char *block)
+    {
+        if (memcmp(block + 257, "ustar", 5) != 0) return false;
+        unsigned long long checksum = 0, stored = 0;
+        for (int i = 0; i < TAR_BLOCK_BYTES; i++)
+            checksum += (i >= 148 && i < 156) ? ' ' : block[i];
+        for (int i = 148; i < 156 && block[i] >= '0' && block[i] <= '7'; i++)
+            stored = stored * 8 + (block[i] - '0');
+        return checksum == stored;
+    }
+
+    /**
+     * @brief Checks whether the decoded content is a tar archive and, if
+     * so, moves to its matrix member.
+     */
+    void CheckTar()
+    {
+        tar_checked = true;
+        char block[TAR_BLOCK_BYTES];
+        size_t got = 0;
+        while (got < TAR_BLOCK_BYTES)
+        {
+            size_t length = RawRead(block + got, TAR_BLOCK_BYTES - got);
+            if (length == 0) break;
+            got += length;
+        }
+        tar_buffer.assign(block, got);
+        if (got < TAR_BLOCK_BYTES || !IsTarHeader((const unsigned char*)block))
+            return;
+        tar_mode = true;
+        if (!FindTarMember())
+            Fail("no matrix member (<dir>/<dir>.mtx) in the tar archive");
+    }
+
+    /**
+     * @brief Skips to the data of the archive's matrix member.
+     *
+     * \return false if the archive has none.
+     */
+    bool FindTarMember()
+    {
+        std::string long_name;
+        while (true)
+        {
+            unsigned char block[TAR_BLOCK_BYTES];
+            if (BufferedRead((char*)block, TAR_BLOCK_BYTES) != TAR_BLOCK_BYTES)
+                return false;
+            if (block[0] == 0) return false;  // end of archive
+            if (!IsTarHeader(block))
+            {
+                Fail("corrupt tar archive");
+                return false;
+            }
+            unsigned long long size = 0;
+            for (int i = 124; i < 136 && block[i] >= '0' && block[i] <= '7'; i++)
+                size = size * 8 + (block[i] - '0');
+            unsigned long long padded = (size + TAR_BLOCK_BYTES - 1)
+                / TAR_BLOCK_BYTES * TAR_BLOCK_BYTES;
+            char flag = block[156];
+
+            if (flag == 'L')  // GNU long name of the next member
+            {
+                std::vector<char> name(padded + 1, 0);
+                if (BufferedRead(&name[0], padded) != padded) return false;
+                long_name = std::string(&name[0]);
+                continue;
+            }
+            std::string name = long_name;
+            long_name.clear();
+            if (name.empty())
+            {
+                std::string prefix((const char*)block + 345,
+                    strnlen((const char*)block + 345, 155));
+                name.assign((const char*)block, strnlen((const char*)block, 100));
+                if (!prefix.empty()) name = prefix + "/" + name;
+            }
+            if ((flag == '0' || flag == '\0') && IsMatrixMember(name))
+            {
+                member_name   = name;
+                tar_remaining = size;
+                return true;
+            }
+            if (!TarSkip(padded)) return false;
+        }
+    }
+
+    /**
+     * @brief Whether a member is the archive's matrix: <dir>/<dir>.mtx, or
+     * <name>.mtx at the top level.
+     */
+    static bool IsMatrixMember(const std::string &name)
+    {
+        if (name.size() < 4 || name.compare(name.size() - 4, 4, ".mtx") != 0)
+            return false;
+        size_t slash = name.find_last_of('/');
+        if (slash == std::string::npos) return true;
+        std::string base = name.substr(slash + 1, name.size() - slash - 5);
+        std::string dir  = name.substr(0, slash);
+        size_t dir_slash = dir.find_last_of('/');
+        if (dir_slash != std::string::npos) dir = dir.substr(dir_slash + 1);
+        return base == dir;
+    }
+
+    static ssize_t CookieRead(void *cookie, char *buffer, size_t size)
+    {
+        CompressedReader *reader = (CompressedReader*)cookie;
+        size_t got = reader->Read(buffer, size);
+        return (got == 0 && reader->Failed()) ? -1 : (ssize_t)got;
+    }
+};
+
+} // namespace graphio
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
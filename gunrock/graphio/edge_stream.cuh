@@ -0,0 +1,385 @@
+// ----------------------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------------------
+
+/**
+ * @file
+ * edge_stream.cuh
+ *
+ * @brief Streams the edges of a MARKET file, plain or compressed, to an
+ * operator as they are parsed, without building a COO or CSR. The content
+ * is parsed in blocks, each split among the OpenMP threads at line
+ * boundaries; a compressed file is decoded in the background meanwhile.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#include <gunrock/graphio/compressed.cuh>
+
+namespace gunrock {
+namespace graphio {
+
+#define EDGE_STREAM_BLOCK_BYTES (64 << 20)  // decoded bytes parsed at once
+
+/**
+ * @brief Edges of a MARKET file, 0-based, in the direction they are
+ * stored: a symmetric file yields each edge once, and the caller adds the
+ * reverse if needed. Edges may reach the operator in any order and from
+ * several threads at once.
+ */
+class MarketEdgeStream
+{
+public:
+    long long   nodes;          // from the size line
+    long long   entries;        // from the size line
+    long long   edges_read;     // by the last ForAllEdges()
+    long long   edges_invalid;  // out-of-range or malformed, skipped
+    bool        symmetric;      // symmetric, skew-symmetric or hermitian
+    bool        skew;
+    bool        pattern;        // no values stored
+    std::string error;
+
+    MarketEdgeStream() :
+        nodes        (0),
+        entries      (0),
+        edges_read   (0),
+        edges_invalid(0),
+        symmetric    (false),
+        skew         (false),
+        pattern      (false),
+        num_threads  (0),
+        compression  (COMPRESSION_NONE),
+        data         (NULL),
+        data_size    (0),
+        data_handed  (false),
+        header_bytes (0),
+        buffer       (NULL),
+        buffer_size  (0),
+        buffer_used  (0),
+        buffer_start (0),
+        reader_done  (false)
+    {
+    }
+
+    ~MarketEdgeStream()
+    {
+        Close();
+    }
+
+    /**
+     * @brief Opens a MARKET file and reads its header.
+     *
+     * @param[in] file_name Input file, may be compressed.
+     * @param[in] num_threads Parsing threads, 0 for the OpenMP thread count.
+     *
+     * \return 0 on success, -1 with error set otherwise.
+     */
+    int Open(const char *file_name, int num_threads = 0)
+    {
+        Close();
+        this->file_name   = file_name;
+        this->num_threads = num_threads > 0 ? num_threads : omp_get_max_threads();
+        compression = DetectFileCompression(file_name);
+        if (compression == COMPRESSION_NONE)
+        {
+            int fd = open(file_name, O_RDONLY);
+            struct stat file_stat;
+            if (fd < 0 || fstat(fd, &file_stat) != 0)
+            {
+                if (fd >= 0) close(fd);
+                return Fail(std::string("cannot open ") + file_name);
+            }
+            data_size = file_stat.st_size;
+            data = data_size == 0 ? NULL : (const char*)
+                mmap(NULL, data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (data == MAP_FAILED)
+            {
+                data = NULL;
+                return Fail(std::string("cannot map ") + file_name);
+            }
+        }
+
+        const char *begin = NULL, *end = NULL;
+        if (!Rewind() || !NextBlock(begin, end)) return -1;
+        return ReadHeader(begin, end);
+    }
+
+    void Close()
+    {
+        reader.Close();
+        if (data != NULL) { munmap((void*)data, data_size); data = NULL; }
+        if (buffer != NULL) { free(buffer); buffer = NULL; }
+        data_size = header_bytes = 0;
+        buffer_size = buffer_used = buffer_start = 0;
+        reader_done = false;
+        nodes = entries = edges_read = edges_invalid = 0;
+        symmetric = skew = pattern = false;
+        error.clear();
+    }
+
+    bool Failed() const { return !error.empty(); }
+
+    /**
+     * @brief Parsing threads; the thread_num ForAllEdges() hands to the
+     * operator is below it.
+     */
+    int NumThreads() const { return num_threads; }
+
+    /**
+     * @brief Parses all the edges, calling op(thread_num, src, dst, value)
+     * for each; value is 0 unless LOAD_VALUES and the line has one. Can be
+     * called again for another pass.
+     *
+     * \return false if reading fails.
+     */
+    template <bool LOAD_VALUES, typename Op>
+    bool ForAllEdges(Op &op)
+    {
+        edges_read = edges_invalid = 0;
+        if (!Rewind()) return false;
+        const char *begin = NULL, *end = NULL;
+        bool first = true;
+        while (NextBlock(begin, end))
+        {
+            if (first) begin += header_bytes;
+            first = false;
+            ParseBlock<LOAD_VALUES>(begin, end, op);
+        }
+        return !Failed();
+    }
+
+private:
+    std::string      file_name;
+    int              num_threads;
+    CompressionType  compression;
+    CompressedReader reader;
+    const char      *data;          // mapped plain file
+    size_t           data_size;
+    bool             data_handed;
+    size_t           header_bytes;  // from the start of the content
+    char            *buffer;        // decoded content being parsed
+    size_t           buffer_size;
+    size_t           buffer_used;
+    size_t           buffer_start;  // of the unparsed tail of a line
+    bool             reader_done;
+
+    int Fail(const std::string &message)
+    {
+        if (error.empty()) error = message;
+        return -1;
+    }
+
+    bool Rewind()
+    {
+        data_handed = false;
+        if (compression == COMPRESSION_NONE) return true;
+        buffer_used = buffer_start = 0;
+        reader_done = false;
+        if (reader.Open(file_name.c_str(), num_threads) != 0)
+        {
+            Fail(reader.error);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Next range of whole lines: all the mapped file, or the decoded
+     * bytes read so far up to the last newline.
+     */
+    bool NextBlock(const char *&begin, const char *&end)
+    {
+        if (compression == COMPRESSION_NONE)
+        {
+            // the whole mapped file is one block
+            if (data_handed) return false;
+            data_handed = true;
+            begin = data == NULL ? "" : data;
+            end   = begin + data_size;
+            return true;
+        }
+
+        // keep the partial last line of the previous block
+        if (buffer_start > 0)
+        {
+            memmove(buffer, buffer + buffer_start, buffer_used - buffer_start);
+            buffer_used -= buffer_start;
+            buffer_start = 0;
+        }
+        if (reader_done && buffer_used == 0) return false;
+        if (buffer_size < buffer_used + EDGE_STREAM_BLOCK_BYTES)
+        {
+            buffer_size = buffer_used + EDGE_STREAM_BLOCK_BYTES;
+            buffer = (char*) realloc(buffer, buffer_size);
+        }
+        while (!reader_done && buffer_used < buffer_size)
+        {
+            size_t size = reader.Read(buffer + buffer_used, buffer_size - buffer_used);
+            if (size == 0) reader_done = true;
+            buffer_used += size;
+        }
+        if (reader.Failed())
+        {
+            Fail(reader.error);
+            return false;
+        }
+
+        size_t stop = buffer_used;
+        if (!reader_done)
+        {
+            while (stop > 0 && buffer[stop - 1] != '\n') stop--;
+            if (stop == 0) stop = buffer_used;  // a line longer than a block
+        }
+        buffer_start = stop;
+        begin = buffer;
+        end   = buffer + stop;
+        return true;
+    }
+
+    static const char* SkipBlanks(const char *p, const char *end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        return p;
+    }
+
+    static const char* NextLine(const char *p, const char *end)
+    {
+        const char *newline = (const char*) memchr(p, '\n', end - p);
+        return newline == NULL ? end : newline + 1;
+    }
+
+    /**
+     * @brief Parses an unsigned integer.
+     *
+     * \return false if there is none.
+     */
+    static bool ParseIndex(const char *&p, const char *end, long long &value)
+    {
+        p = SkipBlanks(p, end);
+        if (p >= end || *p < '0' || *p > '9') return false;
+        value = 0;
+        while (p < end && *p >= '0' && *p <= '9')
+            value = value * 10 + (*p++ - '0');
+        return true;
+    }
+
+    /**
+     * @brief Parses a value; the content needs not be NUL terminated.
+     */
+    static void ParseValue(const char *p, const char *end, double &value)
+    {
+        char text[64];
+        size_t length = 0;
+        p = SkipBlanks(p, end);
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n' &&
+            length < sizeof(text) - 1)
+            text[length++] = *p++;
+        text[length] = '\0';
+        if (length > 0) value = strtod(text, NULL);
+    }
+
+    /**
+     * @brief Reads the banner, the comments and the size line.
+     */
+    int ReadHeader(const char *begin, const char *end)
+    {
+        const char *p = begin;
+        while (p < end)
+        {
+            const char *line = SkipBlanks(p, end);
+            const char *next = NextLine(p, end);
+            p = next;
+            if (line >= end || *line == '\n') continue;
+            if (*line == '%')
+            {
+                std::string text(line, next - line);
+                if (text.compare(0, 2, "%%") == 0)
+                {
+                    if (text.find("array") != std::string::npos)
+                        return Fail("dense array MARKET files are not supported");
+                    symmetric = text.find("symmetric") != std::string::npos
+                             || text.find("hermitian") != std::string::npos;
+                    skew      = text.find("skew"   ) != std::string::npos;
+                    pattern   = text.find("pattern") != std::string::npos;
+                }
+                continue;
+            }
+
+            long long rows = 0, columns = 0;
+            if (!ParseIndex(line, end, rows   ) ||
+                !ParseIndex(line, end, columns) ||
+                !ParseIndex(line, end, entries))
+                return Fail("invalid problem description");
+            if (rows != columns)
+                return Fail("not square");
+            nodes        = rows;
+            header_bytes = next - begin;
+            return 0;
+        }
+        return Fail("no size line found");
+    }
+
+    /**
+     * @brief Parses a range of whole lines, one slice per thread; a line
+     * belongs to the thread its first character falls in.
+     */
+    template <bool LOAD_VALUES, typename Op>
+    void ParseBlock(const char *body, const char *end, Op &op)
+    {
+        size_t    body_size = end - body;
+        long long read = 0, invalid = 0;
+
+        #pragma omp parallel num_threads(num_threads) reduction(+:read, invalid)
+        {
+            int thread_num = omp_get_thread_num();
+            int threads    = omp_get_num_threads();
+            const char *begin = body + body_size * thread_num / threads;
+            const char *stop  = body + body_size * (thread_num + 1) / threads;
+            if (thread_num > 0 && begin[-1] != '\n')
+                begin = NextLine(begin, end);
+
+            for (const char *line = begin; line < stop; line = NextLine(line, end))
+            {
+                const char *q = SkipBlanks(line, end);
+                if (q >= end || *q == '\n' || *q == '%') continue;
+                long long src = 0, dst = 0;
+                if (!ParseIndex(q, end, src) || !ParseIndex(q, end, dst) ||
+                    src < 1 || dst < 1 || src > nodes || dst > nodes)
+                {
+                    invalid ++;
+                    continue;
+                }
+                double value = 0;
+                if (LOAD_VALUES) ParseValue(q, end, value);
+                op(thread_num, src - 1, dst - 1, value);
+                read ++;
+            }
+        }
+        edges_read    += read;
+        edges_invalid += invalid;
+    }
+};
+
+} // namespace graphio
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
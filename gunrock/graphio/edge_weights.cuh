@@ -0,0 +1,236 @@
+// ----------------------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------------------
+
+/**
+ * @file
+ * edge_weights.cuh
+ *
+ * @brief Deterministic synthetic edge weights for inputs that carry none.
+ * The weight of an edge is a hash of (seed, source, destination), so it is
+ * the same in every run, for every thread count, and in the forward and
+ * reversed graphs; for undirected graphs the endpoints are hashed as an
+ * unordered pair, so both directions of an edge get the same weight.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <limits>
+#include <omp.h>
+
+namespace gunrock {
+namespace graphio {
+
+enum EdgeWeightDistribution
+{
+    WEIGHT_UNIFORM   = 0,  // uniform in [min_weight, max_weight]
+    WEIGHT_LOGNORMAL = 1,  // heavy-tailed, most weights near min_weight
+    WEIGHT_DEGREE    = 2,  // grows with the endpoints' degrees
+};
+
+/**
+ * @brief Parameters of the synthetic weights. The defaults match the range
+ * of the rand() % 64 weights they replace.
+ */
+struct EdgeWeightConfig
+{
+    EdgeWeightDistribution distribution;
+    unsigned long long     seed;
+    double                 min_weight;  // inclusive
+    double                 max_weight;  // inclusive
+    double                 sigma;       // log-normal shape
+
+    EdgeWeightConfig() :
+        distribution(WEIGHT_UNIFORM),
+        seed        (0),
+        min_weight  (0),
+        max_weight  (63),
+        sigma       (1.0)
+    {
+    }
+
+    /**
+     * @brief Sets the distribution from its name.
+     *
+     * \return false if the name is unknown.
+     */
+    bool SetDistribution(const std::string &name)
+    {
+        if      (name == "uniform"  ) distribution = WEIGHT_UNIFORM;
+        else if (name == "lognormal") distribution = WEIGHT_LOGNORMAL;
+        else if (name == "degree"   ) distribution = WEIGHT_DEGREE;
+        else return false;
+        return true;
+    }
+
+    const char* DistributionName() const
+    {
+        return distribution == WEIGHT_LOGNORMAL ? "lognormal" :
+              (distribution == WEIGHT_DEGREE    ? "degree"    : "uniform");
+    }
+
+    /**
+     * @brief Short tag identifying the weights, used in binary cache names,
+     * e.g. "wu0-63s0." for the defaults.
+     */
+    std::string Tag() const
+    {
+        char tag[128];
+        if (distribution == WEIGHT_LOGNORMAL)
+            sprintf(tag, "wl%g-%gs%llug%g.", min_weight, max_weight, seed, sigma);
+        else
+            sprintf(tag, "w%c%g-%gs%llu.", distribution == WEIGHT_DEGREE ? 'd' : 'u',
+                min_weight, max_weight, seed);
+        return std::string(tag);
+    }
+};
+
+/**
+ * @brief splitmix64 finalizer.
+ */
+inline unsigned long long WeightHash(unsigned long long x)
+{
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Uniform number in (0, 1] from the hash of an edge.
+ */
+inline double WeightUnit(unsigned long long edge_hash, unsigned int salt)
+{
+    unsigned long long x = WeightHash(edge_hash + salt);
+    return ((x >> 11) + 1) * (1.0 / 9007199254740992.0);  // 53 bits
+}
+
+/**
+ * @brief Synthetic weight of edge (src, dest).
+ *
+ * @param[in] config Weight parameters.
+ * @param[in] src Source of the edge, as in the input file.
+ * @param[in] dest Destination of the edge, as in the input file.
+ * @param[in] symmetric Whether (src, dest) and (dest, src) share a weight.
+ * @param[in] degree_term Degree of the endpoints scaled to [0, 1], for
+ * WEIGHT_DEGREE.
+ */
+template <typename Value, typename VertexId>
+Value EdgeWeight(
+    const EdgeWeightConfig &config,
+    VertexId                src,
+    VertexId                dest,
+    bool                    symmetric,
+    double                  degree_term = 0)
+{
+    if (symmetric && src > dest) { VertexId t = src; src = dest; dest = t; }
+    unsigned long long edge_hash = WeightHash(config.seed ^
+        WeightHash(((unsigned long long)src << 32) ^ (unsigned long long)dest));
+    double range = config.max_weight - config.min_weight;
+    double unit  = WeightUnit(edge_hash, 0);
+    double x     = 0;
+
+    if (config.distribution == WEIGHT_LOGNORMAL)
+    {
+        // Box-Muller; scaled so that a three-sigma draw reaches max_weight
+        double z = sqrt(-2.0 * log(unit)) *
+            cos(6.283185307179586 * WeightUnit(edge_hash, 1));
+        x = config.min_weight +
+            range * exp(config.sigma * z) / exp(3.0 * config.sigma);
+    } else if (config.distribution == WEIGHT_DEGREE) {
+        // mostly the degree term, with a quarter of jitter
+        x = config.min_weight + range * (0.75 * degree_term + 0.25 * unit);
+    } else if (std::numeric_limits<Value>::is_integer) {
+        // spread over the range + 1 integers
+        x = floor(config.min_weight + (range + 1) * (1.0 - unit));
+    } else {
+        x = config.min_weight + range * (1.0 - unit);
+    }
+    if (std::numeric_limits<Value>::is_integer) x = floor(x + 0.5);
+    if (x < config.min_weight) x = config.min_weight;
+    if (x > config.max_weight) x = config.max_weight;
+    return (Value)x;
+}
+
+/**
+ * @brief Degree term of WEIGHT_DEGREE: log(1 + d(src) d(dest)) scaled to
+ * [0, 1] by the largest possible product.
+ */
+inline double WeightDegreeTerm(
+    double src_degree, double dest_degree, double max_degree)
+{
+    double log_max = log(1.0 + max_degree * max_degree);
+    if (log_max <= 0) return 0;
+    return log(1.0 + src_degree * dest_degree) / log_max;
+}
+
+/**
+ * @brief Fills the edge values of a CSR graph with synthetic weights, in
+ * parallel.
+ *
+ * @param[in] config Weight parameters.
+ * @param[in] nodes Number of vertices.
+ * @param[in] row_offsets Row offsets of the graph.
+ * @param[in] column_indices Column indices of the graph.
+ * @param[out] edge_values Weight of each edge.
+ * @param[in] undirected Whether both directions of an edge share a weight.
+ * @param[in] reversed Whether the graph holds the input edges reversed;
+ * weights are then the ones of the forward edges.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+void AssignEdgeWeights(
+    const EdgeWeightConfig &config,
+    SizeT                   nodes,
+    const SizeT            *row_offsets,
+    const VertexId         *column_indices,
+    Value                  *edge_values,
+    bool                    undirected,
+    bool                    reversed = false)
+{
+    // total (in + out) degrees, the same in the forward and reversed graphs
+    SizeT *degrees    = NULL;
+    SizeT  max_degree = 0;
+    if (config.distribution == WEIGHT_DEGREE)
+    {
+        degrees = (SizeT*) malloc(sizeof(SizeT) * nodes);
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            degrees[v] = row_offsets[v+1] - row_offsets[v];
+        #pragma omp parallel for
+        for (SizeT e = 0; e < row_offsets[nodes]; e++)
+            __sync_fetch_and_add(degrees + column_indices[e], 1);
+        #pragma omp parallel for reduction(max:max_degree)
+        for (SizeT v = 0; v < nodes; v++)
+            if (degrees[v] > max_degree) max_degree = degrees[v];
+    }
+
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (SizeT v = 0; v < nodes; v++)
+    {
+        for (SizeT e = row_offsets[v]; e < row_offsets[v+1]; e++)
+        {
+            VertexId src  = reversed ? column_indices[e] : v;
+            VertexId dest = reversed ? v : column_indices[e];
+            double degree_term = degrees == NULL ? 0 :
+                WeightDegreeTerm(degrees[src], degrees[dest], max_degree);
+            edge_values[e] = EdgeWeight<Value>(
+                config, src, dest, undirected, degree_term);
+        }
+    }
+    if (degrees) { free(degrees); degrees = NULL; }
+}
+
+} // namespace graphio
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
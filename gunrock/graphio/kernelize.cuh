@@ -0,0 +1,501 @@
+// ----------------------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------------------
+
+/**
+ * @file
+ * kernelize.cuh
+ *
+ * @brief Graph kernelization pre-pass, alongside RemoveStandaloneNodes:
+ * pendant trees are peeled into the vertices they hang from, and chains of
+ * degree-2 vertices are contracted into single weighted edges. Primitives
+ * run on the smaller kernel graph, and a recorded plan rebuilds their
+ * per-vertex results on the full graph in a parallel post-pass.
+ */
+
+#pragma once
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <omp.h>
+
+#include <gunrock/util/sort_omp.cuh>
+#include <gunrock/util/host/scan.cuh>
+#include <gunrock/coo.cuh>
+#include <gunrock/csr.cuh>
+
+namespace gunrock {
+namespace graphio {
+
+/**
+ * @brief Orders edges by row, column, then value, so the first of
+ * duplicates is the lightest.
+ */
+template <typename Tuple>
+bool RowColumnValueCompare(Tuple elem1, Tuple elem2)
+{
+    if (elem1.row != elem2.row) return elem1.row < elem2.row;
+    if (elem1.col != elem2.col) return elem1.col < elem2.col;
+    return elem1.val < elem2.val;
+}
+
+/**
+ * @brief Kernel of an undirected graph and the plan to rebuild results on
+ * the full graph from results on the kernel.
+ *
+ * A folded vertex is either
+ * - isolated: no edge is left once its pendant tree is peeled;
+ * - a tree vertex: hangs from anchors[v] by an edge of weight offsets[v];
+ * - a chain vertex: lies offsets[v] from anchors[v] on a chain of
+ *   lengths[v] between anchors[v] and ends[v], both kernel vertices.
+ * Tree vertices depend on their anchor, folded in a later peeling round or
+ * not at all, so levels[] lists the folded vertices in the order they can
+ * be rebuilt: isolated and chain vertices first, then the peeling rounds
+ * backward.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+struct Kernelization
+{
+    SizeT     nodes;          // of the full graph
+    SizeT     kernel_nodes;
+    SizeT     num_tree;       // folded vertices, by kind
+    SizeT     num_chain;
+    SizeT     num_isolated;
+    VertexId *kernel_ids;     // kernel vertex of v, -1 if folded
+    VertexId *original_ids;   // full-graph vertex of a kernel vertex
+    VertexId *anchors;        // tree parent or first chain end, -1 if isolated
+    VertexId *ends;           // second chain end, -1 otherwise
+    Value    *offsets;        // distance from the anchor
+    Value    *lengths;        // chain length
+    VertexId *fold_order;     // folded vertices, by level
+    std::vector<SizeT> levels;  // offsets of the levels in fold_order
+
+    Kernelization() :
+        nodes        (0),
+        kernel_nodes (0),
+        num_tree     (0),
+        num_chain    (0),
+        num_isolated (0),
+        kernel_ids   (NULL),
+        original_ids (NULL),
+        anchors      (NULL),
+        ends         (NULL),
+        offsets      (NULL),
+        lengths      (NULL),
+        fold_order   (NULL)
+    {
+    }
+
+    ~Kernelization()
+    {
+        Release();
+    }
+
+    void Release()
+    {
+        if (kernel_ids  ) { free(kernel_ids  ); kernel_ids   = NULL; }
+        if (original_ids) { free(original_ids); original_ids = NULL; }
+        if (anchors     ) { free(anchors     ); anchors      = NULL; }
+        if (ends        ) { free(ends        ); ends         = NULL; }
+        if (offsets     ) { free(offsets     ); offsets      = NULL; }
+        if (lengths     ) { free(lengths     ); lengths      = NULL; }
+        if (fold_order  ) { free(fold_order  ); fold_order   = NULL; }
+        levels.clear();
+        nodes = kernel_nodes = num_tree = num_chain = num_isolated = 0;
+    }
+
+    /**
+     * @brief Builds the kernel of a symmetric graph.
+     *
+     * @param[in] graph Undirected graph, each edge stored both ways with
+     * the same value.
+     * @param[out] kernel Kernel graph; contracted chains carry their length
+     * as edge value, and of parallel edges the lightest is kept.
+     * @param[in] keep Vertices never folded, e.g. sources; may be NULL.
+     * @param[in] num_keep Number of vertices in keep.
+     * @param[in] contract_chains Contract degree-2 chains; off for
+     * primitives that count hops rather than sum edge values, such as BFS.
+     * @param[in] quiet Don't print out anything.
+     */
+    void Build(
+        const Csr<VertexId, SizeT, Value> &graph,
+        Csr<VertexId, SizeT, Value>       &kernel,
+        const VertexId *keep            = NULL,
+        SizeT           num_keep        = 0,
+        bool            contract_chains = true,
+        bool            quiet           = false)
+    {
+        typedef Coo<VertexId, Value> EdgeTupleType;
+
+        Release();
+        nodes = graph.nodes;
+        bool has_values = graph.edge_values != NULL || graph.edge_value_codes != NULL;
+        kernel_ids   = (VertexId*) malloc(sizeof(VertexId) * (nodes + 1));
+        anchors      = (VertexId*) malloc(sizeof(VertexId) * (nodes + 1));
+        ends         = (VertexId*) malloc(sizeof(VertexId) * (nodes + 1));
+        offsets      = (Value   *) malloc(sizeof(Value   ) * (nodes + 1));
+        lengths      = (Value   *) malloc(sizeof(Value   ) * (nodes + 1));
+        fold_order   = (VertexId*) malloc(sizeof(VertexId) * (nodes + 1));
+        SizeT *degrees = (SizeT*) malloc(sizeof(SizeT) * (nodes + 1));
+        char  *kept    = (char *) malloc(sizeof(char ) * (nodes + 1));
+        int   *rounds  = (int  *) malloc(sizeof(int  ) * (nodes + 1));
+        time_t mark0   = time(NULL);
+
+        // rounds[v]: 0 while v is in the graph, -r while in the frontier of
+        // peeling round r, r once folded in round r (1: isolated from the
+        // start), CHAIN_ROUND once in a contracted chain
+        const int CHAIN_ROUND = -1;
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            SizeT degree = 0;
+            for (SizeT e = graph.row_offsets[v]; e < graph.row_offsets[v+1]; e++)
+                if (graph.ColumnIndex(e) != v) degree ++;
+            degrees[v] = degree;
+            kept   [v] = 0;
+            rounds [v] = 0;
+            anchors[v] = -1;
+            ends   [v] = -1;
+        }
+        for (SizeT i = 0; i < num_keep; i++)
+            if (keep[i] >= 0 && keep[i] < nodes) kept[keep[i]] = 1;
+
+        std::vector<VertexId> frontier, isolated;
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            if (kept[v]) continue;
+            if (degrees[v] == 1) frontier.push_back(v);
+            else if (degrees[v] == 0) isolated.push_back(v);
+        }
+        for (size_t i = 0; i < isolated.size(); i++)
+            rounds[isolated[i]] = 1;
+
+        // Peel pendant vertices round by round: pick the neighbor left to
+        // each leaf, then fold the leaves into them, so a round sees the
+        // graph as the previous round left it
+        int num_threads = omp_get_max_threads();
+        std::vector<std::vector<VertexId> > round_order;
+        std::vector<std::vector<VertexId> > next_parts(num_threads);
+        std::vector<std::vector<VertexId> > tree_parts(num_threads);
+        std::vector<std::vector<VertexId> > root_parts(num_threads);
+        for (int round = 2; !frontier.empty(); round++)
+        {
+            SizeT frontier_size = frontier.size();
+            #pragma omp parallel for
+            for (SizeT i = 0; i < frontier_size; i++)
+                rounds[frontier[i]] = -round;
+            #pragma omp parallel for
+            for (SizeT i = 0; i < frontier_size; i++)
+            {
+                VertexId v = frontier[i];
+                anchors[v] = -1;
+                for (SizeT e = graph.row_offsets[v]; e < graph.row_offsets[v+1]; e++)
+                {
+                    VertexId u = graph.ColumnIndex(e);
+                    if (u == v || rounds[u] > 0) continue;
+                    Value weight = has_values ? graph.EdgeValue(e) : (Value)1;
+                    if (anchors[v] == -1 || weight < offsets[v])
+                    {
+                        anchors[v] = u;
+                        offsets[v] = weight;
+                    }
+                }
+            }
+
+            #pragma omp parallel num_threads(num_threads)
+            {
+                int thread_num = omp_get_thread_num();
+                std::vector<VertexId> &next = next_parts[thread_num];
+                std::vector<VertexId> &tree = tree_parts[thread_num];
+                std::vector<VertexId> &root = root_parts[thread_num];
+                next.clear(); tree.clear(); root.clear();
+                #pragma omp for
+                for (SizeT i = 0; i < frontier_size; i++)
+                {
+                    VertexId v = frontier[i];
+                    VertexId p = anchors[v];
+                    if (p == -1)
+                    {
+                        // all its neighbors are folded: the root of a tree
+                        root.push_back(v);
+                        continue;
+                    }
+                    if (rounds[p] == -round && v < p)
+                    {
+                        // of two leaves joined by an edge, the smaller stays
+                        anchors[v] = -1;
+                        next.push_back(v);
+                        continue;
+                    }
+                    tree.push_back(v);
+                    SizeT degree = __sync_sub_and_fetch(degrees + p, (SizeT)1);
+                    if (degree == 1 && !kept[p] && rounds[p] != -round)
+                        next.push_back(p);
+                }
+            }
+
+            round_order.push_back(std::vector<VertexId>());
+            std::vector<VertexId> &order = round_order.back();
+            frontier.clear();
+            for (int t = 0; t < num_threads; t++)
+            {
+                frontier.insert(frontier.end(), next_parts[t].begin(), next_parts[t].end());
+                order   .insert(order   .end(), tree_parts[t].begin(), tree_parts[t].end());
+                isolated.insert(isolated.end(), root_parts[t].begin(), root_parts[t].end());
+                for (size_t i = 0; i < root_parts[t].size(); i++)
+                    rounds[root_parts[t][i]] = round;
+            }
+            #pragma omp parallel for
+            for (SizeT i = 0; i < (SizeT)order.size(); i++)
+                rounds[order[i]] = round;
+        }
+        num_isolated = isolated.size();
+
+        // Contract chains: walk from each end of degree other than 2 into
+        // its degree-2 neighbors; the walk from the smaller end records it
+        std::vector<std::vector<VertexId> > chain_parts(num_threads);
+        std::vector<std::vector<EdgeTupleType> > edge_parts(num_threads);
+        #pragma omp parallel num_threads(num_threads)
+        {
+            int thread_num = omp_get_thread_num();
+            std::vector<VertexId> &chain = chain_parts[thread_num];
+            std::vector<EdgeTupleType> &chain_edges = edge_parts[thread_num];
+            std::vector<VertexId> path;
+            std::vector<Value   > path_offsets;
+            #pragma omp for schedule(dynamic, 1024)
+            for (SizeT u = 0; u < nodes; u++)
+            {
+                if (!contract_chains || rounds[u] > 0 ||
+                    (degrees[u] == 2 && !kept[u])) continue;
+                for (SizeT e = graph.row_offsets[u]; e < graph.row_offsets[u+1]; e++)
+                {
+                    VertexId c = graph.ColumnIndex(e);
+                    if (c == u || rounds[c] > 0 || degrees[c] != 2 || kept[c])
+                        continue;
+                    path.clear();
+                    path_offsets.clear();
+                    VertexId prev = u, cur = c;
+                    Value length = has_values ? graph.EdgeValue(e) : (Value)1;
+                    while (rounds[cur] <= 0 && degrees[cur] == 2 && !kept[cur])
+                    {
+                        path.push_back(cur);
+                        path_offsets.push_back(length);
+                        // the two edges left at cur; leave by the one not
+                        // taken to come in
+                        SizeT in_edge = -1, out_edge = -1;
+                        for (SizeT f = graph.row_offsets[cur];
+                            f < graph.row_offsets[cur+1]; f++)
+                        {
+                            VertexId w = graph.ColumnIndex(f);
+                            if (w == cur || rounds[w] > 0) continue;
+                            if (in_edge == -1 && w == prev) in_edge = f;
+                            else out_edge = f;
+                        }
+                        if (out_edge == -1) { cur = c; break; }
+                        prev    = cur;
+                        cur     = graph.ColumnIndex(out_edge);
+                        length += has_values ? graph.EdgeValue(out_edge) : (Value)1;
+                        if (cur == c) break;  // a cycle, no end
+                    }
+                    VertexId w = cur;
+                    if (w == c) continue;
+                    bool owner = u < w || (u == w && path.front() < path.back());
+                    if (u == w && path.front() == path.back())
+                    {
+                        // both edges of u lead to the same chain vertex
+                        owner = true;
+                        for (SizeT f = graph.row_offsets[u]; f < e; f++)
+                            if (graph.ColumnIndex(f) == c) owner = false;
+                    }
+                    if (!owner) continue;
+                    for (size_t i = 0; i < path.size(); i++)
+                    {
+                        VertexId v = path[i];
+                        anchors[v] = u;
+                        ends   [v] = w;
+                        offsets[v] = path_offsets[i];
+                        lengths[v] = length;
+                        rounds [v] = CHAIN_ROUND;
+                        chain.push_back(v);
+                    }
+                    if (u != w)
+                    {
+                        chain_edges.push_back(EdgeTupleType(u, w, length));
+                        chain_edges.push_back(EdgeTupleType(w, u, length));
+                    }
+                }
+            }
+        }
+
+        // Number the kernel vertices in ID order
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            kernel_ids[v] = (rounds[v] <= 0 && rounds[v] != CHAIN_ROUND) ? 1 : 0;
+        kernel_nodes = util::host::ExclusiveScan(kernel_ids, kernel_ids, nodes);
+        original_ids = (VertexId*) malloc(sizeof(VertexId) * (kernel_nodes + 1));
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            if (rounds[v] <= 0 && rounds[v] != CHAIN_ROUND)
+                original_ids[kernel_ids[v]] = v;
+            else kernel_ids[v] = -1;
+        }
+
+        // Plan: isolated and chain vertices, then the rounds backward
+        SizeT num_folded = 0;
+        levels.push_back(0);
+        for (size_t i = 0; i < isolated.size(); i++)
+            fold_order[num_folded++] = isolated[i];
+        for (int t = 0; t < num_threads; t++)
+            for (size_t i = 0; i < chain_parts[t].size(); i++)
+                fold_order[num_folded++] = chain_parts[t][i];
+        num_chain = num_folded - num_isolated;
+        levels.push_back(num_folded);
+        for (int r = (int)round_order.size() - 1; r >= 0; r--)
+        {
+            if (round_order[r].empty()) continue;
+            for (size_t i = 0; i < round_order[r].size(); i++)
+                fold_order[num_folded++] = round_order[r][i];
+            levels.push_back(num_folded);
+        }
+        num_tree = num_folded - num_chain - num_isolated;
+
+        // Kernel edges: edges between kernel vertices, and contracted chains
+        #pragma omp parallel num_threads(num_threads)
+        {
+            // chain edges were recorded with full-graph ends
+            std::vector<EdgeTupleType> &part = edge_parts[omp_get_thread_num()];
+            for (size_t i = 0; i < part.size(); i++)
+            {
+                part[i].row = kernel_ids[part[i].row];
+                part[i].col = kernel_ids[part[i].col];
+            }
+            #pragma omp for schedule(dynamic, 1024)
+            for (SizeT v = 0; v < nodes; v++)
+            {
+                if (kernel_ids[v] == -1) continue;
+                for (SizeT e = graph.row_offsets[v]; e < graph.row_offsets[v+1]; e++)
+                {
+                    VertexId u = graph.ColumnIndex(e);
+                    if (kernel_ids[u] == -1) continue;
+                    part.push_back(EdgeTupleType(kernel_ids[v], kernel_ids[u],
+                        has_values ? graph.EdgeValue(e) : (Value)1));
+                }
+            }
+        }
+        std::vector<SizeT> edge_offsets(num_threads + 1, 0);
+        for (int t = 0; t < num_threads; t++)
+            edge_offsets[t+1] = edge_offsets[t] + edge_parts[t].size();
+        SizeT kernel_edges = edge_offsets[num_threads];
+        EdgeTupleType *coo = (EdgeTupleType*) malloc(
+            sizeof(EdgeTupleType) * (kernel_edges + 1));
+        #pragma omp parallel for
+        for (int t = 0; t < num_threads; t++)
+        {
+            if (!edge_parts[t].empty())
+                memcpy(coo + edge_offsets[t], &edge_parts[t][0],
+                    sizeof(EdgeTupleType) * edge_parts[t].size());
+            std::vector<EdgeTupleType>().swap(edge_parts[t]);
+        }
+        util::omp_sort(coo, kernel_edges, RowColumnValueCompare<EdgeTupleType>);
+        if (has_values)
+            kernel.template FromCoo<true >(NULL, coo, kernel_nodes, kernel_edges,
+                true, false, false, true);
+        else
+            kernel.template FromCoo<false>(NULL, coo, kernel_nodes, kernel_edges,
+                true, false, false, true);
+        free(coo); coo = NULL;
+
+        if (!quiet)
+        {
+            printf("Kernelized in %ds: %lld -> %lld vertices (%lld in trees, "
+                "%lld in chains, %lld isolated), %lld -> %lld edges, "
+                "%lld levels\n", (int)(time(NULL) - mark0),
+                (long long)nodes, (long long)kernel_nodes, (long long)num_tree,
+                (long long)num_chain, (long long)num_isolated,
+                (long long)graph.edges, (long long)kernel.edges,
+                (long long)levels.size() - 1);
+        }
+        free(degrees); degrees = NULL;
+        free(kept   ); kept    = NULL;
+        free(rounds ); rounds  = NULL;
+    }
+
+    /**
+     * @brief Component of every vertex from the components of the kernel.
+     *
+     * @param[in] kernel_labels Component of each kernel vertex, named by a
+     * kernel vertex of it, as CC computes.
+     * @param[out] labels Component of each vertex, named by a vertex of it.
+     */
+    template <typename LabelT>
+    void ExpandComponents(const LabelT *kernel_labels, LabelT *labels) const
+    {
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            if (kernel_ids[v] != -1)
+                labels[v] = original_ids[kernel_labels[kernel_ids[v]]];
+        for (size_t level = 0; level + 1 < levels.size(); level++)
+        {
+            #pragma omp parallel for
+            for (SizeT i = levels[level]; i < levels[level + 1]; i++)
+            {
+                VertexId v = fold_order[i];
+                labels[v] = anchors[v] == -1 ? (LabelT)v : labels[anchors[v]];
+            }
+        }
+    }
+
+    /**
+     * @brief Distance of every vertex from distances on the kernel, from a
+     * source kept in it.
+     *
+     * @param[in] kernel_distances Distance of each kernel vertex.
+     * @param[out] distances Distance of each vertex.
+     * @param[in] unreachable Distance of unreached vertices.
+     */
+    template <typename DistT>
+    void ExpandDistances(
+        const DistT *kernel_distances,
+        DistT       *distances,
+        DistT        unreachable) const
+    {
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            if (kernel_ids[v] != -1)
+                distances[v] = kernel_distances[kernel_ids[v]];
+        for (size_t level = 0; level + 1 < levels.size(); level++)
+        {
+            #pragma omp parallel for
+            for (SizeT i = levels[level]; i < levels[level + 1]; i++)
+            {
+                VertexId v = fold_order[i];
+                DistT distance = unreachable;
+                if (anchors[v] != -1 && distances[anchors[v]] != unreachable)
+                    distance = distances[anchors[v]] + (DistT)offsets[v];
+                if (ends[v] != -1 && distances[ends[v]] != unreachable)
+                {
+                    DistT other = distances[ends[v]] + (DistT)(lengths[v] - offsets[v]);
+                    if (distance == unreachable || other < distance)
+                        distance = other;
+                }
+                distances[v] = distance;
+            }
+        }
+    }
+};
+
+} // namespace graphio
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -17,10 +17,14 @@
 #include <math.h>
 #include <time.h>
 #include <stdio.h>
+#include <string.h>
 #include <libgen.h>
 #include <iostream>
 
 #include <gunrock/graphio/utils.cuh>
+#include <gunrock/graphio/edge_weights.cuh>
+#include <gunrock/graphio/compressed.cuh>
+#include <gunrock/temporal_csr.cuh>
 
 namespace gunrock {
 namespace graphio {
@@ -193,6 +197,8 @@ int ReadLabelStream(
  * @param[in] csr_graph     Csr graph object to store the graph data.
  * @param[in] undirected    Is the graph undirected or not?
  * @param[in] reversed      Whether or not the graph is inversed.
+ * @param[in] quiet         Don't print out anything.
+ * @param[in] weights       Synthetic weights for edges without a value.
  *
  * \return If there is any File I/O error along the way.
  */
@@ -203,7 +209,8 @@ int ReadMarketStream(
     Csr<VertexId, SizeT, Value> &csr_graph,
     bool undirected,
     bool reversed,
-    bool quiet = false)
+    bool quiet = false,
+    const EdgeWeightConfig &weights = EdgeWeightConfig())
 {
     typedef Coo<VertexId, Value> EdgeTupleType;
 
@@ -213,6 +220,7 @@ int ReadMarketStream(
     EdgeTupleType *coo = NULL; // read in COO format
     bool  skew  = false; //whether edge values are the inverse for symmetric matrices
     bool  array = false; //whether the mtx file is in dense array format
+    bool  synthesize_weights = false; //whether some edges carry no value
 
     time_t mark0 = time(NULL);
     if (!quiet)
@@ -354,7 +362,8 @@ int ReadMarketStream(
 
                 else if (num_input == 2)
                 {
-                    ll_value = rand() % 64;
+                    ll_value = 0;  // synthesized once the CSR is built
+                    synthesize_weights = true;
                 }
             }
             else
@@ -435,12 +444,22 @@ int ReadMarketStream(
         fflush(stdout);
     }
 
-    // Convert COO to CSR
-    csr_graph.template FromCoo<LOAD_VALUES>(output_file, coo,
-                                            nodes, edges, ordered_rows,
-                                            undirected, reversed, quiet);
+    // Convert COO to CSR; with synthetic weights, the binary file is
+    // written once they are assigned
+    csr_graph.template FromCoo<LOAD_VALUES>(
+        synthesize_weights ? NULL : output_file, coo,
+        nodes, edges, ordered_rows, undirected, reversed, quiet);
 
     free(coo);
+    if (synthesize_weights)
+    {
+        AssignEdgeWeights(weights, csr_graph.nodes, csr_graph.row_offsets,
+            csr_graph.column_indices, csr_graph.edge_values,
+            undirected, reversed && !undirected);
+        csr_graph.WriteBinary(output_file, csr_graph.nodes, csr_graph.edges,
+            csr_graph.row_offsets, csr_graph.column_indices,
+            csr_graph.edge_values, csr_graph.rows_sorted);
+    }
     fflush(stdout);
 
     return 0;
@@ -486,12 +505,16 @@ int ReadCsrArrays(char *f_in, Csr<VertexId, SizeT, Value> &csr_graph,
 /**
  * @brief Loads a MARKET-formatted CSR graph from the specified file.
  *
- * @param[in] mm_filename Graph file name, if empty, it is loaded from STDIN.
+ * @param[in] mm_filename Graph file name, if empty, it is loaded from STDIN;
+ * may be gzip, bzip2 or zstd compressed, or a compressed tar archive.
  * @param[in] output_file Output file name for binary i/o.
  * @param[in] csr_graph Reference to CSR graph object. @see Csr
  * @param[in] undirected Is the graph undirected or not?
  * @param[in] reversed Is the graph reversed or not?
  * @param[in] quiet If true, print no output
+ * @param[in] edge_maps Build the reverse / csc-to-csr edge maps and store
+ * them in the binary file, unless it already has them.
+ * @param[in] weights Synthetic weights for edges without a value.
  *
  * \return If there is any File I/O error along the way. 0 for no error.
  */
@@ -502,7 +525,9 @@ int BuildMarketGraph(
     Csr<VertexId, SizeT, Value> &csr_graph,
     bool undirected,
     bool reversed,
-    bool quiet = false)
+    bool quiet = false,
+    bool edge_maps = false,
+    const EdgeWeightConfig &weights = EdgeWeightConfig())
 {
     FILE *_file = fopen(output_file, "r");
     if (_file)
@@ -524,11 +549,38 @@ int BuildMarketGraph(
                 printf("Reading from stdin:\n");
             }
             if (ReadMarketStream<LOAD_VALUES>(
-                        stdin, output_file, csr_graph, undirected, reversed) != 0)
+                        stdin, output_file, csr_graph, undirected, reversed,
+                        quiet, weights) != 0)
             {
                 return -1;
             }
         }
+        else if (DetectFileCompression(mm_filename) != COMPRESSION_NONE)
+        {
+            // Read from a compressed file or archive, decoded while parsed
+            CompressedReader reader;
+            if (reader.Open(mm_filename) != 0)
+            {
+                fprintf(stderr, "Unable to read %s: %s\n",
+                    mm_filename, reader.error.c_str());
+                return -1;
+            }
+            if (!quiet)
+            {
+                printf("Reading from %s (%s, %lld parallel units):\n", mm_filename,
+                    CompressionName(reader.type), (long long)reader.num_units);
+            }
+            int retval = ReadMarketStream<LOAD_VALUES>(
+                reader.Stream(), output_file, csr_graph,
+                undirected, reversed, quiet, weights);
+            if (reader.Failed())
+            {
+                fprintf(stderr, "Unable to read %s: %s\n",
+                    mm_filename, reader.error.c_str());
+                return -1;
+            }
+            if (retval != 0) return -1;
+        }
         else
         {
             // Read from file
@@ -541,7 +593,7 @@ int BuildMarketGraph(
                 }
                 if (ReadMarketStream<LOAD_VALUES>(
                             f_in, output_file, csr_graph,
-                            undirected, reversed, quiet) != 0)
+                            undirected, reversed, quiet, weights) != 0)
                 {
                     fclose(f_in);
                     return -1;
@@ -555,6 +607,15 @@ int BuildMarketGraph(
             }
         }
     }
+
+    if (edge_maps && csr_graph.reverse_edges == NULL)
+    {
+        csr_graph.BuildEdgeMaps();
+        csr_graph.WriteBinary(output_file, csr_graph.nodes, csr_graph.edges,
+            csr_graph.row_offsets, csr_graph.column_indices,
+            LOAD_VALUES ? csr_graph.edge_values : NULL, true,
+            csr_graph.reverse_edges, csr_graph.csc_to_csr_edges);
+    }
     return 0;
 }
 
@@ -723,6 +784,106 @@ int BuildMarketGraph_SM(
     }
     return 0;
 }
+/**
+ * @brief Whether loading a MARKET file with values draws synthetic weights:
+ * its banner says pattern, or its first edge has no value. Files that
+ * cannot be read are assumed to need them.
+ *
+ * @param[in] file_in Input MARKET graph file, may be compressed.
+ */
+inline bool MarketSynthesizesWeights(const char *file_in)
+{
+    if (file_in == NULL) return true;
+    CompressedReader reader;
+    FILE *f_in = NULL;
+    bool  compressed = DetectFileCompression(file_in) != COMPRESSION_NONE;
+    if (!compressed) f_in = fopen(file_in, "r");
+    else if (reader.Open(file_in) == 0) f_in = reader.Stream();
+    if (f_in == NULL) return true;
+
+    char line[1024];
+    bool synthesize = true, size_read = false;
+    while (fgets(line, sizeof(line), f_in) != NULL)
+    {
+        if (line[0] == '%')
+        {
+            if (strncmp(line, "%%", 2) == 0 && strstr(line, "pattern") != NULL)
+                break;
+            continue;
+        }
+        if (strspn(line, " \t\r\n") == strlen(line)) continue;
+        if (!size_read) { size_read = true; continue; }
+        long long ll_row, ll_col;
+        double    lf_value;
+        synthesize = sscanf(line, "%lld %lld %lf", &ll_row, &ll_col, &lf_value) < 3;
+        break;
+    }
+    if (!compressed) fclose(f_in);  // the reader closes its own stream
+    return synthesize;
+}
+
+/**
+ * @brief Name of the binary CSR cache of a MARKET file, next to it:
+ * <path>/.<name>.<ud|rv|di>.<0|1>.[<weight tag>][cw.][64bVe.][64bVa.][64bSi.]bin
+ * The weight tag names the synthetic weights the cache holds for edges
+ * without a value; it is there only when values are loaded and the file
+ * lacks them (MarketSynthesizesWeights), so files with their own weights
+ * share one cache whatever the weight options. cw marks caches whose
+ * weights may be narrow codes, which readers predating them would misread.
+ *
+ * @param[in] file_in    Input MARKET graph file.
+ * @param[in] undirected Is the graph undirected or not?
+ * @param[in] reversed   Whether or not the graph is inversed.
+ * @param[out] output_file Cache file name, 256 chars.
+ * @param[in] weights    Synthetic weights for edges without a value.
+ * @param[in] compact_weights Name the cache of Csr::quantize_binary.
+ */
+template <bool LOAD_VALUES, typename VertexId, typename SizeT, typename Value>
+void MarketBinaryFileName(
+    char *file_in,
+    bool  undirected,
+    bool  reversed,
+    char *output_file,
+    const EdgeWeightConfig &weights = EdgeWeightConfig(),
+    bool  compact_weights = false)
+{
+    // seperate the graph path and the file name
+    char *temp1 = strdup(file_in);
+    char *temp2 = strdup(file_in);
+    char *file_path = dirname (temp1);
+    char *file_name = basename(temp2);
+
+    sprintf(output_file, "%s/.%s.%s.%d.%s%s%s%s%sbin", file_path, file_name,
+        undirected ? "ud" : (reversed ? "rv" : "di"), (LOAD_VALUES?1:0),
+        (LOAD_VALUES && MarketSynthesizesWeights(file_in)) ?
+            weights.Tag().c_str() : "",
+        (LOAD_VALUES && compact_weights) ? "cw." : "",
+        ((sizeof(VertexId) == 8) ? "64bVe." : ""),
+        ((sizeof(Value   ) == 8) ? "64bVa." : ""),
+        ((sizeof(SizeT   ) == 8) ? "64bSi." : ""));
+    free(temp1); temp1 = NULL;
+    free(temp2); temp2 = NULL;
+}
+
+/**
+ * @brief Name of a file derived from a binary graph cache and kept next to
+ * it, e.g. an index: the cache's name with the "bin" suffix replaced.
+ *
+ * @param[in] cache_name Binary cache file, from MarketBinaryFileName.
+ * @param[in] suffix Suffix of the derived file.
+ * @param[out] output_file Derived file name, 256 chars.
+ */
+inline void CacheSidecarFileName(
+    const char *cache_name,
+    const char *suffix,
+    char       *output_file)
+{
+    size_t length = strlen(cache_name);
+    if (length >= 3 && strcmp(cache_name + length - 3, "bin") == 0)
+        length -= 3;
+    snprintf(output_file, 256, "%.*s%s", (int)length, cache_name, suffix);
+}
+
 /**
  * @brief read in graph function read in graph according to its type.
  *
@@ -732,10 +893,13 @@ int BuildMarketGraph_SM(
  * @tparam SizeT
  *
  * @param[in] file_in    Input MARKET graph file.
- * @param[in] graph      CSR graph object to store the graph data.
+ * @param[in] graph      CSR graph object to store the graph data; with
+ * quantize_binary set, its cache is the cw one, with narrow weights.
  * @param[in] undirected Is the graph undirected or not?
  * @param[in] reversed   Whether or not the graph is inversed.
  * @param[in] quiet     Don't print out anything to stdout
+ * @param[in] edge_maps Build and cache the reverse / csc-to-csr edge maps
+ * @param[in] weights   Synthetic weights for edges without a value
  *
  * \return int Whether error occurs (0 correct, 1 error)
  */
@@ -745,55 +909,263 @@ int BuildMarketGraph(
     Csr<VertexId, SizeT, Value> &graph,
     bool undirected,
     bool reversed,
+    bool quiet = false,
+    bool edge_maps = false,
+    const EdgeWeightConfig &weights = EdgeWeightConfig())
+{
+    char output_file[256];
+    MarketBinaryFileName<LOAD_VALUES, VertexId, SizeT, Value>(
+        file_in, undirected, reversed, output_file, weights,
+        graph.quantize_binary);
+    if (BuildMarketGraph<LOAD_VALUES>(file_in, output_file, graph,
+                undirected, !undirected && reversed, quiet, edge_maps,
+                weights) != 0)
+        return 1;
+    return 0;
+}
+
+/**
+ * @brief Parses one field of a temporal edge line, integers exactly.
+ */
+template <typename T>
+T ParseTemporalField(const char *field)
+{
+    if (typeid(T) == typeid(float) || typeid(T) == typeid(double))
+        return (T)strtod(field, NULL);
+    return (T)strtoll(field, NULL, 10);
+}
+
+/**
+ * @brief Reads a MARKET edge list with a timestamp column into a temporal
+ * CSR. The timestamp is the last column of every edge line:
+ *
+ *   I J T         (pattern, or no value; the value is then 1)
+ *   I J A(I,J) T
+ *
+ * Dense array files cannot carry timestamps and are rejected.
+ *
+ * @param[in] f_in          Input MARKET graph file.
+ * @param[in] graph         Temporal CSR object to store the graph data.
+ * @param[in] undirected    Is the graph undirected or not?
+ * @param[in] reversed      Whether or not the graph is inversed.
+ * @param[in] quiet         Don't print out anything.
+ *
+ * \return If there is any File I/O or format error along the way.
+ */
+template <bool LOAD_VALUES, typename VertexId, typename SizeT, typename Value,
+    typename Time>
+int ReadTemporalMarketStream(
+    FILE *f_in,
+    TemporalCsr<VertexId, SizeT, Value, Time> &graph,
+    bool undirected,
+    bool reversed,
     bool quiet = false)
 {
-    // seperate the graph path and the file name
-    char *temp1 = strdup(file_in);
-    char *temp2 = strdup(file_in);
-    char *file_path = dirname (temp1);
-    char *file_name = basename(temp2);
+    typedef TemporalEdge<VertexId, Value, Time> EdgeTupleType;
 
-    if (undirected)
+    SizeT edges_read = -1;
+    SizeT nodes = 0;
+    SizeT edges = 0;
+    EdgeTupleType *edge_list = NULL;
+    bool  skew = false;
+
+    time_t mark0 = time(NULL);
+    if (!quiet)
     {
-        char ud[256];  // undirected graph
-        sprintf(ud, "%s/.%s.ud.%d.%s%s%sbin", file_path, file_name, (LOAD_VALUES?1:0),
-            ((sizeof(VertexId) == 8) ? "64bVe." : ""), 
-            ((sizeof(Value   ) == 8) ? "64bVa." : ""), 
-            ((sizeof(SizeT   ) == 8) ? "64bSi." : ""));
-        if (BuildMarketGraph<LOAD_VALUES>(file_in, ud, graph,
-                    true, false, quiet) != 0)
-            return 1;
+        printf("  Parsing temporal MARKET COO format");
     }
-    else if (!undirected && reversed)
+    fflush(stdout);
+
+    char line[1024];
+    while (fscanf(f_in, "%[^\n]\n", line) > 0)
     {
-        char rv[256];  // reversed graph
-        sprintf(rv, "%s/.%s.rv.%d.%s%s%sbin", file_path, file_name, (LOAD_VALUES?1:0),
-            ((sizeof(VertexId) == 8) ? "64bVe." : ""), 
-            ((sizeof(Value   ) == 8) ? "64bVa." : ""), 
-            ((sizeof(SizeT   ) == 8) ? "64bSi." : ""));
-        if (BuildMarketGraph<LOAD_VALUES>(file_in, rv, graph,
-                    false, true, quiet) != 0)
-            return 1;
+        if (line[0] == '%')
+        {
+            if (strlen(line) >= 2 && line[1] == '%')
+            {
+                // Banner
+                if (strstr(line, "array") != NULL)
+                {
+                    fprintf(stderr, "Error parsing temporal MARKET graph:"
+                        " dense array format has no timestamps\n");
+                    return -1;
+                }
+                if (!undirected)
+                    undirected = (strstr(line, "symmetric") != NULL);
+                skew = (strstr(line, "skew") != NULL);
+            }
+        }
+        else if (edges_read == -1)
+        {
+            // Problem description
+            long long ll_nodes_x, ll_nodes_y, ll_edges;
+            if (sscanf(line, "%lld %lld %lld",
+                    &ll_nodes_x, &ll_nodes_y, &ll_edges) != 3 ||
+                ll_nodes_x != ll_nodes_y)
+            {
+                fprintf(stderr, "Error parsing temporal MARKET graph:"
+                        " invalid problem description.\n");
+                return -1;
+            }
+            nodes = ll_nodes_x;
+            edges = undirected ? ll_edges * 2 : ll_edges;
+            if (!quiet)
+            {
+                printf(" (%lld nodes, %lld directed edges)... ",
+                       (long long)nodes, (long long)edges);
+                fflush(stdout);
+            }
+            edge_list = (EdgeTupleType*)malloc(sizeof(EdgeTupleType) * edges);
+            if (edge_list == NULL)
+            {
+                fprintf(stderr, "Error parsing temporal MARKET graph:"
+                    " edge list allocation failed, edges = %lld\n",
+                    (long long)edges);
+                return -1;
+            }
+            edges_read++;
+        }
+        else
+        {
+            // Edge description (v -> w at time)
+            if (edges_read >= edges)
+            {
+                fprintf(stderr, "Error parsing temporal MARKET graph:"
+                        " encountered more than %lld edges\n", (long long)edges);
+                free(edge_list); edge_list = NULL;
+                return -1;
+            }
+
+            long long ll_row, ll_col;
+            char field0[64], field1[64];
+            int num_input = sscanf(line, "%lld %lld %63s %63s",
+                &ll_row, &ll_col, field0, field1);
+            if (num_input < 3)
+            {
+                fprintf(stderr, "Error parsing temporal MARKET graph:"
+                        " edge without a timestamp\n");
+                free(edge_list); edge_list = NULL;
+                return -1;
+            }
+            Value value = (num_input == 4) ? ParseTemporalField<Value>(field0) : 1;
+            Time  stamp = ParseTemporalField<Time>(num_input == 4 ? field1 : field0);
+
+            EdgeTupleType &edge = edge_list[edges_read++];
+            edge.row  = ((reversed && !undirected) ? ll_col : ll_row) - 1;
+            edge.col  = ((reversed && !undirected) ? ll_row : ll_col) - 1;
+            edge.val  = value;
+            edge.time = stamp;
+            if (undirected)
+            {
+                // Go ahead and insert reverse edge, at the same time
+                EdgeTupleType &back = edge_list[edges_read++];
+                back.row  = ll_col - 1;
+                back.col  = ll_row - 1;
+                back.val  = value * (skew ? -1 : 1);
+                back.time = stamp;
+            }
+        }
     }
-    else if (!undirected && !reversed)
+
+    if (edge_list == NULL)
     {
-        char di[256];  // directed graph
-        sprintf(di, "%s/.%s.di.%d.%s%s%sbin", file_path, file_name, (LOAD_VALUES?1:0),
-            ((sizeof(VertexId) == 8) ? "64bVe." : ""), 
-            ((sizeof(Value   ) == 8) ? "64bVa." : ""), 
-            ((sizeof(SizeT   ) == 8) ? "64bSi." : ""));
-        if (BuildMarketGraph<LOAD_VALUES>(file_in, di, graph,
-                    false, false, quiet) != 0)
-            return 1;
+        fprintf(stderr, "No graph found\n");
+        return -1;
     }
-    else
+    if (edges_read != edges)
     {
-        fprintf(stderr, "Unspecified Graph Type.\n");
-        return 1;
+        fprintf(stderr,
+                "Error parsing temporal MARKET graph: only %lld/%lld edges read\n",
+                (long long)edges_read, (long long)edges);
+        free(edge_list); edge_list = NULL;
+        return -1;
+    }
+
+    time_t mark1 = time(NULL);
+    if (!quiet)
+    {
+        printf("Done parsing (%ds).\n", (int) (mark1 - mark0));
+        fflush(stdout);
     }
+
+    graph.template FromEdges<LOAD_VALUES>(edge_list, nodes, edges);
+    free(edge_list); edge_list = NULL;
     return 0;
 }
 
+/**
+ * @brief Loads a temporal CSR from a MARKET edge list with a timestamp
+ * column, see ReadTemporalMarketStream. There is no binary cache: the
+ * parse dominates, and the sort by time is part of it either way.
+ *
+ * @param[in] mm_filename Graph file name, if NULL, it is loaded from STDIN.
+ * @param[in] graph      Temporal CSR object to store the graph data.
+ * @param[in] undirected Is the graph undirected or not?
+ * @param[in] reversed   Whether or not the graph is inversed.
+ * @param[in] quiet      Don't print out anything to stdout
+ *
+ * \return If there is any File I/O error along the way. 0 for no error.
+ */
+template <bool LOAD_VALUES, typename VertexId, typename SizeT, typename Value,
+    typename Time>
+int BuildTemporalMarketGraph(
+    char *mm_filename,
+    TemporalCsr<VertexId, SizeT, Value, Time> &graph,
+    bool undirected,
+    bool reversed,
+    bool quiet = false)
+{
+    if (mm_filename == NULL)
+    {
+        if (!quiet)
+        {
+            printf("Reading from stdin:\n");
+        }
+        return ReadTemporalMarketStream<LOAD_VALUES>(
+            stdin, graph, undirected, reversed, quiet);
+    }
+
+    if (DetectFileCompression(mm_filename) != COMPRESSION_NONE)
+    {
+        CompressedReader reader;
+        if (reader.Open(mm_filename) != 0)
+        {
+            fprintf(stderr, "Unable to read %s: %s\n",
+                mm_filename, reader.error.c_str());
+            return -1;
+        }
+        if (!quiet)
+        {
+            printf("Reading from %s (%s, %lld parallel units):\n", mm_filename,
+                CompressionName(reader.type), (long long)reader.num_units);
+        }
+        int retval = ReadTemporalMarketStream<LOAD_VALUES>(
+            reader.Stream(), graph, undirected, reversed, quiet);
+        if (reader.Failed())
+        {
+            fprintf(stderr, "Unable to read %s: %s\n",
+                mm_filename, reader.error.c_str());
+            return -1;
+        }
+        return retval;
+    }
+
+    FILE *f_in = fopen(mm_filename, "r");
+    if (!f_in)
+    {
+        perror("Unable to open file");
+        return -1;
+    }
+    if (!quiet)
+    {
+        printf("Reading from %s:\n", mm_filename);
+    }
+    int retval = ReadTemporalMarketStream<LOAD_VALUES>(
+        f_in, graph, undirected, reversed, quiet);
+    fclose(f_in);
+    return retval;
+}
+
 /**@}*/
 
 } // namespace graphio
@@ -18,9 +18,13 @@
 #include <omp.h>
 #include <time.h>
 #include <list>
+#include <vector>
 #include <random>
 #include <gunrock/graphio/utils.cuh>
 #include <gunrock/util/sort_omp.cuh>
+#include <gunrock/util/host/scan.cuh>
+#include <gunrock/util/host/histogram.cuh>
+#include <gunrock/util/host/segmented_sort.cuh>
 
 namespace gunrock {
 namespace graphio {
@@ -67,6 +71,24 @@ bool XFirstPointCompare (
     return false;
 }
 
+/**
+ * @brief Grid block of the i-th point, the blocks being threshold wide.
+ */
+template <typename SizeT>
+struct BlockOfPointOp
+{
+    const RggPoint *points;
+    double          threshold;
+    long long       row_length;
+
+    SizeT operator()(SizeT i) const
+    {
+        SizeT x_index = points[i].x / threshold;
+        SizeT y_index = points[i].y / threshold;
+        return x_index * row_length + y_index;
+    }
+};
+
 template <typename T>
 bool PureTwoFactor(T x)
 {
@@ -124,88 +146,71 @@ int BuildRggGraph(
               threshold     = 0.55 * sqrt(log(nodes)/nodes);
     SizeT     edges         = 0;
     long long row_length    = 1.0 / threshold + 1;
-    VertexId **blocks       = new VertexId* [row_length * row_length + 1];
-    SizeT    *block_size    = new SizeT     [row_length * row_length + 1];
-    SizeT    *block_length  = new SizeT     [row_length * row_length + 1];
+    SizeT     num_blocks    = row_length * row_length;
+    SizeT    *block_size    = new SizeT   [num_blocks + 1];
+    SizeT    *block_offsets = new SizeT   [num_blocks + 1];
+    SizeT    *block_length  = new SizeT   [num_blocks + 1];
+    VertexId *block_nodes   = new VertexId[nodes + 1];
     EdgeTupleType *coo      = NULL;
-    long long reserved_factor2 = 8;
-    long long initial_length   = reserved_factor2 * nodes / row_length / row_length;
+    int       max_threads   = omp_get_max_threads();
+    std::vector<Engine> engines;
 
     if (seed == -1) seed = time(NULL);
     if (!quiet) { printf("rgg seed = %lld\n", (long long)seed); }
-    if (initial_length <4) initial_length = 4;
-    for (SizeT i=0; i< row_length * row_length +1; i++)
-    {
-        block_size  [i] = 0;
-        block_length[i] = 0;
-        blocks      [i] = NULL;
-    }
+    for (int t = 0; t < max_threads; t++)
+        engines.push_back(Engine(seed + 805 * t));
 
-    #pragma omp parallel
+    #pragma omp parallel num_threads(max_threads)
     {
         int       thread_num  = omp_get_thread_num();
         int       num_threads = omp_get_num_threads();
         SizeT     node_start  = (long long)(nodes) * thread_num / num_threads;
         SizeT     node_end    = (long long)(nodes) * (thread_num + 1) / num_threads;
-        SizeT     counter     = 0;
-        VertexId *col_index   = col_index_ + reserved_size * node_start;
-        Value    *values      = WITH_VALUES ? values_ + reserved_size * node_start : NULL;
-        unsigned int seed_    = seed + 805 * thread_num;
-        Engine    engine(seed_);
+        Engine   &engine      = engines[thread_num];
         Distribution distribution(0.0, 1.0);
 
-        #pragma omp single
-            offsets           = new SizeT[num_threads+1];
-
         for (VertexId node = node_start; node < node_end; node++)
         {
             points[node].x = distribution(engine);
             points[node].y = distribution(engine);
             points[node].node = node;
         }
+    }
+    std::stable_sort(points, points+nodes, XFirstPointCompare<RggPoint>);
+
+    // bucket the points by grid block: sizes by histogram, offsets by scan,
+    // then a scatter, whose order within each block a segmented sort fixes
+    BlockOfPointOp<SizeT> block_of;
+    block_of.points     = points;
+    block_of.threshold  = threshold;
+    block_of.row_length = row_length;
+    util::host::Histogram(nodes, block_of, block_size, num_blocks);
+    block_offsets[num_blocks] = util::host::ExclusiveScan(
+        block_size, block_offsets, num_blocks);
+    memset(block_length, 0, sizeof(SizeT) * num_blocks);
+    #pragma omp parallel for
+    for (SizeT node = 0; node < nodes; node++)
+    {
+        SizeT block_index = block_of(node);
+        SizeT pos = __sync_fetch_and_add(block_length + block_index, (SizeT)1);
+        block_nodes[block_offsets[block_index] + pos] = node;
+    }
+    util::host::SegmentedSort(block_nodes, block_offsets, num_blocks);
 
-        #pragma omp barrier
-        #pragma omp single
-        {
-            std::stable_sort(points, points+nodes, XFirstPointCompare<RggPoint>);
-        }
-
-        for (VertexId node = node_start; node < node_end; node++)
-        {
-            SizeT x_index = points[node].x / threshold;
-            SizeT y_index = points[node].y / threshold;
-            SizeT block_index = x_index * row_length + y_index;
-            #pragma omp atomic
-                block_size[block_index]++;
-        }
+    #pragma omp parallel num_threads(max_threads)
+    {
+        int       thread_num  = omp_get_thread_num();
+        int       num_threads = omp_get_num_threads();
+        SizeT     node_start  = (long long)(nodes) * thread_num / num_threads;
+        SizeT     node_end    = (long long)(nodes) * (thread_num + 1) / num_threads;
+        SizeT     counter     = 0;
+        VertexId *col_index   = col_index_ + reserved_size * node_start;
+        Value    *values      = WITH_VALUES ? values_ + reserved_size * node_start : NULL;
+        Engine   &engine      = engines[thread_num];
+        Distribution distribution(0.0, 1.0);
 
-        #pragma omp barrier
         #pragma omp single
-        {
-            for (SizeT i=0; i<row_length * row_length; i++)
-            if (block_size[i] != 0)
-                blocks[i] = new VertexId[block_size[i]];
-        }
-
-        for (VertexId node = node_start; node < node_end; node++)
-        {
-            double co_x0 = points[node].x; //co_x[node];
-            double co_y0 = points[node].y; //co_y[node];
-            //RggPoint point(co_x0, co_y0, node);
-            SizeT x_index = co_x0 / threshold;
-            SizeT y_index = co_y0 / threshold;
-            SizeT block_index = x_index * row_length + y_index;
-            SizeT pos = 0;
-
-            #pragma omp atomic capture
-            {
-                pos = block_length[block_index];
-                block_length[block_index] += 1;
-            }
-            blocks[block_index][pos] = node;
-        }
-
-        #pragma omp barrier
+            offsets           = new SizeT[num_threads+1];
 
         for (VertexId node = node_start; node < node_end; node++)
         {
@@ -222,8 +227,8 @@ int BuildRggGraph(
                     continue;
 
                 SizeT block_index = x1*row_length + y1;
-                VertexId *block = blocks[block_index];
-                for (SizeT i = 0; i< block_length[block_index]; i++)
+                VertexId *block = block_nodes + block_offsets[block_index];
+                for (SizeT i = 0; i< block_size[block_index]; i++)
                 {
                     VertexId peer = block[i];
                     if (node >= peer) continue;
@@ -286,14 +291,6 @@ int BuildRggGraph(
         values    = NULL;
     }
 
-    SizeT counter = 0;
-    for (SizeT i=0;  i < row_length * row_length; i++)
-    if (block_size[i] != 0)
-    {
-        counter += block_length[i];
-        if (blocks[i] != NULL) delete[] blocks[i]; blocks[i] = NULL;
-    }
-
     char *out_file = NULL;
     graph.template FromCoo<WITH_VALUES, EdgeTupleType>(
         out_file, coo, nodes, edges, false, undirected, false, quiet);
@@ -301,9 +298,10 @@ int BuildRggGraph(
     delete[] row_offsets; row_offsets = NULL;
     delete[] offsets    ; offsets     = NULL;
     delete[] points     ; points      = NULL;
-    delete[] blocks     ; blocks      = NULL;
     delete[] block_size ; block_size  = NULL;
+    delete[] block_offsets; block_offsets = NULL;
     delete[] block_length; block_length = NULL;
+    delete[] block_nodes; block_nodes = NULL;
     delete[] col_index_ ; col_index_  = NULL;
     if (WITH_VALUES) { delete[] values_; values_ = NULL; }
     free(coo); coo=NULL;
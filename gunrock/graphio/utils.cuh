@@ -40,6 +40,7 @@ struct drand48_data
 
 #include <gunrock/util/error_utils.cuh>
 #include <gunrock/util/random_bits.h>
+#include <gunrock/util/host/scan.cuh>
 
 #include <gunrock/coo.cuh>
 #include <gunrock/csr.cuh>
@@ -71,76 +72,35 @@ void RemoveStandaloneNodes(
 {
     SizeT nodes = graph->nodes;
     SizeT edges = graph->edges;
-    int *marker = new int[nodes];
-    memset(marker, 0, sizeof(int) * nodes);
     VertexId *column_indices = graph->column_indices;
     SizeT    *row_offsets    = graph->row_offsets;
-    SizeT    *displacements  = new SizeT   [graph->nodes];
+    SizeT    *marker         = new SizeT   [graph->nodes];
+    SizeT    *new_nodes      = new SizeT   [graph->nodes];
     SizeT    *new_offsets    = new SizeT   [graph->nodes + 1];
-    SizeT    *block_offsets  = NULL;
-    VertexId *new_nodes      = new VertexId[graph->nodes];
     Value    *new_values     = new Value   [graph->nodes];
     Value    *values         = graph->node_values;
-    int       num_threads    = 0;
 
-    #pragma omp parallel
-    {
-        num_threads  = omp_get_num_threads();
-        int thread_num   = omp_get_thread_num ();
-        SizeT edge_start = (long long)(edges) * thread_num / num_threads;
-        SizeT edge_end   = (long long)(edges) * (thread_num + 1) / num_threads;
-        SizeT node_start = (long long)(nodes) * thread_num / num_threads;
-        SizeT node_end   = (long long)(nodes) * (thread_num + 1) / num_threads;
-
-        for (SizeT    edge = edge_start; edge < edge_end; edge++)
-            marker[column_indices[edge]] = 1;
-        for (VertexId node = node_start; node < node_end; node++)
-            if (row_offsets[node] != row_offsets[node + 1])
-                marker[node] = 1;
-        if (thread_num == 0) block_offsets = new SizeT[num_threads + 1];
-        #pragma omp barrier
-
-        if (node_end > node_start) displacements[node_start] = 0;
-        for (VertexId node = node_start; node < node_end - 1; node++)
-            displacements[node + 1] = displacements[node] + 1 - marker[node];
-        #pragma omp barrier
-        if (node_end != 0)
-            block_offsets[thread_num + 1] = displacements[node_end - 1] + 1 - marker[node_end - 1];
-        else block_offsets[thread_num + 1] = 1 - marker[0];
-
-        #pragma omp barrier
-        #pragma omp single
-        {
-            block_offsets[0] = 0;
-            for (int i = 0; i < num_threads; i++)
-                block_offsets[i + 1] += block_offsets[i];
-        }
-
-        for (VertexId node = node_start; node < node_end; node++)
-        {
-            if (marker[node] == 0) continue;
-            VertexId node_ = node - block_offsets[thread_num] - displacements[node];
-            //printf("thread_num = %d, node = %d, block_offsets[] = %d, displacements[] = %d, node_ = %d\n",
-            //    thread_num, node, block_offsets[thread_num], displacements[node], node_);
-            new_nodes  [node ] = node_;
-            new_offsets[node_] = row_offsets[node];
-            if (values != NULL) new_values[node_] = values[node];
-        }
+    // a vertex stays if it has an out- or in-edge
+    #pragma omp parallel for
+    for (SizeT node = 0; node < nodes; node++)
+        marker[node] = (row_offsets[node] != row_offsets[node + 1]) ? 1 : 0;
+    #pragma omp parallel for
+    for (SizeT edge = 0; edge < edges; edge++)
+        marker[column_indices[edge]] = 1;
+    nodes = util::host::ExclusiveScan(marker, new_nodes, graph->nodes);
 
-        //#pragma omp barrier
-        //for (SizeT edge = edge_start; edge < edge_end; edge++)
-        //{
-        //    column_indices[edge] = new_nodes[column_indices[edge]];
-        //}
+    #pragma omp parallel for
+    for (SizeT node = 0; node < graph->nodes; node++)
+    {
+        if (marker[node] == 0) continue;
+        new_offsets[new_nodes[node]] = row_offsets[node];
+        if (values != NULL) new_values[new_nodes[node]] = values[node];
     }
-
+    #pragma omp parallel for
     for (SizeT edge = 0; edge < edges; edge++)
-    {
         column_indices[edge] = new_nodes[column_indices[edge]];
-    }
 
-    nodes = nodes - block_offsets[num_threads];
-    memcpy(row_offsets, new_offsets, sizeof(SizeT) * (nodes + 1));
+    memcpy(row_offsets, new_offsets, sizeof(SizeT) * nodes);
     if (values != NULL) memcpy(values, new_values, sizeof(Value) * nodes);
     if (!quiet)
     {
@@ -154,8 +114,6 @@ void RemoveStandaloneNodes(
     delete[] new_values   ; new_values    = NULL;
     delete[] new_nodes    ; new_nodes     = NULL;
     delete[] marker       ; marker        = NULL;
-    delete[] displacements; displacements = NULL;
-    delete[] block_offsets; block_offsets = NULL;
 }
 
 } // namespace graphio
@@ -85,6 +85,25 @@ enum SrcMode
     largest_degree,  // Largest-degree node as source
 };
 
+/**
+ * @brief Landmark selection enumerators.
+ */
+enum LandmarkMode
+{
+    landmark_degree,    // Highest-degree vertices
+    landmark_coverage,  // Highest-degree vertices not next to another landmark
+};
+
+#ifndef GR_LANDMARK_INFINITY
+#define GR_LANDMARK_INFINITY 0xffffffffu  // no bound / unreachable
+#endif
+
+/**
+ * @brief Landmark distance sketch, built by landmark_sketch() or
+ * landmark_sketch_market() and released by landmark_sketch_free().
+ */
+struct GRLandmarkSketch;
+
 /**
  * @brief arguments configuration used to specify arguments.
  */
@@ -106,6 +125,9 @@ struct GRSetup
     float   max_queue_sizing;  // Setting frontier queue size
     char* traversal_mode;  // Traversal mode: 0 for LB, 1 TWC
     enum SrcMode source_mode;  // Source mode rand/largest_degree
+    char*          tune_file;  // Parameters saved by --autotune, or NULL;
+                               // they don't override a traversal_mode
+                               // other than the default "LB"
 };
 
 /**
@@ -151,6 +173,7 @@ inline struct GRSetup* InitSetup(int num_iters, int* source)
     strcpy(configurations -> traversal_mode, "LB");
     configurations -> traversal_mode[2] = '\0';
     configurations -> source_mode = manually;
+    configurations -> tune_file = NULL;
     int* gpu_idx = (int*)malloc(sizeof(int)); gpu_idx[0] = 0;
     configurations -> device_list = gpu_idx;
     return configurations;
@@ -346,6 +369,79 @@ void pagerank(
     const int* col_indices,   // Input graph col_indices
     bool       normalized);   // normalized pagerank flag
 
+/**
+ * @brief Landmark distance sketch of a graph given as CSR arrays: the
+ * distances to and from num_landmarks landmarks, from which
+ * landmark_bounds() bounds any distance in O(num_landmarks).
+ *
+ * @param[in] num_nodes Input graph number of nodes.
+ * @param[in] num_edges Input graph number of edges.
+ * @param[in] row_offsets Input graph row_offsets.
+ * @param[in] col_indices Input graph col_indices.
+ * @param[in] edge_values Input graph edge weight, NULL for hop counts.
+ * @param[in] undirected Whether every edge is stored in both directions.
+ * @param[in] num_landmarks Number of landmarks.
+ * @param[in] landmark_mode How the landmarks are picked.
+ *
+ * \return The sketch, or NULL if a distance exceeds 31 bits.
+ */
+struct GRLandmarkSketch* landmark_sketch(
+    const int           num_nodes,      // Input graph number of nodes
+    const int           num_edges,      // Input graph number of edges
+    const int*          row_offsets,    // Input graph row_offsets
+    const int*          col_indices,    // Input graph col_indices
+    const unsigned int* edge_values,    // Input graph edge weight, or NULL
+    const bool          undirected,     // Both directions stored
+    const int           num_landmarks,  // Number of landmarks
+    enum LandmarkMode   landmark_mode); // Landmark selection
+
+/**
+ * @brief Landmark distance sketch of a MARKET graph. The sketch is saved
+ * next to the graph's binary cache, and read from there by later calls
+ * with the same settings.
+ *
+ * @param[in] market_file MARKET graph file.
+ * @param[in] undirected Treat the graph as undirected.
+ * @param[in] weighted Distances over the edge values, or hop counts.
+ * @param[in] num_landmarks Number of landmarks.
+ * @param[in] landmark_mode How the landmarks are picked.
+ * @param[in] quiet Don't print out anything.
+ *
+ * \return The sketch, or NULL on error.
+ */
+struct GRLandmarkSketch* landmark_sketch_market(
+    const char*       market_file,
+    const bool        undirected,
+    const bool        weighted,
+    const int         num_landmarks,
+    enum LandmarkMode landmark_mode,
+    const bool        quiet);
+
+/**
+ * @brief Bounds on the distances of (source, target) pairs: lower is
+ * GR_LANDMARK_INFINITY if the target is provably unreachable, upper if no
+ * landmark joins the pair; lower == upper means the distance is exact.
+ *
+ * @param[in] sketch Sketch of the graph.
+ * @param[in] num_queries Number of pairs.
+ * @param[in] sources Source of each pair.
+ * @param[in] targets Target of each pair.
+ * @param[out] lower Lower bound of each distance.
+ * @param[out] upper Upper bound of each distance.
+ */
+void landmark_bounds(
+    const struct GRLandmarkSketch* sketch,
+    const int     num_queries,
+    const int*    sources,
+    const int*    targets,
+    unsigned int* lower,
+    unsigned int* upper);
+
+/**
+ * @brief Releases a sketch.
+ */
+void landmark_sketch_free(struct GRLandmarkSketch* sketch);
+
 // TODO Add other primitives
 
 #ifdef __cplusplus
@@ -0,0 +1,223 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * edge_map.cuh
+ *
+ * @brief Host vertex-centric operators over VertexSubset frontiers, with
+ * push / pull auto-switch
+ */
+
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <omp.h>
+
+#include <gunrock/csr.cuh>
+#include <gunrock/util/sort_omp.cuh>
+#include <gunrock/oprtr/host/vertex_subset.cuh>
+
+namespace gunrock {
+namespace oprtr {
+namespace host {
+
+enum EdgeMapMode {
+    EDGE_MAP_AUTO = 0, // pull when |F| + out-degree sum of F > edges / 20
+    EDGE_MAP_PUSH = 1, // sparse: scatter along the out-edges of F
+    EDGE_MAP_PULL = 2, // dense: every vertex gathers over its in-edges
+};
+
+/**
+ * @brief Sum of the out-degrees of the frontier vertices.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+SizeT FrontierDegreeSum(
+    const Csr<VertexId, SizeT, Value>  &graph,
+    const VertexSubset<VertexId, SizeT> &frontier)
+{
+    SizeT sum = 0;
+    if (frontier.dense)
+    {
+        #pragma omp parallel for reduction(+:sum)
+        for (SizeT v = 0; v < graph.nodes; v++)
+            if (frontier.flags[v])
+                sum += graph.row_offsets[v+1] - graph.row_offsets[v];
+    } else {
+        #pragma omp parallel for reduction(+:sum)
+        for (SizeT i = 0; i < frontier.size; i++)
+        {
+            VertexId v = frontier.vertices[i];
+            sum += graph.row_offsets[v+1] - graph.row_offsets[v];
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Applies the functor to the edges leaving the frontier and
+ * collects the destinations it activates.
+ *
+ * The functor provides
+ *     bool CondDst        (VertexId d)             d may still be updated
+ *     bool ApplyEdge      (VertexId s, VertexId d) update, single writer per d
+ *     bool ApplyEdgeAtomic(VertexId s, VertexId d) update, concurrent writers
+ * where the Apply calls return true when d joins the output. Push runs
+ * ApplyEdgeAtomic over the out-edges of a sparse frontier and gives a
+ * sparse output; pull runs ApplyEdge over the in-edges of every vertex
+ * that passes CondDst, stopping at the first edge after which CondDst
+ * fails, and gives a dense output.
+ *
+ * @param[in] graph Graph (out-edges).
+ * @param[in] inv_graph Inverse graph (in-edges), NULL if graph is symmetric.
+ * @param[in,out] frontier Input frontier; may change representation.
+ * @param[out] output Activated vertices.
+ * @param[in,out] functor Edge functor.
+ * @param[in] mode Direction, or EDGE_MAP_AUTO.
+ * @param[in] threshold_divisor Pull when |F| + degree sum > edges / this.
+ *
+ * \return Direction used, EDGE_MAP_PUSH or EDGE_MAP_PULL.
+ */
+template <typename VertexId, typename SizeT, typename Value, typename FunctorT>
+EdgeMapMode EdgeMap(
+    const Csr<VertexId, SizeT, Value> &graph,
+    const Csr<VertexId, SizeT, Value> *inv_graph,
+    VertexSubset<VertexId, SizeT>     &frontier,
+    VertexSubset<VertexId, SizeT>     &output,
+    FunctorT                          &functor,
+    EdgeMapMode                        mode              = EDGE_MAP_AUTO,
+    SizeT                              threshold_divisor = 20)
+{
+    SizeT nodes = graph.nodes;
+    if (mode == EDGE_MAP_AUTO)
+    {
+        SizeT degree_sum = FrontierDegreeSum(graph, frontier);
+        mode = (frontier.size + degree_sum > graph.edges / threshold_divisor) ?
+            EDGE_MAP_PULL : EDGE_MAP_PUSH;
+    }
+
+    if (mode == EDGE_MAP_PULL)
+    {
+        const Csr<VertexId, SizeT, Value> &in_graph =
+            (inv_graph == NULL) ? graph : *inv_graph;
+        unsigned char *next_flags =
+            (unsigned char*) malloc(sizeof(unsigned char) * nodes);
+        frontier.ToDense();
+
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (SizeT d = 0; d < nodes; d++)
+        {
+            next_flags[d] = 0;
+            if (!functor.CondDst(d)) continue;
+            for (SizeT e = in_graph.row_offsets[d]; e < in_graph.row_offsets[d+1]; e++)
+            {
+                VertexId s = in_graph.column_indices[e];
+                if (!frontier.Contains(s)) continue;
+                if (functor.ApplyEdge(s, d)) next_flags[d] = 1;
+                if (!functor.CondDst(d)) break;
+            }
+        }
+        output.InitDense(nodes, next_flags);
+        return EDGE_MAP_PULL;
+    }
+
+    frontier.ToSparse();
+    int    num_threads = omp_get_max_threads();
+    std::vector<std::vector<VertexId> > buckets(num_threads);
+    SizeT *offsets = (SizeT*) malloc(sizeof(SizeT) * (num_threads + 1));
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        int thread_num = omp_get_thread_num();
+        std::vector<VertexId> &bucket = buckets[thread_num];
+        #pragma omp for schedule(dynamic, 64)
+        for (SizeT i = 0; i < frontier.size; i++)
+        {
+            VertexId s = frontier.vertices[i];
+            for (SizeT e = graph.row_offsets[s]; e < graph.row_offsets[s+1]; e++)
+            {
+                VertexId d = graph.column_indices[e];
+                if (functor.CondDst(d) && functor.ApplyEdgeAtomic(s, d))
+                    bucket.push_back(d);
+            }
+        }
+    }
+
+    offsets[0] = 0;
+    for (int i = 0; i < num_threads; i++)
+        offsets[i + 1] = offsets[i] + buckets[i].size();
+    VertexId *next_vertices = (VertexId*) malloc(
+        sizeof(VertexId) * (offsets[num_threads] > 0 ? offsets[num_threads] : 1));
+    #pragma omp parallel for num_threads(num_threads)
+    for (int i = 0; i < num_threads; i++)
+        if (!buckets[i].empty())
+            memcpy(next_vertices + offsets[i], &buckets[i][0],
+                sizeof(VertexId) * buckets[i].size());
+    util::omp_sort(next_vertices, offsets[num_threads], std::less<VertexId>());
+    output.InitSparse(nodes, next_vertices, offsets[num_threads]);
+    free(offsets); offsets = NULL;
+    return EDGE_MAP_PUSH;
+}
+
+/**
+ * @brief Applies op(v) to every member of the frontier.
+ */
+template <typename VertexId, typename SizeT, typename OpT>
+void VertexMap(
+    const VertexSubset<VertexId, SizeT> &frontier,
+    OpT                                 &op)
+{
+    if (frontier.dense)
+    {
+        #pragma omp parallel for
+        for (SizeT v = 0; v < frontier.nodes; v++)
+            if (frontier.flags[v]) op(v);
+    } else {
+        #pragma omp parallel for
+        for (SizeT i = 0; i < frontier.size; i++)
+            op(frontier.vertices[i]);
+    }
+}
+
+/**
+ * @brief Keeps the members v of the frontier for which op(v) is true;
+ * the output has the representation of the input.
+ */
+template <typename VertexId, typename SizeT, typename OpT>
+void VertexFilter(
+    const VertexSubset<VertexId, SizeT> &frontier,
+    VertexSubset<VertexId, SizeT>       &output,
+    OpT                                 &op)
+{
+    SizeT nodes = frontier.nodes;
+    unsigned char *flags = (unsigned char*) malloc(sizeof(unsigned char) * nodes);
+    if (frontier.dense)
+    {
+        #pragma omp parallel for
+        for (SizeT v = 0; v < nodes; v++)
+            flags[v] = (frontier.flags[v] && op(v)) ? 1 : 0;
+        output.InitDense(nodes, flags);
+    } else {
+        memset(flags, 0, sizeof(unsigned char) * nodes);
+        #pragma omp parallel for
+        for (SizeT i = 0; i < frontier.size; i++)
+            if (op(frontier.vertices[i])) flags[frontier.vertices[i]] = 1;
+        output.InitDense(nodes, flags);
+        output.ToSparse();
+    }
+}
+
+} // namespace host
+} // namespace oprtr
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,210 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * vertex_subset.cuh
+ *
+ * @brief Host frontier with sparse (sorted array) and dense (flag array)
+ * representations
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include <algorithm>
+
+namespace gunrock {
+namespace oprtr {
+namespace host {
+
+/**
+ * @brief A subset of the vertices [0, nodes), i.e. a host frontier.
+ *
+ * Sparse form: the members in ascending order in vertices[0 .. size).
+ * Dense form: flags[v] != 0 for every member v; one byte per vertex, so
+ * concurrent writers to different vertices never share a word they have
+ * to update atomically. Conversions keep the member set and the size.
+ *
+ * @tparam VertexId Vertex identifier.
+ * @tparam SizeT Graph size type.
+ */
+template <typename VertexId, typename SizeT>
+struct VertexSubset
+{
+    SizeT          nodes;
+    SizeT          size;
+    bool           dense;
+    VertexId      *vertices;  // [size], sparse form
+    unsigned char *flags;     // [nodes], dense form
+
+    VertexSubset() :
+        nodes   (0    ),
+        size    (0    ),
+        dense   (false),
+        vertices(NULL ),
+        flags   (NULL )
+    {
+    }
+
+    ~VertexSubset()
+    {
+        Release();
+    }
+
+    /**
+     * @brief Empty sparse subset of [0, _nodes).
+     */
+    void Init(SizeT _nodes)
+    {
+        Release();
+        nodes = _nodes;
+        size  = 0;
+        dense = false;
+    }
+
+    /**
+     * @brief Subset holding the single vertex v.
+     */
+    void InitSingle(SizeT _nodes, VertexId v)
+    {
+        Init(_nodes);
+        vertices = (VertexId*) malloc(sizeof(VertexId) * 1);
+        vertices[0] = v;
+        size = 1;
+    }
+
+    /**
+     * @brief Subset holding all vertices, kept dense.
+     */
+    void InitAll(SizeT _nodes)
+    {
+        Init(_nodes);
+        flags = (unsigned char*) malloc(sizeof(unsigned char) * nodes);
+        memset(flags, 1, sizeof(unsigned char) * nodes);
+        size  = nodes;
+        dense = true;
+    }
+
+    /**
+     * @brief Takes ownership of a dense flag array.
+     */
+    void InitDense(SizeT _nodes, unsigned char *_flags)
+    {
+        Init(_nodes);
+        flags = _flags;
+        dense = true;
+        SizeT count = 0;
+        #pragma omp parallel for reduction(+:count)
+        for (SizeT v = 0; v < nodes; v++)
+            if (flags[v]) count ++;
+        size = count;
+    }
+
+    /**
+     * @brief Takes ownership of a sorted, duplicate-free member array.
+     */
+    void InitSparse(SizeT _nodes, VertexId *_vertices, SizeT _size)
+    {
+        Init(_nodes);
+        vertices = _vertices;
+        size     = _size;
+    }
+
+    bool Empty() const { return size == 0; }
+
+    /**
+     * @brief Membership test; needs the dense form.
+     */
+    bool Contains(VertexId v) const
+    {
+        return flags[v] != 0;
+    }
+
+    /**
+     * @brief Builds the dense form from the sparse one.
+     */
+    void ToDense()
+    {
+        if (dense) return;
+        flags = (unsigned char*) malloc(sizeof(unsigned char) * nodes);
+        memset(flags, 0, sizeof(unsigned char) * nodes);
+        #pragma omp parallel for
+        for (SizeT i = 0; i < size; i++)
+            flags[vertices[i]] = 1;
+        if (vertices) { free(vertices); vertices = NULL; }
+        dense = true;
+    }
+
+    /**
+     * @brief Builds the sparse form from the dense one; every thread packs
+     * a contiguous vertex range, so the result stays sorted.
+     */
+    void ToSparse()
+    {
+        if (!dense) return;
+        int    num_threads = omp_get_max_threads();
+        SizeT *offsets     = (SizeT*) malloc(sizeof(SizeT) * (num_threads + 1));
+        vertices = (VertexId*) malloc(sizeof(VertexId) * (size > 0 ? size : 1));
+
+        #pragma omp parallel num_threads(num_threads)
+        {
+            int   thread_num = omp_get_thread_num();
+            SizeT v_start    = (long long)nodes * thread_num / num_threads;
+            SizeT v_end      = (long long)nodes * (thread_num + 1) / num_threads;
+            SizeT count      = 0;
+            for (SizeT v = v_start; v < v_end; v++)
+                if (flags[v]) count ++;
+            offsets[thread_num + 1] = count;
+            #pragma omp barrier
+            #pragma omp single
+            {
+                offsets[0] = 0;
+                for (int i = 0; i < num_threads; i++)
+                    offsets[i + 1] += offsets[i];
+            }
+            SizeT pos = offsets[thread_num];
+            for (SizeT v = v_start; v < v_end; v++)
+                if (flags[v]) vertices[pos++] = v;
+        }
+        free(offsets); offsets = NULL;
+        free(flags  ); flags   = NULL;
+        dense = false;
+    }
+
+    void Release()
+    {
+        if (vertices) { free(vertices); vertices = NULL; }
+        if (flags   ) { free(flags   ); flags    = NULL; }
+        size  = 0;
+        dense = false;
+    }
+
+    /**
+     * @brief Exchanges the contents of two subsets.
+     */
+    void Swap(VertexSubset &other)
+    {
+        std::swap(nodes   , other.nodes   );
+        std::swap(size    , other.size    );
+        std::swap(dense   , other.dense   );
+        std::swap(vertices, other.vertices);
+        std::swap(flags   , other.flags   );
+    }
+};
+
+} // namespace host
+} // namespace oprtr
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
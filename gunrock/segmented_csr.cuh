@@ -0,0 +1,199 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * segmented_csr.cuh
+ *
+ * @brief Cache-blocked (segmented) CSR layout for host gather / SpMV-style
+ * primitives
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+
+#include <gunrock/csr.cuh>
+#include <gunrock/util/sort_omp.cuh>
+
+namespace gunrock {
+
+/**
+ * @brief CSR split into segments by the vertex being read.
+ *
+ * A gather y[r] = sum(x[c]) over the edges (r, c) reads x at random. Here
+ * the read vertices c are cut into ranges of segment_size vertices, sized
+ * so that the slice of x fits in the cache, and every segment keeps its own
+ * sub-CSR holding only the rows that have edges into that range. Segments
+ * are processed one after another; within a segment all random reads hit
+ * the cached slice of x and the writes to y are sequential in row order.
+ *
+ * @tparam VertexId Vertex identifier.
+ * @tparam SizeT Graph size type.
+ * @tparam Value Associated value type.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+struct SegmentedCsr
+{
+    SizeT     nodes;
+    SizeT     edges;
+    SizeT     segment_size;     // number of read vertices per segment
+    SizeT     num_segments;
+    SizeT     num_rows;         // sum of the rows of all segments
+    SizeT    *segment_offsets;  // [num_segments + 1], into row_ids
+    VertexId *row_ids;          // [num_rows], row (written vertex)
+    SizeT    *row_offsets;      // [num_rows + 1], into column_indices
+    VertexId *column_indices;   // [edges], read vertex
+
+    SegmentedCsr() :
+        nodes          (0   ),
+        edges          (0   ),
+        segment_size   (0   ),
+        num_segments   (0   ),
+        num_rows       (0   ),
+        segment_offsets(NULL),
+        row_ids        (NULL),
+        row_offsets    (NULL),
+        column_indices (NULL)
+    {
+    }
+
+    ~SegmentedCsr()
+    {
+        Free();
+    }
+
+    /**
+     * @brief Builds the segments from a CSR graph.
+     *
+     * @param[in] graph Source graph.
+     * @param[in] reverse false: y[u] gathers x[v] over the edges u -> v;
+     * true: y[v] gathers x[u] over the edges u -> v (pull over in-edges).
+     * @param[in] segment_bytes Cache budget for one segment's slice of x.
+     */
+    void FromCsr(
+        const Csr<VertexId, SizeT, Value> &graph,
+        bool   reverse       = true,
+        size_t segment_bytes = 1 << 20)
+    {
+        struct SegmentKey
+        {
+            unsigned long long key;     // segment * nodes + row
+            VertexId           column;
+        };
+        struct KeyLess
+        {
+            bool operator()(const SegmentKey &a, const SegmentKey &b) const
+            {
+                return (a.key < b.key) || (a.key == b.key && a.column < b.column);
+            }
+        };
+
+        Free();
+        nodes        = graph.nodes;
+        edges        = graph.edges;
+        segment_size = segment_bytes / sizeof(Value);
+        if (segment_size < 1) segment_size = 1;
+        if (segment_size > nodes) segment_size = nodes > 0 ? nodes : 1;
+        num_segments = (nodes + segment_size - 1) / segment_size;
+
+        SegmentKey *keys = (SegmentKey*) malloc(sizeof(SegmentKey) * edges);
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (SizeT u = 0; u < nodes; u++)
+        {
+            for (SizeT e = graph.row_offsets[u]; e < graph.row_offsets[u+1]; e++)
+            {
+                VertexId v      = graph.column_indices[e];
+                VertexId row    = reverse ? v : u;
+                VertexId column = reverse ? u : v;
+                keys[e].key    = (unsigned long long)(column / segment_size) * nodes + row;
+                keys[e].column = column;
+            }
+        }
+        util::omp_sort(keys, edges, KeyLess());
+
+        // count rows, i.e. distinct (segment, row) keys
+        num_rows = 0;
+        for (SizeT e = 0; e < edges; e++)
+            if (e == 0 || keys[e].key != keys[e-1].key) num_rows ++;
+
+        segment_offsets = (SizeT*   ) malloc(sizeof(SizeT   ) * (num_segments + 1));
+        row_ids         = (VertexId*) malloc(sizeof(VertexId) * num_rows);
+        row_offsets     = (SizeT*   ) malloc(sizeof(SizeT   ) * (num_rows + 1));
+        column_indices  = (VertexId*) malloc(sizeof(VertexId) * edges);
+
+        SizeT row = 0, segment = 0;
+        segment_offsets[0] = 0;
+        for (SizeT e = 0; e < edges; e++)
+        {
+            column_indices[e] = keys[e].column;
+            if (e != 0 && keys[e].key == keys[e-1].key) continue;
+            SizeT key_segment = keys[e].key / nodes;
+            while (segment < key_segment)
+                segment_offsets[++segment] = row;
+            row_ids    [row] = keys[e].key % nodes;
+            row_offsets[row] = e;
+            row ++;
+        }
+        while (segment < num_segments)
+            segment_offsets[++segment] = row;
+        row_offsets[num_rows] = edges;
+        free(keys); keys = NULL;
+    }
+
+    /**
+     * @brief y[r] = sum of x[c] over the edges (r, c).
+     *
+     * @param[in] x Values read.
+     * @param[out] y Sums written, all nodes entries are set.
+     */
+    void Gather(const Value *x, Value *y) const
+    {
+        #pragma omp parallel
+        {
+            #pragma omp for
+            for (SizeT v = 0; v < nodes; v++)
+                y[v] = 0;
+
+            for (SizeT segment = 0; segment < num_segments; segment++)
+            {
+                // rows within a segment are distinct, no write conflicts
+                #pragma omp for schedule(dynamic, 256)
+                for (SizeT r = segment_offsets[segment];
+                    r < segment_offsets[segment + 1]; r++)
+                {
+                    Value sum = 0;
+                    for (SizeT e = row_offsets[r]; e < row_offsets[r + 1]; e++)
+                        sum += x[column_indices[e]];
+                    y[row_ids[r]] += sum;
+                }
+            }
+        }
+    }
+
+    void Free()
+    {
+        if (segment_offsets) { free(segment_offsets); segment_offsets = NULL; }
+        if (row_ids        ) { free(row_ids        ); row_ids         = NULL; }
+        if (row_offsets    ) { free(row_offsets    ); row_offsets     = NULL; }
+        if (column_indices ) { free(column_indices ); column_indices  = NULL; }
+        nodes = 0;
+        edges = 0;
+        num_segments = 0;
+        num_rows = 0;
+    }
+};
+
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
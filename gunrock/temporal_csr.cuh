@@ -0,0 +1,216 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * temporal_csr.cuh
+ *
+ * @brief Temporal CSR: every edge carries a timestamp and every row is
+ * sorted by time, so that traversals restricted to a time window find
+ * their edges by binary search instead of rebuilding the graph
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <omp.h>
+
+#include <gunrock/util/sort_omp.cuh>
+
+namespace gunrock {
+
+/**
+ * @brief One timestamped edge, as read from an edge list.
+ */
+template <typename VertexId, typename Value, typename Time>
+struct TemporalEdge
+{
+    VertexId row;
+    VertexId col;
+    Value    val;
+    Time     time;
+};
+
+/**
+ * @brief Orders temporal edges by source, then time, then destination.
+ */
+template <typename TemporalEdge>
+struct TemporalEdgeLess
+{
+    bool operator()(const TemporalEdge &a, const TemporalEdge &b) const
+    {
+        if (a.row  != b.row ) return a.row  < b.row ;
+        if (a.time != b.time) return a.time < b.time;
+        return a.col < b.col;
+    }
+};
+
+/**
+ * @brief CSR with a timestamp per edge, rows sorted by timestamp.
+ *
+ * timestamps runs alongside column_indices, and within a row is non
+ * decreasing. The edges of row v within [t0, t1] are then the contiguous
+ * range found by two binary searches over timestamps, so one build serves
+ * any number of windows. Parallel edges are kept: the same pair of
+ * vertices linked at different times are different contacts.
+ *
+ * @tparam VertexId Vertex identifier.
+ * @tparam SizeT Graph size type.
+ * @tparam Value Associated value type.
+ * @tparam Time Timestamp type.
+ */
+template <typename VertexId, typename SizeT, typename Value,
+    typename Time = long long>
+struct TemporalCsr
+{
+    SizeT     nodes;
+    SizeT     edges;
+    Time      min_time;         // smallest timestamp, 0 if no edges
+    Time      max_time;         // largest timestamp, 0 if no edges
+    SizeT    *row_offsets;      // [nodes + 1], into column_indices
+    VertexId *column_indices;   // [edges], destination
+    Time     *timestamps;       // [edges], time of the edge, sorted per row
+    Value    *edge_values;      // [edges], NULL if not loaded
+
+    TemporalCsr() :
+        nodes         (0   ),
+        edges         (0   ),
+        min_time      (0   ),
+        max_time      (0   ),
+        row_offsets   (NULL),
+        column_indices(NULL),
+        timestamps    (NULL),
+        edge_values   (NULL)
+    {
+    }
+
+    ~TemporalCsr()
+    {
+        Free();
+    }
+
+    // owns its arrays, which a copy would free twice
+    TemporalCsr(const TemporalCsr &) = delete;
+    TemporalCsr &operator=(const TemporalCsr &) = delete;
+
+    /**
+     * @brief Builds the temporal CSR from an edge list.
+     *
+     * @tparam LOAD_VALUES Whether to keep the edge values.
+     *
+     * @param[in] edge_list Edges, sorted in place by (source, time, destination).
+     * @param[in] num_nodes Number of vertices.
+     * @param[in] num_edges Number of edges.
+     */
+    template <bool LOAD_VALUES>
+    void FromEdges(
+        TemporalEdge<VertexId, Value, Time> *edge_list,
+        SizeT num_nodes,
+        SizeT num_edges)
+    {
+        typedef TemporalEdge<VertexId, Value, Time> EdgeT;
+
+        Free();
+        nodes = num_nodes;
+        edges = num_edges;
+        util::omp_sort(edge_list, edges, TemporalEdgeLess<EdgeT>());
+
+        row_offsets    = (SizeT*   ) malloc(sizeof(SizeT   ) * (nodes + 1));
+        column_indices = (VertexId*) malloc(sizeof(VertexId) * edges);
+        timestamps     = (Time*    ) malloc(sizeof(Time    ) * edges);
+        if (LOAD_VALUES)
+            edge_values = (Value*  ) malloc(sizeof(Value   ) * edges);
+
+        Time t_min = edges > 0 ? edge_list[0].time : 0;
+        Time t_max = t_min;
+        #pragma omp parallel
+        {
+            Time thread_min = t_min, thread_max = t_max;
+            #pragma omp for
+            for (SizeT e = 0; e < edges; e++)
+            {
+                column_indices[e] = edge_list[e].col;
+                timestamps    [e] = edge_list[e].time;
+                if (LOAD_VALUES) edge_values[e] = edge_list[e].val;
+                if (edge_list[e].time < thread_min) thread_min = edge_list[e].time;
+                if (edge_list[e].time > thread_max) thread_max = edge_list[e].time;
+            }
+            #pragma omp critical
+            {
+                if (thread_min < t_min) t_min = thread_min;
+                if (thread_max > t_max) t_max = thread_max;
+            }
+        }
+        min_time = t_min;
+        max_time = t_max;
+
+        // rows are contiguous after the sort, offsets by a sweep
+        SizeT e = 0;
+        for (SizeT v = 0; v <= nodes; v++)
+        {
+            while (e < edges && edge_list[e].row < v) e++;
+            row_offsets[v] = e;
+        }
+    }
+
+    /**
+     * @brief Edges of row v with timestamps in [t0, t1].
+     *
+     * @param[in] v Source vertex.
+     * @param[in] t0 Window start, inclusive.
+     * @param[in] t1 Window end, inclusive.
+     * @param[out] begin First edge in the window.
+     * @param[out] end One past the last edge in the window.
+     */
+    void WindowRange(
+        VertexId v, Time t0, Time t1, SizeT &begin, SizeT &end) const
+    {
+        const Time *row_begin = timestamps + row_offsets[v];
+        const Time *row_end   = timestamps + row_offsets[v + 1];
+        const Time *first     = std::lower_bound(row_begin, row_end, t0);
+        begin = first - timestamps;
+        end   = std::upper_bound(first, row_end, t1) - timestamps;
+    }
+
+    /**
+     * @brief Number of edges with timestamps in [t0, t1].
+     */
+    SizeT WindowEdges(Time t0, Time t1) const
+    {
+        SizeT num_edges = 0;
+        #pragma omp parallel for reduction(+:num_edges)
+        for (SizeT v = 0; v < nodes; v++)
+        {
+            SizeT begin, end;
+            WindowRange(v, t0, t1, begin, end);
+            num_edges += end - begin;
+        }
+        return num_edges;
+    }
+
+    void Free()
+    {
+        if (row_offsets   ) { free(row_offsets   ); row_offsets    = NULL; }
+        if (column_indices) { free(column_indices); column_indices = NULL; }
+        if (timestamps    ) { free(timestamps    ); timestamps     = NULL; }
+        if (edge_values   ) { free(edge_values   ); edge_values    = NULL; }
+        nodes = 0;
+        edges = 0;
+        min_time = 0;
+        max_time = 0;
+    }
+};
+
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,154 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * compact.cuh
+ *
+ * @brief Parallel stream compaction and stable partition on the host
+ */
+
+#pragma once
+
+#include <omp.h>
+#include <gunrock/util/host/scan.cuh>
+
+namespace gunrock {
+namespace util {
+namespace host {
+
+/**
+ * @brief Counts, per thread block of [0, num_elements), the indices that
+ * pass the predicate, and scans the counts.
+ *
+ * \return Number of indices passing.
+ */
+template <typename SizeT, typename Predicate>
+SizeT CountBlocks(
+    SizeT      num_elements,
+    Predicate  keep,
+    int        num_blocks,
+    SizeT     *block_offsets)
+{
+    #pragma omp parallel for num_threads(num_blocks)
+    for (int block = 0; block < num_blocks; block++)
+    {
+        SizeT begin = (long long)num_elements * block / num_blocks;
+        SizeT end   = (long long)num_elements * (block + 1) / num_blocks;
+        SizeT count = 0;
+        for (SizeT i = begin; i < end; i++)
+            if (keep(i)) count ++;
+        block_offsets[block] = count;
+    }
+    return ExclusiveScan(block_offsets, block_offsets, num_blocks);
+}
+
+/**
+ * @brief Copies input[i] for every i with keep(i), keeping their order.
+ * keep is called twice per index and must be pure.
+ *
+ * @param[in] input Input elements.
+ * @param[in] num_elements Number of input elements.
+ * @param[out] output Kept elements; must not overlap input.
+ * @param[in] keep Predicate on the index.
+ *
+ * \return Number of kept elements.
+ */
+template <typename T, typename SizeT, typename Predicate>
+SizeT Compact(
+    const T   *input,
+    SizeT      num_elements,
+    T         *output,
+    Predicate  keep)
+{
+    int    num_blocks    = omp_get_max_threads();
+    SizeT *block_offsets = new SizeT[num_blocks];
+    SizeT  num_kept = CountBlocks(num_elements, keep, num_blocks, block_offsets);
+
+    #pragma omp parallel for num_threads(num_blocks)
+    for (int block = 0; block < num_blocks; block++)
+    {
+        SizeT begin  = (long long)num_elements * block / num_blocks;
+        SizeT end    = (long long)num_elements * (block + 1) / num_blocks;
+        SizeT offset = block_offsets[block];
+        for (SizeT i = begin; i < end; i++)
+            if (keep(i)) output[offset++] = input[i];
+    }
+    delete[] block_offsets; block_offsets = NULL;
+    return num_kept;
+}
+
+/**
+ * @brief Stable partition: elements with keep(i) first, the others after,
+ * each group in input order. keep must be pure.
+ *
+ * @param[in] input Input elements.
+ * @param[in] num_elements Number of input elements.
+ * @param[out] output Partitioned elements; must not overlap input.
+ * @param[in] keep Predicate on the index.
+ *
+ * \return Number of elements in the first group.
+ */
+template <typename T, typename SizeT, typename Predicate>
+SizeT Partition(
+    const T   *input,
+    SizeT      num_elements,
+    T         *output,
+    Predicate  keep)
+{
+    int    num_blocks    = omp_get_max_threads();
+    SizeT *block_offsets = new SizeT[num_blocks];
+    SizeT  num_kept = CountBlocks(num_elements, keep, num_blocks, block_offsets);
+
+    #pragma omp parallel for num_threads(num_blocks)
+    for (int block = 0; block < num_blocks; block++)
+    {
+        SizeT begin  = (long long)num_elements * block / num_blocks;
+        SizeT end    = (long long)num_elements * (block + 1) / num_blocks;
+        SizeT kept   = block_offsets[block];
+        SizeT others = num_kept + begin - kept;  // rejects before this block
+        for (SizeT i = begin; i < end; i++)
+        {
+            if (keep(i)) output[kept  ++] = input[i];
+            else         output[others++] = input[i];
+        }
+    }
+    delete[] block_offsets; block_offsets = NULL;
+    return num_kept;
+}
+
+template <typename T, typename SizeT>
+struct FlagPredicate
+{
+    const T *flags;
+    bool operator()(SizeT i) const { return flags[i] != 0; }
+};
+
+/**
+ * @brief Compact with the predicate given as an array of flags.
+ */
+template <typename T, typename SizeT, typename FlagT>
+SizeT CompactFlagged(
+    const T     *input,
+    const FlagT *flags,
+    SizeT        num_elements,
+    T           *output)
+{
+    FlagPredicate<FlagT, SizeT> keep;
+    keep.flags = flags;
+    return Compact(input, num_elements, output, keep);
+}
+
+} // namespace host
+} // namespace util
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
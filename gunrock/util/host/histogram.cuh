@@ -0,0 +1,95 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * histogram.cuh
+ *
+ * @brief Parallel histogram on the host
+ */
+
+#pragma once
+
+#include <omp.h>
+
+namespace gunrock {
+namespace util {
+namespace host {
+
+/**
+ * @brief Largest private histogram per thread, in bytes; above it, threads
+ * share one histogram and count with atomics.
+ */
+static const long long PRIVATE_HISTOGRAM_BYTES = 1 << 20;
+
+/**
+ * @brief Counts the elements of each bin: counts[bin_of(i)] for i in
+ * [0, num_elements). Small histograms are privatized per thread and
+ * summed bin-parallel; large ones, where private copies would not fit in
+ * cache and conflicts are rare, are counted with atomic adds.
+ *
+ * @param[in] num_elements Number of elements.
+ * @param[in] bin_of Functor returning the bin of the i-th element, in
+ * [0, num_bins).
+ * @param[out] counts Count of each bin.
+ * @param[in] num_bins Number of bins.
+ */
+template <typename CountT, typename SizeT, typename BinOp>
+void Histogram(
+    SizeT   num_elements,
+    BinOp   bin_of,
+    CountT *counts,
+    SizeT   num_bins)
+{
+    int num_threads = omp_get_max_threads();
+    #pragma omp parallel for
+    for (SizeT bin = 0; bin < num_bins; bin++)
+        counts[bin] = 0;
+
+    if ((long long)num_bins * sizeof(CountT) > PRIVATE_HISTOGRAM_BYTES)
+    {
+        #pragma omp parallel for
+        for (SizeT i = 0; i < num_elements; i++)
+            __sync_fetch_and_add(counts + bin_of(i), (CountT)1);
+        return;
+    }
+
+    // the runtime may start fewer threads than asked for, only the copies
+    // of the threads actually started are zeroed and summed
+    CountT *private_counts = new CountT[(long long)num_bins * num_threads];
+    #pragma omp parallel num_threads(num_threads)
+    {
+        int     thread_num  = omp_get_thread_num();
+        int     num_copies  = omp_get_num_threads();
+        CountT *local       = private_counts + (long long)num_bins * thread_num;
+        for (SizeT bin = 0; bin < num_bins; bin++)
+            local[bin] = 0;
+        #pragma omp for
+        for (SizeT i = 0; i < num_elements; i++)
+            local[bin_of(i)] ++;
+        // implicit barrier, then sum the private copies bin by bin
+        #pragma omp for
+        for (SizeT bin = 0; bin < num_bins; bin++)
+        {
+            CountT sum = 0;
+            for (int t = 0; t < num_copies; t++)
+                sum += private_counts[(long long)num_bins * t + bin];
+            counts[bin] = sum;
+        }
+    }
+    delete[] private_counts; private_counts = NULL;
+}
+
+} // namespace host
+} // namespace util
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,103 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * merge.cuh
+ *
+ * @brief Merge-path parallel merge on the host
+ */
+
+#pragma once
+
+#include <omp.h>
+#include <algorithm>
+#include <functional>
+
+namespace gunrock {
+namespace util {
+namespace host {
+
+/**
+ * @brief Merge-path search: how many elements of a are among the first
+ * diagonal elements of the stable merge of a and b (a first on ties).
+ */
+template <typename T, typename SizeT, typename Compare>
+SizeT MergePathSearch(
+    const T *a, SizeT a_length,
+    const T *b, SizeT b_length,
+    SizeT    diagonal,
+    Compare  comp)
+{
+    SizeT begin = diagonal > b_length ? diagonal - b_length : 0;
+    SizeT end   = diagonal < a_length ? diagonal : a_length;
+    while (begin < end)
+    {
+        SizeT mid = begin + (end - begin) / 2;
+        if (!comp(b[diagonal - 1 - mid], a[mid])) begin = mid + 1;
+        else end = mid;
+    }
+    return begin;
+}
+
+/**
+ * @brief Stable merge of two sorted ranges. The output is cut into equal
+ * parts, one per thread; merge-path search finds where each part starts in
+ * a and b, so every thread merges the same number of elements however the
+ * inputs interleave.
+ *
+ * @param[in] a First sorted range.
+ * @param[in] a_length Length of a.
+ * @param[in] b Second sorted range.
+ * @param[in] b_length Length of b.
+ * @param[out] output Merged range, a_length + b_length elements; must not
+ * overlap the inputs.
+ * @param[in] comp Strict weak order the inputs are sorted by.
+ */
+template <typename T, typename SizeT, typename Compare>
+void ParallelMerge(
+    const T *a, SizeT a_length,
+    const T *b, SizeT b_length,
+    T       *output,
+    Compare  comp)
+{
+    SizeT total       = a_length + b_length;
+    int   num_threads = omp_get_max_threads();
+    if (total < (1 << 14)) num_threads = 1;
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        int   thread_num = omp_get_thread_num();
+        int   num_parts  = omp_get_num_threads();
+        SizeT begin = (long long)total * thread_num / num_parts;
+        SizeT end   = (long long)total * (thread_num + 1) / num_parts;
+        SizeT a_begin = MergePathSearch(a, a_length, b, b_length, begin, comp);
+        SizeT a_end   = MergePathSearch(a, a_length, b, b_length, end  , comp);
+        std::merge(a + a_begin, a + a_end,
+                   b + (begin - a_begin), b + (end - a_end),
+                   output + begin, comp);
+    }
+}
+
+template <typename T, typename SizeT>
+void ParallelMerge(
+    const T *a, SizeT a_length,
+    const T *b, SizeT b_length,
+    T       *output)
+{
+    ParallelMerge(a, a_length, b, b_length, output, std::less<T>());
+}
+
+} // namespace host
+} // namespace util
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,28 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * primitives.cuh
+ *
+ * @brief Parallel host primitives for preprocessing: scan, compaction and
+ * partition, histogram, segmented sort and merge-path merge.
+ */
+
+#pragma once
+
+#include <gunrock/util/host/scan.cuh>
+#include <gunrock/util/host/compact.cuh>
+#include <gunrock/util/host/histogram.cuh>
+#include <gunrock/util/host/merge.cuh>
+#include <gunrock/util/host/segmented_sort.cuh>
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,163 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * scan.cuh
+ *
+ * @brief Parallel prefix sums on the host
+ */
+
+#pragma once
+
+#include <omp.h>
+
+namespace gunrock {
+namespace util {
+namespace host {
+
+/**
+ * @brief Inputs below this size are scanned by one thread.
+ */
+static const long long SERIAL_SCAN_SIZE = 1 << 14;
+
+/**
+ * @brief Prefix sum of value_of(i), i in [0, num_elements). Each thread
+ * sums a contiguous block, the block sums are scanned, then each thread
+ * writes its block; value_of is called twice per element and must be pure.
+ *
+ * @tparam INCLUSIVE Whether output[i] includes value_of(i).
+ *
+ * @param[in] num_elements Number of elements.
+ * @param[in] value_of Functor returning the i-th value.
+ * @param[out] output Prefix sums; may alias the values read by value_of.
+ * @param[in] init Offset added to every prefix sum.
+ *
+ * \return init plus the sum of all values.
+ */
+template <bool INCLUSIVE, typename T, typename SizeT, typename ValueOp>
+T ScanOf(
+    SizeT   num_elements,
+    ValueOp value_of,
+    T      *output,
+    T       init = 0)
+{
+    if (num_elements < SERIAL_SCAN_SIZE)
+    {
+        T sum = init;
+        for (SizeT i = 0; i < num_elements; i++)
+        {
+            T value = value_of(i);
+            if (INCLUSIVE) sum += value;
+            output[i] = sum;
+            if (!INCLUSIVE) sum += value;
+        }
+        return sum;
+    }
+
+    T  total      = init;
+    T *block_sums = NULL;
+    #pragma omp parallel
+    {
+        int   num_threads = omp_get_num_threads();
+        int   thread_num  = omp_get_thread_num();
+        SizeT begin = (long long)num_elements * thread_num / num_threads;
+        SizeT end   = (long long)num_elements * (thread_num + 1) / num_threads;
+        #pragma omp single
+        block_sums = new T[num_threads + 1];
+
+        T sum = 0;
+        for (SizeT i = begin; i < end; i++)
+            sum += value_of(i);
+        block_sums[thread_num + 1] = sum;
+        #pragma omp barrier
+        #pragma omp single
+        {
+            block_sums[0] = init;
+            for (int t = 0; t < num_threads; t++)
+                block_sums[t + 1] += block_sums[t];
+            total = block_sums[num_threads];
+        }
+
+        sum = block_sums[thread_num];
+        for (SizeT i = begin; i < end; i++)
+        {
+            T value = value_of(i);
+            if (INCLUSIVE) sum += value;
+            output[i] = sum;
+            if (!INCLUSIVE) sum += value;
+        }
+    }
+    delete[] block_sums; block_sums = NULL;
+    return total;
+}
+
+/**
+ * @brief Exclusive prefix sum of value_of(i):
+ * output[i] = init + sum of value_of(j) for j < i.
+ */
+template <typename T, typename SizeT, typename ValueOp>
+T ExclusiveScanOf(
+    SizeT   num_elements,
+    ValueOp value_of,
+    T      *output,
+    T       init = 0)
+{
+    return ScanOf<false>(num_elements, value_of, output, init);
+}
+
+template <typename T, typename SizeT>
+struct ArrayValueOp
+{
+    const T *input;
+    T operator()(SizeT i) const { return input[i]; }
+};
+
+/**
+ * @brief Exclusive prefix sum of an array, may be in place.
+ *
+ * \return init plus the sum of all elements.
+ */
+template <typename T, typename SizeT>
+T ExclusiveScan(
+    const T *input,
+    T       *output,
+    SizeT    num_elements,
+    T        init = 0)
+{
+    ArrayValueOp<T, SizeT> value_of;
+    value_of.input = input;
+    return ScanOf<false>(num_elements, value_of, output, init);
+}
+
+/**
+ * @brief Inclusive prefix sum of an array, may be in place:
+ * output[i] = init + sum of input[j] for j <= i.
+ *
+ * \return init plus the sum of all elements.
+ */
+template <typename T, typename SizeT>
+T InclusiveScan(
+    const T *input,
+    T       *output,
+    SizeT    num_elements,
+    T        init = 0)
+{
+    ArrayValueOp<T, SizeT> value_of;
+    value_of.input = input;
+    return ScanOf<true>(num_elements, value_of, output, init);
+}
+
+} // namespace host
+} // namespace util
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,187 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * segmented_sort.cuh
+ *
+ * @brief Parallel segmented sort on the host
+ */
+
+#pragma once
+
+#include <omp.h>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <gunrock/util/sort_omp.cuh>
+
+namespace gunrock {
+namespace util {
+namespace host {
+
+/**
+ * @brief A key with its value; plain data, as omp_sort copies its elements
+ * with malloc and memcpy.
+ */
+template <typename KeyT, typename ValueT>
+struct KeyValuePair
+{
+    KeyT   key;
+    ValueT value;
+};
+
+/**
+ * @brief Orders (key, value) pairs by key, ties by value.
+ */
+template <typename Compare>
+struct PairKeyCompare
+{
+    Compare comp;
+    PairKeyCompare(Compare comp) : comp(comp) {}
+
+    template <typename Pair>
+    bool operator()(const Pair &x, const Pair &y) const
+    {
+        if (comp(x.key, y.key)) return true;
+        if (comp(y.key, x.key)) return false;
+        return x.value < y.value;
+    }
+};
+
+/**
+ * @brief Sorts every segment [offsets[s], offsets[s+1]) of keys, and
+ * permutes values (if not NULL) alike; equal keys are ordered by value. Segments are sorted one per thread,
+ * dynamically scheduled; segments longer than the input divided by the
+ * thread count would unbalance that, so they are sorted afterwards one at
+ * a time, each by all threads.
+ *
+ * @param[in,out] keys Keys, sorted within each segment.
+ * @param[in,out] values Values moved with their keys, or NULL.
+ * @param[in] offsets Segment offsets, num_segments + 1 of them.
+ * @param[in] num_segments Number of segments.
+ * @param[in] comp Strict weak order on the keys.
+ */
+template <typename KeyT, typename ValueT, typename SizeT, typename Compare>
+void SegmentedSortPairs(
+    KeyT        *keys,
+    ValueT      *values,
+    const SizeT *offsets,
+    SizeT        num_segments,
+    Compare      comp)
+{
+    typedef KeyValuePair<KeyT, ValueT> Pair;
+    int   num_threads = omp_get_max_threads();
+    SizeT total       = offsets[num_segments] - offsets[0];
+    SizeT large       = num_threads > 1 ? total / num_threads + 1 : total + 1;
+    if (large < (1 << 14)) large = 1 << 14;
+    std::vector<SizeT> large_segments;
+
+    #pragma omp parallel
+    {
+        std::vector<Pair> pairs;
+        std::vector<SizeT> local_large;
+        #pragma omp for schedule(dynamic, 256) nowait
+        for (SizeT s = 0; s < num_segments; s++)
+        {
+            SizeT begin = offsets[s], length = offsets[s+1] - offsets[s];
+            if (length < 2) continue;
+            if (length >= large) { local_large.push_back(s); continue; }
+            if (values == NULL)
+            {
+                std::sort(keys + begin, keys + begin + length, comp);
+                continue;
+            }
+            pairs.resize(length);
+            for (SizeT i = 0; i < length; i++)
+            {
+                pairs[i].key   = keys  [begin + i];
+                pairs[i].value = values[begin + i];
+            }
+            std::sort(pairs.begin(), pairs.end(), PairKeyCompare<Compare>(comp));
+            for (SizeT i = 0; i < length; i++)
+            {
+                keys  [begin + i] = pairs[i].key;
+                values[begin + i] = pairs[i].value;
+            }
+        }
+        #pragma omp critical
+        large_segments.insert(large_segments.end(),
+            local_large.begin(), local_large.end());
+    }
+
+    for (size_t l = 0; l < large_segments.size(); l++)
+    {
+        SizeT s = large_segments[l];
+        SizeT begin = offsets[s], length = offsets[s+1] - offsets[s];
+        if (values == NULL)
+        {
+            util::omp_sort(keys + begin, length, comp);
+            continue;
+        }
+        Pair *pairs = (Pair*) malloc(sizeof(Pair) * length);
+        #pragma omp parallel for
+        for (SizeT i = 0; i < length; i++)
+        {
+            pairs[i].key   = keys  [begin + i];
+            pairs[i].value = values[begin + i];
+        }
+        util::omp_sort(pairs, length, PairKeyCompare<Compare>(comp));
+        #pragma omp parallel for
+        for (SizeT i = 0; i < length; i++)
+        {
+            keys  [begin + i] = pairs[i].key;
+            values[begin + i] = pairs[i].value;
+        }
+        free(pairs); pairs = NULL;
+    }
+}
+
+/**
+ * @brief SegmentedSortPairs in ascending key order.
+ */
+template <typename KeyT, typename ValueT, typename SizeT>
+void SegmentedSortPairs(
+    KeyT        *keys,
+    ValueT      *values,
+    const SizeT *offsets,
+    SizeT        num_segments)
+{
+    SegmentedSortPairs(keys, values, offsets, num_segments, std::less<KeyT>());
+}
+
+/**
+ * @brief SegmentedSortPairs without values.
+ */
+template <typename KeyT, typename SizeT, typename Compare>
+void SegmentedSort(
+    KeyT        *keys,
+    const SizeT *offsets,
+    SizeT        num_segments,
+    Compare      comp)
+{
+    SegmentedSortPairs(keys, (char*)NULL, offsets, num_segments, comp);
+}
+
+template <typename KeyT, typename SizeT>
+void SegmentedSort(
+    KeyT        *keys,
+    const SizeT *offsets,
+    SizeT        num_segments)
+{
+    SegmentedSort(keys, offsets, num_segments, std::less<KeyT>());
+}
+
+} // namespace host
+} // namespace util
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
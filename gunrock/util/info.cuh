@@ -80,6 +80,8 @@ public:
         info["compiler_version"]   = "";     // what version compiler?
         info["debug_mode"]         = false;  // verbose flag print debug info
         info["dataset"]            = "";     // dataset name used in test
+        info["dataset_path"]       = "";     // market file the graph came from
+        info["dataset_cache"]      = "";     // binary cache of the market file
         info["edges_visited"]      = 0;      // number of edges touched
         info["elapsed"]            = 0.0f;   // elapsed device running time
         info["preprocess_time"]    = 0.0f;   // elapsed preprocessing time
@@ -151,6 +153,33 @@ public:
         info["direction_optimized"]= false;  // whether to enable directional optimization
         info["do_a"               ]= 0.001;  // direction optimization parameter
         info["do_b"               ]= 0.200;  // direction optimization parameter
+        info["do_heuristic"       ]= "beamer"; // direction switching heuristic
+        info["autotune"           ]= false;  // whether to tune with pilot runs
+        info["edge_list_ref"      ]= false;  // whether to run edge-list CPU reference
+        info["hilbert_order"      ]= false;  // whether to Hilbert-order edge lists
+        info["segmented_ref"      ]= false;  // whether to run cache-blocked CPU reference
+        info["segment_bytes"      ]= 1 << 20;// cache budget of one CSR segment
+        info["ppr_batch"          ]= 0;      // personalized PageRanks of the batched CPU run
+        info["vertex_subset_ref"  ]= false;  // whether to run VertexSubset CPU reference
+        info["multi_source_ref"   ]= false;  // whether to check the multi-source CPU runs
+        info["reach_index"        ]= false;  // whether to check the reachability index
+        info["landmarks"          ]= 0;      // landmarks of the checked distance sketch
+        info["temporal"           ]= false;  // whether to check the temporal traversals
+        info["temporal_t0"        ]= (int64_t)0; // start of the temporal window
+        info["temporal_t1"        ]= (int64_t)0; // end of the temporal window
+        info["temporal_durations" ]= false;  // whether edge values are traversal durations
+        info["hub_degree"         ]= 0;      // minimum degree of hash-indexed hubs
+        info["edge_maps"          ]= false;  // whether to build reverse edge maps
+        info["largest_cc"         ]= false;  // whether only the largest component was loaded
+        info["kernelize"          ]= false;  // whether to run on the folded kernel graph
+        info["weight_distribution"]= "uniform"; // synthetic edge weights
+        info["weight_seed"        ]= 0;      // synthetic edge weight seed
+        info["weight_min"         ]= 0.0;    // smallest synthetic edge weight
+        info["weight_max"         ]= 63.0;   // largest synthetic edge weight
+        info["weight_sigma"       ]= 1.0;    // log-normal weight shape
+        info["weight_codec"       ]= "none"; // narrow edge weight storage
+        info["autotuned"          ]= false;  // whether a tune file was applied
+        info["autotune_file"      ]= "";     // tune file of this dataset
         info["duplicate_graph"    ]= false;  // whether to duplicate graph on every GPUs
         info["64bit_VertexId"     ]= (sizeof(VertexId) == 8) ? true : false;
         info["64bit_SizeT"        ]= (sizeof(SizeT   ) == 8) ? true : false;
@@ -213,6 +242,14 @@ public:
         info["idempotent"] =  args.CheckCmdLineFlag("idempotence");       // BFS
         info["mark_predecessors"] =  args.CheckCmdLineFlag("mark-pred");  // BFS
         info["normalized"] =  args.CheckCmdLineFlag("normalized"); // PR
+        info["autotune"  ] =  args.CheckCmdLineFlag("autotune");
+        info["edge_list_ref"] = args.CheckCmdLineFlag("edge-list-ref");
+        info["hilbert_order"] = args.CheckCmdLineFlag("hilbert-order");
+        info["segmented_ref"] = args.CheckCmdLineFlag("segmented-ref");
+        info["vertex_subset_ref"] = args.CheckCmdLineFlag("vertex-subset-ref");
+        info["multi_source_ref" ] = args.CheckCmdLineFlag("multi-source-ref"); // BFS, SSSP
+        info["reach_index"      ] = args.CheckCmdLineFlag("reach-index");
+        info["kernelize" ] =  args.CheckCmdLineFlag("kernelize" ); // CC, SSSP
         info["scaled"    ] =  args.CheckCmdLineFlag("scaled"    ); // PR
         info["compensate"] =  args.CheckCmdLineFlag("compensate"); // PR
         info["direction_optimized"] = args.CheckCmdLineFlag("direction-optimized");
@@ -387,6 +424,38 @@ public:
             args.GetCmdLineArgument("output_filename", output_filename);
             info["output_filename"] = output_filename;
         }
+        if (args.CheckCmdLineFlag("segment-bytes"))
+        {
+            int segment_bytes = 1 << 20;
+            args.GetCmdLineArgument("segment-bytes", segment_bytes);
+            info["segment_bytes"] = segment_bytes;
+        }
+        if (args.CheckCmdLineFlag("ppr-batch"))
+        {
+            int ppr_batch = 0;
+            args.GetCmdLineArgument("ppr-batch", ppr_batch);
+            info["ppr_batch"] = ppr_batch;
+        }
+        if (args.CheckCmdLineFlag("landmarks"))
+        {
+            int landmarks = 0;
+            args.GetCmdLineArgument("landmarks", landmarks);
+            info["landmarks"] = landmarks;
+        }
+        if (args.CheckCmdLineFlag("temporal-window"))
+        {
+            std::vector<long long> window;
+            args.GetCmdLineArguments("temporal-window", window);
+            if (window.size() == 2)
+            {
+                info["temporal"   ] = true;
+                info["temporal_t0"] = (int64_t)window[0];
+                info["temporal_t1"] = (int64_t)window[1];
+                info["temporal_durations"] =
+                    args.CheckCmdLineFlag("temporal-durations");
+            }
+            else fprintf(stderr, "--temporal-window takes <t0>,<t1>\n");
+        }
         if (args.CheckCmdLineFlag("communicate-latency"))
         {
             int communicate_latency = 0;
@@ -435,6 +504,14 @@ public:
             args.GetCmdLineArgument("do_b", do_b);
             info["do_b"] = do_b;
         }
+        if (args.CheckCmdLineFlag("do-heuristic"))
+        {
+            std::string do_heuristic = "beamer";
+            args.GetCmdLineArgument("do-heuristic", do_heuristic);
+            info["do_heuristic"] = do_heuristic;
+        }
+        if (!args.CheckCmdLineFlag("disable-autotune"))
+            ApplyTuneFile(args);
         if (args.CheckCmdLineFlag("tag"))
         {
             std::string tag = "";
@@ -496,6 +573,45 @@ public:
         ///////////////////////////////////////////////////////////////////////
     }
 
+    /**
+     * @brief Applies the tune file saved next to the dataset by a previous
+     * --autotune run. Parameters given on the command line take precedence.
+     *
+     * @param[in] args Command line arguments.
+     */
+    void ApplyTuneFile(util::CommandLineArgs &args)
+    {
+        std::string dataset_cache = info["dataset_cache"].get_str();
+        if (dataset_cache == "") return;
+        std::string tune_file = app::TuneFileName(dataset_cache,
+            info["algorithm"].get_str());
+        info["autotune_file"] = tune_file;
+
+        app::TuneConfig config;
+        if (!config.Load(tune_file)) return;
+        if (!args.CheckCmdLineFlag("traversal-mode"))
+        {
+            traversal_mode = config.traversal_mode;
+            info["traversal_mode"] = traversal_mode;
+        }
+        if (!args.CheckCmdLineFlag("do_a"))
+            info["do_a"] = config.do_a;
+        if (!args.CheckCmdLineFlag("do_b"))
+            info["do_b"] = config.do_b;
+        if (!args.CheckCmdLineFlag("alpha"))
+            info["alpha"] = config.alpha;
+        if (!args.CheckCmdLineFlag("beta"))
+            info["beta"] = config.beta;
+        if (!args.CheckCmdLineFlag("delta_factor"))
+        {
+            delta_factor = config.delta_factor;
+            info["delta_factor"] = delta_factor;
+        }
+        info["autotuned"] = true;
+        if (!args.CheckCmdLineFlag("quiet"))
+            printf("Applied tuned parameters from %s\n", tune_file.c_str());
+    }
+
     /**
      * @brief Initialization process for Info.
      *
@@ -520,13 +636,12 @@ public:
             {
                 if (csr_ref.edge_values != NULL) free(csr_ref.edge_values);
                 csr_ref.edge_values = (Value*)malloc(csr_ref.edges * sizeof(Value));
-                srand(time(NULL));
-                for (SizeT e= 0; e < csr_ref.edges; e++)
-                {
-                    csr_ref.edge_values[e] = rand() %64;
-                }
+                graphio::AssignEdgeWeights(GetEdgeWeightConfig(args),
+                    csr_ref.nodes, csr_ref.row_offsets, csr_ref.column_indices,
+                    csr_ref.edge_values, info["undirected"].get_bool());
             }
         }
+        if (info["edge_value"].get_bool()) CompactEdgeValues(args, csr_ref);
         csr_ptr = &csr_ref;  // set graph pointer
         InitBase(algorithm_name, args);
         if (info["destination_vertex"].get_int64() < 0 || info["destination_vertex"].get_int64()>=(int)csr_ref.nodes)
@@ -829,6 +944,70 @@ public:
         return 0;
     }
 
+    /**
+     * @brief Synthetic edge weight parameters from the command line:
+     * --weight-dist=<uniform|lognormal|degree>, --weight-seed, --weight-min,
+     * --weight-max and --weight-sigma.
+     *
+     * @param[in] args Command line arguments.
+     *
+     * \return The weight parameters, also recorded in info.
+     */
+    graphio::EdgeWeightConfig GetEdgeWeightConfig(util::CommandLineArgs &args)
+    {
+        graphio::EdgeWeightConfig config;
+        std::string distribution = config.DistributionName();
+        args.GetCmdLineArgument("weight-dist" , distribution     );
+        args.GetCmdLineArgument("weight-seed" , config.seed      );
+        args.GetCmdLineArgument("weight-min"  , config.min_weight);
+        args.GetCmdLineArgument("weight-max"  , config.max_weight);
+        args.GetCmdLineArgument("weight-sigma", config.sigma     );
+        if (!config.SetDistribution(distribution) ||
+            config.min_weight > config.max_weight)
+        {
+            fprintf(stderr, "Invalid edge weight distribution %s [%g, %g].\n",
+                distribution.c_str(), config.min_weight, config.max_weight);
+            exit(EXIT_FAILURE);
+        }
+        info["weight_distribution"] = std::string(config.DistributionName());
+        info["weight_seed"        ] = (int64_t)config.seed;
+        info["weight_min"         ] = config.min_weight;
+        info["weight_max"         ] = config.max_weight;
+        info["weight_sigma"       ] = config.sigma;
+        return config;
+    }
+
+    /**
+     * @brief Keeps the edge weights as narrow codes with
+     * --compact-weights[=<auto|uint8|uint16|bf16>]. auto, the default, only
+     * uses a lossless code and keeps full weights if none fits. The flag
+     * also makes LoadGraph keep a MARKET graph's cache under a cw name,
+     * with losslessly narrowed weights.
+     *
+     * @param[in] args Command line arguments.
+     * @param[in] csr_ref Graph whose weights to compact.
+     */
+    void CompactEdgeValues(
+        util::CommandLineArgs &args,
+        Csr<VertexId, SizeT, Value> &csr_ref)
+    {
+        if (!args.CheckCmdLineFlag("compact-weights")) return;
+        std::string type_name = "auto";
+        util::QuantizedValueType type = util::QUANTIZED_AUTO;
+        args.GetCmdLineArgument("compact-weights", type_name);
+        if (type_name == "") type_name = "auto";
+        if (!util::QuantizedValueCodec::ParseType(type_name, type))
+        {
+            fprintf(stderr, "Invalid weight code %s.\n", type_name.c_str());
+            exit(EXIT_FAILURE);
+        }
+        if (csr_ref.QuantizeEdgeValues(type))
+            info["weight_codec"] = std::string(csr_ref.edge_value_codec.TypeName());
+        if (!args.CheckCmdLineFlag("quiet"))
+            printf("Edge weights stored as %s.\n",
+                info["weight_codec"].get_str().c_str());
+    }
+
     /**
      * @brief Utility function to load input graph.
      *
@@ -863,15 +1042,44 @@ public:
                 fprintf(stderr, "Input graph file %s does not exist.\n",market_filename);
                 exit (EXIT_FAILURE);
             }
-            boost::filesystem::path market_filename_path(market_filename);
+            std::string market_name(market_filename);
+            market_name.resize(market_name.size() -
+                graphio::CompressedExtensionLength(market_name));
+            boost::filesystem::path market_filename_path(market_name);
             file_stem = market_filename_path.stem().string();
             info["dataset"] = file_stem;
-            if (graphio::BuildMarketGraph<EDGE_VALUE>(
+            info["dataset_path"] = std::string(market_filename);
+            // narrow weights in the cache only on request, under its own name
+            csr_ref.quantize_binary =
+                EDGE_VALUE && args.CheckCmdLineFlag("compact-weights");
+            char cache_name[256];
+            graphio::MarketBinaryFileName<EDGE_VALUE, VertexId, SizeT, Value>(
+                market_filename, info["undirected"].get_bool(), INVERSE_GRAPH,
+                cache_name, GetEdgeWeightConfig(args), csr_ref.quantize_binary);
+            info["dataset_cache"] = std::string(cache_name);
+            if (args.CheckCmdLineFlag("largest-cc"))
+            {
+                // components found while parsing, no binary cache
+                info["largest_cc"] = true;
+                if (app::cc::BuildLargestComponentGraph<EDGE_VALUE>(
+                            market_filename,
+                            csr_ref,
+                            info["undirected"].get_bool(),
+                            INVERSE_GRAPH,
+                            args.CheckCmdLineFlag("quiet"),
+                            GetEdgeWeightConfig(args)) != 0)
+                {
+                    return 1;
+                }
+            }
+            else if (graphio::BuildMarketGraph<EDGE_VALUE>(
                         market_filename,
                         csr_ref,
                         info["undirected"].get_bool(),
                         INVERSE_GRAPH,
-                        args.CheckCmdLineFlag("quiet")) != 0)
+                        args.CheckCmdLineFlag("quiet"),
+                        args.CheckCmdLineFlag("edge-maps"),
+                        GetEdgeWeightConfig(args)) != 0)
             {
                 return 1;
             }
@@ -1155,6 +1363,22 @@ public:
             exit(EXIT_FAILURE);
         }
 
+        // generators and old binary caches carry no sorted-rows guarantee
+        csr_ref.SortRows();
+        if (args.CheckCmdLineFlag("hub-degree"))
+        {
+            SizeT hub_degree = 0;
+            args.GetCmdLineArgument("hub-degree", hub_degree);
+            info["hub_degree"] = (int64_t)hub_degree;
+            csr_ref.BuildHubIndex(hub_degree);
+        }
+        if (args.CheckCmdLineFlag("edge-maps"))
+        {
+            // market inputs have them already, built or read from the cache
+            info["edge_maps"] = true;
+            if (csr_ref.reverse_edges == NULL) csr_ref.BuildEdgeMaps();
+        }
+
         if (!args.CheckCmdLineFlag("quiet"))
         {
             csr_ref.GetAverageDegree();
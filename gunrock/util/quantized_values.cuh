@@ -0,0 +1,348 @@
+// ----------------------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------------------
+
+/**
+ * @file
+ * quantized_values.cuh
+ *
+ * @brief Narrow storage for per-edge values. A value is kept as an 8- or
+ * 16-bit code, decoded as offset + scale * code, or as a bfloat16. The
+ * automatic choice is lossless: it only picks a code that reproduces every
+ * value exactly, e.g. uint8 for the integer weights in [0, 63] that the
+ * generators produce.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <limits>
+#include <omp.h>
+
+namespace gunrock {
+namespace util {
+
+// Largest power-of-two denominator FindQuantization looks for in the
+// differences of fractional values
+#define MAX_QUANTIZED_SHIFT 16
+
+enum QuantizedValueType
+{
+    QUANTIZED_NONE   = 0,  // full-width values
+    QUANTIZED_UINT8  = 1,  // offset + scale * uint8
+    QUANTIZED_UINT16 = 2,  // offset + scale * uint16
+    QUANTIZED_BF16   = 3,  // upper half of a float
+    QUANTIZED_AUTO   = 4,  // narrowest lossless code, as a request only
+};
+
+/**
+ * @brief float -> bfloat16, rounding to nearest even.
+ */
+__host__ __device__ __forceinline__ unsigned short FloatToBf16(float x)
+{
+    union { float f; unsigned int i; } bits;
+    bits.f = x;
+    if ((bits.i & 0x7f800000u) == 0x7f800000u)  // inf / nan, keep a nan a nan
+        return (unsigned short)((bits.i >> 16) | ((bits.i & 0xffffu) ? 0x40u : 0u));
+    bits.i += 0x7fffu + ((bits.i >> 16) & 1u);
+    return (unsigned short)(bits.i >> 16);
+}
+
+__host__ __device__ __forceinline__ float Bf16ToFloat(unsigned short x)
+{
+    union { float f; unsigned int i; } bits;
+    bits.i = ((unsigned int)x) << 16;
+    return bits.f;
+}
+
+/**
+ * @brief How a value array is encoded. Stored as is in binary CSR files,
+ * so the layout is fixed.
+ */
+struct QuantizedValueCodec
+{
+    unsigned int type;      // QuantizedValueType, never QUANTIZED_AUTO
+    unsigned int reserved;
+    double       scale;     // uint8 / uint16 only
+    double       offset;    // uint8 / uint16 only
+
+    __host__ __device__ QuantizedValueCodec() :
+        type    (QUANTIZED_NONE),
+        reserved(0),
+        scale   (1),
+        offset  (0)
+    {
+    }
+
+    /**
+     * @brief Bytes of one code.
+     */
+    __host__ __device__ __forceinline__ size_t Bytes() const
+    {
+        return type == QUANTIZED_UINT8 ? 1 : (type == QUANTIZED_NONE ? 0 : 2);
+    }
+
+    template <typename SizeT>
+    size_t CodeBytes(SizeT n) const
+    {
+        return Bytes() * (size_t)n;
+    }
+
+    /**
+     * @brief Value of the i-th code.
+     */
+    template <typename Value, typename SizeT>
+    __host__ __device__ __forceinline__ Value Decode(
+        const unsigned char *codes, SizeT i) const
+    {
+        if (type == QUANTIZED_UINT8)
+            return (Value)(offset + scale * codes[i]);
+        if (type == QUANTIZED_UINT16)
+            return (Value)(offset + scale * ((const unsigned short*)codes)[i]);
+        return (Value)Bf16ToFloat(((const unsigned short*)codes)[i]);
+    }
+
+    /**
+     * @brief Code of a value, clamped to the code range.
+     */
+    template <typename Value>
+    unsigned int Encode(Value value) const
+    {
+        if (type == QUANTIZED_BF16) return FloatToBf16((float)value);
+        double levels = (type == QUANTIZED_UINT8) ? 255 : 65535;
+        double code   = floor(((double)value - offset) / scale + 0.5);
+        if (code < 0     ) code = 0;
+        if (code > levels) code = levels;
+        return (unsigned int)code;
+    }
+
+    /**
+     * @brief Copies code j of from into slot i of to.
+     */
+    template <typename SizeT>
+    void CopyCode(
+        unsigned char *to, SizeT i, const unsigned char *from, SizeT j) const
+    {
+        memcpy(to + Bytes() * i, from + Bytes() * j, Bytes());
+    }
+
+    const char* TypeName() const
+    {
+        return TypeName((QuantizedValueType)type);
+    }
+
+    static const char* TypeName(QuantizedValueType type)
+    {
+        return type == QUANTIZED_UINT8  ? "uint8"  :
+              (type == QUANTIZED_UINT16 ? "uint16" :
+              (type == QUANTIZED_BF16   ? "bf16"   :
+              (type == QUANTIZED_AUTO   ? "auto"   : "none")));
+    }
+
+    /**
+     * @brief Parses a code type name: none, auto, uint8, uint16 or bf16.
+     *
+     * \return false if the name is unknown.
+     */
+    static bool ParseType(const std::string &name, QuantizedValueType &type)
+    {
+        if      (name == "none"  ) type = QUANTIZED_NONE;
+        else if (name == "auto"  ) type = QUANTIZED_AUTO;
+        else if (name == "uint8" ) type = QUANTIZED_UINT8;
+        else if (name == "uint16") type = QUANTIZED_UINT16;
+        else if (name == "bf16"  ) type = QUANTIZED_BF16;
+        else return false;
+        return true;
+    }
+};
+
+/**
+ * @brief Chooses a code for an array of values.
+ *
+ * With QUANTIZED_AUTO, only lossless codes are considered: uint8 or uint16
+ * when the differences of the values from the smallest are multiples of a
+ * common step (an integer, or a fraction with a power-of-two denominator)
+ * that fits them in the code range, otherwise bf16 when every value is a
+ * bfloat16. An explicit type is always used and may lose precision: the
+ * range of the values is spread over the code range, with an integral step
+ * for integer values.
+ *
+ * @param[in] values Values to encode.
+ * @param[in] n Number of values.
+ * @param[in] type Requested code type.
+ *
+ * \return The codec; of type QUANTIZED_NONE if no lossless code fits.
+ */
+template <typename SizeT, typename Value>
+QuantizedValueCodec FindQuantization(
+    const Value       *values,
+    SizeT              n,
+    QuantizedValueType type = QUANTIZED_AUTO)
+{
+    QuantizedValueCodec codec;
+    if (n <= 0 || type == QUANTIZED_NONE) return codec;
+
+    double min_value = (double)values[0], max_value = (double)values[0];
+    bool   integral  = true, bf16 = true, finite = true;
+    #pragma omp parallel
+    {
+        double thread_min = min_value, thread_max = max_value;
+        bool   thread_integral = true, thread_bf16 = true, thread_finite = true;
+        #pragma omp for
+        for (SizeT i = 0; i < n; i++)
+        {
+            double value = (double)values[i];
+            if (value < thread_min) thread_min = value;
+            if (value > thread_max) thread_max = value;
+            if (value != value || fabs(value) > 1e300) thread_finite = false;
+            if (value != floor(value)) thread_integral = false;
+            if (thread_bf16 && (double)Bf16ToFloat(FloatToBf16((float)value)) != value)
+                thread_bf16 = false;
+        }
+        #pragma omp critical
+        {
+            if (thread_min < min_value) min_value = thread_min;
+            if (thread_max > max_value) max_value = thread_max;
+            integral = integral && thread_integral;
+            bf16     = bf16     && thread_bf16;
+            finite   = finite   && thread_finite;
+        }
+    }
+    if (!finite) return codec;
+
+    if (type == QUANTIZED_BF16)
+    {
+        codec.type = QUANTIZED_BF16;
+        return codec;
+    }
+    if (type == QUANTIZED_UINT8 || type == QUANTIZED_UINT16)
+    {
+        double levels = (type == QUANTIZED_UINT8) ? 255 : 65535;
+        codec.type   = type;
+        codec.offset = min_value;
+        codec.scale  = (max_value - min_value) / levels;
+        if (std::numeric_limits<Value>::is_integer)
+            codec.scale = ceil(codec.scale);
+        if (codec.scale <= 0) codec.scale = 1;
+        return codec;
+    }
+
+    // QUANTIZED_AUTO: common step of the values above the smallest, taken
+    // as an integer after scaling by the smallest power of two that makes
+    // every difference integral (1 for integer values)
+    int shift = 0;
+    if (!integral)
+    {
+        #pragma omp parallel
+        {
+            int thread_shift = 0;
+            #pragma omp for
+            for (SizeT i = 0; i < n; i++)
+            {
+                double diff = ((double)values[i] - min_value) * ldexp(1.0, thread_shift);
+                while (diff != floor(diff) && thread_shift <= MAX_QUANTIZED_SHIFT)
+                {
+                    thread_shift ++;
+                    diff *= 2;
+                }
+            }
+            #pragma omp critical
+            if (thread_shift > shift) shift = thread_shift;
+        }
+    }
+    double unit = ldexp(1.0, shift);
+    if (shift <= MAX_QUANTIZED_SHIFT &&
+        (max_value - min_value) * unit < 9007199254740992.0)  // 2^53
+    {
+        unsigned long long step = 0;
+        #pragma omp parallel
+        {
+            unsigned long long thread_step = 0;
+            #pragma omp for
+            for (SizeT i = 0; i < n; i++)
+            {
+                unsigned long long a = (unsigned long long)
+                    (((double)values[i] - min_value) * unit);
+                unsigned long long b = thread_step;
+                while (b != 0) { unsigned long long t = a % b; a = b; b = t; }
+                thread_step = a;
+            }
+            #pragma omp critical
+            {
+                unsigned long long a = step, b = thread_step;
+                while (b != 0) { unsigned long long t = a % b; a = b; b = t; }
+                step = a;
+            }
+        }
+        if (step == 0) step = 1;
+        double range = (max_value - min_value) * unit / (double)step;
+        if (range <= 65535)
+        {
+            codec.type   = (range <= 255) ? QUANTIZED_UINT8 : QUANTIZED_UINT16;
+            codec.scale  = (double)step / unit;
+            codec.offset = min_value;
+            return codec;
+        }
+    }
+    if (bf16 && !std::numeric_limits<Value>::is_integer)
+        codec.type = QUANTIZED_BF16;
+    return codec;
+}
+
+/**
+ * @brief Encodes values, in parallel.
+ *
+ * @param[in] codec Codec from FindQuantization.
+ * @param[in] values Values to encode.
+ * @param[in] n Number of values.
+ * @param[out] codes codec.CodeBytes(n) bytes.
+ */
+template <typename SizeT, typename Value>
+void Quantize(
+    const QuantizedValueCodec &codec,
+    const Value               *values,
+    SizeT                      n,
+    unsigned char             *codes)
+{
+    if (codec.type == QUANTIZED_UINT8)
+    {
+        #pragma omp parallel for
+        for (SizeT i = 0; i < n; i++)
+            codes[i] = (unsigned char)codec.Encode(values[i]);
+    } else {
+        unsigned short *wide_codes = (unsigned short*)codes;
+        #pragma omp parallel for
+        for (SizeT i = 0; i < n; i++)
+            wide_codes[i] = (unsigned short)codec.Encode(values[i]);
+    }
+}
+
+/**
+ * @brief Decodes values, in parallel.
+ */
+template <typename SizeT, typename Value>
+void Dequantize(
+    const QuantizedValueCodec &codec,
+    const unsigned char       *codes,
+    SizeT                      n,
+    Value                     *values)
+{
+    #pragma omp parallel for
+    for (SizeT i = 0; i < n; i++)
+        values[i] = codec.template Decode<Value>(codes, i);
+}
+
+} // namespace util
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
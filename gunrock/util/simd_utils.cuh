@@ -0,0 +1,756 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * simd_utils.cuh
+ *
+ * @brief Host SIMD kernels over neighbor lists (AVX2 / AVX-512 with a
+ * scalar fallback, chosen at runtime), a row gather for dense
+ * per-vertex blocks of values (SpMM), and landmark distance bounds
+ */
+
+#pragma once
+
+#include <limits>
+
+// x86 host code built by a compiler that allows intrinsics inside
+// functions with a target attribute (gcc >= 4.9, clang)
+#if !defined(__CUDA_ARCH__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define GUNROCK_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace gunrock {
+namespace util {
+namespace simd {
+
+enum SimdLevel {
+    SIMD_SCALAR = 0,
+    SIMD_AVX2   = 1,
+    SIMD_AVX512 = 2,
+};
+
+enum GatherCompare {
+    GATHER_EQUAL   = 0, // labels[v] == value
+    GATHER_GREATER = 1, // labels[v] >  value
+};
+
+inline const char* SimdLevelName(SimdLevel level)
+{
+    return level == SIMD_AVX512 ? "avx512" :
+           level == SIMD_AVX2   ? "avx2"   : "scalar";
+}
+
+/**
+ * @brief Widest instruction set the CPU supports.
+ */
+inline SimdLevel DetectSimdLevel()
+{
+#ifdef GUNROCK_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2"   )) return SIMD_AVX2;
+#endif
+    return SIMD_SCALAR;
+}
+
+/**
+ * @brief Level the kernels dispatch to, detected on first use.
+ */
+inline SimdLevel &ActiveSimdLevel()
+{
+    static SimdLevel level = DetectSimdLevel();
+    return level;
+}
+
+/**
+ * @brief Caps the dispatch level, e.g. to time the scalar kernels;
+ * levels above what the CPU supports are ignored.
+ *
+ * \return The level now active.
+ */
+inline SimdLevel SetSimdLevel(SimdLevel level)
+{
+    SimdLevel detected = DetectSimdLevel();
+    ActiveSimdLevel() = (level > detected) ? detected : level;
+    return ActiveSimdLevel();
+}
+
+/******************************************************************************
+ * Scalar kernels
+ ******************************************************************************/
+
+template <typename VertexId, typename SizeT>
+SizeT GatherFindScalar(
+    const VertexId *indices, SizeT start, SizeT n,
+    const VertexId *labels, VertexId value, GatherCompare compare)
+{
+    for (SizeT i = start; i < n; i++)
+    {
+        VertexId label = labels[indices[i]];
+        if (compare == GATHER_EQUAL ? label == value : label > value)
+            return i;
+    }
+    return n;
+}
+
+template <typename VertexId, typename SizeT>
+SizeT GatherCountScalar(
+    const VertexId *indices, SizeT n,
+    const VertexId *labels, VertexId value, GatherCompare compare)
+{
+    SizeT count = 0;
+    for (SizeT i = 0; i < n; i++)
+    {
+        VertexId label = labels[indices[i]];
+        if (compare == GATHER_EQUAL ? label == value : label > value)
+            count ++;
+    }
+    return count;
+}
+
+template <typename VertexId, typename SizeT>
+VertexId GatherMinScalar(
+    const VertexId *indices, SizeT n,
+    const VertexId *values, VertexId init, VertexId exclude)
+{
+    VertexId result = init;
+    for (SizeT i = 0; i < n; i++)
+    {
+        VertexId value = values[indices[i]];
+        if (value != exclude && value < result) result = value;
+    }
+    return result;
+}
+
+template <typename VertexId, typename SizeT>
+SizeT IntersectCountScalar(
+    const VertexId *a, SizeT a_size,
+    const VertexId *b, SizeT b_size)
+{
+    SizeT i = 0, j = 0, count = 0;
+    while (i < a_size && j < b_size)
+    {
+        if      (a[i] < b[j]) i++;
+        else if (b[j] < a[i]) j++;
+        else { count ++; i++; j++; }
+    }
+    return count;
+}
+
+template <typename VertexId, typename SizeT>
+SizeT TestAndSetScalar(
+    const VertexId *indices, SizeT start, SizeT n,
+    unsigned int *bitmap, VertexId *output, SizeT count)
+{
+    for (SizeT i = start; i < n; i++)
+    {
+        VertexId     v    = indices[i];
+        unsigned int mask = 1u << (v & 31);
+        if (bitmap[v >> 5] & mask) continue;
+        bitmap[v >> 5] |= mask;
+        output[count++] = v;
+    }
+    return count;
+}
+
+template <typename VertexId, typename SizeT, typename T>
+void GatherAddRowsScalar(
+    const VertexId *indices, SizeT n,
+    const T *rows, SizeT width, T *sum)
+{
+    for (SizeT i = 0; i < n; i++)
+    {
+        const T *row = rows + (size_t)indices[i] * width;
+        for (SizeT j = 0; j < width; j++)
+            sum[j] += row[j];
+    }
+}
+
+template <typename T, typename SizeT>
+void LandmarkBoundsScalar(
+    const T *u_to, const T *u_from, const T *v_to, const T *v_from,
+    SizeT start, SizeT n, T &lower, T &upper)
+{
+    const T unreached = std::numeric_limits<T>::max();
+    for (SizeT i = start; i < n; i++)
+    {
+        unsigned long long sum = (unsigned long long)u_to[i] + v_from[i];
+        T through = sum > unreached ? unreached : (T)sum;
+        T ahead   = v_from[i] > u_from[i] ? v_from[i] - u_from[i] : 0;
+        T behind  = u_to  [i] > v_to  [i] ? u_to  [i] - v_to  [i] : 0;
+        if (through < upper) upper = through;
+        if (ahead   > lower) lower = ahead;
+        if (behind  > lower) lower = behind;
+    }
+}
+
+#ifdef GUNROCK_SIMD_X86
+
+/******************************************************************************
+ * AVX2 kernels, 32-bit signed vertex ids
+ ******************************************************************************/
+
+__attribute__((target("avx2")))
+inline __m256i CompareAvx2(__m256i labels, __m256i value, GatherCompare compare)
+{
+    return compare == GATHER_EQUAL ?
+        _mm256_cmpeq_epi32(labels, value) : _mm256_cmpgt_epi32(labels, value);
+}
+
+template <typename SizeT>
+__attribute__((target("avx2")))
+SizeT GatherFindAvx2(
+    const int *indices, SizeT start, SizeT n,
+    const int *labels, int value, GatherCompare compare)
+{
+    __m256i values = _mm256_set1_epi32(value);
+    SizeT i = start;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i ids  = _mm256_loadu_si256((const __m256i*)(indices + i));
+        __m256i vals = _mm256_i32gather_epi32(labels, ids, 4);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(
+            CompareAvx2(vals, values, compare)));
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    return GatherFindScalar(indices, i, n, labels, value, compare);
+}
+
+template <typename SizeT>
+__attribute__((target("avx2,popcnt")))
+SizeT GatherCountAvx2(
+    const int *indices, SizeT n,
+    const int *labels, int value, GatherCompare compare)
+{
+    __m256i values = _mm256_set1_epi32(value);
+    SizeT i = 0, count = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i ids  = _mm256_loadu_si256((const __m256i*)(indices + i));
+        __m256i vals = _mm256_i32gather_epi32(labels, ids, 4);
+        count += _mm_popcnt_u32(_mm256_movemask_ps(_mm256_castsi256_ps(
+            CompareAvx2(vals, values, compare))));
+    }
+    return count + GatherCountScalar(indices + i, n - i, labels, value, compare);
+}
+
+template <typename SizeT>
+__attribute__((target("avx2")))
+int GatherMinAvx2(
+    const int *indices, SizeT n,
+    const int *values, int init, int exclude)
+{
+    __m256i result   = _mm256_set1_epi32(init);
+    __m256i excludes = _mm256_set1_epi32(exclude);
+    SizeT i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i ids  = _mm256_loadu_si256((const __m256i*)(indices + i));
+        __m256i vals = _mm256_i32gather_epi32(values, ids, 4);
+        // excluded lanes keep the running minimum
+        vals   = _mm256_blendv_epi8(vals, result,
+            _mm256_cmpeq_epi32(vals, excludes));
+        result = _mm256_min_epi32(result, vals);
+    }
+    __m128i low = _mm_min_epi32(_mm256_castsi256_si128(result),
+        _mm256_extracti128_si256(result, 1));
+    low = _mm_min_epi32(low, _mm_shuffle_epi32(low, _MM_SHUFFLE(1, 0, 3, 2)));
+    low = _mm_min_epi32(low, _mm_shuffle_epi32(low, _MM_SHUFFLE(2, 3, 0, 1)));
+    return GatherMinScalar(indices + i, n - i, values,
+        _mm_cvtsi128_si32(low), exclude);
+}
+
+/**
+ * Compares a block of 8 from each list against all 8 rotations of the
+ * other, then advances the block(s) with the smaller last element.
+ */
+template <typename SizeT>
+__attribute__((target("avx2,popcnt")))
+SizeT IntersectCountAvx2(
+    const int *a, SizeT a_size,
+    const int *b, SizeT b_size)
+{
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    SizeT i = 0, j = 0, count = 0;
+    while (i + 8 <= a_size && j + 8 <= b_size)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+        __m256i match = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; r++)
+        {
+            vb    = _mm256_permutevar8x32_epi32(vb, rotate);
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+        }
+        count += _mm_popcnt_u32(_mm256_movemask_ps(_mm256_castsi256_ps(match)));
+        int a_last = a[i + 7], b_last = b[j + 7];
+        if (a_last <= b_last) i += 8;
+        if (b_last <= a_last) j += 8;
+    }
+    return count + IntersectCountScalar(a + i, a_size - i, b + j, b_size - j);
+}
+
+template <typename SizeT>
+__attribute__((target("avx2")))
+SizeT TestAndSetAvx2(
+    const int *indices, SizeT n,
+    unsigned int *bitmap, int *output)
+{
+    const __m256i ones = _mm256_set1_epi32(1);
+    const __m256i low5 = _mm256_set1_epi32(31);
+    SizeT i = 0, count = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i ids   = _mm256_loadu_si256((const __m256i*)(indices + i));
+        __m256i words = _mm256_i32gather_epi32((const int*)bitmap,
+            _mm256_srli_epi32(ids, 5), 4);
+        __m256i bits  = _mm256_sllv_epi32(ones, _mm256_and_si256(ids, low5));
+        int unset = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(
+            _mm256_and_si256(words, bits), _mm256_setzero_si256())));
+        // set the candidates one by one, duplicates within the block are
+        // caught by the scalar re-test
+        while (unset != 0)
+        {
+            int lane = __builtin_ctz(unset);
+            unset &= unset - 1;
+            int          v    = indices[i + lane];
+            unsigned int mask = 1u << (v & 31);
+            if (bitmap[v >> 5] & mask) continue;
+            bitmap[v >> 5] |= mask;
+            output[count++] = v;
+        }
+    }
+    return TestAndSetScalar(indices, i, n, bitmap, output, count);
+}
+
+/**
+ * @brief Row gather, width a multiple of 8; each 32-wide slice of sum is
+ * kept in registers over the whole list.
+ */
+template <typename VertexId, typename SizeT>
+__attribute__((target("avx2")))
+void GatherAddRowsAvx2(
+    const VertexId *indices, SizeT n,
+    const float *rows, SizeT width, float *sum)
+{
+    SizeT j = 0;
+    for (; j + 32 <= width; j += 32)
+    {
+        __m256 sum0 = _mm256_loadu_ps(sum + j     );
+        __m256 sum1 = _mm256_loadu_ps(sum + j +  8);
+        __m256 sum2 = _mm256_loadu_ps(sum + j + 16);
+        __m256 sum3 = _mm256_loadu_ps(sum + j + 24);
+        for (SizeT i = 0; i < n; i++)
+        {
+            const float *row = rows + (size_t)indices[i] * width + j;
+            sum0 = _mm256_add_ps(sum0, _mm256_loadu_ps(row     ));
+            sum1 = _mm256_add_ps(sum1, _mm256_loadu_ps(row +  8));
+            sum2 = _mm256_add_ps(sum2, _mm256_loadu_ps(row + 16));
+            sum3 = _mm256_add_ps(sum3, _mm256_loadu_ps(row + 24));
+        }
+        _mm256_storeu_ps(sum + j     , sum0);
+        _mm256_storeu_ps(sum + j +  8, sum1);
+        _mm256_storeu_ps(sum + j + 16, sum2);
+        _mm256_storeu_ps(sum + j + 24, sum3);
+    }
+    for (; j < width; j += 8)
+    {
+        __m256 sum0 = _mm256_loadu_ps(sum + j);
+        for (SizeT i = 0; i < n; i++)
+            sum0 = _mm256_add_ps(sum0,
+                _mm256_loadu_ps(rows + (size_t)indices[i] * width + j));
+        _mm256_storeu_ps(sum + j, sum0);
+    }
+}
+
+/**
+ * @brief Horizontal minimum, or maximum, of unsigned 8-bit lanes.
+ */
+__attribute__((target("avx2")))
+inline unsigned char ReduceEpu8(__m256i x, bool maximum)
+{
+    __m128i a = _mm256_castsi256_si128(x), b = _mm256_extracti128_si256(x, 1);
+    __m128i r = maximum ? _mm_max_epu8(a, b) : _mm_min_epu8(a, b);
+    // fold the halves down to one byte; unsigned bytes widen exactly
+    __m128i lo = _mm_unpacklo_epi8(r, _mm_setzero_si128());
+    __m128i hi = _mm_unpackhi_epi8(r, _mm_setzero_si128());
+    r = maximum ? _mm_max_epu16(lo, hi) : _mm_min_epu16(lo, hi);
+    if (maximum)  // minpos finds the minimum, so search the complement
+        return 0xff - (unsigned char)_mm_cvtsi128_si32(_mm_minpos_epu16(
+            _mm_sub_epi16(_mm_set1_epi16(0xff), r)));
+    return (unsigned char)_mm_cvtsi128_si32(_mm_minpos_epu16(r));
+}
+
+/**
+ * @brief Horizontal minimum, or maximum, of unsigned 16-bit lanes.
+ */
+__attribute__((target("avx2")))
+inline unsigned short ReduceEpu16(__m256i x, bool maximum)
+{
+    __m128i a = _mm256_castsi256_si128(x), b = _mm256_extracti128_si256(x, 1);
+    __m128i r = maximum ? _mm_max_epu16(a, b) : _mm_min_epu16(a, b);
+    if (maximum)
+        return 0xffff - (unsigned short)_mm_cvtsi128_si32(_mm_minpos_epu16(
+            _mm_xor_si128(r, _mm_set1_epi16(-1))));
+    return (unsigned short)_mm_cvtsi128_si32(_mm_minpos_epu16(r));
+}
+
+/**
+ * @brief Landmark bounds over 8-bit distances, 32 landmarks a step;
+ * adds and subtracts saturate, so unreached (255) needs no masking.
+ */
+template <typename SizeT>
+__attribute__((target("avx2")))
+void LandmarkBoundsAvx2(
+    const unsigned char *u_to, const unsigned char *u_from,
+    const unsigned char *v_to, const unsigned char *v_from,
+    SizeT n, unsigned char &lower, unsigned char &upper)
+{
+    __m256i lows = _mm256_set1_epi8((char)lower);
+    __m256i ups  = _mm256_set1_epi8((char)upper);
+    SizeT i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i ut = _mm256_loadu_si256((const __m256i*)(u_to   + i));
+        __m256i uf = _mm256_loadu_si256((const __m256i*)(u_from + i));
+        __m256i vt = _mm256_loadu_si256((const __m256i*)(v_to   + i));
+        __m256i vf = _mm256_loadu_si256((const __m256i*)(v_from + i));
+        ups  = _mm256_min_epu8(ups , _mm256_adds_epu8(ut, vf));
+        lows = _mm256_max_epu8(lows, _mm256_max_epu8(
+            _mm256_subs_epu8(vf, uf), _mm256_subs_epu8(ut, vt)));
+    }
+    lower = ReduceEpu8(lows, true );
+    upper = ReduceEpu8(ups , false);
+    LandmarkBoundsScalar(u_to, u_from, v_to, v_from, i, n, lower, upper);
+}
+
+/**
+ * @brief Landmark bounds over 16-bit distances, 16 landmarks a step.
+ */
+template <typename SizeT>
+__attribute__((target("avx2")))
+void LandmarkBoundsAvx2(
+    const unsigned short *u_to, const unsigned short *u_from,
+    const unsigned short *v_to, const unsigned short *v_from,
+    SizeT n, unsigned short &lower, unsigned short &upper)
+{
+    __m256i lows = _mm256_set1_epi16((short)lower);
+    __m256i ups  = _mm256_set1_epi16((short)upper);
+    SizeT i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i ut = _mm256_loadu_si256((const __m256i*)(u_to   + i));
+        __m256i uf = _mm256_loadu_si256((const __m256i*)(u_from + i));
+        __m256i vt = _mm256_loadu_si256((const __m256i*)(v_to   + i));
+        __m256i vf = _mm256_loadu_si256((const __m256i*)(v_from + i));
+        ups  = _mm256_min_epu16(ups , _mm256_adds_epu16(ut, vf));
+        lows = _mm256_max_epu16(lows, _mm256_max_epu16(
+            _mm256_subs_epu16(vf, uf), _mm256_subs_epu16(ut, vt)));
+    }
+    lower = ReduceEpu16(lows, true );
+    upper = ReduceEpu16(ups , false);
+    LandmarkBoundsScalar(u_to, u_from, v_to, v_from, i, n, lower, upper);
+}
+
+/******************************************************************************
+ * AVX-512 kernels, 32-bit signed vertex ids
+ ******************************************************************************/
+
+__attribute__((target("avx512f")))
+inline __mmask16 CompareAvx512(
+    __mmask16 active, __m512i labels, __m512i value, GatherCompare compare)
+{
+    return compare == GATHER_EQUAL ?
+        _mm512_mask_cmpeq_epi32_mask(active, labels, value) :
+        _mm512_mask_cmpgt_epi32_mask(active, labels, value);
+}
+
+template <typename SizeT>
+__attribute__((target("avx512f")))
+SizeT GatherFindAvx512(
+    const int *indices, SizeT start, SizeT n,
+    const int *labels, int value, GatherCompare compare)
+{
+    __m512i values = _mm512_set1_epi32(value);
+    for (SizeT i = start; i < n; i += 16)
+    {
+        __mmask16 active = (n - i >= 16) ? (__mmask16)0xFFFF :
+            (__mmask16)((1u << (n - i)) - 1);
+        __m512i ids  = _mm512_maskz_loadu_epi32(active, indices + i);
+        __m512i vals = _mm512_mask_i32gather_epi32(
+            _mm512_setzero_si512(), active, ids, labels, 4);
+        unsigned int mask = CompareAvx512(active, vals, values, compare);
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    return n;
+}
+
+template <typename SizeT>
+__attribute__((target("avx512f,popcnt")))
+SizeT GatherCountAvx512(
+    const int *indices, SizeT n,
+    const int *labels, int value, GatherCompare compare)
+{
+    __m512i values = _mm512_set1_epi32(value);
+    SizeT count = 0;
+    for (SizeT i = 0; i < n; i += 16)
+    {
+        __mmask16 active = (n - i >= 16) ? (__mmask16)0xFFFF :
+            (__mmask16)((1u << (n - i)) - 1);
+        __m512i ids  = _mm512_maskz_loadu_epi32(active, indices + i);
+        __m512i vals = _mm512_mask_i32gather_epi32(
+            _mm512_setzero_si512(), active, ids, labels, 4);
+        count += _mm_popcnt_u32(CompareAvx512(active, vals, values, compare));
+    }
+    return count;
+}
+
+template <typename SizeT>
+__attribute__((target("avx512f")))
+int GatherMinAvx512(
+    const int *indices, SizeT n,
+    const int *values, int init, int exclude)
+{
+    __m512i result   = _mm512_set1_epi32(init);
+    __m512i excludes = _mm512_set1_epi32(exclude);
+    for (SizeT i = 0; i < n; i += 16)
+    {
+        __mmask16 active = (n - i >= 16) ? (__mmask16)0xFFFF :
+            (__mmask16)((1u << (n - i)) - 1);
+        __m512i ids  = _mm512_maskz_loadu_epi32(active, indices + i);
+        __m512i vals = _mm512_mask_i32gather_epi32(
+            result, active, ids, values, 4);
+        __mmask16 keep = _mm512_mask_cmpneq_epi32_mask(active, vals, excludes);
+        result = _mm512_mask_min_epi32(result, keep, result, vals);
+    }
+    return _mm512_reduce_min_epi32(result);
+}
+
+/**
+ * @brief Row gather, width a multiple of 16; each 64-wide slice of sum is
+ * kept in registers over the whole list.
+ */
+template <typename VertexId, typename SizeT>
+__attribute__((target("avx512f")))
+void GatherAddRowsAvx512(
+    const VertexId *indices, SizeT n,
+    const float *rows, SizeT width, float *sum)
+{
+    SizeT j = 0;
+    for (; j + 64 <= width; j += 64)
+    {
+        __m512 sum0 = _mm512_loadu_ps(sum + j     );
+        __m512 sum1 = _mm512_loadu_ps(sum + j + 16);
+        __m512 sum2 = _mm512_loadu_ps(sum + j + 32);
+        __m512 sum3 = _mm512_loadu_ps(sum + j + 48);
+        for (SizeT i = 0; i < n; i++)
+        {
+            const float *row = rows + (size_t)indices[i] * width + j;
+            sum0 = _mm512_add_ps(sum0, _mm512_loadu_ps(row     ));
+            sum1 = _mm512_add_ps(sum1, _mm512_loadu_ps(row + 16));
+            sum2 = _mm512_add_ps(sum2, _mm512_loadu_ps(row + 32));
+            sum3 = _mm512_add_ps(sum3, _mm512_loadu_ps(row + 48));
+        }
+        _mm512_storeu_ps(sum + j     , sum0);
+        _mm512_storeu_ps(sum + j + 16, sum1);
+        _mm512_storeu_ps(sum + j + 32, sum2);
+        _mm512_storeu_ps(sum + j + 48, sum3);
+    }
+    for (; j < width; j += 16)
+    {
+        __m512 sum0 = _mm512_loadu_ps(sum + j);
+        for (SizeT i = 0; i < n; i++)
+            sum0 = _mm512_add_ps(sum0,
+                _mm512_loadu_ps(rows + (size_t)indices[i] * width + j));
+        _mm512_storeu_ps(sum + j, sum0);
+    }
+}
+
+#endif // GUNROCK_SIMD_X86
+
+/******************************************************************************
+ * Dispatch; the SIMD paths take 32-bit signed ids, other types run scalar
+ ******************************************************************************/
+
+template <typename VertexId>
+inline bool UseSimd(SimdLevel level)
+{
+    return sizeof(VertexId) == 4 &&
+        std::numeric_limits<VertexId>::is_signed &&
+        ActiveSimdLevel() >= level;
+}
+
+/**
+ * @brief First i in [start, n) with labels[indices[i]] compared to value
+ * true, or n; e.g. the first in-neighbor at the current BFS depth.
+ */
+template <typename VertexId, typename SizeT>
+SizeT GatherFind(
+    const VertexId *indices, SizeT start, SizeT n,
+    const VertexId *labels, VertexId value, GatherCompare compare)
+{
+#ifdef GUNROCK_SIMD_X86
+    if (UseSimd<VertexId>(SIMD_AVX512))
+        return GatherFindAvx512((const int*)indices, start, n,
+            (const int*)labels, (int)value, compare);
+    if (UseSimd<VertexId>(SIMD_AVX2))
+        return GatherFindAvx2((const int*)indices, start, n,
+            (const int*)labels, (int)value, compare);
+#endif
+    return GatherFindScalar(indices, start, n, labels, value, compare);
+}
+
+/**
+ * @brief Number of i in [0, n) with labels[indices[i]] compared to value
+ * true.
+ */
+template <typename VertexId, typename SizeT>
+SizeT GatherCount(
+    const VertexId *indices, SizeT n,
+    const VertexId *labels, VertexId value, GatherCompare compare)
+{
+#ifdef GUNROCK_SIMD_X86
+    if (UseSimd<VertexId>(SIMD_AVX512))
+        return GatherCountAvx512((const int*)indices, n,
+            (const int*)labels, (int)value, compare);
+    if (UseSimd<VertexId>(SIMD_AVX2))
+        return GatherCountAvx2((const int*)indices, n,
+            (const int*)labels, (int)value, compare);
+#endif
+    return GatherCountScalar(indices, n, labels, value, compare);
+}
+
+/**
+ * @brief Minimum of init and values[indices[i]] over i in [0, n),
+ * skipping the entries equal to exclude (e.g. an invalid label).
+ */
+template <typename VertexId, typename SizeT>
+VertexId GatherMin(
+    const VertexId *indices, SizeT n,
+    const VertexId *values, VertexId init, VertexId exclude)
+{
+#ifdef GUNROCK_SIMD_X86
+    if (UseSimd<VertexId>(SIMD_AVX512))
+        return GatherMinAvx512((const int*)indices, n,
+            (const int*)values, (int)init, (int)exclude);
+    if (UseSimd<VertexId>(SIMD_AVX2))
+        return GatherMinAvx2((const int*)indices, n,
+            (const int*)values, (int)init, (int)exclude);
+#endif
+    return GatherMinScalar(indices, n, values, init, exclude);
+}
+
+/**
+ * @brief Size of the intersection of two sorted, duplicate-free lists.
+ */
+template <typename VertexId, typename SizeT>
+SizeT IntersectCount(
+    const VertexId *a, SizeT a_size,
+    const VertexId *b, SizeT b_size)
+{
+#ifdef GUNROCK_SIMD_X86
+    if (UseSimd<VertexId>(SIMD_AVX2))
+        return IntersectCountAvx2((const int*)a, a_size,
+            (const int*)b, b_size);
+#endif
+    return IntersectCountScalar(a, a_size, b, b_size);
+}
+
+/**
+ * @brief Sets the bitmap bit of every listed vertex and appends the ones
+ * whose bit was clear to output, in list order. Not thread-safe.
+ *
+ * \return Number of vertices appended.
+ */
+template <typename VertexId, typename SizeT>
+SizeT TestAndSet(
+    const VertexId *indices, SizeT n,
+    unsigned int *bitmap, VertexId *output)
+{
+#ifdef GUNROCK_SIMD_X86
+    if (UseSimd<VertexId>(SIMD_AVX2))
+        return TestAndSetAvx2((const int*)indices, n, bitmap, (int*)output);
+#endif
+    return TestAndSetScalar(indices, (SizeT)0, n, bitmap, output, (SizeT)0);
+}
+
+/**
+ * @brief Adds the listed rows of a row-major block to sum:
+ * sum[j] += rows[indices[i] * width + j] for i in [0, n), j in [0, width).
+ * Float rows take the SIMD paths when width is a multiple of 8 (AVX2) or
+ * 16 (AVX-512); every lane adds in list order, so all levels agree.
+ */
+template <typename VertexId, typename SizeT, typename T>
+void GatherAddRows(
+    const VertexId *indices, SizeT n,
+    const T *rows, SizeT width, T *sum)
+{
+#ifdef GUNROCK_SIMD_X86
+    if (sizeof(T) == sizeof(float) && !std::numeric_limits<T>::is_integer)
+    {
+        if (ActiveSimdLevel() >= SIMD_AVX512 && width % 16 == 0)
+        {
+            GatherAddRowsAvx512(indices, n, (const float*)rows, width, (float*)sum);
+            return;
+        }
+        if (ActiveSimdLevel() >= SIMD_AVX2 && width % 8 == 0)
+        {
+            GatherAddRowsAvx2(indices, n, (const float*)rows, width, (float*)sum);
+            return;
+        }
+    }
+#endif
+    GatherAddRowsScalar(indices, n, rows, width, sum);
+}
+
+/**
+ * @brief Distance bounds between u and v from their distances to and from
+ * n landmarks, the largest value of T meaning unreached:
+ * upper = min over i of u_to[i] + v_from[i], saturated, and
+ * lower = max over i of v_from[i] - u_from[i] and u_to[i] - v_to[i],
+ * each clamped at 0. 8 and 16-bit distances take the AVX2 path, also at
+ * the AVX-512 level, as AVX-512F has no byte or word arithmetic.
+ */
+template <typename T, typename SizeT>
+void LandmarkBounds(
+    const T *u_to, const T *u_from, const T *v_to, const T *v_from,
+    SizeT n, T &lower, T &upper)
+{
+    lower = 0;
+    upper = std::numeric_limits<T>::max();
+#ifdef GUNROCK_SIMD_X86
+    if (ActiveSimdLevel() >= SIMD_AVX2 && sizeof(T) == 1)
+    {
+        LandmarkBoundsAvx2((const unsigned char*)u_to, (const unsigned char*)u_from,
+            (const unsigned char*)v_to, (const unsigned char*)v_from, n,
+            (unsigned char&)lower, (unsigned char&)upper);
+        return;
+    }
+    if (ActiveSimdLevel() >= SIMD_AVX2 && sizeof(T) == 2)
+    {
+        LandmarkBoundsAvx2((const unsigned short*)u_to, (const unsigned short*)u_from,
+            (const unsigned short*)v_to, (const unsigned short*)v_from, n,
+            (unsigned short&)lower, (unsigned short&)upper);
+        return;
+    }
+#endif
+    LandmarkBoundsScalar(u_to, u_from, v_to, v_from, (SizeT)0, n, lower, upper);
+}
+
+} // namespace simd
+} // namespace util
+} // namespace gunrock
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
 #include <omp.h>
 
 namespace gunrock {
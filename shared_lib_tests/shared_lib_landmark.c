@@ -0,0 +1,41 @@
+/**
+ * @brief Landmark distance sketch test for shared library interface
+ * @file shared_lib_landmark.c
+ */
+
+#include <stdio.h>
+#include <gunrock/gunrock.h>
+
+int main(int argc, char* argv[])
+{
+    ////////////////////////////////////////////////////////////////////////////
+    int num_nodes = 7, num_edges = 15;  // number of nodes and edges
+    int row_offsets[8]  = {0, 3, 6, 9, 11, 14, 15, 15};
+    int col_indices[15] = {1, 2, 3, 0, 2, 4, 3, 4, 5, 5, 6, 2, 5, 6, 6};
+    unsigned int edge_values[15] = {39, 6, 41, 51, 63, 17, 10, 44, 41, 13, 58, 43, 50, 59, 35};
+
+    struct GRLandmarkSketch *sketch = landmark_sketch(num_nodes, num_edges,
+        row_offsets, col_indices, edge_values, false, 2, landmark_coverage);
+    if (sketch == NULL) return 1;
+
+    ////////////////////////////////////////////////////////////////////////////
+    int sources[7], targets[7];
+    unsigned int lower[7], upper[7];
+    int node; for (node = 0; node < num_nodes; ++node)
+    {
+        sources[node] = 0;
+        targets[node] = node;
+    }
+    landmark_bounds(sketch, num_nodes, sources, targets, lower, upper);
+    for (node = 0; node < num_nodes; ++node)
+    {
+        printf("Node_ID [%d] : Distance ", node);
+        if (lower[node] == GR_LANDMARK_INFINITY) printf("[unreachable]\n");
+        else if (upper[node] == GR_LANDMARK_INFINITY)
+            printf("[>= %u]\n", lower[node]);
+        else printf("[%u, %u]\n", lower[node], upper[node]);
+    }
+
+    landmark_sketch_free(sketch);
+    return 0;
+}
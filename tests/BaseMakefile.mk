@@ -11,6 +11,9 @@
 
 force64 = 1
 use_metis = 1
+use_zlib = 1
+use_bzip2 = 1
+use_zstd = 0
 NVCC = "$(shell which nvcc)"
 NVCC_VERSION = $(strip $(shell nvcc --version | grep release | sed 's/.*release //' |  sed 's/,.*//'))
 
@@ -51,8 +54,18 @@ ifneq ($(use_metis), 1)
 else
 	METIS_DEPS = -Xlinker -lmetis -Xcompiler -DMETIS_FOUND
 endif
+COMPRESSION_DEPS =
+ifeq ($(use_zlib), 1)
+	COMPRESSION_DEPS += -Xlinker -lz -Xcompiler -DZLIB_FOUND
+endif
+ifeq ($(use_bzip2), 1)
+	COMPRESSION_DEPS += -Xlinker -lbz2 -Xcompiler -DBZIP2_FOUND
+endif
+ifeq ($(use_zstd), 1)
+	COMPRESSION_DEPS += -Xlinker -lzstd -Xcompiler -DZSTD_FOUND
+endif
 GUNROCK_DEF = -Xcompiler -DGUNROCKVERSION=0.4.0
-INC = -I$(CUDA_INC) -I$(MGPU_INC) -I$(CUB_INC) $(BOOST_DEPS) $(OMP_DEPS) $(METIS_DEPS) $(GUNROCK_DEF) -I.. -I../..
+INC = -I$(CUDA_INC) -I$(MGPU_INC) -I$(CUB_INC) $(BOOST_DEPS) $(OMP_DEPS) $(METIS_DEPS) $(COMPRESSION_DEPS) $(GUNROCK_DEF) -I.. -I../..
 
 #-------------------------------------------------------------------------------
 # Defines
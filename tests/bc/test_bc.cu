@@ -104,6 +104,8 @@ void Usage()
         "[--partition_method=<random|biasrandom|clustered|metis>]\n"
         "                          Choose partitioner (Default use random).\n"
         "[--ref-file=<file_name>]  Use pre-computed result in file to verify.\n"
+        "[--largest-cc]            Load only the largest connected component of\n"
+        "                          a market graph, found while parsing.\n"
         "[--quiet]                 No output (unless --json is specified).\n"
         "[--json]                  Output JSON-format statistics to STDOUT.\n"
         "[--jsonfile=<name>]       Output JSON-format statistics to file <name>\n"
@@ -22,12 +22,20 @@
 
 // Utilities and correctness-checking
 #include <gunrock/util/test_utils.cuh>
+#include <gunrock/util/simd_utils.cuh>
 #include <gunrock/util/track_utils.cuh>
 
 // BFS includes
+#include <gunrock/app/queue_planner.cuh>
+#include <gunrock/app/autotune.cuh>
 #include <gunrock/app/bfs/bfs_enactor.cuh>
+#include <gunrock/app/bfs/direction_policy.cuh>
+#include <gunrock/app/bfs/bfs_host.cuh>
 #include <gunrock/app/bfs/bfs_problem.cuh>
 #include <gunrock/app/bfs/bfs_functor.cuh>
+#include <gunrock/app/reach/reach_index.cuh>
+#include <gunrock/app/landmark/landmark_sketch.cuh>
+#include <gunrock/app/temporal/temporal_bfs.cuh>
 
 // Operator includes
 #include <gunrock/oprtr/advance/kernel.cuh>
@@ -89,17 +97,54 @@ void Usage()
         "[--disable-size-check]    Disable frontier queue size check.\n"
         "[--grid-size=<grid size>] Maximum allowed grid size setting.\n"
         "[--queue-sizing=<factor>] Allocates a frontier queue sized at: \n"
-        "                          (graph-edges * <factor>). (Default: 1.0)\n"
+        "                          (graph-edges * <factor>). (Default: planned\n"
+        "                          from the graph profile)\n"
         "[--in-sizing=<in/out_queue_scale_factor>]\n"
         "                          Allocates a frontier queue sized at: \n"
-        "                          (graph-edges * <factor>). (Default: 1.0)\n"
+        "                          (graph-edges * <factor>). (Default: planned\n"
+        "                          from the graph profile)\n"
         "[--v]                     Print verbose per iteration debug info.\n"
         "[--iteration-num=<num>]   Number of runs to perform the test.\n"
         "[--traversal-mode=<0|1>]  Set traversal strategy, 0 for Load-Balanced\n"
         "                          1 for Dynamic-Cooperative (Default: dynamic\n"
         "                          determine based on average degree).\n"
+        "[--direction-optimized]   Switch between push and pull traversal.\n"
+        "[--do-heuristic=<beamer|ratio>]\n"
+        "                          Switching rule: beamer uses exact frontier and\n"
+        "                          unexplored edge counts with --alpha / --beta,\n"
+        "                          ratio uses degree estimates with --do_a / --do_b\n"
+        "                          (Default: beamer).\n"
+        "[--alpha=<a>] [--beta=<b>] Push to pull when frontier edges exceed\n"
+        "                          unexplored edges / a; pull to push when the\n"
+        "                          frontier drops below nodes / b (Default: 6, 6).\n"
+        "[--hub-degree=<d>]        Hash the neighbor lists of vertices with at\n"
+        "                          least d neighbors for O(1) edge lookups.\n"
+        "[--vertex-subset-ref]     Also run the CPU BFS on VertexSubset frontiers\n"
+        "                          (auto push / pull).\n"
+        "[--multi-source-ref]      Also run the bit-parallel CPU BFS from the\n"
+        "                          source and 63 random ones, and check each\n"
+        "                          against a single-source run.\n"
+        "[--reach-index]           Build the reachability index and check its\n"
+        "                          answer for source to every vertex against\n"
+        "                          the BFS labels.\n"
+        "[--landmarks=<k>]         Build a k-landmark distance sketch and check\n"
+        "                          its bounds from source to every vertex\n"
+        "                          against the BFS labels.\n"
+        "[--temporal-window=<t0>,<t1>]\n"
+        "                          Reload the market file with its last column\n"
+        "                          as edge timestamps, run the windowed and\n"
+        "                          earliest-arrival BFS within [t0, t1] and\n"
+        "                          check them, and 8 windows at once.\n"
+        "[--temporal-durations]    With --temporal-window, the edge values\n"
+        "                          (I J A T lines) are traversal durations.\n"
+        "[--autotune]              Time pilot runs to pick traversal mode and\n"
+        "                          direction-optimization parameters, and save\n"
+        "                          them next to the dataset for later runs.\n"
+        "[--disable-autotune]      Ignore parameters saved by --autotune.\n"
         "[--partition-method=<random|biasrandom|clustered|metis>]\n"
         "                          Choose partitioner (Default use random).\n"
+        "[--largest-cc]            Load only the largest connected component of\n"
+        "                          a market graph, found while parsing.\n"
         "[--quiet]                 No output (unless --json is specified).\n"
         "[--json]                  Output JSON-format statistics to STDOUT.\n"
         "[--jsonfile=<name>]       Output JSON-format statistics to file <name>\n"
@@ -220,23 +265,26 @@ void ReferenceBFS(
         SizeT edges_begin = graph->row_offsets[dequeued_node];
         SizeT edges_end = graph->row_offsets[dequeued_node + 1];
 
-        for (SizeT edge = edges_begin; edge < edges_end; ++edge)
+        const VertexId *neighbors = graph->column_indices + edges_begin;
+        SizeT degree = edges_end - edges_begin;
+        for (SizeT i = util::simd::GatherFind(neighbors, (SizeT)0, degree,
+                source_path, neighbor_dist, util::simd::GATHER_GREATER);
+            i < degree;
+            i = util::simd::GatherFind(neighbors, i + 1, degree,
+                source_path, neighbor_dist, util::simd::GATHER_GREATER))
         {
             //Lookup neighbor and enqueue if undiscovered
-            VertexId neighbor = graph->column_indices[edge];
-            if (source_path[neighbor] > neighbor_dist) //|| source_path[neighbor] == -1)
+            VertexId neighbor = neighbors[i];
+            source_path[neighbor] = neighbor_dist;
+            if (MARK_PREDECESSORS)
             {
-                source_path[neighbor] = neighbor_dist;
-                if (MARK_PREDECESSORS)
-                {
-                    predecessor[neighbor] = dequeued_node;
-                }
-                if (search_depth < neighbor_dist)
-                {
-                    search_depth = neighbor_dist;
-                }
-                frontier.push_back(neighbor);
+                predecessor[neighbor] = dequeued_node;
+            }
+            if (search_depth < neighbor_dist)
+            {
+                search_depth = neighbor_dist;
             }
+            frontier.push_back(neighbor);
         }
     }
 
@@ -256,6 +304,75 @@ void ReferenceBFS(
     }
 }
 
+/**
+ * @brief Times one BFS run per tuning candidate. The enactor binds its
+ * advance threads to a traversal mode at Init, so a new enactor is made
+ * whenever the candidate changes the mode.
+ */
+template <typename Problem, typename Enactor>
+struct BFSTunePilot
+{
+    typedef typename Problem::VertexId VertexId;
+
+    Enactor      *&enactor;
+    Problem       *problem;
+    ContextPtr    *context;
+    int            num_gpus;
+    int           *gpu_idx;
+    int            max_grid_size;
+    bool           instrument, debug, size_check, direction_optimized;
+    VertexId       src;
+    double         max_queue_sizing, max_queue_sizing1;
+    std::string    traversal_mode;
+
+    BFSTunePilot(Enactor *&enactor_) : enactor(enactor_) {}
+
+    double operator()(const TuneConfig &config)
+    {
+        cudaError_t retval = cudaSuccess;
+        if (config.traversal_mode != traversal_mode)
+        {
+            Enactor *new_enactor = new Enactor(num_gpus, gpu_idx,
+                instrument, debug, size_check, direction_optimized);
+            if (retval = new_enactor -> Init(context, problem,
+                max_grid_size, config.traversal_mode))
+            {
+                delete new_enactor; new_enactor = NULL;
+                return -1;
+            }
+            new_enactor -> communicate_latency = enactor -> communicate_latency;
+            new_enactor -> communicate_multipy = enactor -> communicate_multipy;
+            new_enactor -> expand_latency      = enactor -> expand_latency;
+            new_enactor -> subqueue_latency    = enactor -> subqueue_latency;
+            new_enactor -> fullqueue_latency   = enactor -> fullqueue_latency;
+            new_enactor -> makeout_latency     = enactor -> makeout_latency;
+            enactor -> Release();
+            delete enactor;
+            enactor = new_enactor;
+            traversal_mode = config.traversal_mode;
+        }
+        enactor -> alpha = config.alpha;
+        enactor -> beta  = config.beta;
+        enactor -> do_a  = config.do_a;
+        enactor -> do_b  = config.do_b;
+
+        if (retval = problem -> Reset(src, enactor -> GetFrontierType(),
+            max_queue_sizing, max_queue_sizing1)) return -1;
+        if (retval = enactor -> Reset()) return -1;
+        for (int gpu = 0; gpu < num_gpus; gpu++)
+        {
+            if (retval = util::SetDevice(gpu_idx[gpu])) return -1;
+            if (retval = cudaDeviceSynchronize()) return -1;
+        }
+
+        CpuTimer cpu_timer;
+        cpu_timer.Start();
+        if (retval = enactor -> Enact(src, traversal_mode)) return -1;
+        cpu_timer.Stop();
+        return cpu_timer.ElapsedMillis();
+    }
+};
+
 /**
  * @brief Run BFS tests
  *
@@ -323,9 +440,32 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
     bool     direction_optimized   = info->info["direction_optimized"].get_bool();
     float    do_a                  = info->info["do_a"              ].get_real();
     float    do_b                  = info->info["do_b"              ].get_real();
+    float    alpha                 = info->info["alpha"             ].get_real();
+    float    beta                  = info->info["beta"              ].get_real();
+    DirectionHeuristic do_heuristic= GetDirectionHeuristic(
+                                     info->info["do_heuristic"      ].get_str());
     bool     undirected            = info->info["undirected"        ].get_bool();
-    if (max_queue_sizing < 0) max_queue_sizing = 6.5;
-    if (max_in_sizing < 0) max_in_sizing = 4;
+    bool     autotune              = info->info["autotune"          ].get_bool();
+    bool     vertex_subset_ref     = info->info["vertex_subset_ref" ].get_bool();
+    bool     multi_source_ref      = info->info["multi_source_ref"  ].get_bool();
+    bool     reach_index           = info->info["reach_index"       ].get_bool();
+    int      num_landmarks         = info->info["landmarks"         ].get_int ();
+    bool     temporal              = info->info["temporal"          ].get_bool();
+    bool     plan_queue_sizing     = (max_queue_sizing < 0 || max_in_sizing < 0);
+    QueuePlanner<VertexId, SizeT, Value> queue_planner;
+    if (plan_queue_sizing)
+    {
+        // size queues from the graph profile instead of fixed factors;
+        // the partition is not known yet, so assume a random one
+        queue_planner.Plan(*graph, num_gpus, NULL,
+            src_type == "random2" || src_type == "list" ? -1 : src);
+        if (max_queue_sizing  < 0) max_queue_sizing  = queue_planner.queue_sizing;
+        if (max_queue_sizing1 < 0) max_queue_sizing1 = queue_planner.queue_sizing1;
+        if (max_in_sizing     < 0) max_in_sizing     = queue_planner.in_sizing;
+        if (!quiet_mode)
+            printf("Planned queue sizing: %lf, %lf, in sizing: %lf\n",
+                max_queue_sizing, max_queue_sizing1, max_in_sizing);
+    }
     if (communicate_multipy > 1) max_in_sizing *= communicate_multipy;
 
     CpuTimer cpu_timer;
@@ -381,6 +521,19 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
         partition_seed),
         "BFS Problem Init failed", __FILE__, __LINE__)) return retval;
 
+    if (plan_queue_sizing && num_gpus > 1)
+    {
+        // refine frontier queue factors with the actual partition
+        double in_sizing = queue_planner.in_sizing;
+        queue_planner.Plan(*graph, num_gpus, problem -> partition_tables[0],
+            src_type == "random2" || src_type == "list" ? -1 : src);
+        queue_planner.in_sizing = in_sizing;
+        if (info -> info["max_queue_sizing" ].get_real() < 0)
+            max_queue_sizing  = queue_planner.queue_sizing;
+        if (info -> info["max_queue_sizing1"].get_real() < 0)
+            max_queue_sizing1 = queue_planner.queue_sizing1;
+    }
+
     Enactor* enactor = new Enactor(
         num_gpus, gpu_idx, instrument, debug, size_check, direction_optimized);  // enactor map
     if (retval = util::GRError(enactor->Init(
@@ -394,6 +547,9 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
     enactor -> subqueue_latency    = subqueue_latency;
     enactor -> fullqueue_latency   = fullqueue_latency;
     enactor -> makeout_latency     = makeout_latency;
+    enactor -> do_heuristic        = do_heuristic;
+    enactor -> alpha               = alpha;
+    enactor -> beta                = beta;
     enactor -> do_a                = do_a;
     enactor -> do_b                = do_b;
 
@@ -407,6 +563,66 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
         fullqueue_latency,
         makeout_latency)) return retval;
 
+    if (autotune)
+    {
+        GraphProfile profile;
+        profile.Build(*graph);
+        TuneConfig initial;
+        initial.algorithm      = info -> info["algorithm"].get_str();
+        initial.traversal_mode = traversal_mode;
+        initial.do_a           = do_a;
+        initial.do_b           = do_b;
+        initial.alpha          = alpha;
+        initial.beta           = beta;
+        initial.delta_factor   = info -> info["delta_factor"].get_int();
+
+        BFSTunePilot<Problem, Enactor> pilot(enactor);
+        pilot.problem             = problem;
+        pilot.context             = context;
+        pilot.num_gpus            = num_gpus;
+        pilot.gpu_idx             = gpu_idx;
+        pilot.max_grid_size       = max_grid_size;
+        pilot.instrument          = instrument;
+        pilot.debug               = debug;
+        pilot.size_check          = size_check;
+        pilot.direction_optimized = direction_optimized;
+        pilot.src                 = src;
+        pilot.max_queue_sizing    = max_queue_sizing;
+        pilot.max_queue_sizing1   = max_queue_sizing1;
+        pilot.traversal_mode      = traversal_mode;
+
+        AutoTuner tuner;
+        tuner.tune_direction = direction_optimized;
+        tuner.tune_ratio     = (do_heuristic == RATIO_HEURISTIC);
+        tuner.quiet          = quiet_mode;
+        TuneConfig best = tuner.Tune(profile, initial, pilot);
+        if (best.elapsed < 0) return util::GRError(cudaErrorUnknown,
+            "BFS auto-tuning failed", __FILE__, __LINE__);
+        // leave the enactor in the tuned mode for the measured runs
+        if (pilot(best) < 0) return util::GRError(cudaErrorUnknown,
+            "BFS auto-tuning failed", __FILE__, __LINE__);
+
+        traversal_mode = best.traversal_mode;
+        do_a           = best.do_a;
+        do_b           = best.do_b;
+        alpha          = best.alpha;
+        beta           = best.beta;
+        info -> info["traversal_mode"] = traversal_mode;
+        info -> info["do_a"          ] = do_a;
+        info -> info["do_b"          ] = do_b;
+        info -> info["alpha"         ] = alpha;
+        info -> info["beta"          ] = beta;
+        info -> info["autotuned"     ] = true;
+
+        json_spirit::mObject profile_json;
+        profile.ToJson(profile_json);
+        info -> info["autotune_profile"] = profile_json;
+        info -> info["autotune_pilots" ] = tuner.pilots;
+        std::string tune_file = info -> info["autotune_file"].get_str();
+        if (tune_file != "" && !best.Save(tune_file))
+            fprintf(stderr, "Cannot write tune file %s\n", tune_file.c_str());
+    }
+
     cpu_timer.Stop();
     info -> info["preprocess_time"] = cpu_timer.ElapsedMillis();
 
@@ -495,11 +711,27 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
         }
     }
     total_elapsed /= iterations;
+    if (plan_queue_sizing)
+    {
+        json_spirit::mObject queue_plan;
+        queue_planner.ToJson(queue_plan);
+        queue_planner.RecordActual(problem, queue_plan);
+        info -> info["queue_plan"] = queue_plan;
+    }
+    if (direction_optimized)
+    {
+        json_spirit::mObject direction_trace;
+        problem -> data_slices[0] -> direction_policy.ToJson(direction_trace);
+        info -> info["direction_trace"] = direction_trace;
+    }
     info -> info["process_times"] = process_times;
     info -> info["min_process_time"] = min_elapsed;
     info -> info["max_process_time"] = max_elapsed;
 
     // compute reference CPU BFS solution for source-distance
+    SizeT direction_replay_errors = 0;
+    SizeT vertex_subset_errors    = 0;
+    SizeT multi_source_errors     = 0;
     if (!quick_mode)
     {
         if (!quiet_mode)
@@ -517,6 +749,103 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
         {
             printf("\n");
         }
+
+        if (direction_optimized)
+        {
+            // replay the switching policy on the host for comparison
+            DirectionPolicy<SizeT> host_policy;
+            host_policy.heuristic = do_heuristic;
+            host_policy.alpha     = alpha;
+            host_policy.beta      = beta;
+            host_policy.do_a      = do_a;
+            host_policy.do_b      = do_b;
+            VertexId *host_labels = new VertexId[graph -> nodes];
+            HostDirectionOptimizedBFS(*graph, inv_graph, src,
+                host_labels, host_policy);
+            SizeT num_errors = 0;
+            for (SizeT v = 0; v < graph -> nodes; v++)
+            {
+                VertexId label = (host_labels[v] == -1) ?
+                    util::MaxValue<VertexId>() : host_labels[v];
+                if (label != reference_check_label[v]) num_errors ++;
+            }
+            if (!quiet_mode)
+                printf("Host direction-optimized BFS: %lld errors, "
+                    "%d push / pull switches\n", (long long)num_errors,
+                    host_policy.NumSwitches());
+            json_spirit::mObject host_trace;
+            host_policy.ToJson(host_trace);
+            info -> info["host_direction_trace" ] = host_trace;
+            info -> info["host_direction_errors"] = (int64_t)num_errors;
+            direction_replay_errors = num_errors;
+            delete[] host_labels; host_labels = NULL;
+        }
+        if (vertex_subset_ref)
+        {
+            VertexId *host_labels = new VertexId[graph -> nodes];
+            int       num_pulls   = 0;
+            CpuTimer  host_timer;
+            host_timer.Start();
+            HostVertexSubsetBFS(*graph, inv_graph, src, host_labels, &num_pulls);
+            host_timer.Stop();
+            SizeT num_errors = 0;
+            for (SizeT v = 0; v < graph -> nodes; v++)
+            {
+                VertexId label = (host_labels[v] == -1) ?
+                    util::MaxValue<VertexId>() : host_labels[v];
+                if (label != reference_check_label[v]) num_errors ++;
+            }
+            info -> info["vertex_subset_bfs_time"  ] = host_timer.ElapsedMillis();
+            info -> info["vertex_subset_bfs_errors"] = (int64_t)num_errors;
+            vertex_subset_errors = num_errors;
+            if (!quiet_mode)
+                printf("VertexSubset CPU BFS finished in %lf msec: %lld errors, "
+                    "%d pull levels\n", host_timer.ElapsedMillis(),
+                    (long long)num_errors, num_pulls);
+            delete[] host_labels; host_labels = NULL;
+        }
+        if (multi_source_ref)
+        {
+            // the source's column against the reference, the others
+            // against the single-source VertexSubset BFS
+            int       num_sources = graph -> nodes < 64 ? graph -> nodes : 64;
+            VertexId *sources     = new VertexId[num_sources];
+            VertexId *labels      = new VertexId[(SizeT)num_sources * graph -> nodes];
+            VertexId *host_labels = new VertexId[graph -> nodes];
+            CpuTimer  host_timer;
+            sources[0] = src;
+            for (int i = 1; i < num_sources; i++)
+                sources[i] = rand() % graph -> nodes;
+            host_timer.Start();
+            HostMultiSourceBFS(*graph, inv_graph, sources, num_sources, labels);
+            host_timer.Stop();
+            SizeT num_errors = 0;
+            for (int i = 0; i < num_sources; i++)
+            {
+                VertexId *column = labels + (SizeT)i * graph -> nodes;
+                if (i > 0)
+                    HostVertexSubsetBFS(*graph, inv_graph, sources[i], host_labels);
+                for (SizeT v = 0; v < graph -> nodes; v++)
+                {
+                    VertexId label = (column[v] == -1) ?
+                        util::MaxValue<VertexId>() : column[v];
+                    VertexId ref_label = (i == 0) ? reference_check_label[v] :
+                        (host_labels[v] == -1) ?
+                        util::MaxValue<VertexId>() : host_labels[v];
+                    if (label != ref_label) num_errors ++;
+                }
+            }
+            info -> info["multi_source_bfs_time"  ] = host_timer.ElapsedMillis();
+            info -> info["multi_source_bfs_errors"] = (int64_t)num_errors;
+            multi_source_errors = num_errors;
+            if (!quiet_mode)
+                printf("Multi-source CPU BFS from %d sources finished in "
+                    "%lf msec: %lld errors\n", num_sources,
+                    host_timer.ElapsedMillis(), (long long)num_errors);
+            delete[] sources    ; sources     = NULL;
+            delete[] labels     ; labels      = NULL;
+            delete[] host_labels; host_labels = NULL;
+        }
     }
 
     cpu_timer.Start();
@@ -568,14 +897,7 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
                     continue;
                 }
 
-                bool v_found = false;
-                for (SizeT t = graph->row_offsets[pred]; t < graph->row_offsets[pred+1]; t++)
-                if (v == graph->column_indices[t])
-                {
-                    v_found = true;
-                    break;
-                }
-                if (!v_found)
+                if (!graph->HasEdge(pred, v))
                 {
                     if (num_errors == 0)
                         printf("INCORRECT: Vertex %lld not in Vertex %lld's neighbor list\n",
@@ -595,6 +917,234 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
 
     }
 
+    SizeT reach_index_errors = 0;
+    if (reach_index)
+    {
+        app::reach::ReachIndex<VertexId, SizeT> index;
+        CpuTimer reach_timer;
+        reach_timer.Start();
+        index.Build(*graph, 5, 0, quiet_mode);
+        reach_timer.Stop();
+        info -> info["reach_index_time"] = reach_timer.ElapsedMillis();
+
+        VertexId *sources = new VertexId[graph -> nodes];
+        VertexId *targets = new VertexId[graph -> nodes];
+        char     *reached = new char    [graph -> nodes];
+        for (VertexId v = 0; v < graph -> nodes; v++)
+        {
+            sources[v] = src;
+            targets[v] = v;
+        }
+        reach_timer.Start();
+        long long num_searches = index.Reachable(
+            graph -> nodes, sources, targets, reached);
+        reach_timer.Stop();
+        SizeT num_errors = 0;
+        for (VertexId v = 0; v < graph -> nodes; v++)
+            if ((reached[v] != 0) != (h_labels[v] != util::MaxValue<VertexId>()))
+                num_errors ++;
+        info -> info["reach_query_time"  ] = reach_timer.ElapsedMillis();
+        info -> info["reach_searches"    ] = (int64_t)num_searches;
+        info -> info["reach_index_errors"] = (int64_t)num_errors;
+        reach_index_errors = num_errors;
+        if (!quiet_mode)
+            printf("Reachability index: %lld queries in %lf msec, %lld searched,"
+                " %lld errors\n", (long long)graph -> nodes,
+                reach_timer.ElapsedMillis(), num_searches, (long long)num_errors);
+        delete[] sources; sources = NULL;
+        delete[] targets; targets = NULL;
+        delete[] reached; reached = NULL;
+    }
+
+    SizeT landmark_errors = 0;
+    if (num_landmarks > 0)
+    {
+        app::landmark::LandmarkSketch<VertexId, SizeT> sketch;
+        CpuTimer sketch_timer;
+        sketch_timer.Start();
+        sketch.Build(*graph, undirected ? NULL : inv_graph, num_landmarks,
+            app::landmark::LANDMARK_COVERAGE, false, quiet_mode);
+        sketch_timer.Stop();
+        info -> info["landmark_sketch_time"] = sketch_timer.ElapsedMillis();
+
+        VertexId     *sources = new VertexId    [graph -> nodes];
+        VertexId     *targets = new VertexId    [graph -> nodes];
+        unsigned int *lowers  = new unsigned int[graph -> nodes];
+        unsigned int *uppers  = new unsigned int[graph -> nodes];
+        for (VertexId v = 0; v < graph -> nodes; v++)
+        {
+            sources[v] = src;
+            targets[v] = v;
+        }
+        sketch_timer.Start();
+        sketch.Bounds(graph -> nodes, sources, targets, lowers, uppers);
+        sketch_timer.Stop();
+        SizeT  num_errors = 0, num_exact = 0, num_bounded = 0;
+        double stretch = 0;
+        for (VertexId v = 0; v < graph -> nodes; v++)
+        {
+            unsigned int distance = (h_labels[v] == util::MaxValue<VertexId>()) ?
+                GR_LANDMARK_INFINITY : (unsigned int)h_labels[v];
+            if (lowers[v] > distance || uppers[v] < distance) num_errors ++;
+            if (lowers[v] == uppers[v]) num_exact ++;
+            if (distance > 0 && distance != GR_LANDMARK_INFINITY &&
+                uppers[v] != GR_LANDMARK_INFINITY)
+            {
+                num_bounded ++;
+                stretch += (double)uppers[v] / distance;
+            }
+        }
+        info -> info["landmark_query_time"] = sketch_timer.ElapsedMillis();
+        info -> info["landmark_errors"    ] = (int64_t)num_errors;
+        landmark_errors = num_errors;
+        if (!quiet_mode)
+            printf("Landmark sketch: %lld queries in %lf msec, %lld exact,"
+                " mean upper bound stretch %.3f, %lld errors\n",
+                (long long)graph -> nodes, sketch_timer.ElapsedMillis(),
+                (long long)num_exact, num_bounded > 0 ? stretch / num_bounded : 1.0,
+                (long long)num_errors);
+        delete[] sources; sources = NULL;
+        delete[] targets; targets = NULL;
+        delete[] lowers ; lowers  = NULL;
+        delete[] uppers ; uppers  = NULL;
+    }
+
+    std::string dataset_path = info->info["dataset_path"].get_str();
+    SizeT temporal_errors = 0;
+    if (temporal && dataset_path != "")
+    {
+        typedef long long Time;
+        Time t0 = info->info["temporal_t0"].get_int64();
+        Time t1 = info->info["temporal_t1"].get_int64();
+        bool use_durations = info->info["temporal_durations"].get_bool();
+        TemporalCsr<VertexId, SizeT, Value, Time> temporal_graph;
+        CpuTimer temporal_timer;
+        temporal_timer.Start();
+        char *file_name = strdup(dataset_path.c_str());
+        int retval = use_durations ?
+            graphio::BuildTemporalMarketGraph<true >(
+                file_name, temporal_graph, undirected, false, quiet_mode) :
+            graphio::BuildTemporalMarketGraph<false>(
+                file_name, temporal_graph, undirected, false, quiet_mode);
+        free(file_name); file_name = NULL;
+        temporal_timer.Stop();
+        info -> info["temporal_build_time"] = temporal_timer.ElapsedMillis();
+
+        if (retval != 0)
+        {
+            if (!quiet_mode)
+                printf("Temporal BFS: unable to read %s as a temporal edge"
+                    " list, skipped\n", dataset_path.c_str());
+        } else if (temporal_graph.nodes != graph -> nodes) {
+            // vertex IDs differ from the graph's, the labels can't be compared
+            if (!quiet_mode)
+                printf("Temporal BFS: %s has %lld vertices, the graph run has"
+                    " %lld%s, skipped\n", dataset_path.c_str(),
+                    (long long)temporal_graph.nodes, (long long)graph -> nodes,
+                    info -> info["largest_cc"].get_bool() ?
+                    " (only its largest component, --largest-cc)" : "");
+        } else {
+            const int num_windows     = 8;
+            VertexId *window_labels   = new VertexId[graph -> nodes];
+            Time     *arrivals        = new Time    [graph -> nodes];
+            bool     *achieved        = new bool    [graph -> nodes];
+            Time     *window_t0s      = new Time    [num_windows];
+            Time     *window_t1s      = new Time    [num_windows];
+            Time     *window_arrivals = new Time    [(size_t)graph -> nodes * num_windows];
+            SizeT     num_errors      = 0;
+
+            // over all times, the windowed BFS is the static BFS
+            app::temporal::HostWindowBFS(temporal_graph, src,
+                temporal_graph.min_time, temporal_graph.max_time, window_labels);
+            for (VertexId v = 0; v < graph -> nodes; v++)
+                if ((window_labels[v] == -1) !=
+                    (h_labels[v] == util::MaxValue<VertexId>()))
+                    num_errors ++;
+
+            temporal_timer.Start();
+            app::temporal::HostWindowBFS(
+                temporal_graph, src, t0, t1, window_labels);
+            SizeT num_reached = app::temporal::HostEarliestArrival(
+                temporal_graph, src, t0, t1, arrivals, (VertexId*)NULL,
+                use_durations);
+            temporal_timer.Stop();
+
+            // a certificate of the arrivals: no edge leaving a reached vertex
+            // lands earlier than the arrival found, every arrival but the
+            // source's is where some such edge lands, and time-respecting
+            // paths are paths of the window
+            for (VertexId v = 0; v < graph -> nodes; v++)
+                achieved[v] = (v == src);
+            if (arrivals[src] != t0) num_errors ++;
+            for (VertexId u = 0; u < graph -> nodes; u++)
+            {
+                if (arrivals[u] == util::MaxValue<Time>()) continue;
+                if (window_labels[u] == -1) num_errors ++;
+                SizeT begin, end;
+                temporal_graph.WindowRange(u, arrivals[u], t1, begin, end);
+                for (SizeT e = begin; e < end; e++)
+                {
+                    VertexId v    = temporal_graph.column_indices[e];
+                    Time     land = temporal_graph.timestamps[e];
+                    if (use_durations)
+                    {
+                        land += (Time)temporal_graph.edge_values[e];
+                        if (land > t1) continue;
+                    }
+                    if (arrivals[v] >  land) num_errors ++;
+                    if (arrivals[v] == land) achieved[v] = true;
+                }
+            }
+            for (VertexId v = 0; v < graph -> nodes; v++)
+                if (arrivals[v] != util::MaxValue<Time>() && !achieved[v])
+                    num_errors ++;
+
+            // windows starting through [t0, t1], one per thread, each as
+            // if queried alone
+            for (int i = 0; i < num_windows; i++)
+            {
+                window_t0s[i] = t0 + (t1 - t0) * i / num_windows;
+                window_t1s[i] = t1;
+            }
+            CpuTimer multi_window_timer;
+            multi_window_timer.Start();
+            app::temporal::HostMultiWindowEarliestArrival(temporal_graph, src,
+                window_t0s, window_t1s, num_windows, window_arrivals,
+                use_durations);
+            multi_window_timer.Stop();
+            for (int i = 0; i < num_windows; i++)
+            {
+                app::temporal::HostEarliestArrival(temporal_graph, src,
+                    window_t0s[i], window_t1s[i], arrivals, (VertexId*)NULL,
+                    use_durations);
+                for (VertexId v = 0; v < graph -> nodes; v++)
+                    if (window_arrivals[(size_t)i * graph -> nodes + v] !=
+                        arrivals[v])
+                        num_errors ++;
+            }
+
+            info -> info["temporal_query_time"       ] = temporal_timer.ElapsedMillis();
+            info -> info["temporal_multi_window_time"] = multi_window_timer.ElapsedMillis();
+            info -> info["temporal_errors"           ] = (int64_t)num_errors;
+            temporal_errors = num_errors;
+            if (!quiet_mode)
+                printf("Temporal BFS: [%lld, %lld] holds %lld of %lld edges,"
+                    " %lld vertices reached by time-respecting paths,"
+                    " %lf msec, %d windows in %lf msec, %lld errors\n",
+                    (long long)t0, (long long)t1,
+                    (long long)temporal_graph.WindowEdges(t0, t1),
+                    (long long)temporal_graph.edges, (long long)num_reached,
+                    temporal_timer.ElapsedMillis(), num_windows,
+                    multi_window_timer.ElapsedMillis(), (long long)num_errors);
+            delete[] window_labels  ; window_labels   = NULL;
+            delete[] arrivals       ; arrivals        = NULL;
+            delete[] achieved       ; achieved        = NULL;
+            delete[] window_t0s     ; window_t0s      = NULL;
+            delete[] window_t1s     ; window_t1s      = NULL;
+            delete[] window_arrivals; window_arrivals = NULL;
+        }
+    }
+
     if (!quick_mode && TO_TRACK)
     {
         VertexId **v_ = NULL;
@@ -692,6 +1242,24 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
         }
         delete[] h_preds         ; h_preds          = NULL;
     }
+    if (retval == cudaSuccess && direction_replay_errors > 0)
+        retval = util::GRError(cudaErrorUnknown,
+            "Host direction-optimized BFS check failed", __FILE__, __LINE__);
+    if (retval == cudaSuccess && vertex_subset_errors > 0)
+        retval = util::GRError(cudaErrorUnknown,
+            "VertexSubset CPU BFS check failed", __FILE__, __LINE__);
+    if (retval == cudaSuccess && multi_source_errors > 0)
+        retval = util::GRError(cudaErrorUnknown,
+            "Multi-source CPU BFS check failed", __FILE__, __LINE__);
+    if (retval == cudaSuccess && reach_index_errors > 0)
+        retval = util::GRError(cudaErrorUnknown,
+            "Reachability index check failed", __FILE__, __LINE__);
+    if (retval == cudaSuccess && landmark_errors > 0)
+        retval = util::GRError(cudaErrorUnknown,
+            "Landmark bounds miss the BFS distance", __FILE__, __LINE__);
+    if (retval == cudaSuccess && temporal_errors > 0)
+        retval = util::GRError(cudaErrorUnknown,
+            "Temporal BFS check failed", __FILE__, __LINE__);
     return retval;
 }
 
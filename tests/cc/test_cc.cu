@@ -25,6 +25,9 @@
 #include <gunrock/app/cc/cc_enactor.cuh>
 #include <gunrock/app/cc/cc_problem.cuh>
 #include <gunrock/app/cc/cc_functor.cuh>
+#include <gunrock/app/cc/cc_host.cuh>
+#include <gunrock/app/tc/tc_host.cuh>
+#include <gunrock/graphio/kernelize.cuh>
 
 // Operator includes
 #include <gunrock/oprtr/advance/kernel.cuh>
@@ -99,6 +102,12 @@ void Usage()
         "                          total_queued, search_depth and barrier duty.\n"
         "                          (a relative indicator of load imbalance.)\n"
         "[--quick]                 Skip the CPU reference validation process.\n"
+        "[--edge-list-ref]         Also run the edge-list CPU hooking CC, the\n"
+        "                          CSR label-propagation CC and triangle\n"
+        "                          support, and check them.\n"
+        "[--edge-maps]             Build the reverse edge maps, check them,\n"
+        "                          and use them in the CSR triangle support.\n"
+        "[--hilbert-order]         Order that edge list along a Hilbert curve.\n"
         "[--disable-size-check]    Disable frontier queue size check.\n"
         "[--grid-size=<grid size>] Maximum allowed grid size setting.\n"
         "[--queue-sizing=<factor>] Allocates a frontier queue sized at: \n"
@@ -110,6 +119,11 @@ void Usage()
         "[--iteration-num=<num>]   Number of runs to perform the test.\n"
         "[--partition-method=<random|biasrandom|clustered|metis>]\n"
         "                          Choose partitioner (Default use random).\n"
+        "[--largest-cc]            Load only the largest connected component of\n"
+        "                          a market graph, found while parsing.\n"
+        "[--kernelize]             Fold pendant trees and degree-2 chains, run\n"
+        "                          on the remaining kernel, then expand;\n"
+        "                          with --undirected.\n"
         "[--quiet]                 No output (unless --json is specified).\n"
         "[--json]                  Output JSON-format statistics to STDOUT.\n"
         "[--jsonfile=<name>]       Output JSON-format statistics to file <name>\n"
@@ -310,6 +324,12 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
     int     subqueue_latency       = info->info["subqueue_latency"  ].get_int ();
     int     fullqueue_latency      = info->info["fullqueue_latency" ].get_int ();
     int     makeout_latency        = info->info["makeout_latency"   ].get_int ();
+    bool    edge_list_ref          = info->info["edge_list_ref"     ].get_bool ();
+    bool    hilbert_order          = info->info["hilbert_order"     ].get_bool ();
+    bool    kernelize              = info->info["kernelize"         ].get_bool ()
+                                  && info->info["undirected"        ].get_bool ();
+    // CC starts from every vertex and edge, so the frontier never exceeds
+    // the graph and the traversal queue planner has nothing to predict
     if (max_queue_sizing < 0) max_queue_sizing = 1.0;
     if (max_in_sizing < 0) max_in_sizing = 1.1;
     if (communicate_multipy > 1) max_in_sizing *= communicate_multipy;
@@ -325,9 +345,23 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
     ContextPtr   *context = (ContextPtr*)  info->context;
     cudaStream_t *streams = (cudaStream_t*)info->streams;
 
+    // fold pendant trees and chains; the GPU runs on the kernel only
+    graphio::Kernelization<VertexId, SizeT, Value> kernelization;
+    Csr<VertexId, SizeT, Value> kernel_graph(false);
+    Csr<VertexId, SizeT, Value> *run_graph = graph;
+    if (kernelize)
+    {
+        kernelization.Build(*graph, kernel_graph, NULL, 0, true, quiet_mode);
+        run_graph = &kernel_graph;
+        info -> info["kernel_nodes"] = (int64_t)kernel_graph.nodes;
+        info -> info["kernel_edges"] = (int64_t)kernel_graph.edges;
+    }
+
     // Allocate host-side array (for both reference and GPU-computed results)
     VertexId    *reference_component_ids = new VertexId[graph->nodes];
     VertexId    *h_component_ids        = new VertexId[graph->nodes];
+    VertexId    *h_kernel_component_ids = kernelize ?
+        new VertexId[run_graph->nodes + 1] : h_component_ids;
     VertexId    *reference_check        = (quick_mode) ? NULL : reference_component_ids;
     SizeT        ref_num_components     = 0;
 
@@ -351,7 +385,7 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
     Problem* problem = new Problem;  // allocate problem on GPU
     if (retval = util::GRError(problem->Init(
         stream_from_host,
-        graph,
+        run_graph,
         NULL,
         num_gpus,
         gpu_idx,
@@ -392,11 +426,140 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
     info -> info["preprocess_time"] = cpu_timer.ElapsedMillis();
 
     // compute reference CPU CC
+    SizeT edge_list_check_errors = 0;  // edge-list, label-propagation and
+                                       // triangle support checks
+    SizeT edge_map_errors        = 0;
     if (!quick_mode)
     {
         if (!quiet_mode) { printf("Computing reference value ...\n"); }
         ref_num_components = ReferenceCC(*graph, reference_check, quiet_mode);
         if (!quiet_mode) { printf("\n"); }
+
+        if (graph -> reverse_edges != NULL)
+        {
+            edge_map_errors = graph -> CheckEdgeMaps();
+            info -> info["edge_map_errors"] = (int64_t)edge_map_errors;
+            if (!quiet_mode)
+                printf("Edge map Validity: %s (%lld errors)\n",
+                    edge_map_errors == 0 ? "CORRECT" : "INCORRECT",
+                    (long long)edge_map_errors);
+        }
+
+        if (edge_list_ref)
+        {
+            EdgeList<VertexId, SizeT, Value> edge_list;
+            VertexId *edge_list_component_ids = new VertexId[graph->nodes];
+            CpuTimer edge_list_timer;
+            edge_list.FromCsr(*graph,
+                hilbert_order ? HILBERT_ORDER : SOURCE_ORDER);
+            edge_list_timer.Start();
+            SizeT edge_list_num_components =
+                HostCC(edge_list, edge_list_component_ids);
+            edge_list_timer.Stop();
+            info -> info["edge_list_cc_time"] = edge_list_timer.ElapsedMillis();
+            if (!quiet_mode)
+                printf("Edge-list CPU CC finished in %lf msec, "
+                    "%lld components\n", edge_list_timer.ElapsedMillis(),
+                    (long long)edge_list_num_components);
+
+            // both labelings to the smallest vertex of each component
+            ConvertIDs<VertexId, SizeT>(reference_check, graph->nodes, ref_num_components);
+            ConvertIDs<VertexId, SizeT>(edge_list_component_ids, graph->nodes,
+                edge_list_num_components);
+            if (!quiet_mode) printf("Edge-list CC Validity: ");
+            SizeT edge_list_errors = CompareResults(edge_list_component_ids,
+                reference_check, graph->nodes, true, quiet_mode);
+            if (edge_list_num_components != ref_num_components)
+                edge_list_errors ++;
+            info -> info["edge_list_cc_errors"] = (int64_t)edge_list_errors;
+            edge_list_check_errors += edge_list_errors;
+
+            // min-label propagation over the CSR gives the converted
+            // labeling directly
+            edge_list_timer.Start();
+            SizeT label_propagation_num_components =
+                HostLabelPropagationCC(*graph, edge_list_component_ids);
+            edge_list_timer.Stop();
+            info -> info["label_propagation_cc_time"] = edge_list_timer.ElapsedMillis();
+            if (!quiet_mode)
+                printf("Label-propagation CPU CC finished in %lf msec, "
+                    "%lld components\n", edge_list_timer.ElapsedMillis(),
+                    (long long)label_propagation_num_components);
+            if (!quiet_mode) printf("Label-propagation CC Validity: ");
+            SizeT label_propagation_errors = CompareResults(edge_list_component_ids,
+                reference_check, graph->nodes, true, quiet_mode);
+            if (label_propagation_num_components != ref_num_components)
+                label_propagation_errors ++;
+            info -> info["label_propagation_cc_errors"] = (int64_t)label_propagation_errors;
+            edge_list_check_errors += label_propagation_errors;
+            delete[] edge_list_component_ids; edge_list_component_ids = NULL;
+
+            // triangle support over the same edge stream, against a scalar
+            // intersection of the neighbor lists
+            if (graph -> rows_sorted)
+            {
+                SizeT *supports = new SizeT[edge_list.edges];
+                edge_list_timer.Start();
+                long long num_triangles =
+                    app::tc::HostTriangleSupport(*graph, edge_list, supports);
+                edge_list_timer.Stop();
+                SizeT support_errors = 0;
+                for (SizeT e = 0; e < edge_list.edges; e++)
+                {
+                    VertexId u = edge_list.froms[e], v = edge_list.tos[e];
+                    SizeT support = util::simd::IntersectCountScalar(
+                        graph -> column_indices + graph -> row_offsets[u],
+                        graph -> row_offsets[u + 1] - graph -> row_offsets[u],
+                        graph -> column_indices + graph -> row_offsets[v],
+                        graph -> row_offsets[v + 1] - graph -> row_offsets[v]);
+                    if (support != supports[e]) support_errors ++;
+                }
+                info -> info["triangle_support_time"] = edge_list_timer.ElapsedMillis();
+                info -> info["num_triangles"        ] = (int64_t)num_triangles;
+                if (!quiet_mode)
+                    printf("Edge-list triangle support finished in %lf msec, "
+                        "%lld triangles, %lld errors\n",
+                        edge_list_timer.ElapsedMillis(), num_triangles,
+                        (long long)support_errors);
+                delete[] supports; supports = NULL;
+
+                // the same in CSR order, halved by the reverse edge map
+                // when --edge-maps built it
+                supports = new SizeT[graph -> edges];
+                edge_list_timer.Start();
+                long long csr_num_triangles =
+                    app::tc::HostCsrTriangleSupport(*graph, supports);
+                edge_list_timer.Stop();
+                SizeT csr_support_errors = 0;
+                for (SizeT u = 0; u < graph -> nodes; u++)
+                {
+                    for (SizeT e = graph -> row_offsets[u];
+                        e < graph -> row_offsets[u + 1]; e++)
+                    {
+                        VertexId v = graph -> column_indices[e];
+                        SizeT support = util::simd::IntersectCountScalar(
+                            graph -> column_indices + graph -> row_offsets[u],
+                            graph -> row_offsets[u + 1] - graph -> row_offsets[u],
+                            graph -> column_indices + graph -> row_offsets[v],
+                            graph -> row_offsets[v + 1] - graph -> row_offsets[v]);
+                        if (support != supports[e]) csr_support_errors ++;
+                    }
+                }
+                if (csr_num_triangles != num_triangles) csr_support_errors ++;
+                info -> info["csr_triangle_support_time"] = edge_list_timer.ElapsedMillis();
+                info -> info["triangle_support_errors"  ] =
+                    (int64_t)(support_errors + csr_support_errors);
+                edge_list_check_errors += support_errors + csr_support_errors;
+                if (!quiet_mode)
+                    printf("CSR triangle support finished in %lf msec, "
+                        "%lld triangles, %lld errors\n",
+                        edge_list_timer.ElapsedMillis(), csr_num_triangles,
+                        (long long)csr_support_errors);
+                delete[] supports; supports = NULL;
+            } else if (!quiet_mode)
+                printf("Edge-list triangle support skipped: neighbor lists"
+                    " are not sorted\n");
+        }
     }
 
     // perform CC
@@ -446,9 +609,15 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
 
     cpu_timer.Start();
     // copy out results
-    if (retval = util::GRError(problem->Extract(h_component_ids),
+    if (retval = util::GRError(problem->Extract(h_kernel_component_ids),
         "CC Problem Data Extraction Failed", __FILE__, __LINE__))
         return retval;
+    if (kernelize)
+    {
+        // every folded tree that had no kernel vertex is a component of its own
+        kernelization.ExpandComponents(h_kernel_component_ids, h_component_ids);
+        problem->num_components += kernelization.num_isolated;
+    }
 
     // validity
     if (!quick_mode)
@@ -488,6 +657,24 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
         }
         SizeT error_num = CompareResults(
             h_component_ids, reference_check, graph->nodes, true, quiet_mode);
+
+        // independently of the reference, every neighbor must share the
+        // vertex's label
+        SizeT inconsistent_num = 0;
+        #pragma omp parallel for reduction(+:inconsistent_num)
+        for (SizeT v = 0; v < graph->nodes; v++)
+        {
+            SizeT start  = graph->row_offsets[v];
+            SizeT degree = graph->row_offsets[v + 1] - start;
+            if (util::simd::GatherCount(graph->column_indices + start, degree,
+                h_component_ids, h_component_ids[v],
+                util::simd::GATHER_EQUAL) != degree)
+                inconsistent_num ++;
+        }
+        if (inconsistent_num > 0 && !quiet_mode)
+            printf("%lld vertices have a neighbor with another label.\n",
+                (long long)inconsistent_num);
+        error_num += inconsistent_num;
         if (error_num > 0)
         {
             if (!quiet_mode) { printf("%lld errors occurred.\n", (long long)error_num); }
@@ -505,7 +692,8 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
         SizeT    *h_histograms = new SizeT   [problem->num_components];
 
         //printf("num_components = %d\n", problem->num_components);
-        problem->ComputeCCHistogram(h_component_ids, h_roots, h_histograms);
+        problem->ComputeCCHistogram(h_component_ids, h_roots, h_histograms,
+            graph->nodes);
         //printf("num_components = %d\n", problem->num_components);
 
         if (!quiet_mode)
@@ -578,10 +766,17 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
     if (problem                ) {delete   problem                ; problem                 = NULL;}
     if (enactor                ) {delete   enactor                ; enactor                 = NULL;}
     if (reference_component_ids) {delete[] reference_component_ids; reference_component_ids = NULL;}
+    if (kernelize              ) {delete[] h_kernel_component_ids ; h_kernel_component_ids  = NULL;}
     if (h_component_ids        ) {delete[] h_component_ids        ; h_component_ids         = NULL;}
     if (gpu_idx                ) {delete[] gpu_idx                ; gpu_idx                 = NULL;}
     cpu_timer.Stop();
     info->info["postprocess_time"] = cpu_timer.ElapsedMillis();
+    if (retval == cudaSuccess && edge_list_check_errors > 0)
+        retval = util::GRError(cudaErrorUnknown,
+            "Edge-list CPU CC check failed", __FILE__, __LINE__);
+    if (retval == cudaSuccess && edge_map_errors > 0)
+        retval = util::GRError(cudaErrorUnknown,
+            "Reverse edge map check failed", __FILE__, __LINE__);
     return retval;
 }
 
@@ -599,6 +794,15 @@ int main_(CommandLineArgs *args)
     Csr <VertexId, SizeT, Value> csr(false);  // graph we process on
     Info<VertexId, SizeT, Value> *info = new Info<VertexId, SizeT, Value>;
 
+    // the kernel is built for a symmetric graph, which has to be asked for
+    if (args -> CheckCmdLineFlag("kernelize") &&
+        !args -> CheckCmdLineFlag("undirected"))
+    {
+        fprintf(stderr, "--kernelize requires --undirected\n");
+        delete info; info = NULL;
+        return 1;
+    }
+
     // graph construction or generation related parameters
     info->info["undirected"] = true;   // require undirected input graph
 
@@ -609,7 +813,7 @@ int main_(CommandLineArgs *args)
         cpu_timer2.Stop();
     info->info["load_time"] = cpu_timer2.ElapsedMillis();
 
-    RunTests<VertexId, SizeT, Value>(info);  // run test
+    cudaError_t retval = RunTests<VertexId, SizeT, Value>(info);  // run test
 
     cpu_timer.Stop();
     info->info["total_time"] = cpu_timer.ElapsedMillis();
@@ -621,7 +825,7 @@ int main_(CommandLineArgs *args)
 
     info->CollectInfo();  // collected all the info and put into JSON mObject
     if (info) {delete info; info=NULL;}
-    return 0;
+    return retval;
 }
 
 template <
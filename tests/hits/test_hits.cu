@@ -29,6 +29,7 @@
 #include <gunrock/app/hits/hits_enactor.cuh>
 #include <gunrock/app/hits/hits_problem.cuh>
 #include <gunrock/app/hits/hits_functor.cuh>
+#include <gunrock/app/hits/hits_host.cuh>
 
 // Operator includes
 #include <gunrock/oprtr/advance/kernel.cuh>
@@ -168,6 +169,8 @@ void DisplaySolution(Value *hrank, Value *arank, SizeT nodes)
  *
  * @param[in] graph Reference to the CSR graph we process on
  * @param[in] inv_graph Reference to the inversed CSR graph we process on
+ * @param[in] src Source vertex
+ * @param[in] delta Weight of the return to the source
  * @param[in] hrank Host-side vector to store CPU computed hub rank scores for each node
  * @param[in] arank Host-side vector to store CPU computed authority rank scores for each node
  * @param[in] max_iter max iteration to go
@@ -180,6 +183,8 @@ template <
 void ReferenceHITS(
     const Csr<VertexId, SizeT, Value>       &graph,
     const Csr<VertexId, SizeT, Value>       &inv_graph,
+    VertexId                                 src,
+    Value                                    delta,
     Value                                   *hrank,
     Value                                   *arank,
     SizeT                                   max_iter,
@@ -189,13 +194,27 @@ void ReferenceHITS(
     // compute HITS rank
     //
 
+    SegmentedCsr<VertexId, SizeT, Value> in_edges, out_edges;
+    SizeT *out_degrees = (SizeT*)malloc(sizeof(SizeT) * graph.nodes);
+    SizeT *in_degrees  = (SizeT*)malloc(sizeof(SizeT) * graph.nodes);
+    for (VertexId v = 0; v < graph.nodes; v++)
+    {
+        out_degrees[v] = graph.row_offsets[v+1] - graph.row_offsets[v];
+        in_degrees [v] = inv_graph.row_offsets[v+1] - inv_graph.row_offsets[v];
+    }
+    in_edges .FromCsr(graph, true );
+    out_edges.FromCsr(graph, false);
+
     CpuTimer cpu_timer;
     cpu_timer.Start();
-
+    HostHITS(in_edges, out_edges, out_degrees, in_degrees, src, delta,
+        hrank, arank, max_iter);
     cpu_timer.Stop();
+    free(out_degrees); out_degrees = NULL;
+    free(in_degrees ); in_degrees  = NULL;
     float elapsed = cpu_timer.ElapsedMillis();
 
-    if (!quiet) { printf("CPU BFS finished in %lf msec.\n", elapsed); }
+    if (!quiet) { printf("CPU HITS finished in %lf msec.\n", elapsed); }
 }
 
 /**
@@ -209,6 +228,9 @@ void ReferenceHITS(
  * @tparam SIZE_CHECK
  *
  * @param[in] info Pointer to info contains parameters and statistics.
+ *
+ * \return cudaError_t object, an error if the ranks differ from the CPU
+ * reference.
  */
 template <
     typename VertexId,
@@ -217,7 +239,7 @@ template <
     //bool INSTRUMENT,
     //bool DEBUG,
     //bool SIZE_CHECK >
-void RunTests(Info<VertexId, SizeT, Value> *info)
+cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
 {
     typedef HITSProblem < VertexId,
             SizeT,
@@ -245,6 +267,7 @@ void RunTests(Info<VertexId, SizeT, Value> *info)
     bool        debug               = info->info["debug_mode"       ].get_bool (); 
     bool        size_check          = info->info["size_check"       ].get_bool (); 
     CpuTimer    cpu_timer;
+    int         num_errors          = 0;
 
     cpu_timer.Start();
     json_spirit::mArray device_list = info->info["device_list"].get_array();
@@ -297,6 +320,8 @@ void RunTests(Info<VertexId, SizeT, Value> *info)
         ReferenceHITS(
             *csr,
             *csc,
+            src,
+            delta,
             reference_check_h,
             reference_check_a,
             max_iter);
@@ -321,6 +346,17 @@ void RunTests(Info<VertexId, SizeT, Value> *info)
         problem->Extract(h_hrank, h_arank),
         "HITS Problem Data Extraction Failed", __FILE__, __LINE__);
 
+    // Verify the result
+    if (reference_check_h != NULL)
+    {
+        if (!quiet_mode) printf("Validity: ");
+        num_errors += CompareResults(h_hrank, reference_check_h, csr->nodes,
+            true, quiet_mode);
+        num_errors += CompareResults(h_arank, reference_check_a, csr->nodes,
+            true, quiet_mode);
+        info -> info["hits_errors"] = num_errors;
+    }
+
     // Display Solution
     if (!quiet_mode) DisplaySolution(h_hrank, h_arank, csr->nodes);
 
@@ -338,6 +374,11 @@ void RunTests(Info<VertexId, SizeT, Value> *info)
     cudaDeviceSynchronize();
     cpu_timer.Stop();
     info->info["postprocess_time"] = cpu_timer.ElapsedMillis();
+
+    if (num_errors > 0)
+        return util::GRError(cudaErrorUnknown,
+            "HITS ranks differ from the CPU reference", __FILE__, __LINE__);
+    return cudaSuccess;
 }
 
 /******************************************************************************
@@ -361,10 +402,7 @@ int main_(CommandLineArgs *args)
     cpu_timer2.Stop();
     info->info["load_time"] = cpu_timer2.ElapsedMillis();
 
-    // TODO: add a CPU Reference algorithm,
-    // before that, quick_mode always on.
-    info->info["quick_mode"] = true;
-    RunTests<VertexId, SizeT, Value>(info);
+    cudaError_t retval = RunTests<VertexId, SizeT, Value>(info);
     cpu_timer.Stop();
     info->info["total_time"] = cpu_timer.ElapsedMillis();
 
@@ -374,7 +412,7 @@ int main_(CommandLineArgs *args)
     }
 
     info->CollectInfo();  // collected all the info and put into JSON mObject
-    return 0;
+    return retval;
 }
 
 template <
@@ -28,6 +28,7 @@
 #include <gunrock/app/pr/pr_enactor.cuh>
 #include <gunrock/app/pr/pr_problem.cuh>
 #include <gunrock/app/pr/pr_functor.cuh>
+#include <gunrock/app/pr/pr_host.cuh>
 
 // Operator includes
 #include <gunrock/oprtr/advance/kernel.cuh>
@@ -107,6 +108,12 @@ void Usage()
         "                          total_queued, search_depth and barrier duty.\n"
         "                          (a relative indicator of load imbalance.)\n"
         "[--quick]                 Skip the CPU reference validation process.\n"
+        "[--edge-list-ref]         Also run the edge-list CPU push PageRank.\n"
+        "[--hilbert-order]         Order that edge list along a Hilbert curve.\n"
+        "[--segmented-ref]         Also run the cache-blocked CPU pull PageRank.\n"
+        "[--segment-bytes=<bytes>] Cache budget of one CSR segment (Default: 1MB).\n"
+        "[--ppr-batch=<k>]         Also run k CPU personalized PageRanks, seeds\n"
+        "                          spread over the IDs, batched and one by one.\n"
         "[--disable-size-check]    Disable frontier queue size check.\n"
         "[--grid-size=<grid size>] Maximum allowed grid size setting.\n"
         "[--queue-sizing=<factor>] Allocates a frontier queue sized at: \n"
@@ -122,6 +129,8 @@ void Usage()
         "                          Choose partitioner (Default use random).\n"
         "[--delta=<delta>]         Delta for PageRank (Default 0.85f).\n"
         "[--error=<error>]         Error threshold for PageRank (Default 0.01f).\n"
+        "[--largest-cc]            Load only the largest connected component of\n"
+        "                          a market graph, found while parsing.\n"
         "[--quiet]                 No output (unless --json is specified).\n"
         "[--json]                  Output JSON-format statistics to STDOUT.\n"
         "[--jsonfile=<name>]       Output JSON-format statistics to file <name>\n"
@@ -508,6 +517,11 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
     bool        undirected          = info->info["undirected"       ].get_bool ();
     bool        quiet_mode          = info->info["quiet_mode"       ].get_bool ();
     bool        quick_mode          = info->info["quick_mode"       ].get_bool ();
+    bool        edge_list_ref       = info->info["edge_list_ref"    ].get_bool ();
+    bool        hilbert_order       = info->info["hilbert_order"    ].get_bool ();
+    bool        segmented_ref       = info->info["segmented_ref"    ].get_bool ();
+    int         segment_bytes       = info->info["segment_bytes"    ].get_int  ();
+    int         ppr_batch           = info->info["ppr_batch"        ].get_int  ();
     bool        stream_from_host    = info->info["stream_from_host" ].get_bool ();
     int         max_grid_size       = info->info["max_grid_size"    ].get_int  ();
     int         num_gpus            = info->info["num_gpus"         ].get_int  ();
@@ -538,6 +552,7 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
 
     CpuTimer    cpu_timer;
     cudaError_t retval              = cudaSuccess;
+    SizeT       cpu_ref_errors      = 0;  // disagreements of the extra CPU runs
 
     cpu_timer.Start();
     json_spirit::mArray device_list = info->info["device_list"].get_array();
@@ -791,6 +806,144 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
                 printf("INCORRECT : vertex %lld does not appear in result\n", (long long)v);
             error_count ++;
         }
+        // the CPU power iterations stop once no rank moves by more than
+        // error, which leaves each within about error / (1 - delta) per unit
+        // of initial rank it holds of the fixed point; the GPU is as close
+        double init_rank = NORMALIZED ? 1.0 / graph->nodes : 1.0;
+        if (edge_list_ref)
+        {
+            EdgeList<VertexId, SizeT, Value> edge_list;
+            Value *edge_list_rank = new Value[graph->nodes];
+            CpuTimer edge_list_timer;
+            edge_list.FromCsr(*graph,
+                hilbert_order ? HILBERT_ORDER : SOURCE_ORDER);
+            edge_list_timer.Start();
+            SizeT edge_list_iterations = HostPageRankPush(
+                edge_list, edge_list_rank, delta, error,
+                (SizeT)max_iteration, NORMALIZED);
+            edge_list_timer.Stop();
+            double edge_list_max_diff = 0;
+            SizeT  edge_list_errors   = 0;
+            for (VertexId v = 0; v < graph->nodes; v++)
+            {
+                double diff = fabs(edge_list_rank[v] - unorder_rank[v]);
+                if (diff > edge_list_max_diff) edge_list_max_diff = diff;
+                if (diff > 2 * error / (1 - delta) *
+                    std::max(edge_list_rank[v] / init_rank, 1.0))
+                    edge_list_errors ++;
+            }
+            info -> info["edge_list_pr_time"  ] = edge_list_timer.ElapsedMillis();
+            info -> info["edge_list_pr_errors"] = (int64_t)edge_list_errors;
+            cpu_ref_errors += edge_list_errors;
+            if (!quiet_mode)
+                printf("Edge-list CPU PR finished in %lf msec, %lld iterations,"
+                    " max diff to GPU = %.8le, %lld errors\n",
+                    edge_list_timer.ElapsedMillis(),
+                    (long long)edge_list_iterations, edge_list_max_diff,
+                    (long long)edge_list_errors);
+            delete[] edge_list_rank; edge_list_rank = NULL;
+        }
+        if (segmented_ref)
+        {
+            SegmentedCsr<VertexId, SizeT, Value> in_edges;
+            SizeT *out_degrees    = new SizeT[graph->nodes];
+            Value *segmented_rank = new Value[graph->nodes];
+            CpuTimer segmented_timer;
+            in_edges.FromCsr(*graph, true, segment_bytes);
+            for (VertexId v = 0; v < graph->nodes; v++)
+                out_degrees[v] = graph->row_offsets[v+1] - graph->row_offsets[v];
+            segmented_timer.Start();
+            SizeT segmented_iterations = HostPageRankPull(
+                in_edges, out_degrees, segmented_rank, delta, error,
+                (SizeT)max_iteration, NORMALIZED);
+            segmented_timer.Stop();
+            double segmented_max_diff = 0;
+            SizeT  segmented_errors   = 0;
+            for (VertexId v = 0; v < graph->nodes; v++)
+            {
+                double diff = fabs(segmented_rank[v] - unorder_rank[v]);
+                if (diff > segmented_max_diff) segmented_max_diff = diff;
+                if (diff > 2 * error / (1 - delta) *
+                    std::max(segmented_rank[v] / init_rank, 1.0))
+                    segmented_errors ++;
+            }
+            info -> info["segmented_pr_time"  ] = segmented_timer.ElapsedMillis();
+            info -> info["segmented_pr_errors"] = (int64_t)segmented_errors;
+            cpu_ref_errors += segmented_errors;
+            if (!quiet_mode)
+                printf("Segmented CPU PR finished in %lf msec, %lld iterations,"
+                    " %lld segments, max diff to GPU = %.8le, %lld errors\n",
+                    segmented_timer.ElapsedMillis(),
+                    (long long)segmented_iterations,
+                    (long long)in_edges.num_segments, segmented_max_diff,
+                    (long long)segmented_errors);
+            delete[] out_degrees   ; out_degrees    = NULL;
+            delete[] segmented_rank; segmented_rank = NULL;
+        }
+        if (ppr_batch > 0)
+        {
+            typedef Coo<VertexId, Value> EdgeTupleType;
+            Csr<VertexId, SizeT, Value> csc(false);
+            if (!undirected)
+                csc.template CsrToCsc<EdgeTupleType>(csc, *graph);
+            const Csr<VertexId, SizeT, Value> &in_graph = undirected ? *graph : csc;
+            SizeT    *out_degrees  = new SizeT   [graph->nodes];
+            SizeT    *seed_offsets = new SizeT   [ppr_batch + 1];
+            VertexId *seeds        = new VertexId[ppr_batch];
+            Value    *batch_ranks  = new Value   [(size_t)graph->nodes * ppr_batch];
+            Value    *single_rank  = new Value   [graph->nodes];
+            CpuTimer  batch_timer, single_timer;
+            for (VertexId v = 0; v < graph->nodes; v++)
+                out_degrees[v] = graph->row_offsets[v+1] - graph->row_offsets[v];
+            for (int c = 0; c <= ppr_batch; c++)
+            {
+                seed_offsets[c] = c;
+                if (c < ppr_batch)
+                    seeds[c] = (VertexId)((long long)graph->nodes * c / ppr_batch);
+            }
+            batch_timer.Start();
+            SizeT batch_iterations = HostBatchedPersonalizedPageRank(
+                in_graph, out_degrees, ppr_batch, seed_offsets, seeds,
+                batch_ranks, (Value)delta, (Value)error, (SizeT)max_iteration);
+            batch_timer.Stop();
+
+            // a column run one by one takes the same steps, up to rounding,
+            // so the two stop at most one step apart, and the step that
+            // stopped the shorter run moved the ranks by at most error (L1)
+            double ppr_max_diff = 0;
+            SizeT  ppr_errors   = 0;
+            single_timer.Start();
+            for (int c = 0; c < ppr_batch; c++)
+            {
+                HostPersonalizedPageRank(in_graph, out_degrees, seeds[c],
+                    single_rank, (Value)delta, (Value)error, (SizeT)max_iteration);
+                for (VertexId v = 0; v < graph->nodes; v++)
+                {
+                    double diff = fabs(single_rank[v] -
+                        batch_ranks[(size_t)v * ppr_batch + c]);
+                    if (diff > ppr_max_diff) ppr_max_diff = diff;
+                    if (diff > error + 1e-6) ppr_errors ++;
+                }
+            }
+            single_timer.Stop();
+            info -> info["ppr_batch_time" ] = batch_timer .ElapsedMillis();
+            info -> info["ppr_single_time"] = single_timer.ElapsedMillis();
+            info -> info["ppr_batch_errors"] = (int64_t)ppr_errors;
+            cpu_ref_errors += ppr_errors;
+            if (!quiet_mode)
+                printf("Batched CPU PPR of %d seeds finished in %lf msec, %lld"
+                    " iterations (%lf msec one by one), max diff = %.8le,"
+                    " %lld errors\n",
+                    ppr_batch, batch_timer.ElapsedMillis(),
+                    (long long)batch_iterations, single_timer.ElapsedMillis(),
+                    ppr_max_diff, (long long)ppr_errors);
+            delete[] out_degrees ; out_degrees  = NULL;
+            delete[] seed_offsets; seed_offsets = NULL;
+            delete[] seeds       ; seeds        = NULL;
+            delete[] batch_ranks ; batch_ranks  = NULL;
+            delete[] single_rank ; single_rank  = NULL;
+        }
+
         double ref_total_rank = 0;
         double max_diff       = 0;
         VertexId max_diff_pos = graph->nodes;
@@ -990,6 +1143,10 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
     cpu_timer.Stop();
     info->info["postprocess_time"] = cpu_timer.ElapsedMillis();
 
+    if (retval == cudaSuccess && cpu_ref_errors > 0)
+        retval = util::GRError(cudaErrorUnknown,
+            "CPU PageRank runs disagree beyond their tolerance",
+            __FILE__, __LINE__);
     return retval;
 }
 
@@ -31,6 +31,7 @@
 #include <gunrock/app/salsa/salsa_enactor.cuh>
 #include <gunrock/app/salsa/salsa_problem.cuh>
 #include <gunrock/app/salsa/salsa_functor.cuh>
+#include <gunrock/app/salsa/salsa_host.cuh>
 
 // Operator includes
 #include <gunrock/oprtr/advance/kernel.cuh>
@@ -197,13 +198,27 @@ void ReferenceSALSA(
     //compute SALSA rank
     //
 
+    SegmentedCsr<VertexId, SizeT, Value> in_edges, out_edges;
+    SizeT *out_degrees = (SizeT*)malloc(sizeof(SizeT) * graph.nodes);
+    SizeT *in_degrees  = (SizeT*)malloc(sizeof(SizeT) * graph.nodes);
+    for (VertexId v = 0; v < graph.nodes; v++)
+    {
+        out_degrees[v] = graph.row_offsets[v+1] - graph.row_offsets[v];
+        in_degrees [v] = inv_graph.row_offsets[v+1] - inv_graph.row_offsets[v];
+    }
+    in_edges .FromCsr(graph, true );
+    out_edges.FromCsr(graph, false);
+
     CpuTimer cpu_timer;
     cpu_timer.Start();
-
+    HostSALSA(in_edges, out_edges, out_degrees, in_degrees,
+        hrank, arank, max_iter);
     cpu_timer.Stop();
+    free(out_degrees); out_degrees = NULL;
+    free(in_degrees ); in_degrees  = NULL;
     float elapsed = cpu_timer.ElapsedMillis();
 
-    if (!quiet) { printf("CPU BFS finished in %lf msec.\n", elapsed); }
+    if (!quiet) { printf("CPU SALSA finished in %lf msec.\n", elapsed); }
 }
 
 
@@ -386,9 +401,6 @@ int main_(CommandLineArgs *args)
     cpu_timer2.Stop();
     info->info["load_time"] = cpu_timer2.ElapsedMillis();
 
-    // TODO: add a CPU Reference SALSA algorithm.
-    // before that, quick_mode always on.
-    info->info["quick_mode"] = true;
     RunTests<VertexId, SizeT, Value>(info);
     cpu_timer.Stop();
     info->info["total_time"] = cpu_timer.ElapsedMillis();
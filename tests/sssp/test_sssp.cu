@@ -22,9 +22,12 @@
 #include <gunrock/util/test_utils.cuh>
 
 // SSSP includes
+#include <gunrock/app/queue_planner.cuh>
 #include <gunrock/app/sssp/sssp_enactor.cuh>
 #include <gunrock/app/sssp/sssp_problem.cuh>
 #include <gunrock/app/sssp/sssp_functor.cuh>
+#include <gunrock/app/sssp/sssp_host.cuh>
+#include <gunrock/graphio/kernelize.cuh>
 
 
 #include <gunrock/app/sample/sample_enactor.cuh>
@@ -94,10 +97,12 @@ void Usage()
         "[--disable-size-check]    Disable frontier queue size check.\n"
         "[--grid-size=<grid size>] Maximum allowed grid size setting.\n"
         "[--queue-sizing=<factor>] Allocates a frontier queue sized at: \n"
-        "                          (graph-edges * <factor>). (Default: 1.0)\n"
+        "                          (graph-edges * <factor>). (Default: planned\n"
+        "                          from the graph profile, at least 1.2)\n"
         "[--in-sizing=<in/out_queue_scale_factor>]\n"
         "                          Allocates a frontier queue sized at: \n"
-        "                          (graph-edges * <factor>). (Default: 1.0)\n"
+        "                          (graph-edges * <factor>). (Default: planned\n"
+        "                          from the graph profile)\n"
         "[--v]                     Print verbose per iteration debug info.\n"
         "[--iteration-num=<num>]   Number of runs to perform the test.\n"
         "[--traversal-mode=<0|1>]  Set traversal strategy, 0 for Load-Balanced\n"
@@ -106,6 +111,27 @@ void Usage()
         "[--partition-method=<random|biasrandom|clustered|metis>]\n"
         "                          Choose partitioner (Default use random).\n"
         "[--delta_factor=<factor>] Delta factor for delta-stepping SSSP.\n"
+        "[--random-edge-value]     Replace the input weights by synthetic ones.\n"
+        "[--weight-dist=<uniform|lognormal|degree>]\n"
+        "                          Distribution of the synthetic weights given\n"
+        "                          to edges without one (Default: uniform).\n"
+        "[--weight-min=<w>] [--weight-max=<w>]\n"
+        "                          Synthetic weight range (Default: 0 to 63).\n"
+        "[--weight-seed=<seed>]    Synthetic weight seed (Default: 0).\n"
+        "[--weight-sigma=<sigma>]  Shape of log-normal weights (Default: 1).\n"
+        "[--compact-weights[=<auto|uint8|uint16|bf16>]]\n"
+        "                          Store the weights as narrow codes; auto\n"
+        "                          only picks a lossless one (Default: auto).\n"
+        "                          A market graph's binary cache is then kept\n"
+        "                          apart, with narrow weights, as .cw.bin.\n"
+        "[--largest-cc]            Load only the largest connected component of\n"
+        "                          a market graph, found while parsing.\n"
+        "[--kernelize]             Fold pendant trees and degree-2 chains, run\n"
+        "                          on the remaining kernel, then expand;\n"
+        "                          with --undirected and without --mark-pred.\n"
+        "[--multi-source-ref]      Also run the CPU Dijkstra from the source\n"
+        "                          and 63 random ones, one per thread, and\n"
+        "                          check each against a single-source run.\n"
         "[--quiet]                 No output (unless --json is specified).\n"
         "[--json]                  Output JSON-format statistics to STDOUT.\n"
         "[--jsonfile=<name>]       Output JSON-format statistics to file <name>\n"
@@ -188,7 +214,7 @@ void ReferenceSssp(
         for (SizeT j = graph.row_offsets[i]; j < graph.row_offsets[i + 1]; ++j)
         {
             edges[j] = Edge(i, graph.column_indices[j]);
-            weight[j] = graph.edge_values[j];
+            weight[j] = graph.EdgeValue(j);
         }
     }
 
@@ -328,9 +354,11 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
     int      subqueue_latency       = info->info["subqueue_latency"  ].get_int ();
     int      fullqueue_latency      = info->info["fullqueue_latency" ].get_int ();
     int      makeout_latency        = info->info["makeout_latency"   ].get_int ();
-    if (max_queue_sizing < 1.2) max_queue_sizing=1.2;
-    if (max_in_sizing < 0) max_in_sizing = 1.0;
-    if (communicate_multipy > 1) max_in_sizing *= communicate_multipy;
+    bool     kernelize              = info->info["kernelize"         ].get_bool ()
+                                   && info->info["undirected"        ].get_bool ()
+                                   && !MARK_PREDECESSORS;
+    bool     plan_queue_sizing      = (max_queue_sizing < 0 || max_in_sizing < 0);
+    bool     multi_source_ref       = info->info["multi_source_ref"  ].get_bool ();
 
     CpuTimer    cpu_timer;
     cudaError_t retval              = cudaSuccess;
@@ -344,9 +372,44 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
     ContextPtr   *context = (ContextPtr*)  info->context;
     cudaStream_t *streams = (cudaStream_t*)info->streams;
 
+    // fold pendant trees and chains, keeping the source; a random source is
+    // drawn from the kernel instead
+    graphio::Kernelization<VertexId, SizeT, Value> kernelization;
+    Csr<VertexId, SizeT, Value> kernel_graph(false);
+    Csr<VertexId, SizeT, Value> *run_graph = graph;
+    if (kernelize)
+    {
+        kernelization.Build(*graph, kernel_graph,
+            src_type == "random2" ? NULL : &src,
+            src_type == "random2" ? 0 : 1, true, quiet_mode);
+        run_graph = &kernel_graph;
+        info -> info["kernel_nodes"] = (int64_t)kernel_graph.nodes;
+        info -> info["kernel_edges"] = (int64_t)kernel_graph.edges;
+    }
+
+    // size queues from the graph profile; the partition is not known yet,
+    // so assume a random one. The BFS level profile underestimates the
+    // re-relaxations of label-correcting SSSP, hence the 1.2 floor
+    QueuePlanner<VertexId, SizeT, Value> queue_planner;
+    if (plan_queue_sizing)
+    {
+        queue_planner.Plan(*run_graph, num_gpus, NULL,
+            (src_type == "random2" || kernelize) ? -1 : src);
+        if (max_queue_sizing  < 0) max_queue_sizing  = queue_planner.queue_sizing;
+        if (max_queue_sizing1 < 0) max_queue_sizing1 = queue_planner.queue_sizing1;
+        if (max_in_sizing     < 0) max_in_sizing     = queue_planner.in_sizing;
+        if (!quiet_mode)
+            printf("Planned queue sizing: %lf, %lf, in sizing: %lf\n",
+                max_queue_sizing, max_queue_sizing1, max_in_sizing);
+    }
+    if (max_queue_sizing < 1.2) max_queue_sizing=1.2;
+    if (communicate_multipy > 1) max_in_sizing *= communicate_multipy;
+
     // Allocate host-side array (for both reference and GPU-computed results)
     Value    *reference_labels      = new Value[graph->nodes];
     Value    *h_labels              = new Value[graph->nodes];
+    Value    *h_kernel_labels       = kernelize ?
+        new Value[run_graph->nodes + 1] : h_labels;
     Value    *reference_check_label = (quick_mode) ? NULL : reference_labels;
     VertexId *reference_preds       = MARK_PREDECESSORS ? new VertexId[graph->nodes] : NULL;
     VertexId *h_preds               = MARK_PREDECESSORS ? new VertexId[graph->nodes] : NULL;
@@ -365,7 +428,7 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
     Problem *problem = new Problem;
     if (retval = util::GRError(problem->Init(
         stream_from_host,
-        graph,
+        run_graph,
         NULL,
         num_gpus,
         gpu_idx,
@@ -379,6 +442,19 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
         "SSSP Problem Init failed", __FILE__, __LINE__))
         return retval;
 
+    if (plan_queue_sizing && num_gpus > 1)
+    {
+        // refine frontier queue factors with the actual partition
+        double in_sizing = queue_planner.in_sizing;
+        queue_planner.Plan(*run_graph, num_gpus, problem -> partition_tables[0],
+            (src_type == "random2" || kernelize) ? -1 : src);
+        queue_planner.in_sizing = in_sizing;
+        if (info -> info["max_queue_sizing" ].get_real() < 0)
+            max_queue_sizing  = std::max(queue_planner.queue_sizing, 1.2);
+        if (info -> info["max_queue_sizing1"].get_real() < 0)
+            max_queue_sizing1 = queue_planner.queue_sizing1;
+    }
+
     // Allocate SSSP enactor map
     Enactor* enactor = new Enactor(
         num_gpus, gpu_idx, instrument, debug, size_check);
@@ -428,14 +504,16 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
             bool src_valid = false;
             while (!src_valid)
             {
-                src = rand() % graph -> nodes;
-                if (graph -> row_offsets[src] != graph -> row_offsets[src+1])
+                src = rand() % run_graph -> nodes;
+                if (run_graph -> row_offsets[src] != run_graph -> row_offsets[src+1])
                     src_valid = true;
             }
+            if (kernelize) src = kernelization.original_ids[src];
         }
+        VertexId run_src = kernelize ? kernelization.kernel_ids[src] : src;
 
         if (retval = util::GRError(problem->Reset(
-            src, enactor->GetFrontierType(),
+            run_src, enactor->GetFrontierType(),
             max_queue_sizing, max_queue_sizing1),
             "SSSP Problem Data Reset Failed", __FILE__, __LINE__))
             return retval;
@@ -458,7 +536,7 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
             printf("__________________________\n"); fflush(stdout);
         }
         cpu_timer.Start();
-        if (retval = util::GRError(enactor->Enact(src, traversal_mode),
+        if (retval = util::GRError(enactor->Enact(run_src, traversal_mode),
             "SSSP Problem Enact Failed", __FILE__, __LINE__))
             return retval;
         cpu_timer.Stop();
@@ -477,6 +555,13 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
         }
     }
     total_elapsed /= iterations;
+    if (plan_queue_sizing)
+    {
+        json_spirit::mObject queue_plan;
+        queue_planner.ToJson(queue_plan);
+        queue_planner.RecordActual(problem, queue_plan);
+        info -> info["queue_plan"] = queue_plan;
+    }
     info -> info["process_times"] = process_times;
     info -> info["min_process_time"] = min_elapsed;
     info -> info["max_process_time"] = max_elapsed;
@@ -492,13 +577,56 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
             src,
             quiet_mode);
         if (!quiet_mode) { printf("\n"); }
+
+        if (multi_source_ref)
+        {
+            // the source's column against the reference, the others
+            // against the single-source host Dijkstra
+            int       num_sources = graph -> nodes < 64 ? graph -> nodes : 64;
+            VertexId *sources     = new VertexId[num_sources];
+            Value    *distances   = new Value[(SizeT)num_sources * graph -> nodes];
+            Value    *host_labels = new Value[graph -> nodes];
+            CpuTimer  host_timer;
+            sources[0] = src;
+            for (int i = 1; i < num_sources; i++)
+                sources[i] = rand() % graph -> nodes;
+            host_timer.Start();
+            app::sssp::HostMultiSourceSSSP(*graph, sources, num_sources, distances);
+            host_timer.Stop();
+            SizeT num_errors = 0;
+            for (int i = 0; i < num_sources; i++)
+            {
+                Value *column = distances + (SizeT)i * graph -> nodes;
+                if (i > 0)
+                    app::sssp::HostSSSP(*graph, sources[i], host_labels);
+                for (SizeT v = 0; v < graph -> nodes; v++)
+                {
+                    Value ref_label = (i > 0) ? host_labels[v] :
+                        (reference_check_label[v] == -1) ?
+                        util::MaxValue<Value>() : reference_check_label[v];
+                    if (column[v] != ref_label) num_errors ++;
+                }
+            }
+            info -> info["multi_source_sssp_time"  ] = host_timer.ElapsedMillis();
+            info -> info["multi_source_sssp_errors"] = (int64_t)num_errors;
+            if (!quiet_mode)
+                printf("Multi-source CPU SSSP from %d sources finished in "
+                    "%lf msec: %lld errors\n", num_sources,
+                    host_timer.ElapsedMillis(), (long long)num_errors);
+            delete[] sources    ; sources     = NULL;
+            delete[] distances  ; distances   = NULL;
+            delete[] host_labels; host_labels = NULL;
+        }
     }
 
     cpu_timer.Start();
     // Copy out results
-    if (retval = util::GRError(problem->Extract(h_labels, h_preds),
+    if (retval = util::GRError(problem->Extract(h_kernel_labels, h_preds),
         "SSSP Problem Data Extraction Failed", __FILE__, __LINE__))
         return retval;
+    if (kernelize)
+        kernelization.ExpandDistances(
+            h_kernel_labels, h_labels, util::MaxValue<Value>());
 
     if (!quick_mode) {
         for (SizeT i = 0; i < graph->nodes; i++)
@@ -615,6 +743,7 @@ cudaError_t RunTests(Info<VertexId, SizeT, Value> *info)
         delete   problem         ; problem          = NULL;
     }
     if (reference_labels) {delete[] reference_labels; reference_labels = NULL;}
+    if (kernelize       ) {delete[] h_kernel_labels ; h_kernel_labels  = NULL;}
     if (h_labels        ) {delete[] h_labels        ; h_labels         = NULL;}
     if (reference_preds ) {delete[] reference_preds ; reference_preds  = NULL;}
     if (h_preds         ) {delete[] h_preds         ; h_preds          = NULL;}
@@ -29,6 +29,7 @@
 #include <gunrock/app/wtf/wtf_enactor.cuh>
 #include <gunrock/app/wtf/wtf_problem.cuh>
 #include <gunrock/app/wtf/wtf_functor.cuh>
+#include <gunrock/app/pr/pr_host.cuh>
 
 // Operator includes
 #include <gunrock/oprtr/advance/kernel.cuh>
@@ -112,6 +113,7 @@ void Usage()
         "                          total_queued, search_depth and barrier duty.\n"
         "                          (a relative indicator of load imbalance.)\n"
         "[--quick]                 Skip the CPU reference validation process.\n"
+        "[--segmented-ref]         Use the cache-blocked CPU PageRank in the reference.\n"
         "[--mark-pred]             Keep both label info and predecessor info.\n"
         "[--disable-size-check]    Disable frontier queue size check.\n"
         "[--grid-size=<grid size>] Maximum allowed grid size setting.\n"
@@ -168,6 +170,8 @@ void DisplaySolution(VertexId *node_id, Value *rank, SizeT nodes)
  * @param[in] delta Delta value for computing PageRank score
  * @param[in] alpha Parameter to adjust iteration number
  * @param[in] max_iter max iteration to go
+ * @param[in] segmented Whether to compute PageRank over a cache-blocked CSR
+ * instead of with Boost
  */
 // TODO: Boost PageRank cannot handle personalized pagerank, so currently the CPU
 // implementation gives incorrect answer. Need to find a CPU PPR implementation
@@ -182,7 +186,8 @@ void ReferenceWTF(
     Value                                   *rank,
     Value                                   delta,
     Value                                   alpha,
-    SizeT                                   max_iter)
+    SizeT                                   max_iter,
+    bool                                    segmented = false)
 {
     using namespace boost;
 
@@ -212,7 +217,24 @@ void ReferenceWTF(
     //remove_dangling_links(g);
 
     std::vector<Value> ranks(num_vertices(g));
-    page_rank(g, make_iterator_property_map(
+    if (segmented)
+    {
+        // Boost's page_rank: ranks start at 1 / n, each step gives
+        // (1 - 0.85) + 0.85 * pulled rank, for max_iter steps
+        // (n counts the vertices Boost's graph holds, up to the last with
+        // an edge)
+        SegmentedCsr<VertexId, SizeT, Value> in_edges;
+        std::vector<SizeT> out_degrees(graph.nodes);
+        in_edges.FromCsr(graph, true);
+        ranks.resize(graph.nodes);
+        for (VertexId v = 0; v < graph.nodes; v++)
+        {
+            out_degrees[v] = graph.row_offsets[v+1] - graph.row_offsets[v];
+            ranks[v] = (Value)1.0 / num_vertices(g);
+        }
+        pr::HostPageRankPull(in_edges, &out_degrees[0], &ranks[0],
+            (Value)0.85, (Value)-1, max_iter, false, true);
+    } else page_rank(g, make_iterator_property_map(
                   ranks.begin(), get(boost::vertex_index, g)),
               boost::graph::n_iterations(max_iter));
 
@@ -367,6 +389,7 @@ void RunTests(Info<VertexId, SizeT, Value> *info)
     int           partition_seed        = info->info["partition_seed"    ].get_int  (); 
     bool          quick_mode            = info->info["quick_mode"        ].get_bool ();
     bool          quiet_mode            = info->info["quiet_mode"        ].get_bool ();
+    bool          segmented_ref         = info->info["segmented_ref"     ].get_bool ();
     bool          stream_from_host      = info->info["stream_from_host"  ].get_bool ();
     bool          instrument            = info->info["instrument"        ].get_bool (); 
     bool          debug                 = info->info["debug_mode"        ].get_bool (); 
@@ -459,7 +482,8 @@ void RunTests(Info<VertexId, SizeT, Value> *info)
             reference_check,
             delta,
             alpha,
-            max_iter);
+            max_iter,
+            segmented_ref);
         if (!quiet_mode) printf("\n");
     }
 
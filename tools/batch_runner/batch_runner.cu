@@ -0,0 +1,829 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * batch_runner.cu
+ *
+ * @brief Runs a file of primitive jobs against one loaded graph, keeping
+ * the partitioned GPU problems of each configuration resident between jobs,
+ * and streams one JSON result line per job.
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+// Utilities and correctness-checking
+#include <gunrock/util/test_utils.cuh>
+
+// BFS includes
+#include <gunrock/app/bfs/bfs_enactor.cuh>
+#include <gunrock/app/bfs/bfs_problem.cuh>
+#include <gunrock/app/bfs/bfs_functor.cuh>
+#include <gunrock/app/bfs/bfs_host.cuh>
+
+// SSSP includes
+#include <gunrock/app/sssp/sssp_enactor.cuh>
+#include <gunrock/app/sssp/sssp_problem.cuh>
+#include <gunrock/app/sssp/sssp_functor.cuh>
+#include <gunrock/app/sssp/sssp_host.cuh>
+
+// Operator includes
+#include <gunrock/oprtr/advance/kernel.cuh>
+#include <gunrock/oprtr/filter/kernel.cuh>
+#include <gunrock/priority_queue/kernel.cuh>
+
+#include <moderngpu.cuh>
+
+using namespace gunrock;
+using namespace gunrock::app;
+using namespace gunrock::util;
+using namespace gunrock::oprtr;
+
+/******************************************************************************
+ * Housekeeping Routines
+ ******************************************************************************/
+void Usage()
+{
+    printf(
+        "batch_runner <graph-type> [graph-type-arguments] --jobs=<file>\n"
+        "Graph type and graph type arguments:\n"
+        "    market <matrix-market-file-name>\n"
+        "    rmat / rgg / smallworld, as in the test drivers\n\n"
+        "Job file, one job per line, '#' starts a comment:\n"
+        "    <primitive> <source> [<key>=<value> ...]\n"
+        "    primitive: bfs | sssp\n"
+        "    source:    vertex ID | random | largest\n"
+        "    keys:      iterations, mark-pred, idempotence (bfs),\n"
+        "               direction-optimized, do-a, do-b (bfs),\n"
+        "               delta-factor (sssp), traversal-mode, queue-sizing,\n"
+        "               queue-sizing1, validate\n"
+        "    Keys not given take their values from the command line.\n"
+        "    A random source is drawn among the vertices with out-edges;\n"
+        "    such jobs fail on a graph without edges.\n\n"
+        "Optional arguments:\n"
+        "[--undirected]            Treat the graph as undirected (symmetric).\n"
+        "[--max-sessions=<n>]      GPU problems kept resident at once; the\n"
+        "                          least recently used is released first\n"
+        "                          (Default: 2).\n"
+        "[--results=<name>]        Write the per-job JSON lines to file <name>\n"
+        "                          instead of STDOUT.\n"
+        "[--src-seed=<seed>]       Seed of the random sources.\n"
+        "[--validate]              Check every job against the CPU BFS or\n"
+        "                          Dijkstra; mismatches fail the job.\n"
+        "[--device=<device_index>] Set GPU(s) for testing (Default: 0).\n"
+        "[--partition-method=<random|biasrandom|clustered|metis>]\n"
+        "                          Choose partitioner (Default use random).\n"
+        "[--quiet]                 No output except the JSON lines.\n"
+        "[--json]                  Output JSON-format statistics to STDOUT.\n"
+        "[--jsonfile=<name>]       Output JSON-format statistics to file <name>\n"
+    );
+}
+
+/**
+ * @brief One line of the job file.
+ */
+struct BatchJob
+{
+    int                                line;
+    std::string                        primitive;
+    std::string                        source;
+    std::map<std::string, std::string> params;
+
+    std::string GetStr(const std::string &key, const std::string &def) const
+    {
+        std::map<std::string, std::string>::const_iterator it = params.find(key);
+        return it == params.end() ? def : it -> second;
+    }
+
+    double GetReal(const std::string &key, double def) const
+    {
+        std::map<std::string, std::string>::const_iterator it = params.find(key);
+        return it == params.end() ? def : strtod(it -> second.c_str(), NULL);
+    }
+
+    long long GetInt(const std::string &key, long long def) const
+    {
+        std::map<std::string, std::string>::const_iterator it = params.find(key);
+        return it == params.end() ? def : strtoll(it -> second.c_str(), NULL, 10);
+    }
+
+    bool GetBool(const std::string &key, bool def) const
+    {
+        std::map<std::string, std::string>::const_iterator it = params.find(key);
+        if (it == params.end()) return def;
+        return it -> second == "" || it -> second == "1" || it -> second == "true";
+    }
+};
+
+/**
+ * @brief Reads the job file.
+ *
+ * \return Number of malformed lines, which are reported and skipped.
+ */
+int ReadJobs(const char *file_name, std::vector<BatchJob> &jobs)
+{
+    std::ifstream input(file_name);
+    if (!input.is_open())
+    {
+        fprintf(stderr, "Cannot open job file %s\n", file_name);
+        return -1;
+    }
+
+    int num_errors = 0;
+    int line_num   = 0;
+    std::string line;
+    while (std::getline(input, line))
+    {
+        line_num ++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+
+        std::istringstream tokens(line);
+        BatchJob job;
+        job.line = line_num;
+        if (!(tokens >> job.primitive)) continue;  // blank line
+        if (!(tokens >> job.source) ||
+            (job.primitive != "bfs" && job.primitive != "sssp"))
+        {
+            fprintf(stderr, "%s:%d: expected <bfs|sssp> <source> ...\n",
+                file_name, line_num);
+            num_errors ++;
+            continue;
+        }
+        std::string param;
+        while (tokens >> param)
+        {
+            size_t eq = param.find('=');
+            if (eq == std::string::npos) job.params[param] = "";
+            else job.params[param.substr(0, eq)] = param.substr(eq + 1);
+        }
+        jobs.push_back(job);
+    }
+    return num_errors;
+}
+
+/**
+ * @brief Resident problem and enactor of one primitive configuration.
+ * Problem::Init (partitioning and the upload to the GPUs) is paid once per
+ * session; each job only resets and enacts.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+struct BatchSession
+{
+    long long last_used;
+
+    BatchSession() : last_used(0) {}
+    virtual ~BatchSession() {}
+
+    /**
+     * @brief Runs iterations rounds from src and records the result.
+     */
+    virtual cudaError_t Run(
+        VertexId src, int iterations, const BatchJob &job,
+        json_spirit::mObject &result) = 0;
+    virtual cudaError_t Release() = 0;
+};
+
+/**
+ * @brief Number of labels differing from the host reference, reading
+ * negative labels as unreached on both sides.
+ */
+template <typename Label, typename SizeT>
+SizeT CountLabelErrors(
+    const Label *labels,
+    const Label *ref_labels,
+    SizeT        nodes)
+{
+    SizeT num_errors = 0;
+    for (SizeT v = 0; v < nodes; v++)
+    {
+        Label label     = labels    [v] < 0 ? util::MaxValue<Label>() : labels    [v];
+        Label ref_label = ref_labels[v] < 0 ? util::MaxValue<Label>() : ref_labels[v];
+        if (label != ref_label) num_errors ++;
+    }
+    return num_errors;
+}
+
+/**
+ * @brief Summarizes the labels of a job, i.e. the hop or path lengths
+ * from its source.
+ */
+template <typename Label, typename SizeT>
+void SummarizeLabels(
+    const Label          *labels,
+    SizeT                 nodes,
+    json_spirit::mObject &result)
+{
+    long long num_reached = 0;
+    Label     max_label   = 0;
+    for (SizeT v = 0; v < nodes; v++)
+    {
+        if (labels[v] < 0 || labels[v] == util::MaxValue<Label>()) continue;
+        num_reached ++;
+        if (labels[v] > max_label) max_label = labels[v];
+    }
+    result["num_reached"] = (int64_t)num_reached;
+    result["max_label"  ] = (int64_t)max_label;
+}
+
+template <
+    typename VertexId,
+    typename SizeT,
+    typename Value,
+    bool     MARK_PREDECESSORS,
+    bool     ENABLE_IDEMPOTENCE>
+struct BFSSession : BatchSession<VertexId, SizeT, Value>
+{
+    typedef bfs::BFSProblem<VertexId, SizeT, Value,
+        MARK_PREDECESSORS, ENABLE_IDEMPOTENCE> Problem;
+    typedef bfs::BFSEnactor<Problem> Enactor;
+
+    Info<VertexId, SizeT, Value> *info;
+    Problem     *problem;
+    Enactor     *enactor;
+    std::string  traversal_mode;
+    double       max_queue_sizing;
+    double       max_queue_sizing1;
+    VertexId    *h_labels;
+    VertexId    *h_preds;
+
+    BFSSession() :
+        info     (NULL),
+        problem  (NULL),
+        enactor  (NULL),
+        h_labels (NULL),
+        h_preds  (NULL)
+    {
+    }
+
+    cudaError_t Init(
+        Info<VertexId, SizeT, Value> *info,
+        int                          *gpu_idx,
+        const BatchJob               &job)
+    {
+        cudaError_t retval = cudaSuccess;
+        Csr<VertexId, SizeT, Value> *graph     = info -> csr_ptr;
+        Csr<VertexId, SizeT, Value> *inv_graph = info -> csc_ptr;
+        int  num_gpus            = info -> info["num_gpus"].get_int();
+        bool direction_optimized = job.GetBool("direction-optimized",
+            info -> info["direction_optimized"].get_bool());
+        bool undirected          = info -> info["undirected"].get_bool();
+
+        this -> info      = info;
+        traversal_mode    = job.GetStr("traversal-mode",
+            info -> info["traversal_mode"].get_str());
+        max_queue_sizing  = job.GetReal("queue-sizing",
+            info -> info["max_queue_sizing" ].get_real());
+        max_queue_sizing1 = job.GetReal("queue-sizing1",
+            info -> info["max_queue_sizing1"].get_real());
+        double max_in_sizing = info -> info["max_in_sizing"].get_real();
+
+        problem = new Problem(direction_optimized, undirected);
+        if (retval = util::GRError(problem -> Init(
+            info -> info["stream_from_host"].get_bool(),
+            graph,
+            inv_graph,
+            num_gpus,
+            gpu_idx,
+            info -> info["partition_method"].get_str(),
+            (cudaStream_t*)info -> streams,
+            max_queue_sizing,
+            max_in_sizing,
+            info -> info["partition_factor"].get_real(),
+            info -> info["partition_seed"  ].get_int ()),
+            "BFS Problem Init failed", __FILE__, __LINE__)) return retval;
+
+        enactor = new Enactor(num_gpus, gpu_idx,
+            info -> info["instrument"].get_bool(),
+            info -> info["debug_mode"].get_bool(),
+            info -> info["size_check"].get_bool(),
+            direction_optimized);
+        if (retval = util::GRError(enactor -> Init(
+            (ContextPtr*)info -> context, problem,
+            info -> info["max_grid_size"].get_int(), traversal_mode),
+            "BFS Enactor Init failed", __FILE__, __LINE__)) return retval;
+
+        h_labels = new VertexId[graph -> nodes];
+        if (MARK_PREDECESSORS) h_preds = new VertexId[graph -> nodes];
+        return retval;
+    }
+
+    cudaError_t Run(
+        VertexId src, int iterations, const BatchJob &job,
+        json_spirit::mObject &result)
+    {
+        cudaError_t retval = cudaSuccess;
+        enactor -> alpha = job.GetReal("alpha", info -> info["alpha"].get_real());
+        enactor -> beta  = job.GetReal("beta" , info -> info["beta" ].get_real());
+        enactor -> do_a  = job.GetReal("do-a" , info -> info["do_a" ].get_real());
+        enactor -> do_b  = job.GetReal("do-b" , info -> info["do_b" ].get_real());
+
+        CpuTimer cpu_timer;
+        json_spirit::mArray process_times;
+        double total_elapsed = 0;
+        for (int iter = 0; iter < iterations; iter++)
+        {
+            if (retval = util::GRError(problem -> Reset(
+                src, enactor -> GetFrontierType(),
+                max_queue_sizing, max_queue_sizing1),
+                "BFS Problem Reset failed", __FILE__, __LINE__)) return retval;
+            if (retval = util::GRError(enactor -> Reset(),
+                "BFS Enactor Reset failed", __FILE__, __LINE__)) return retval;
+
+            cpu_timer.Start();
+            if (retval = util::GRError(enactor -> Enact(src, traversal_mode),
+                "BFS Enact failed", __FILE__, __LINE__)) return retval;
+            cpu_timer.Stop();
+            total_elapsed += cpu_timer.ElapsedMillis();
+            process_times.push_back(cpu_timer.ElapsedMillis());
+        }
+
+        if (retval = util::GRError(problem -> Extract(h_labels, h_preds),
+            "BFS Problem Extraction failed", __FILE__, __LINE__)) return retval;
+        SummarizeLabels(h_labels, info -> csr_ptr -> nodes, result);
+        if (job.GetBool("validate", info -> info["batch_validate"].get_bool()))
+        {
+            Csr<VertexId, SizeT, Value> *graph = info -> csr_ptr;
+            VertexId *ref_labels = new VertexId[graph -> nodes];
+            bfs::HostVertexSubsetBFS(*graph,
+                info -> info["undirected"].get_bool() ? NULL : info -> csc_ptr,
+                src, ref_labels);
+            result["errors"] = (int64_t)CountLabelErrors(
+                h_labels, ref_labels, graph -> nodes);
+            delete[] ref_labels; ref_labels = NULL;
+        }
+        result["elapsed"      ] = total_elapsed / iterations;
+        result["process_times"] = process_times;
+        result["search_depth" ] =
+            (int64_t)enactor -> enactor_stats -> iteration;
+        return retval;
+    }
+
+    cudaError_t Release()
+    {
+        cudaError_t retval = cudaSuccess;
+        if (enactor)
+        {
+            if (retval = util::GRError(enactor -> Release(),
+                "BFS Enactor Release failed", __FILE__, __LINE__))
+                return retval;
+            delete enactor; enactor = NULL;
+        }
+        if (problem)
+        {
+            if (retval = util::GRError(problem -> Release(),
+                "BFS Problem Release failed", __FILE__, __LINE__))
+                return retval;
+            delete problem; problem = NULL;
+        }
+        if (h_labels) { delete[] h_labels; h_labels = NULL; }
+        if (h_preds ) { delete[] h_preds ; h_preds  = NULL; }
+        return retval;
+    }
+};
+
+template <
+    typename VertexId,
+    typename SizeT,
+    typename Value,
+    bool     MARK_PREDECESSORS>
+struct SSSPSession : BatchSession<VertexId, SizeT, Value>
+{
+    typedef sssp::SSSPProblem<VertexId, SizeT, Value,
+        MARK_PREDECESSORS> Problem;
+    typedef sssp::SSSPEnactor<Problem> Enactor;
+
+    Info<VertexId, SizeT, Value> *info;
+    Problem     *problem;
+    Enactor     *enactor;
+    std::string  traversal_mode;
+    double       max_queue_sizing;
+    double       max_queue_sizing1;
+    Value       *h_labels;
+    VertexId    *h_preds;
+
+    SSSPSession() :
+        info     (NULL),
+        problem  (NULL),
+        enactor  (NULL),
+        h_labels (NULL),
+        h_preds  (NULL)
+    {
+    }
+
+    cudaError_t Init(
+        Info<VertexId, SizeT, Value> *info,
+        int                          *gpu_idx,
+        const BatchJob               &job)
+    {
+        cudaError_t retval = cudaSuccess;
+        Csr<VertexId, SizeT, Value> *graph = info -> csr_ptr;
+        int num_gpus = info -> info["num_gpus"].get_int();
+
+        this -> info      = info;
+        traversal_mode    = job.GetStr("traversal-mode",
+            info -> info["traversal_mode"].get_str());
+        max_queue_sizing  = job.GetReal("queue-sizing",
+            info -> info["max_queue_sizing" ].get_real());
+        max_queue_sizing1 = job.GetReal("queue-sizing1",
+            info -> info["max_queue_sizing1"].get_real());
+        double max_in_sizing = info -> info["max_in_sizing"].get_real();
+        if (max_queue_sizing < 1.2) max_queue_sizing = 1.2;
+        if (max_in_sizing    < 0  ) max_in_sizing    = 1.0;
+
+        problem = new Problem;
+        if (retval = util::GRError(problem -> Init(
+            info -> info["stream_from_host"].get_bool(),
+            graph,
+            NULL,
+            num_gpus,
+            gpu_idx,
+            info -> info["partition_method"].get_str(),
+            (cudaStream_t*)info -> streams,
+            (int)job.GetInt("delta-factor",
+                info -> info["delta_factor"].get_int()),
+            max_queue_sizing,
+            max_in_sizing,
+            info -> info["partition_factor"].get_real(),
+            info -> info["partition_seed"  ].get_int ()),
+            "SSSP Problem Init failed", __FILE__, __LINE__)) return retval;
+
+        enactor = new Enactor(num_gpus, gpu_idx,
+            info -> info["instrument"].get_bool(),
+            info -> info["debug_mode"].get_bool(),
+            info -> info["size_check"].get_bool());
+        if (retval = util::GRError(enactor -> Init(
+            (ContextPtr*)info -> context, problem,
+            info -> info["max_grid_size"].get_int(), traversal_mode),
+            "SSSP Enactor Init failed", __FILE__, __LINE__)) return retval;
+
+        h_labels = new Value[graph -> nodes];
+        if (MARK_PREDECESSORS) h_preds = new VertexId[graph -> nodes];
+        return retval;
+    }
+
+    cudaError_t Run(
+        VertexId src, int iterations, const BatchJob &job,
+        json_spirit::mObject &result)
+    {
+        cudaError_t retval = cudaSuccess;
+        CpuTimer cpu_timer;
+        json_spirit::mArray process_times;
+        double total_elapsed = 0;
+        for (int iter = 0; iter < iterations; iter++)
+        {
+            if (retval = util::GRError(problem -> Reset(
+                src, enactor -> GetFrontierType(),
+                max_queue_sizing, max_queue_sizing1),
+                "SSSP Problem Data Reset Failed", __FILE__, __LINE__))
+                return retval;
+            if (retval = util::GRError(enactor -> Reset(),
+                "SSSP Enactor Reset failed", __FILE__, __LINE__))
+                return retval;
+
+            cpu_timer.Start();
+            if (retval = util::GRError(enactor -> Enact(src, traversal_mode),
+                "SSSP Problem Enact Failed", __FILE__, __LINE__))
+                return retval;
+            cpu_timer.Stop();
+            total_elapsed += cpu_timer.ElapsedMillis();
+            process_times.push_back(cpu_timer.ElapsedMillis());
+        }
+
+        if (retval = util::GRError(problem -> Extract(h_labels, h_preds),
+            "SSSP Problem Data Extraction Failed", __FILE__, __LINE__))
+            return retval;
+        SummarizeLabels(h_labels, info -> csr_ptr -> nodes, result);
+        if (job.GetBool("validate", info -> info["batch_validate"].get_bool()))
+        {
+            Csr<VertexId, SizeT, Value> *graph = info -> csr_ptr;
+            Value *ref_labels = new Value[graph -> nodes];
+            sssp::HostSSSP(*graph, src, ref_labels);
+            result["errors"] = (int64_t)CountLabelErrors(
+                h_labels, ref_labels, graph -> nodes);
+            delete[] ref_labels; ref_labels = NULL;
+        }
+        result["elapsed"      ] = total_elapsed / iterations;
+        result["process_times"] = process_times;
+        result["search_depth" ] =
+            (int64_t)enactor -> enactor_stats -> iteration;
+        return retval;
+    }
+
+    cudaError_t Release()
+    {
+        cudaError_t retval = cudaSuccess;
+        if (enactor)
+        {
+            if (retval = util::GRError(enactor -> Release(),
+                "SSSP Enactor Release failed", __FILE__, __LINE__))
+                return retval;
+            delete enactor; enactor = NULL;
+        }
+        if (problem)
+        {
+            if (retval = util::GRError(problem -> Release(),
+                "SSSP Problem Release failed", __FILE__, __LINE__))
+                return retval;
+            delete problem; problem = NULL;
+        }
+        if (h_labels) { delete[] h_labels; h_labels = NULL; }
+        if (h_preds ) { delete[] h_preds ; h_preds  = NULL; }
+        return retval;
+    }
+};
+
+/**
+ * @brief Key of the session a job runs in: everything fixed at
+ * Problem::Init or Enactor::Init time, or kept by the session for its
+ * resets. Jobs sharing a key must build identical sessions.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+std::string SessionKey(
+    const BatchJob               &job,
+    Info<VertexId, SizeT, Value> *info)
+{
+    std::ostringstream key;
+    key << job.primitive
+        << " mark-pred="      << job.GetBool("mark-pred",
+            info -> info["mark_predecessors"].get_bool())
+        << " traversal-mode=" << job.GetStr ("traversal-mode",
+            info -> info["traversal_mode"].get_str())
+        << " queue-sizing="   << job.GetReal("queue-sizing",
+            info -> info["max_queue_sizing" ].get_real())
+        << " queue-sizing1="  << job.GetReal("queue-sizing1",
+            info -> info["max_queue_sizing1"].get_real())
+        << " in-sizing="      << info -> info["max_in_sizing"].get_real();
+    if (job.primitive == "bfs")
+        key << " idempotence="         << job.GetBool("idempotence",
+                info -> info["idempotent"].get_bool())
+            << " direction-optimized=" << job.GetBool("direction-optimized",
+                info -> info["direction_optimized"].get_bool());
+    else
+        key << " delta-factor="        << job.GetInt ("delta-factor",
+                info -> info["delta_factor"].get_int());
+    return key.str();
+}
+
+/**
+ * @brief Allocates and initializes a session of type SessionT.
+ *
+ * \return The session, or NULL if its initialization failed.
+ */
+template <typename SessionT, typename VertexId, typename SizeT, typename Value>
+BatchSession<VertexId, SizeT, Value>* InitSession(
+    const BatchJob               &job,
+    Info<VertexId, SizeT, Value> *info,
+    int                          *gpu_idx)
+{
+    SessionT *session = new SessionT;
+    if (session -> Init(info, gpu_idx, job))
+    {
+        session -> Release();
+        delete session; session = NULL;
+    }
+    return session;
+}
+
+/**
+ * @brief Allocates and initializes the session of a job, with the
+ * template flags picked from the job's parameters.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+BatchSession<VertexId, SizeT, Value>* NewSession(
+    const BatchJob               &job,
+    Info<VertexId, SizeT, Value> *info,
+    int                          *gpu_idx)
+{
+    bool mark_pred = job.GetBool("mark-pred",
+        info -> info["mark_predecessors"].get_bool());
+
+    if (job.primitive == "bfs")
+    {
+        bool idempotence = job.GetBool("idempotence",
+            info -> info["idempotent"].get_bool());
+        if (mark_pred && idempotence)
+            return InitSession<BFSSession<VertexId, SizeT, Value, true , true > >
+                (job, info, gpu_idx);
+        if (mark_pred)
+            return InitSession<BFSSession<VertexId, SizeT, Value, true , false> >
+                (job, info, gpu_idx);
+        if (idempotence)
+            return InitSession<BFSSession<VertexId, SizeT, Value, false, true > >
+                (job, info, gpu_idx);
+        return InitSession<BFSSession<VertexId, SizeT, Value, false, false> >
+            (job, info, gpu_idx);
+    }
+    if (mark_pred)
+        return InitSession<SSSPSession<VertexId, SizeT, Value, true > >
+            (job, info, gpu_idx);
+    return InitSession<SSSPSession<VertexId, SizeT, Value, false> >
+        (job, info, gpu_idx);
+}
+
+/**
+ * @brief Picks the source of a job: a vertex ID, a random vertex with
+ * out-edges, or the vertex of largest degree.
+ *
+ * \return The source, -1 for a random source on a graph without edges.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+VertexId JobSource(
+    const BatchJob              &job,
+    Csr<VertexId, SizeT, Value> &graph)
+{
+    if (job.source == "largest")
+    {
+        int max_degree = 0;
+        return graph.GetNodeWithHighestDegree(max_degree);
+    }
+    if (job.source == "random")
+    {
+        if (graph.edges == 0) return -1;  // no vertex has out-edges
+        VertexId src = 0;
+        do {
+            src = rand() % graph.nodes;
+        } while (graph.row_offsets[src] == graph.row_offsets[src+1]);
+        return src;
+    }
+    return (VertexId)strtoll(job.source.c_str(), NULL, 10);
+}
+
+template <
+    typename VertexId,
+    typename SizeT,
+    typename Value>
+int RunBatch(Info<VertexId, SizeT, Value> *info, CommandLineArgs &args)
+{
+    typedef BatchSession<VertexId, SizeT, Value> Session;
+    typedef std::map<std::string, Session*>      SessionMap;
+
+    Csr<VertexId, SizeT, Value> &graph = *(info -> csr_ptr);
+    bool        quiet_mode   = info -> info["quiet_mode"].get_bool();
+    int         num_gpus     = info -> info["num_gpus"  ].get_int ();
+    int         iterations   = info -> info["num_iteration"].get_int();
+    int         max_sessions = 2;
+    std::string job_file     = "";
+    std::string results_file = "";
+    int         src_seed     = info -> info["source_seed"].get_int();
+    args.GetCmdLineArgument("jobs"        , job_file    );
+    args.GetCmdLineArgument("results"     , results_file);
+    args.GetCmdLineArgument("max-sessions", max_sessions);
+    info -> info["batch_validate"] = args.CheckCmdLineFlag("validate");
+    if (max_sessions < 1) max_sessions = 1;
+    if (src_seed == -1) src_seed = time(NULL);
+    srand(src_seed);
+
+    std::vector<BatchJob> jobs;
+    int num_bad_lines = ReadJobs(job_file.c_str(), jobs);
+    if (num_bad_lines < 0) return 1;
+
+    json_spirit::mArray device_list = info -> info["device_list"].get_array();
+    int *gpu_idx = new int[num_gpus];
+    for (int i = 0; i < num_gpus; i++) gpu_idx[i] = device_list[i].get_int();
+
+    std::ofstream results_out;
+    if (results_file != "") results_out.open(results_file.c_str());
+    std::ostream &out = results_file != "" ?
+        (std::ostream&)results_out : std::cout;
+
+    SessionMap sessions;
+    int num_failed = 0;
+    CpuTimer cpu_timer, job_timer;
+    cpu_timer.Start();
+    for (size_t j = 0; j < jobs.size(); j++)
+    {
+        const BatchJob &job = jobs[j];
+        json_spirit::mObject result;
+        std::string key = SessionKey(job, info);
+        VertexId    src = JobSource(job, graph);
+        int         job_iterations = job.GetInt("iterations", iterations);
+        if (job_iterations < 1) job_iterations = 1;
+
+        result["job"       ] = (int64_t)j;
+        result["line"      ] = job.line;
+        result["primitive" ] = job.primitive;
+        result["session"   ] = key;
+        result["source"    ] = (int64_t)src;
+        result["iterations"] = job_iterations;
+
+        job_timer.Start();
+        typename SessionMap::iterator it = sessions.find(key);
+        bool reused = (it != sessions.end());
+        if (!reused)
+        {
+            // release the least recently used session to make room
+            while ((int)sessions.size() >= max_sessions)
+            {
+                typename SessionMap::iterator lru = sessions.begin();
+                for (it = sessions.begin(); it != sessions.end(); it++)
+                    if (it -> second -> last_used < lru -> second -> last_used)
+                        lru = it;
+                lru -> second -> Release();
+                delete lru -> second;
+                sessions.erase(lru);
+            }
+            Session *session = NewSession(job, info, gpu_idx);
+            it = sessions.insert(std::make_pair(key, session)).first;
+        }
+        job_timer.Stop();
+        result["session_reused"] = reused;
+        result["setup_time"    ] = job_timer.ElapsedMillis();
+
+        cudaError_t retval = cudaSuccess;
+        if (it -> second == NULL || src < 0 || src >= graph.nodes)
+            retval = cudaErrorInvalidValue;
+        else
+        {
+            it -> second -> last_used = j;
+            retval = it -> second -> Run(src, job_iterations, job, result);
+            if (retval == cudaSuccess && result.count("errors") != 0 &&
+                result["errors"].get_int64() != 0)
+                num_failed ++;  // ran, but disagrees with the CPU reference
+        }
+        if (retval)
+        {
+            result["error"] = std::string(cudaGetErrorString(retval));
+            num_failed ++;
+            if (it -> second != NULL) it -> second -> Release();
+            delete it -> second;
+            sessions.erase(it);
+        }
+
+        json_spirit::write_stream(json_spirit::mValue(result), out);
+        out << std::endl;  // one line per job, flushed
+        if (!quiet_mode && results_file != "")
+            printf("job %d (line %d): %s, src = %lld, %s\n",
+                (int)j, job.line, key.c_str(), (long long)src,
+                retval ? "failed" : "done");
+    }
+    cpu_timer.Stop();
+
+    for (typename SessionMap::iterator it = sessions.begin();
+        it != sessions.end(); it++)
+    {
+        it -> second -> Release();
+        delete it -> second;
+    }
+    sessions.clear();
+    if (gpu_idx) { delete[] gpu_idx; gpu_idx = NULL; }
+
+    info -> info["batch_jobs"     ] = (int64_t)jobs.size();
+    info -> info["batch_failed"   ] = num_failed;
+    info -> info["batch_bad_lines"] = num_bad_lines;
+    info -> info["batch_time"     ] = cpu_timer.ElapsedMillis();
+    return num_failed > 0 ? 1 : 0;
+}
+
+/******************************************************************************
+* Main
+******************************************************************************/
+
+int main(int argc, char** argv)
+{
+    CommandLineArgs args(argc, argv);
+    int graph_args = argc - args.ParsedArgc() - 1;
+    if (argc < 2 || graph_args < 1 || args.CheckCmdLineFlag("help") ||
+        !args.CheckCmdLineFlag("jobs"))
+    {
+        Usage();
+        return 1;
+    }
+
+    typedef int VertexId;  // Use int as the vertex identifier
+    typedef int Value;     // Use int as the value type
+    typedef int SizeT;     // Use int as the graph size type
+
+    Csr<VertexId, SizeT, Value> csr(false);  // CSR graph we process on
+    Csr<VertexId, SizeT, Value> csc(false);  // CSC graph we process on
+    Info<VertexId, SizeT, Value> *info = new Info<VertexId, SizeT, Value>;
+
+    CpuTimer cpu_timer;
+    info->info["undirected"] = args.CheckCmdLineFlag("undirected");
+    info->info["edge_value"] = true;  // SSSP jobs need edge weights
+    cpu_timer.Start();
+    info->Init("Batch", args, csr, csc);  // load the graph once
+    cpu_timer.Stop();
+    info->info["load_time"] = cpu_timer.ElapsedMillis();
+
+    int retval = RunBatch<VertexId, SizeT, Value>(info, args);
+    info->CollectInfo();
+    delete info; info = NULL;
+    return retval;
+}
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
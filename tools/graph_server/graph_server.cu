@@ -0,0 +1,940 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * graph_server.cu
+ *
+ * @brief Resident graph server: maps a graph from its binary cache once,
+ * keeps the derived data (CSC, degrees, components) in memory, and answers
+ * BFS / SSSP / PPR / CC / reachability queries from many client processes
+ * over a local Unix socket. Queries that arrive together are queued, and
+ * consecutive queries of one type are computed as a batch: BFS sources
+ * share bit-parallel traversals, SSSP sources run one per thread, and
+ * identical queries are computed once. Answers go out in arrival order,
+ * through per-client buffers, so a slow reader does not hold up others.
+ */
+
+#include <stdio.h>
+#include <signal.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <sstream>
+#include <algorithm>
+
+// Utilities and graph loading
+#include <gunrock/util/test_utils.cuh>
+#include <gunrock/util/json_spirit_writer_template.h>
+#include <gunrock/csr.cuh>
+#include <gunrock/edge_list.cuh>
+#include <gunrock/graphio/market.cuh>
+
+// Host primitives
+#include <gunrock/app/bfs/bfs_host.cuh>
+#include <gunrock/app/sssp/sssp_host.cuh>
+#include <gunrock/app/pr/pr_host.cuh>
+#include <gunrock/app/cc/cc_host.cuh>
+#include <gunrock/app/reach/reach_index.cuh>
+
+#include "graph_server.h"
+
+using namespace gunrock;
+using namespace gunrock::util;
+
+/******************************************************************************
+ * Housekeeping Routines
+ ******************************************************************************/
+void Usage()
+{
+    printf(
+        "graph_server market <matrix-market-file-name> [--undirected]\n"
+        "    Serve the graph; its binary caches are built on first use.\n"
+        "graph_server --connect=<socket>\n"
+        "             --query=<bfs|sssp|ppr|cc|reach|stats|shutdown>\n"
+        "    Send one query and print a summary of the answer.\n\n"
+        "Optional arguments:\n"
+        "[--socket=<path>]         Server socket (Default: /tmp/gunrock.sock).\n"
+        "[--max-batch=<n>]         Most queries computed as one batch\n"
+        "                          (Default: 256).\n"
+        "[--batch-bytes=<bytes>]   Memory for the labels of one BFS / SSSP\n"
+        "                          batch, or the ranks of one PPR batch\n"
+        "                          (Default: 1 GB).\n"
+        "[--src=<vertex>]          Client: source or seed of the query.\n"
+        "[--dst=<vertex>]          Client: target of a reach query.\n"
+        "[--repeat=<n>]            Client: send the query n times.\n"
+        "[--pipeline]              Client: send every query before reading\n"
+        "                          the answers, and check they come back in\n"
+        "                          order; --query may then list several\n"
+        "                          types, e.g. --query=bfs,cc,sssp,ppr.\n"
+        "[--quiet]                 No output other than errors.\n"
+    );
+}
+
+volatile sig_atomic_t g_running = 1;
+
+void StopServer(int signal_number)
+{
+    g_running = 0;
+}
+
+/**
+ * @brief Latencies in power-of-two microsecond buckets: bucket b counts
+ * latencies in [2^b, 2^(b+1)) us, bucket 0 also those below 1 us.
+ */
+struct LatencyHistogram
+{
+    static const int NUM_BUCKETS = 32;
+    long long counts[NUM_BUCKETS];
+    long long count;
+    double    sum_ms;
+    double    max_ms;
+
+    LatencyHistogram() : count(0), sum_ms(0), max_ms(0)
+    {
+        for (int b = 0; b < NUM_BUCKETS; b++) counts[b] = 0;
+    }
+
+    void Add(double ms)
+    {
+        int    bucket = 0;
+        double us     = ms * 1000;
+        while (bucket < NUM_BUCKETS - 1 && us >= 2) { us /= 2; bucket ++; }
+        counts[bucket] ++;
+        count  ++;
+        sum_ms += ms;
+        if (ms > max_ms) max_ms = ms;
+    }
+
+    /**
+     * @brief Upper bound of the bucket holding quantile q, in ms.
+     */
+    double Quantile(double q) const
+    {
+        long long rank = (long long)(q * count), seen = 0;
+        for (int b = 0; b < NUM_BUCKETS; b++)
+        {
+            seen += counts[b];
+            if (seen > rank) return (double)(1ll << (b + 1)) / 1000;
+        }
+        return max_ms;
+    }
+
+    void ToJson(json_spirit::mObject &json) const
+    {
+        json_spirit::mArray buckets;
+        for (int b = 0; b < NUM_BUCKETS; b++)
+        {
+            if (counts[b] == 0) continue;
+            json_spirit::mObject bucket;
+            bucket["below_us"] = (int64_t)(1ll << (b + 1));
+            bucket["count"   ] = (int64_t)counts[b];
+            buckets.push_back(bucket);
+        }
+        json["count"    ] = (int64_t)count;
+        json["mean_ms"  ] = count > 0 ? sum_ms / count : 0.0;
+        json["max_ms"   ] = max_ms;
+        json["p50_ms"   ] = Quantile(0.50);
+        json["p99_ms"   ] = Quantile(0.99);
+        json["histogram"] = buckets;
+    }
+};
+
+/**
+ * @brief The served graph and everything derived from it.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+struct ResidentGraph
+{
+    Csr<VertexId, SizeT, Value>  csr;            // mapped out-edges
+    Csr<VertexId, SizeT, Value>  csc;            // mapped in-edges, if directed
+    Csr<VertexId, SizeT, Value> *inv_graph;      // &csc, or NULL if symmetric
+    SizeT                       *out_degrees;
+    VertexId                    *component_ids;  // computed on first CC query
+    SizeT                        num_components;
+    app::reach::ReachIndex<VertexId, SizeT> reach_index;  // on first reach query
+    bool                         has_reach_index;
+    char                         cache_name[256];  // of csr
+
+    ResidentGraph() :
+        inv_graph      (NULL),
+        out_degrees    (NULL),
+        component_ids  (NULL),
+        num_components (0),
+        has_reach_index(false)
+    {
+        cache_name[0] = '\0';
+    }
+
+    ~ResidentGraph()
+    {
+        if (out_degrees  ) { free(out_degrees  ); out_degrees   = NULL; }
+        if (component_ids) { free(component_ids); component_ids = NULL; }
+    }
+
+    /**
+     * @brief Maps the binary cache of a MARKET file, building it first
+     * if it does not exist yet.
+     */
+    static bool MapCache(
+        char *file_name, bool undirected, bool reversed,
+        Csr<VertexId, SizeT, Value> &graph, bool quiet)
+    {
+        char cache_name[256];
+        graphio::MarketBinaryFileName<true, VertexId, SizeT, Value>(
+            file_name, undirected, reversed, cache_name);
+        if (access(cache_name, R_OK) != 0)
+        {
+            Csr<VertexId, SizeT, Value> temp(false);
+            if (graphio::BuildMarketGraph<true>(file_name, cache_name, temp,
+                undirected, reversed, quiet) != 0) return false;
+        }
+        if (!graph.template FromCsrMapped<true>(cache_name, quiet))
+        {
+            fprintf(stderr, "Cannot map %s\n", cache_name);
+            return false;
+        }
+        graph.SortRows();  // old caches carry no sorted-rows flag
+        return true;
+    }
+
+    bool Load(char *file_name, bool undirected, bool quiet)
+    {
+        graphio::MarketBinaryFileName<true, VertexId, SizeT, Value>(
+            file_name, undirected, false, cache_name);
+        if (!MapCache(file_name, undirected, false, csr, quiet)) return false;
+        if (!undirected)
+        {
+            if (!MapCache(file_name, false, true, csc, quiet)) return false;
+            inv_graph = &csc;
+        }
+
+        out_degrees = (SizeT*) malloc(sizeof(SizeT) * csr.nodes);
+        #pragma omp parallel for
+        for (SizeT v = 0; v < csr.nodes; v++)
+            out_degrees[v] = csr.row_offsets[v+1] - csr.row_offsets[v];
+        return true;
+    }
+
+    void ComputeComponents()
+    {
+        if (component_ids != NULL) return;
+        EdgeList<VertexId, SizeT, Value> edge_list;
+        edge_list.FromCsr(csr);
+        component_ids  = (VertexId*) malloc(sizeof(VertexId) * csr.nodes);
+        num_components = app::cc::HostCC(edge_list, component_ids);
+    }
+
+    /**
+     * @brief Reads the reachability index saved next to the cache, or
+     * builds and saves it if there is none for this graph.
+     */
+    void PrepareReachIndex(bool quiet)
+    {
+        if (has_reach_index) return;
+        char index_name[256];
+        app::reach::ReachIndexFileName(cache_name, index_name);
+        if (reach_index.Load(index_name, csr.nodes, csr.edges) != 0)
+        {
+            reach_index.Build(csr, 5, 0, quiet);
+            if (reach_index.Save(index_name) != 0 && !quiet)
+                printf("Cannot write %s, the index is kept in memory only\n",
+                    index_name);
+        }
+        has_reach_index = true;
+    }
+};
+
+/**
+ * @brief A received query waiting in the queue.
+ */
+struct PendingQuery
+{
+    int             fd;
+    GrServerRequest request;
+    double          arrival;  // ms since the server started
+};
+
+template <typename VertexId, typename SizeT, typename Value>
+struct GraphServer
+{
+    ResidentGraph<VertexId, SizeT, Value> graph;
+    std::string              socket_path;
+    int                      listen_fd;
+    std::vector<int>         client_fds;
+    std::map<int, std::string> input_buffers;
+    std::map<int, std::string> output_buffers;  // answers not yet written
+    std::deque<PendingQuery> queue;
+    LatencyHistogram         histograms[GR_QUERY_REACH + 1];
+    long long                num_batches;
+    long long                num_batched_queries;
+    int                      max_batch;
+    size_t                   batch_bytes;
+    bool                     quiet;
+    CpuTimer                 timer;
+
+    GraphServer() :
+        listen_fd          (-1),
+        num_batches        (0),
+        num_batched_queries(0),
+        max_batch          (256),
+        batch_bytes        (1 << 30),
+        quiet              (false)
+    {
+        timer.Start();
+    }
+
+    bool Listen(const std::string &path)
+    {
+        struct sockaddr_un address;
+        socket_path = path;
+        unlink(path.c_str());
+        listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd < 0) return false;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        if (bind(listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+            listen(listen_fd, 128) != 0)
+        {
+            perror("Cannot listen on socket");
+            return false;
+        }
+        fcntl(listen_fd, F_SETFL, fcntl(listen_fd, F_GETFL) | O_NONBLOCK);
+        return true;
+    }
+
+    void CloseClient(int fd)
+    {
+        close(fd);
+        client_fds.erase(std::find(client_fds.begin(), client_fds.end(), fd));
+        input_buffers .erase(fd);
+        output_buffers.erase(fd);
+        // drop its queued queries, the fd number may be reused
+        std::deque<PendingQuery> kept;
+        for (size_t i = 0; i < queue.size(); i++)
+            if (queue[i].fd != fd) kept.push_back(queue[i]);
+        queue.swap(kept);
+    }
+
+    /**
+     * @brief Reads what a client sent and queues its complete requests.
+     *
+     * \return false if the client has gone.
+     */
+    bool ReadClient(int fd)
+    {
+        char buffer[4096];
+        ssize_t got = read(fd, buffer, sizeof(buffer));
+        if (got <= 0) return (got < 0 &&
+            (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK));
+
+        std::string &input = input_buffers[fd];
+        input.append(buffer, got);
+        size_t offset = 0;
+        while (input.size() - offset >= sizeof(GrServerRequest))
+        {
+            PendingQuery query;
+            query.fd      = fd;
+            query.arrival = timer.MillisSinceStart();
+            memcpy(&query.request, input.data() + offset, sizeof(GrServerRequest));
+            queue.push_back(query);
+            offset += sizeof(GrServerRequest);
+        }
+        input.erase(0, offset);
+        return true;
+    }
+
+    /**
+     * @brief Writes as much of a client's pending answers as its socket
+     * takes without blocking.
+     *
+     * \return false if the client has gone.
+     */
+    bool FlushClient(int fd)
+    {
+        std::string &output = output_buffers[fd];
+        size_t offset = 0;
+        while (offset < output.size())
+        {
+            ssize_t written = write(fd, output.data() + offset,
+                output.size() - offset);
+            if (written < 0 && errno == EINTR) continue;
+            if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            if (written <= 0) return false;
+            offset += written;
+        }
+        output.erase(0, offset);
+        return true;
+    }
+
+    /**
+     * @brief Queues the answer of one query on its client's buffer and
+     * writes what the socket takes; the rest goes out as the client reads.
+     */
+    void Respond(
+        const PendingQuery &query,
+        uint32_t            status,
+        uint32_t            value_type,
+        const void         *values,
+        size_t              num_values,
+        size_t              batch_size)
+    {
+        GrServerResponse response;
+        double latency = timer.MillisSinceStart() - query.arrival;
+        size_t value_size = (value_type == GR_VALUE_TEXT) ? 1 : 4;
+        uint32_t type = query.request.type;
+        memset(&response, 0, sizeof(response));
+        response.magic      = GR_SERVER_MAGIC;
+        response.status     = status;
+        response.request_id = query.request.request_id;
+        response.num_values = num_values;
+        response.value_type = value_type;
+        response.latency_ms = latency;
+        response.batch_size = batch_size;
+        if (status == GR_STATUS_OK && type <= GR_QUERY_REACH)
+            histograms[type].Add(latency);
+
+        std::string &output = output_buffers[query.fd];
+        output.append((const char*)&response, sizeof(response));
+        if (num_values > 0)
+            output.append((const char*)values, value_size * num_values);
+        // a client that has gone is noticed by the next poll
+        FlushClient(query.fd);
+    }
+
+    std::string StatsJson()
+    {
+        static const char* names[] = {
+            "", "bfs", "sssp", "ppr", "cc", "stats", "shutdown", "reach"};
+        json_spirit::mObject stats, latencies;
+        for (int type = GR_QUERY_BFS; type <= GR_QUERY_REACH; type++)
+        {
+            json_spirit::mObject histogram;
+            histograms[type].ToJson(histogram);
+            latencies[names[type]] = histogram;
+        }
+        stats["uptime_ms"      ] = timer.MillisSinceStart();
+        stats["num_vertices"   ] = (int64_t)graph.csr.nodes;
+        stats["num_edges"      ] = (int64_t)graph.csr.edges;
+        stats["num_clients"    ] = (int64_t)client_fds.size();
+        stats["num_batches"    ] = (int64_t)num_batches;
+        stats["mean_batch_size"] = num_batches > 0 ?
+            (double)num_batched_queries / num_batches : 0.0;
+        stats["latency"        ] = latencies;
+        std::ostringstream out;
+        json_spirit::write_stream(json_spirit::mValue(stats), out,
+            json_spirit::pretty_print);
+        return out.str();
+    }
+
+    /**
+     * @brief Most distinct sources of one BFS / SSSP / PPR batch: as many
+     * label or rank columns as fit in batch_bytes, and at most 64 BFS
+     * sources, the width of its masks. Other types have no limit.
+     */
+    size_t SourceCapacity(uint32_t type) const
+    {
+        size_t nodes = graph.csr.nodes > 0 ? graph.csr.nodes : 1;
+        size_t capacity = (size_t)-1, limit = (size_t)-1;
+        if (type == GR_QUERY_BFS)
+        {
+            capacity = batch_bytes / (sizeof(VertexId) * nodes);
+            limit    = 64;
+        } else if (type == GR_QUERY_SSSP)
+        {
+            capacity = batch_bytes / (sizeof(Value) * nodes);
+            limit    = 64;
+        } else if (type == GR_QUERY_PPR)
+        {
+            // ranks and rank shares
+            capacity = batch_bytes / (2 * sizeof(float) * nodes);
+            limit    = 256;
+        }
+        if (capacity < 1    ) capacity = 1;
+        if (capacity > limit) capacity = limit;
+        return capacity;
+    }
+
+    /**
+     * @brief Sorted distinct sources of a batch.
+     */
+    static std::vector<VertexId> DistinctSources(
+        const std::vector<PendingQuery> &queries)
+    {
+        std::vector<VertexId> sources;
+        for (size_t i = 0; i < queries.size(); i++)
+            sources.push_back(queries[i].request.source);
+        std::sort(sources.begin(), sources.end());
+        sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+        return sources;
+    }
+
+    /**
+     * @brief Runs a batch of BFS or SSSP queries, at most SourceCapacity
+     * distinct sources, as one multi-source run, and answers the queries
+     * in order.
+     */
+    template <typename Label>
+    void RunSourceQueries(
+        std::vector<PendingQuery> &queries,
+        bool                       is_bfs)
+    {
+        SizeT nodes = graph.csr.nodes;
+        std::vector<VertexId> sources = DistinctSources(queries);
+        int   num_sources = sources.size();
+        Label *labels = (Label*) malloc(sizeof(Label) * nodes * num_sources);
+        if (is_bfs)
+            app::bfs::HostMultiSourceBFS(graph.csr, graph.inv_graph,
+                &sources[0], num_sources, (VertexId*)labels);
+        else
+            app::sssp::HostMultiSourceSSSP(graph.csr,
+                &sources[0], num_sources, (Value*)labels);
+        for (size_t i = 0; i < queries.size(); i++)
+        {
+            size_t index = std::lower_bound(sources.begin(), sources.end(),
+                (VertexId)queries[i].request.source) - sources.begin();
+            Respond(queries[i], GR_STATUS_OK, GR_VALUE_INT32,
+                labels + index * nodes, nodes, queries.size());
+        }
+        free(labels); labels = NULL;
+    }
+
+    static bool SamePPRParameters(
+        const GrServerRequest &a, const GrServerRequest &b)
+    {
+        return a.delta == b.delta && a.error == b.error &&
+            a.max_iterations == b.max_iterations;
+    }
+
+    /**
+     * @brief Runs a batch of PPR queries, all with the same parameters and
+     * at most SourceCapacity distinct seeds, as one batched PageRank with a
+     * column per seed, and answers the queries in order.
+     */
+    void RunPPRQueries(std::vector<PendingQuery> &queries)
+    {
+        const Csr<VertexId, SizeT, Value> &in_graph =
+            graph.inv_graph == NULL ? graph.csr : *graph.inv_graph;
+        SizeT nodes = graph.csr.nodes;
+        const GrServerRequest &request = queries[0].request;
+        float    delta = request.delta > 0 ? request.delta : 0.85f;
+        float    error = request.error > 0 ? request.error : 1e-6f;
+        SizeT    max_iterations = request.max_iterations > 0 ?
+            request.max_iterations : 50;
+        std::vector<VertexId> sources = DistinctSources(queries);
+        int    num_sources = sources.size();
+        float *ranks = (float*) malloc(sizeof(float) * nodes * num_sources);
+        float *rank  = (float*) malloc(sizeof(float) * nodes);
+
+        std::vector<SizeT> seed_offsets(num_sources + 1);
+        for (int c = 0; c <= num_sources; c++) seed_offsets[c] = c;
+        app::pr::HostBatchedPersonalizedPageRank(in_graph,
+            graph.out_degrees, num_sources, &seed_offsets[0],
+            &sources[0], ranks, delta, error, max_iterations);
+
+        for (size_t i = 0; i < queries.size(); i++)
+        {
+            size_t index = std::lower_bound(sources.begin(), sources.end(),
+                (VertexId)queries[i].request.source) - sources.begin();
+            for (SizeT v = 0; v < nodes; v++)
+                rank[v] = ranks[(size_t)v * num_sources + index];
+            Respond(queries[i], GR_STATUS_OK, GR_VALUE_FLOAT32,
+                rank, nodes, queries.size());
+        }
+        free(ranks); ranks = NULL;
+        free(rank ); rank  = NULL;
+    }
+
+    /**
+     * @brief Answers reachability queries from the index, in parallel.
+     */
+    void RunReachQueries(std::vector<PendingQuery> &queries)
+    {
+        graph.PrepareReachIndex(quiet);
+        SizeT num_queries = queries.size();
+        std::vector<VertexId> sources(num_queries), targets(num_queries);
+        std::vector<char    > results(num_queries);
+        for (SizeT i = 0; i < num_queries; i++)
+        {
+            sources[i] = queries[i].request.source;
+            targets[i] = queries[i].request.target;
+        }
+        graph.reach_index.Reachable(num_queries,
+            &sources[0], &targets[0], &results[0]);
+        for (SizeT i = 0; i < num_queries; i++)
+        {
+            int32_t reached = results[i];
+            Respond(queries[i], GR_STATUS_OK, GR_VALUE_INT32,
+                &reached, 1, num_queries);
+        }
+    }
+
+    /**
+     * @brief Answers a run of consecutive queries of one type.
+     */
+    void RunBatch(std::vector<PendingQuery> &batch)
+    {
+        if (batch.empty()) return;
+        uint32_t type = batch[0].request.type;
+        num_batches ++;
+        num_batched_queries += batch.size();
+
+        if (type == GR_QUERY_BFS)
+            RunSourceQueries<VertexId>(batch, true);
+        else if (type == GR_QUERY_SSSP)
+            RunSourceQueries<Value>(batch, false);
+        else if (type == GR_QUERY_PPR)
+            RunPPRQueries(batch);
+        else if (type == GR_QUERY_REACH)
+            RunReachQueries(batch);
+        else if (type == GR_QUERY_CC)
+        {
+            graph.ComputeComponents();
+            for (size_t i = 0; i < batch.size(); i++)
+                Respond(batch[i], GR_STATUS_OK, GR_VALUE_INT32,
+                    graph.component_ids, graph.csr.nodes, batch.size());
+        }
+        else for (size_t i = 0; i < batch.size(); i++)
+        {
+            if (type == GR_QUERY_STATS)
+            {
+                std::string stats = StatsJson();
+                Respond(batch[i], GR_STATUS_OK, GR_VALUE_TEXT,
+                    stats.c_str(), stats.size(), 1);
+            } else {  // GR_QUERY_SHUTDOWN
+                Respond(batch[i], GR_STATUS_OK, GR_VALUE_NONE, NULL, 0, 1);
+                g_running = 0;
+            }
+        }
+        batch.clear();
+    }
+
+    /**
+     * @brief Takes up to max_batch queries off the queue and answers them
+     * in arrival order, which keeps every connection's answers in order.
+     * A batch is a run of consecutive queries of one type (and, for PPR,
+     * the same parameters) with at most SourceCapacity distinct sources;
+     * a query that does not fit ends the run, which is answered before it.
+     */
+    void ExecuteBatch()
+    {
+        std::vector<PendingQuery> batch;
+        std::set<VertexId>        batch_sources;
+        int num_taken = 0;
+        while (!queue.empty() && num_taken < max_batch)
+        {
+            PendingQuery query = queue.front();
+            const GrServerRequest &request = query.request;
+            queue.pop_front();
+            num_taken ++;
+            bool needs_source = request.type == GR_QUERY_BFS ||
+                request.type == GR_QUERY_SSSP || request.type == GR_QUERY_PPR ||
+                request.type == GR_QUERY_REACH;
+            bool needs_target = request.type == GR_QUERY_REACH;
+            if (request.magic != GR_SERVER_MAGIC ||
+                request.type < GR_QUERY_BFS || request.type > GR_QUERY_REACH ||
+                (needs_source && (request.source < 0 ||
+                    request.source >= graph.csr.nodes)) ||
+                (needs_target && (request.target < 0 ||
+                    request.target >= graph.csr.nodes)))
+            {
+                RunBatch(batch);
+                batch_sources.clear();
+                Respond(query, GR_STATUS_BAD_REQUEST, GR_VALUE_NONE, NULL, 0, 1);
+                continue;
+            }
+
+            if (!batch.empty())
+            {
+                const GrServerRequest &first = batch[0].request;
+                bool joins = request.type == first.type &&
+                    (request.type != GR_QUERY_PPR ||
+                        SamePPRParameters(request, first)) &&
+                    (batch_sources.count(request.source) != 0 ||
+                        batch_sources.size() < SourceCapacity(request.type));
+                if (!joins)
+                {
+                    RunBatch(batch);
+                    batch_sources.clear();
+                }
+            }
+            batch.push_back(query);
+            batch_sources.insert(request.source);
+        }
+        RunBatch(batch);
+    }
+
+    /**
+     * @brief Event loop: queries keep being read while any are readable;
+     * once input pauses, or max_batch queries are waiting, the queue is
+     * answered as one batch.
+     */
+    void Run()
+    {
+        while (g_running)
+        {
+            std::vector<struct pollfd> fds(client_fds.size() + 1);
+            fds[0].fd     = listen_fd;
+            fds[0].events = POLLIN;
+            for (size_t i = 0; i < client_fds.size(); i++)
+            {
+                bool pending = !output_buffers[client_fds[i]].empty();
+                fds[i+1].fd     = client_fds[i];
+                fds[i+1].events = POLLIN | (pending ? POLLOUT : 0);
+            }
+            int num_ready = poll(&fds[0], fds.size(), queue.empty() ? 1000 : 0);
+            if (num_ready < 0)
+            {
+                if (errno == EINTR) continue;
+                perror("poll failed");
+                break;
+            }
+
+            // batch once no new input comes in; writable sockets don't count
+            int num_inputs = 0;
+            for (size_t i = 0; i < fds.size(); i++)
+                if (fds[i].revents & (POLLIN | POLLHUP)) num_inputs ++;
+
+            if (fds[0].revents & POLLIN)
+            {
+                int fd;
+                while ((fd = accept(listen_fd, NULL, NULL)) >= 0)
+                {
+                    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                    client_fds.push_back(fd);
+                }
+            }
+            for (size_t i = 1; i < fds.size(); i++)
+            {
+                short revents = fds[i].revents;
+                bool  alive   = !(revents & (POLLERR | POLLNVAL));
+                if (revents == 0) continue;
+                if (alive && (revents & POLLOUT)) alive = FlushClient(fds[i].fd);
+                if (alive && (revents & POLLIN )) alive = ReadClient (fds[i].fd);
+                else if (revents & POLLHUP) alive = false;
+                if (!alive) CloseClient(fds[i].fd);
+            }
+
+            if (!queue.empty() && (num_inputs == 0 || (int)queue.size() >= max_batch))
+                ExecuteBatch();
+        }
+    }
+
+    void Release()
+    {
+        // answers still buffered get one more chance, without blocking
+        for (size_t i = 0; i < client_fds.size(); i++)
+            FlushClient(client_fds[i]);
+        while (!client_fds.empty()) CloseClient(client_fds.back());
+        if (listen_fd >= 0)
+        {
+            close(listen_fd); listen_fd = -1;
+            unlink(socket_path.c_str());
+        }
+    }
+};
+
+/**
+ * @brief Prints a summary of one answer.
+ */
+void PrintResponse(
+    const GrServerRequest  &request,
+    const GrServerResponse &response,
+    const void             *values)
+{
+    printf("request %lld: status %u, %llu values, %.3f ms, batch of %u\n",
+        (long long)response.request_id, response.status,
+        (unsigned long long)response.num_values, response.latency_ms,
+        response.batch_size);
+    if (response.value_type == GR_VALUE_TEXT)
+        printf("%s\n", (const char*)values);
+    else if (request.type == GR_QUERY_REACH && response.num_values == 1)
+        printf("  %lld %s %lld\n", (long long)request.source,
+            ((const int*)values)[0] ? "reaches" : "does not reach",
+            (long long)request.target);
+    else if (response.value_type == GR_VALUE_INT32)
+    {
+        const int *labels = (const int*)values;
+        long long num_reached = 0, max_label = 0;
+        for (uint64_t v = 0; v < response.num_values; v++)
+        {
+            if (labels[v] < 0 || labels[v] == util::MaxValue<int>()) continue;
+            num_reached ++;
+            if (labels[v] > max_label) max_label = labels[v];
+        }
+        printf("  %lld labeled, largest label %lld\n", num_reached, max_label);
+    }
+    else if (response.value_type == GR_VALUE_FLOAT32)
+    {
+        const float *ranks = (const float*)values;
+        uint64_t top = 0;
+        for (uint64_t v = 1; v < response.num_values; v++)
+            if (ranks[v] > ranks[top]) top = v;
+        if (response.num_values > 0)
+            printf("  top vertex %llu, rank %f\n",
+                (unsigned long long)top, ranks[top]);
+    }
+}
+
+/**
+ * @brief Client mode: sends the queries (repeat times) and prints a
+ * summary of each answer. With --pipeline every query is sent before the
+ * first answer is read, and the answers must come back in order.
+ *
+ * \return 0 on success, 1 on a connection error or an answer out of order.
+ */
+int RunClient(CommandLineArgs &args)
+{
+    std::string socket_path = "", query_list = "bfs";
+    long long   src    = 0, dst = 0;
+    int         repeat = 1;
+    bool        pipeline = args.CheckCmdLineFlag("pipeline");
+    bool        quiet    = args.CheckCmdLineFlag("quiet");
+    args.GetCmdLineArgument("connect", socket_path);
+    args.GetCmdLineArgument("query"  , query_list );
+    args.GetCmdLineArgument("src"    , src        );
+    args.GetCmdLineArgument("dst"    , dst        );
+    args.GetCmdLineArgument("repeat" , repeat     );
+
+    std::vector<uint32_t> types;
+    std::istringstream    queries(query_list);
+    std::string           query;
+    while (std::getline(queries, query, ','))
+    {
+        if      (query == "bfs"     ) types.push_back(GR_QUERY_BFS     );
+        else if (query == "sssp"    ) types.push_back(GR_QUERY_SSSP    );
+        else if (query == "ppr"     ) types.push_back(GR_QUERY_PPR     );
+        else if (query == "cc"      ) types.push_back(GR_QUERY_CC      );
+        else if (query == "reach"   ) types.push_back(GR_QUERY_REACH   );
+        else if (query == "stats"   ) types.push_back(GR_QUERY_STATS   );
+        else if (query == "shutdown") types.push_back(GR_QUERY_SHUTDOWN);
+        else
+        {
+            fprintf(stderr, "Unknown query %s\n", query.c_str());
+            return 1;
+        }
+    }
+    if (types.empty() || repeat < 1) return 0;
+
+    std::vector<GrServerRequest> requests(types.size() * repeat);
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        memset(&requests[i], 0, sizeof(GrServerRequest));
+        requests[i].magic      = GR_SERVER_MAGIC;
+        requests[i].type       = types[i % types.size()];
+        requests[i].request_id = i;
+        requests[i].source     = src;
+        requests[i].target     = dst;
+    }
+
+    int fd = GrServerConnect(socket_path.c_str());
+    if (fd < 0)
+    {
+        perror("Cannot connect to server");
+        return 1;
+    }
+    if (pipeline && GrServerWriteAll(fd, &requests[0],
+        sizeof(GrServerRequest) * requests.size()) != 0)
+    {
+        fprintf(stderr, "Connection lost\n");
+        close(fd);
+        return 1;
+    }
+    int num_out_of_order = 0;
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        GrServerResponse response;
+        void *values = NULL;
+        int   result = pipeline ?
+            GrServerReceive(fd, &response, &values) :
+            GrServerQuery  (fd, &requests[i], &response, &values);
+        if (result != 0)
+        {
+            fprintf(stderr, "Connection lost\n");
+            close(fd);
+            return 1;
+        }
+        if (response.request_id != requests[i].request_id)
+        {
+            fprintf(stderr, "Answer %lld out of order: request %lld expected\n",
+                (long long)response.request_id, (long long)requests[i].request_id);
+            num_out_of_order ++;
+        }
+        if (!quiet) PrintResponse(requests[i], response, values);
+        if (values) { free(values); values = NULL; }
+    }
+    close(fd);
+    return num_out_of_order > 0 ? 1 : 0;
+}
+
+/******************************************************************************
+* Main
+******************************************************************************/
+
+int main(int argc, char** argv)
+{
+    CommandLineArgs args(argc, argv);
+    if (args.CheckCmdLineFlag("help"))
+    {
+        Usage();
+        return 1;
+    }
+    if (args.CheckCmdLineFlag("connect")) return RunClient(args);
+
+    int graph_args = argc - args.ParsedArgc() - 1;
+    if (argc < 2 || graph_args < 2 || strcmp(args.GetCmdLineArgvGraphType(), "market") != 0)
+    {
+        Usage();
+        return 1;
+    }
+
+    typedef int VertexId;  // Use int as the vertex identifier
+    typedef int Value;     // Use int as the value type
+    typedef int SizeT;     // Use int as the graph size type
+
+    GraphServer<VertexId, SizeT, Value> server;
+    std::string socket_path = "/tmp/gunrock.sock";
+    long long   batch_bytes = server.batch_bytes;
+    server.quiet = args.CheckCmdLineFlag("quiet");
+    args.GetCmdLineArgument("socket"     , socket_path     );
+    args.GetCmdLineArgument("max-batch"  , server.max_batch);
+    args.GetCmdLineArgument("batch-bytes", batch_bytes     );
+    server.batch_bytes = batch_bytes;
+    if (server.max_batch < 1) server.max_batch = 1;
+
+    CpuTimer cpu_timer;
+    cpu_timer.Start();
+    if (!server.graph.Load(args.GetCmdLineArgvDataset(),
+        args.CheckCmdLineFlag("undirected"), server.quiet))
+        return 1;
+    cpu_timer.Stop();
+
+    signal(SIGINT , StopServer);
+    signal(SIGTERM, StopServer);
+    signal(SIGPIPE, SIG_IGN);
+    if (!server.Listen(socket_path)) return 1;
+    if (!server.quiet)
+        printf("Serving %lld vertices, %lld edges on %s (loaded in %.1f ms)\n",
+            (long long)server.graph.csr.nodes, (long long)server.graph.csr.edges,
+            socket_path.c_str(), cpu_timer.ElapsedMillis());
+
+    server.Run();
+    if (!server.quiet) printf("%s\n", server.StatsJson().c_str());
+    server.Release();
+    return 0;
+}
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
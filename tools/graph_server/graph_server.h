@@ -0,0 +1,188 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * graph_server.h
+ *
+ * @brief Wire protocol of the graph server and a small C client. A client
+ * writes fixed-size GrServerRequest records to the server's Unix socket
+ * and reads back, for each, a GrServerResponse followed by num_values
+ * values of value_type. Requests on one connection are answered in order.
+ * All fields are in host byte order; the socket is local.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define GR_SERVER_MAGIC 0x53524752u  // "GRSR"
+
+enum GrServerQueryType
+{
+    GR_QUERY_BFS      = 1,  // hop count from source, -1 if unreached
+    GR_QUERY_SSSP     = 2,  // distance from source, MaxValue if unreached
+    GR_QUERY_PPR      = 3,  // personalized PageRank of source
+    GR_QUERY_CC       = 4,  // component of every vertex (its smallest vertex)
+    GR_QUERY_STATS    = 5,  // latency histograms, as JSON text
+    GR_QUERY_SHUTDOWN = 6,  // stop the server after answering
+    GR_QUERY_REACH    = 7,  // 1 if source reaches target, 0 otherwise
+};
+
+enum GrServerStatus
+{
+    GR_STATUS_OK          = 0,
+    GR_STATUS_BAD_REQUEST = 1,  // bad magic, type, source or target
+};
+
+enum GrServerValueType
+{
+    GR_VALUE_NONE    = 0,
+    GR_VALUE_INT32   = 1,
+    GR_VALUE_FLOAT32 = 2,
+    GR_VALUE_TEXT    = 3,
+};
+
+struct GrServerRequest
+{
+    uint32_t magic;           // GR_SERVER_MAGIC
+    uint32_t type;            // GrServerQueryType
+    uint64_t request_id;      // echoed in the response
+    int64_t  source;          // BFS / SSSP source, PPR seed
+    float    delta;           // PPR damping factor, 0 for 0.85
+    float    error;           // PPR L1 tolerance, 0 for 1e-6
+    uint32_t max_iterations;  // PPR iteration limit, 0 for 50
+    uint32_t reserved;
+    int64_t  target;          // reachability target
+};
+
+struct GrServerResponse
+{
+    uint32_t magic;           // GR_SERVER_MAGIC
+    uint32_t status;          // GrServerStatus
+    uint64_t request_id;
+    uint64_t num_values;      // values following this header
+    uint32_t value_type;      // GrServerValueType
+    float    latency_ms;      // from arrival to answer, queueing included
+    uint32_t batch_size;      // queries computed together with this one
+    uint32_t reserved;
+};
+
+/**
+ * @brief Connects to the server's socket.
+ *
+ * \return Socket descriptor, or -1.
+ */
+static inline int GrServerConnect(const char *socket_path)
+{
+    struct sockaddr_un address;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socket_path, sizeof(address.sun_path) - 1);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static inline int GrServerWriteAll(int fd, const void *buffer, size_t size)
+{
+    const char *ptr = (const char*)buffer;
+    while (size > 0)
+    {
+        ssize_t written = write(fd, ptr, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return -1;
+        ptr  += written;
+        size -= written;
+    }
+    return 0;
+}
+
+static inline int GrServerReadAll(int fd, void *buffer, size_t size)
+{
+    char *ptr = (char*)buffer;
+    while (size > 0)
+    {
+        ssize_t got = read(fd, ptr, size);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return -1;
+        ptr  += got;
+        size -= got;
+    }
+    return 0;
+}
+
+/**
+ * @brief Reads the next answer on a connection.
+ *
+ * @param[in] fd Connected socket.
+ * @param[out] response Response header.
+ * @param[out] values Values, malloc'ed, to be freed by the caller; NULL if
+ * there are none.
+ *
+ * \return 0 on success, -1 on a socket error.
+ */
+static inline int GrServerReceive(
+    int                      fd,
+    struct GrServerResponse *response,
+    void                   **values)
+{
+    size_t value_size;
+    *values = NULL;
+    if (GrServerReadAll(fd, response, sizeof(*response)) != 0) return -1;
+    if (response -> num_values == 0) return 0;
+
+    value_size = (response -> value_type == GR_VALUE_TEXT) ? 1 : 4;
+    *values = malloc(value_size * response -> num_values + 1);
+    if (GrServerReadAll(fd, *values, value_size * response -> num_values) != 0)
+    {
+        free(*values); *values = NULL;
+        return -1;
+    }
+    ((char*)*values)[value_size * response -> num_values] = '\0';
+    return 0;
+}
+
+/**
+ * @brief Sends one request and waits for its answer.
+ *
+ * @param[in] fd Connected socket.
+ * @param[in] request Request; magic is filled in.
+ * @param[out] response Response header.
+ * @param[out] values Values, malloc'ed, to be freed by the caller; NULL if
+ * there are none.
+ *
+ * \return 0 on success, -1 on a socket error.
+ */
+static inline int GrServerQuery(
+    int                      fd,
+    struct GrServerRequest  *request,
+    struct GrServerResponse *response,
+    void                   **values)
+{
+    *values = NULL;
+    request -> magic = GR_SERVER_MAGIC;
+    if (GrServerWriteAll(fd, request, sizeof(*request)) != 0) return -1;
+    return GrServerReceive(fd, response, values);
+}
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,1005 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * graph_transform.cu
+ *
+ * @brief Converts and cleans graph files in one pass: the input is parsed
+ * in parallel into an edge list, the requested stages run over it in
+ * order, and the result is formatted in parallel and written once.
+ * Replaces the mtx_to_gr.py, gr_to_mtx_*.py, matrix2snap.py,
+ * remove_weights.py and associate_weights.py scripts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <omp.h>
+
+// Utilities and graph writers
+#include <gunrock/util/test_utils.cuh>
+#include <gunrock/util/sort_omp.cuh>
+#include <gunrock/util/host/compact.cuh>
+#include <gunrock/util/host/histogram.cuh>
+#include <gunrock/util/host/merge.cuh>
+#include <gunrock/util/host/segmented_sort.cuh>
+#include <gunrock/coo.cuh>
+#include <gunrock/csr.cuh>
+#include <gunrock/graphio/edge_weights.cuh>
+#include <gunrock/graphio/compressed.cuh>
+
+using namespace gunrock;
+using namespace gunrock::util;
+
+/******************************************************************************
+ * Housekeeping Routines
+ ******************************************************************************/
+void Usage()
+{
+    printf(
+        "graph_transform <input-file> <output-file> [--stages=<stage>,...]\n"
+        "graph_transform --check-primitives\n"
+        "    Checks the host parallel primitives against serial references.\n"
+        "File formats, from the extension or --from / --to:\n"
+        "    mtx   Matrix-Market coordinate, 1-based (symmetric inputs are\n"
+        "          read as both directions).\n"
+        "    gr    DIMACS shortest-path: p sp <n> <m> / a <u> <v> <w>, 1-based.\n"
+        "    snap  Edge list: <u> <v> [<w>], 0-based, # comments (.txt,\n"
+        "          .edges, .el).\n"
+        "    bin   Gunrock binary CSR, as read by Csr::FromCsr (output only;\n"
+        "          drops self-loops and duplicates, rounds weights).\n"
+        "Inputs may be gzip, bzip2 or zstd compressed (.gz, .bz2, .zst), or\n"
+        "a compressed tar archive holding <dir>/<dir>.mtx (SuiteSparse).\n\n"
+        "Stages, run in the given order:\n"
+        "    reverse            Swap the endpoints of every edge.\n"
+        "    symmetrize         Add the reverse of every edge.\n"
+        "    remove-self-loops  Drop edges (v, v).\n"
+        "    dedup              Sort edges, keep the lightest of duplicates.\n"
+        "    drop-weights       Forget the edge weights.\n"
+        "    weights            Assign synthetic weights (see below).\n"
+        "    largest-cc         Keep the largest weakly connected component.\n"
+        "    relabel            Renumber the vertices with edges 0..n-1.\n\n"
+        "Optional arguments:\n"
+        "[--from=<format>] [--to=<format>]\n"
+        "                          Override the format given by the extension.\n"
+        "[--relabel-order=<compact|degree>]\n"
+        "                          Keep the ID order, or number by decreasing\n"
+        "                          degree (Default: compact).\n"
+        "[--relabel-map=<file>]    Write \"old new\" vertex ID pairs.\n"
+        "[--weight-dist=<uniform|lognormal|degree>] [--weight-seed=<seed>]\n"
+        "[--weight-min=<w>] [--weight-max=<w>] [--weight-sigma=<sigma>]\n"
+        "                          Synthetic weights, as in the test drivers.\n"
+        "[--quiet]                 No output other than errors.\n"
+    );
+}
+
+typedef long long VertexT;  // vertex ID in the edge list
+typedef double    ValueT;   // edge weight in the edge list
+
+struct TransformEdge
+{
+    VertexT src;
+    VertexT dst;
+    ValueT  weight;
+};
+
+/**
+ * @brief Edge list the stages work on.
+ */
+struct EdgeGraph
+{
+    TransformEdge *edges;
+    long long      num_edges;
+    VertexT        nodes;
+    bool           has_weights;
+    bool           symmetric;  // every edge has its reverse
+
+    EdgeGraph() :
+        edges      (NULL),
+        num_edges  (0),
+        nodes      (0),
+        has_weights(false),
+        symmetric  (false)
+    {
+    }
+
+    ~EdgeGraph()
+    {
+        if (edges) { free(edges); edges = NULL; }
+    }
+
+    void Replace(TransformEdge *new_edges, long long new_num_edges)
+    {
+        if (edges) free(edges);
+        edges     = new_edges;
+        num_edges = new_num_edges;
+    }
+};
+
+enum GraphFormat
+{
+    FORMAT_UNKNOWN = 0,
+    FORMAT_MTX,
+    FORMAT_GR,
+    FORMAT_SNAP,
+    FORMAT_BIN,
+};
+
+GraphFormat FormatFromName(std::string name)
+{
+    size_t compressed = graphio::CompressedExtensionLength(name);
+    std::string suffix = name.substr(name.size() - compressed);
+    if (suffix.compare(0, 4, ".tar") == 0 || suffix == ".tgz")
+        return FORMAT_MTX;  // SuiteSparse archives
+    name.resize(name.size() - compressed);
+    std::string ext = name.substr(name.find_last_of('.') + 1);
+    if (ext == "mtx") return FORMAT_MTX;
+    if (ext == "gr" ) return FORMAT_GR;
+    if (ext == "bin") return FORMAT_BIN;
+    if (ext == "snap" || ext == "txt" || ext == "edges" || ext == "el")
+        return FORMAT_SNAP;
+    return FORMAT_UNKNOWN;
+}
+
+/******************************************************************************
+ * Parallel reader
+ ******************************************************************************/
+
+inline const char* SkipBlanks(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    return p;
+}
+
+inline const char* NextLine(const char *p, const char *end)
+{
+    while (p < end && *p != '\n') p++;
+    return p < end ? p + 1 : end;
+}
+
+/**
+ * @brief Parses up to three numbers of a line.
+ *
+ * \return Number of values parsed.
+ */
+inline int ParseNumbers(const char *p, const char *end, double *values)
+{
+    int count = 0;
+    char buffer[128];
+    while (count < 3)
+    {
+        p = SkipBlanks(p, end);
+        if (p >= end || *p == '\n') break;
+        size_t length = 0;
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n' &&
+            length < sizeof(buffer) - 1)
+            buffer[length++] = *p++;
+        buffer[length] = '\0';
+        char *parsed_end = NULL;
+        values[count] = strtod(buffer, &parsed_end);
+        if (parsed_end == buffer) break;
+        count ++;
+    }
+    return count;
+}
+
+/**
+ * @brief Maps a graph file, or decodes a compressed one into memory, its
+ * units in parallel.
+ *
+ * \return The content, to be released with UnmapInput(), or NULL.
+ */
+const char* MapInput(const char *file_name, size_t &size, bool &decoded)
+{
+    decoded = graphio::DetectFileCompression(file_name) != graphio::COMPRESSION_NONE;
+    if (decoded)
+    {
+        graphio::CompressedReader reader;
+        char *content = NULL;
+        if (reader.Open(file_name) != 0 || !reader.ReadAll(content, size))
+        {
+            fprintf(stderr, "Cannot read %s: %s\n", file_name, reader.error.c_str());
+            if (content) { free(content); content = NULL; }
+        }
+        return content;
+    }
+
+    int fd = open(file_name, O_RDONLY);
+    struct stat file_stat;
+    if (fd < 0 || fstat(fd, &file_stat) != 0)
+    {
+        fprintf(stderr, "Cannot open %s\n", file_name);
+        if (fd >= 0) close(fd);
+        return NULL;
+    }
+    size = file_stat.st_size;
+    const char *data = size == 0 ? "" : (const char*)
+        mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        fprintf(stderr, "Cannot map %s\n", file_name);
+        return NULL;
+    }
+    return data;
+}
+
+void UnmapInput(const char *data, size_t size, bool decoded)
+{
+    if (decoded) free((void*)data);
+    else if (size > 0) munmap((void*)data, size);
+}
+
+/**
+ * @brief Reads a graph file: the header sequentially, the edge lines in
+ * parallel, one contiguous chunk of the file per thread.
+ */
+bool ReadGraph(const char *file_name, GraphFormat format, EdgeGraph &graph)
+{
+    size_t size    = 0;
+    bool   decoded = false;
+    const char *data = MapInput(file_name, size, decoded);
+    if (data == NULL) return false;
+    const char *end = data + size, *p = data;
+    bool skew = false;
+
+    // Matrix-Market header: banner, comments, then the size line
+    if (format == FORMAT_MTX)
+    {
+        while (p < end)
+        {
+            const char *line = SkipBlanks(p, end);
+            const char *next = NextLine(p, end);
+            p = next;
+            if (line >= end || *line == '\n') continue;
+            if (*line == '%')
+            {
+                std::string text(line, next - line);
+                if (text.compare(0, 2, "%%") == 0)
+                {
+                    graph.symmetric = text.find("symmetric") != std::string::npos
+                                   || text.find("hermitian") != std::string::npos;
+                    skew = text.find("skew") != std::string::npos;
+                }
+                continue;
+            }
+            double values[3];
+            if (ParseNumbers(line, end, values) < 2)
+            {
+                fprintf(stderr, "Bad Matrix-Market size line\n");
+                UnmapInput(data, size, decoded);
+                return false;
+            }
+            graph.nodes = (VertexT) std::max(values[0], values[1]);
+            break;
+        }
+    }
+
+    int num_threads = omp_get_max_threads();
+    std::vector<std::vector<TransformEdge> > parts(num_threads);
+    std::vector<VertexT> part_nodes(num_threads, 0);
+    std::vector<char>    part_weights(num_threads, 0);
+    std::vector<long long> part_invalid(num_threads, 0);
+    const char *body = p;
+    size_t body_size = end - body;
+    bool mirror = (format == FORMAT_MTX && graph.symmetric);
+    long long base = (format == FORMAT_SNAP) ? 0 : 1;
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        int thread_num = omp_get_thread_num();
+        const char *begin = body + body_size * thread_num / num_threads;
+        const char *stop  = body + body_size * (thread_num + 1) / num_threads;
+        // a line belongs to the thread its first character falls in
+        if (thread_num > 0 && begin > body && begin[-1] != '\n')
+            begin = NextLine(begin, end);
+        std::vector<TransformEdge> &part = parts[thread_num];
+        part.reserve((stop - begin) / 8 + 1);
+        VertexT max_node = 0;
+        bool weighted = false;
+
+        for (const char *line = begin; line < stop; line = NextLine(line, end))
+        {
+            const char *q = SkipBlanks(line, end);
+            if (q >= end || *q == '\n' || *q == '%' || *q == '#') continue;
+            if (format == FORMAT_GR)
+            {
+                if (*q == 'p')
+                {
+                    // p sp <nodes> <edges>
+                    q = SkipBlanks(q + 1, end);
+                    while (q < end && *q != ' ' && *q != '\t') q++;
+                    double values[3];
+                    if (ParseNumbers(q, end, values) >= 1)
+                        part_nodes[thread_num] = (VertexT)values[0];
+                    continue;
+                }
+                if (*q != 'a') continue;  // comments and other records
+                q++;
+            }
+
+            double values[3];
+            int num_values = ParseNumbers(q, end, values);
+            if (num_values < 2) continue;
+            TransformEdge edge;
+            edge.src    = (VertexT)values[0] - base;
+            edge.dst    = (VertexT)values[1] - base;
+            edge.weight = num_values > 2 ? (ValueT)values[2] : (ValueT)1;
+            if (edge.src < 0 || edge.dst < 0)
+            {
+                part_invalid[thread_num] ++;
+                continue;
+            }
+            if (num_values > 2) weighted = true;
+            part.push_back(edge);
+            max_node = std::max(max_node, std::max(edge.src, edge.dst) + 1);
+            if (mirror && edge.src != edge.dst)
+            {
+                std::swap(edge.src, edge.dst);
+                if (skew) edge.weight = -edge.weight;
+                part.push_back(edge);
+            }
+        }
+        part_nodes  [thread_num] = std::max(part_nodes[thread_num], max_node);
+        part_weights[thread_num] = weighted;
+    }
+    UnmapInput(data, size, decoded);
+
+    std::vector<long long> offsets(num_threads + 1, 0);
+    long long num_invalid = 0;
+    for (int t = 0; t < num_threads; t++)
+    {
+        num_invalid += part_invalid[t];
+        offsets[t+1] = offsets[t] + parts[t].size();
+        graph.nodes  = std::max(graph.nodes, part_nodes[t]);
+        graph.has_weights = graph.has_weights || part_weights[t];
+    }
+    if (num_invalid > 0)
+        fprintf(stderr, "Skipped %lld edges with out-of-range vertex IDs\n",
+            num_invalid);
+    graph.Replace((TransformEdge*) malloc(
+        sizeof(TransformEdge) * std::max(offsets[num_threads], 1ll)),
+        offsets[num_threads]);
+    #pragma omp parallel for num_threads(num_threads)
+    for (int t = 0; t < num_threads; t++)
+    {
+        if (!parts[t].empty())
+            memcpy(graph.edges + offsets[t], &parts[t][0],
+                sizeof(TransformEdge) * parts[t].size());
+        std::vector<TransformEdge>().swap(parts[t]);
+    }
+    return true;
+}
+
+/******************************************************************************
+ * Stages
+ ******************************************************************************/
+
+/**
+ * @brief Keeps the edges for which keep[i] is set, in order.
+ */
+void CompactEdges(EdgeGraph &graph, const char *keep)
+{
+    TransformEdge *kept = (TransformEdge*) malloc(
+        sizeof(TransformEdge) * std::max(graph.num_edges, 1ll));
+    long long num_kept = util::host::CompactFlagged(
+        graph.edges, keep, graph.num_edges, kept);
+    graph.Replace(kept, num_kept);
+}
+
+void ReverseEdges(EdgeGraph &graph)
+{
+    #pragma omp parallel for
+    for (long long e = 0; e < graph.num_edges; e++)
+        std::swap(graph.edges[e].src, graph.edges[e].dst);
+}
+
+void SymmetrizeEdges(EdgeGraph &graph)
+{
+    long long num_edges = graph.num_edges;
+    TransformEdge *edges = (TransformEdge*) malloc(
+        sizeof(TransformEdge) * std::max(2 * num_edges, 1ll));
+    #pragma omp parallel for
+    for (long long e = 0; e < num_edges; e++)
+    {
+        edges[e] = edges[num_edges + e] = graph.edges[e];
+        std::swap(edges[num_edges + e].src, edges[num_edges + e].dst);
+    }
+    graph.Replace(edges, 2 * num_edges);
+    graph.symmetric = true;
+}
+
+void RemoveSelfLoops(EdgeGraph &graph)
+{
+    char *keep = (char*) malloc(std::max(graph.num_edges, 1ll));
+    #pragma omp parallel for
+    for (long long e = 0; e < graph.num_edges; e++)
+        keep[e] = graph.edges[e].src != graph.edges[e].dst;
+    CompactEdges(graph, keep);
+    free(keep); keep = NULL;
+}
+
+/**
+ * @brief Orders edges by source, destination, then weight, a total order
+ * on what the output keeps, so the unstable parallel sort is deterministic.
+ */
+bool EdgeLess(const TransformEdge &a, const TransformEdge &b)
+{
+    if (a.src != b.src) return a.src < b.src;
+    if (a.dst != b.dst) return a.dst < b.dst;
+    return a.weight < b.weight;
+}
+
+/**
+ * @brief Sorts the edges and keeps the first, i.e. lightest, of each run
+ * of parallel edges.
+ */
+void DedupEdges(EdgeGraph &graph)
+{
+    util::omp_sort(graph.edges, graph.num_edges, EdgeLess);
+    char *keep = (char*) malloc(std::max(graph.num_edges, 1ll));
+    #pragma omp parallel for
+    for (long long e = 0; e < graph.num_edges; e++)
+        keep[e] = (e == 0 || graph.edges[e].src != graph.edges[e-1].src ||
+                             graph.edges[e].dst != graph.edges[e-1].dst);
+    CompactEdges(graph, keep);
+    free(keep); keep = NULL;
+}
+
+/**
+ * @brief Endpoint i of the edge list: sources, then destinations.
+ */
+struct EndpointOp
+{
+    const EdgeGraph *graph;
+
+    VertexT operator()(long long i) const
+    {
+        return i < graph -> num_edges ? graph -> edges[i].src
+            : graph -> edges[i - graph -> num_edges].dst;
+    }
+};
+
+/**
+ * @brief Total (in + out) degree of every vertex.
+ */
+long long* CountDegrees(const EdgeGraph &graph)
+{
+    long long *degrees = (long long*) malloc(
+        sizeof(long long) * std::max(graph.nodes, 1ll));
+    EndpointOp endpoint_of;
+    endpoint_of.graph = &graph;
+    util::host::Histogram(2 * graph.num_edges, endpoint_of, degrees, graph.nodes);
+    return degrees;
+}
+
+void AssignWeights(EdgeGraph &graph, const graphio::EdgeWeightConfig &config)
+{
+    long long *degrees    = NULL;
+    long long  max_degree = 0;
+    if (config.distribution == graphio::WEIGHT_DEGREE)
+    {
+        degrees = CountDegrees(graph);
+        #pragma omp parallel for reduction(max:max_degree)
+        for (VertexT v = 0; v < graph.nodes; v++)
+            if (degrees[v] > max_degree) max_degree = degrees[v];
+    }
+    #pragma omp parallel for
+    for (long long e = 0; e < graph.num_edges; e++)
+    {
+        TransformEdge &edge = graph.edges[e];
+        double degree_term = degrees == NULL ? 0 : graphio::WeightDegreeTerm(
+            degrees[edge.src], degrees[edge.dst], max_degree);
+        edge.weight = graphio::EdgeWeight<ValueT>(
+            config, edge.src, edge.dst, graph.symmetric, degree_term);
+    }
+    graph.has_weights = true;
+    if (degrees) { free(degrees); degrees = NULL; }
+}
+
+inline VertexT FindRoot(VertexT *parents, VertexT v)
+{
+    while (parents[v] != v)
+    {
+        VertexT grand_parent = parents[parents[v]];
+        parents[v] = grand_parent;  // path halving, races are benign
+        v = grand_parent;
+    }
+    return v;
+}
+
+/**
+ * @brief Keeps the edges of the largest weakly connected component, found
+ * with a concurrent union-find that hooks larger roots onto smaller ones.
+ */
+void KeepLargestComponent(EdgeGraph &graph)
+{
+    VertexT   *parents = (VertexT*) malloc(sizeof(VertexT) * std::max(graph.nodes, 1ll));
+    long long *sizes   = (long long*) malloc(sizeof(long long) * std::max(graph.nodes, 1ll));
+    #pragma omp parallel for
+    for (VertexT v = 0; v < graph.nodes; v++)
+    {
+        parents[v] = v;
+        sizes  [v] = 0;
+    }
+
+    #pragma omp parallel for schedule(dynamic, 4096)
+    for (long long e = 0; e < graph.num_edges; e++)
+    {
+        VertexT a = graph.edges[e].src, b = graph.edges[e].dst;
+        while (true)
+        {
+            a = FindRoot(parents, a);
+            b = FindRoot(parents, b);
+            if (a == b) break;
+            if (a < b) std::swap(a, b);
+            if (__sync_bool_compare_and_swap(parents + a, a, b)) break;
+        }
+    }
+
+    #pragma omp parallel for
+    for (VertexT v = 0; v < graph.nodes; v++)
+        __sync_fetch_and_add(sizes + FindRoot(parents, v), 1ll);
+    VertexT largest = 0;
+    for (VertexT v = 1; v < graph.nodes; v++)
+        if (sizes[v] > sizes[largest]) largest = v;
+
+    char *keep = (char*) malloc(std::max(graph.num_edges, 1ll));
+    #pragma omp parallel for
+    for (long long e = 0; e < graph.num_edges; e++)
+        keep[e] = FindRoot(parents, graph.edges[e].src) == largest;
+    CompactEdges(graph, keep);
+    free(keep   ); keep    = NULL;
+    free(parents); parents = NULL;
+    free(sizes  ); sizes   = NULL;
+}
+
+/**
+ * @brief Renumbers the vertices that have edges, keeping their order or
+ * by decreasing degree (ties by ID).
+ */
+bool RelabelVertices(
+    EdgeGraph         &graph,
+    const std::string &order,
+    const std::string &map_file)
+{
+    long long *degrees = CountDegrees(graph);
+    VertexT   *new_ids = (VertexT*) malloc(sizeof(VertexT) * std::max(graph.nodes, 1ll));
+    VertexT    num_used = 0;
+
+    if (order == "degree")
+    {
+        std::pair<long long, VertexT> *ranks = (std::pair<long long, VertexT>*)
+            malloc(sizeof(std::pair<long long, VertexT>) * std::max(graph.nodes, 1ll));
+        #pragma omp parallel for
+        for (VertexT v = 0; v < graph.nodes; v++)
+            ranks[v] = std::make_pair(-degrees[v], v);
+        util::omp_sort(ranks, graph.nodes, std::less<std::pair<long long, VertexT> >());
+        #pragma omp parallel for reduction(+:num_used)
+        for (VertexT i = 0; i < graph.nodes; i++)
+        {
+            new_ids[ranks[i].second] = ranks[i].first < 0 ? i : -1;
+            if (ranks[i].first < 0) num_used ++;
+        }
+        free(ranks); ranks = NULL;
+    } else if (order == "compact") {
+        for (VertexT v = 0; v < graph.nodes; v++)
+            new_ids[v] = degrees[v] > 0 ? num_used++ : -1;
+    } else {
+        fprintf(stderr, "Unknown relabel order %s\n", order.c_str());
+        free(degrees); free(new_ids);
+        return false;
+    }
+
+    #pragma omp parallel for
+    for (long long e = 0; e < graph.num_edges; e++)
+    {
+        graph.edges[e].src = new_ids[graph.edges[e].src];
+        graph.edges[e].dst = new_ids[graph.edges[e].dst];
+    }
+
+    if (map_file != "")
+    {
+        FILE *out = fopen(map_file.c_str(), "w");
+        if (out == NULL)
+        {
+            fprintf(stderr, "Cannot write %s\n", map_file.c_str());
+        } else {
+            fprintf(out, "# old new (0-based)\n");
+            for (VertexT v = 0; v < graph.nodes; v++)
+                if (new_ids[v] >= 0)
+                    fprintf(out, "%lld %lld\n", v, new_ids[v]);
+            fclose(out);
+        }
+    }
+    graph.nodes = num_used;
+    free(degrees); degrees = NULL;
+    free(new_ids); new_ids = NULL;
+    return true;
+}
+
+/******************************************************************************
+ * Parallel writers
+ ******************************************************************************/
+
+/**
+ * @brief Writes the text formats: blocks of edges are formatted by all
+ * threads, then written in order.
+ */
+bool WriteText(const char *file_name, GraphFormat format, const EdgeGraph &graph)
+{
+    FILE *out = fopen(file_name, "w");
+    if (out == NULL)
+    {
+        fprintf(stderr, "Cannot write %s\n", file_name);
+        return false;
+    }
+    if (format == FORMAT_MTX)
+        fprintf(out, "%%%%MatrixMarket matrix coordinate %s general\n%lld %lld %lld\n",
+            graph.has_weights ? "real" : "pattern",
+            graph.nodes, graph.nodes, graph.num_edges);
+    else if (format == FORMAT_GR)
+        fprintf(out, "p sp %lld %lld\n", graph.nodes, graph.num_edges);
+    else
+        fprintf(out, "# Nodes: %lld Edges: %lld\n", graph.nodes, graph.num_edges);
+
+    const long long block = 1 << 20;  // edges per thread per round
+    int num_threads = omp_get_max_threads();
+    long long base  = (format == FORMAT_SNAP) ? 0 : 1;
+    std::vector<std::string> buffers(num_threads);
+    for (long long round = 0; round < graph.num_edges; round += block * num_threads)
+    {
+        #pragma omp parallel num_threads(num_threads)
+        {
+            int thread_num = omp_get_thread_num();
+            long long begin = round + block * thread_num;
+            long long end   = std::min(begin + block, graph.num_edges);
+            std::string &buffer = buffers[thread_num];
+            char line[96];
+            buffer.clear();
+            for (long long e = begin; e < end; e++)
+            {
+                const TransformEdge &edge = graph.edges[e];
+                int length;
+                if (format == FORMAT_GR)
+                    length = sprintf(line, "a %lld %lld %lld\n", edge.src + base,
+                        edge.dst + base, graph.has_weights ?
+                        (long long)floor(edge.weight + 0.5) : 1ll);
+                else if (graph.has_weights)
+                    length = sprintf(line, "%lld %lld %.15g\n", edge.src + base,
+                        edge.dst + base, edge.weight);
+                else
+                    length = sprintf(line, "%lld %lld\n", edge.src + base,
+                        edge.dst + base);
+                buffer.append(line, length);
+            }
+        }
+        for (int t = 0; t < num_threads; t++)
+            fwrite(buffers[t].data(), 1, buffers[t].size(), out);
+    }
+    fclose(out);
+    return true;
+}
+
+/**
+ * @brief Writes the Gunrock binary CSR through Csr::FromCoo, which drops
+ * self-loops and duplicates; weights are rounded to int.
+ */
+template <typename VertexId, typename SizeT>
+bool WriteBinaryCsr(const char *file_name, const EdgeGraph &graph, bool quiet)
+{
+    typedef Coo<VertexId, int> EdgeTupleType;
+    EdgeTupleType *coo = (EdgeTupleType*) malloc(
+        sizeof(EdgeTupleType) * std::max(graph.num_edges, 1ll));
+    #pragma omp parallel for
+    for (long long e = 0; e < graph.num_edges; e++)
+    {
+        coo[e].row = graph.edges[e].src;
+        coo[e].col = graph.edges[e].dst;
+        coo[e].val = (int)floor(graph.edges[e].weight + 0.5);
+    }
+    Csr<VertexId, SizeT, int> csr(false);
+    std::string name = file_name;
+    if (graph.has_weights)
+        csr.template FromCoo<true >(&name[0], coo, graph.nodes, graph.num_edges,
+            false, false, false, quiet);
+    else
+        csr.template FromCoo<false>(&name[0], coo, graph.nodes, graph.num_edges,
+            false, false, false, quiet);
+    free(coo); coo = NULL;
+    return true;
+}
+
+/******************************************************************************
+ * Self check
+ ******************************************************************************/
+
+struct OddOp
+{
+    const long long *values;
+    bool operator()(long long i) const { return (values[i] & 1) != 0; }
+};
+
+struct ModuloOp
+{
+    const long long *values;
+    long long        num_bins;
+    long long operator()(long long i) const { return values[i] % num_bins; }
+};
+
+typedef std::pair<long long, long long> CheckPair;
+
+/**
+ * @brief Orders pairs by their first element only, so merges must keep
+ * the order of ties to pass.
+ */
+bool FirstLess(const CheckPair &a, const CheckPair &b)
+{
+    return a.first < b.first;
+}
+
+bool IsSelfLoop(const CheckPair &edge)
+{
+    return edge.first == edge.second;
+}
+
+long long ReportCheck(const char *name, long long size, long long errors, bool quiet)
+{
+    if (errors > 0 || !quiet)
+        printf("%-16s %9lld elements: %s (%lld errors)\n",
+            name, size, errors == 0 ? "PASS" : "FAIL", errors);
+    return errors;
+}
+
+/**
+ * @brief Checks the host primitives against serial loops, on inputs below
+ * and above the sizes where they go parallel, and Csr::FromCoo, built on
+ * them, against a sorted edge list without self-loops and duplicates.
+ *
+ * \return Number of mismatches.
+ */
+long long CheckPrimitives(bool quiet)
+{
+    std::mt19937 engine(805);
+    long long sizes[] = {0, 1, 1000, 100000, (1 << 20) + 7};
+    long long num_errors = 0;
+
+    for (int s = 0; s < 5; s++)
+    {
+        long long n = sizes[s], errors = 0, count = 0;
+        std::vector<long long> values(n + 1), output(n + 1), expected(n + 1);
+        for (long long i = 0; i < n; i++)
+            values[i] = engine() % 100000;
+
+        // exclusive scan
+        long long sum = 0;
+        for (long long i = 0; i < n; i++) { expected[i] = sum; sum += values[i]; }
+        errors = util::host::ExclusiveScan(&values[0], &output[0], n) != sum;
+        for (long long i = 0; i < n; i++) errors += output[i] != expected[i];
+        num_errors += ReportCheck("ExclusiveScan", n, errors, quiet);
+
+        // compaction and partition of the odd values
+        OddOp odd;
+        odd.values = &values[0];
+        count = 0;
+        for (long long i = 0; i < n; i++) if ( odd(i)) expected[count++] = values[i];
+        long long num_odd = count;
+        for (long long i = 0; i < n; i++) if (!odd(i)) expected[count++] = values[i];
+        errors = util::host::Compact(&values[0], n, &output[0], odd) != num_odd;
+        for (long long i = 0; i < num_odd && errors == 0; i++)
+            errors += output[i] != expected[i];
+        num_errors += ReportCheck("Compact", n, errors, quiet);
+        errors = util::host::Partition(&values[0], n, &output[0], odd) != num_odd;
+        for (long long i = 0; i < n && errors == 0; i++)
+            errors += output[i] != expected[i];
+        num_errors += ReportCheck("Partition", n, errors, quiet);
+
+        // histograms with private copies, and with shared atomic bins
+        long long bin_sizes[] = {1000, 1 << 18};
+        for (int b = 0; b < 2; b++)
+        {
+            ModuloOp bin_of;
+            bin_of.values   = &values[0];
+            bin_of.num_bins = bin_sizes[b];
+            std::vector<long long> counts(bin_sizes[b], 0), histogram(bin_sizes[b]);
+            for (long long i = 0; i < n; i++) counts[bin_of(i)] ++;
+            util::host::Histogram(n, bin_of, &histogram[0], bin_sizes[b]);
+            errors = 0;
+            for (long long bin = 0; bin < bin_sizes[b]; bin++)
+                errors += histogram[bin] != counts[bin];
+            num_errors += ReportCheck("Histogram", n, errors, quiet);
+        }
+
+        // segmented sort, short segments and one taking half the input
+        std::vector<long long> offsets(1, 0), keys(values), indices(n + 1);
+        while (offsets.back() < n)
+        {
+            long long length = offsets.size() == 4 ? n / 2 : engine() % 64;
+            offsets.push_back(std::min(offsets.back() + length, n));
+        }
+        for (long long i = 0; i < n; i++) indices[i] = i;
+        util::host::SegmentedSortPairs(&keys[0], &indices[0], &offsets[0],
+            (long long)offsets.size() - 1);
+        errors = 0;
+        for (size_t seg = 0; seg + 1 < offsets.size(); seg++)
+        {
+            std::vector<CheckPair> pairs;
+            for (long long i = offsets[seg]; i < offsets[seg + 1]; i++)
+                pairs.push_back(CheckPair(values[i], i));
+            std::sort(pairs.begin(), pairs.end());
+            for (size_t i = 0; i < pairs.size(); i++)
+                errors += keys   [offsets[seg] + i] != pairs[i].first ||
+                          indices[offsets[seg] + i] != pairs[i].second;
+        }
+        num_errors += ReportCheck("SegmentedSort", n, errors, quiet);
+
+        // stable merge, ties coming from both inputs
+        long long a_length = n / 3, b_length = n - a_length;
+        std::vector<CheckPair> a(a_length + 1), b(b_length + 1),
+            merged(n + 1), merged_ref(n + 1);
+        for (long long i = 0; i < a_length; i++) a[i] = CheckPair(values[i] % 1000, i);
+        for (long long i = 0; i < b_length; i++) b[i] = CheckPair(values[a_length + i] % 1000, n + i);
+        std::stable_sort(a.begin(), a.begin() + a_length, FirstLess);
+        std::stable_sort(b.begin(), b.begin() + b_length, FirstLess);
+        std::merge(a.begin(), a.begin() + a_length, b.begin(), b.begin() + b_length,
+            merged_ref.begin(), FirstLess);
+        util::host::ParallelMerge(&a[0], a_length, &b[0], b_length, &merged[0], FirstLess);
+        errors = 0;
+        for (long long i = 0; i < n; i++) errors += merged[i] != merged_ref[i];
+        num_errors += ReportCheck("ParallelMerge", n, errors, quiet);
+
+        // CSR from a COO with self-loops and duplicates
+        typedef Coo<int, int> EdgeTupleType;
+        int nodes = 1000;
+        EdgeTupleType *coo = (EdgeTupleType*) malloc(
+            sizeof(EdgeTupleType) * std::max(n, 1ll));
+        std::vector<CheckPair> edges(n);
+        for (long long e = 0; e < n; e++)
+        {
+            coo[e].row = values[e] % nodes;
+            coo[e].col = engine() % nodes;
+            coo[e].val = 1;
+            edges[e] = CheckPair(coo[e].row, coo[e].col);
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        edges.erase(std::remove_if(edges.begin(), edges.end(), IsSelfLoop), edges.end());
+        Csr<int, int, int> csr(false);
+        csr.template FromCoo<false>(NULL, coo, nodes, (int)n, false, false, false, true);
+        errors = csr.row_offsets[nodes] != (int)edges.size() ? 1 : 0;
+        for (int v = 0; v < nodes && errors == 0; v++)
+        for (int e = csr.row_offsets[v]; e < csr.row_offsets[v+1]; e++)
+            errors += edges[e].first != v || edges[e].second != csr.column_indices[e];
+        num_errors += ReportCheck("Csr::FromCoo", n, errors, quiet);
+        free(coo); coo = NULL;
+    }
+    return num_errors;
+}
+
+/******************************************************************************
+* Main
+******************************************************************************/
+
+int main(int argc, char** argv)
+{
+    CommandLineArgs args(argc, argv);
+    if (args.CheckCmdLineFlag("check-primitives"))
+        return CheckPrimitives(args.CheckCmdLineFlag("quiet")) == 0 ? 0 : 1;
+
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++)
+        if (strncmp(argv[i], "--", 2) != 0) files.push_back(argv[i]);
+    if (files.size() != 2 || args.CheckCmdLineFlag("help"))
+    {
+        Usage();
+        return 1;
+    }
+
+    bool quiet = args.CheckCmdLineFlag("quiet");
+    std::string from = "", to = "", stage_list = "";
+    std::string relabel_order = "compact", relabel_map = "";
+    args.GetCmdLineArgument("from"         , from         );
+    args.GetCmdLineArgument("to"           , to           );
+    args.GetCmdLineArgument("stages"       , stage_list   );
+    args.GetCmdLineArgument("relabel-order", relabel_order);
+    args.GetCmdLineArgument("relabel-map"  , relabel_map  );
+    GraphFormat in_format  = FormatFromName(from == "" ? files[0] : "." + from);
+    GraphFormat out_format = FormatFromName(to   == "" ? files[1] : "." + to  );
+    if (in_format == FORMAT_UNKNOWN || in_format == FORMAT_BIN ||
+        out_format == FORMAT_UNKNOWN ||
+        graphio::CompressedExtensionLength(files[1]) > 0)
+    {
+        fprintf(stderr, "Unsupported input or output format\n");
+        return 1;
+    }
+
+    graphio::EdgeWeightConfig weight_config;
+    std::string distribution = weight_config.DistributionName();
+    args.GetCmdLineArgument("weight-dist" , distribution            );
+    args.GetCmdLineArgument("weight-seed" , weight_config.seed      );
+    args.GetCmdLineArgument("weight-min"  , weight_config.min_weight);
+    args.GetCmdLineArgument("weight-max"  , weight_config.max_weight);
+    args.GetCmdLineArgument("weight-sigma", weight_config.sigma     );
+    if (!weight_config.SetDistribution(distribution))
+    {
+        fprintf(stderr, "Unknown weight distribution %s\n", distribution.c_str());
+        return 1;
+    }
+
+    std::vector<std::string> stages;
+    for (size_t begin = 0; begin < stage_list.size(); )
+    {
+        size_t comma = stage_list.find(',', begin);
+        if (comma == std::string::npos) comma = stage_list.size();
+        if (comma > begin) stages.push_back(stage_list.substr(begin, comma - begin));
+        begin = comma + 1;
+    }
+
+    EdgeGraph graph;
+    CpuTimer  timer;
+    timer.Start();
+    if (!ReadGraph(files[0].c_str(), in_format, graph)) return 1;
+    timer.Stop();
+    if (!quiet)
+        printf("read %s: %lld vertices, %lld edges%s (%.1f ms)\n",
+            files[0].c_str(), graph.nodes, graph.num_edges,
+            graph.has_weights ? ", weighted" : "", timer.ElapsedMillis());
+
+    for (size_t i = 0; i < stages.size(); i++)
+    {
+        const std::string &stage = stages[i];
+        timer.Start();
+        if      (stage == "reverse"          ) ReverseEdges   (graph);
+        else if (stage == "symmetrize"       ) SymmetrizeEdges(graph);
+        else if (stage == "remove-self-loops") RemoveSelfLoops(graph);
+        else if (stage == "dedup"            ) DedupEdges     (graph);
+        else if (stage == "drop-weights"     ) graph.has_weights = false;
+        else if (stage == "weights"          ) AssignWeights  (graph, weight_config);
+        else if (stage == "largest-cc"       ) KeepLargestComponent(graph);
+        else if (stage == "relabel")
+        {
+            if (!RelabelVertices(graph, relabel_order, relabel_map)) return 1;
+        } else {
+            fprintf(stderr, "Unknown stage %s\n", stage.c_str());
+            return 1;
+        }
+        timer.Stop();
+        if (!quiet)
+            printf("%-18s %lld vertices, %lld edges (%.1f ms)\n", stage.c_str(),
+                graph.nodes, graph.num_edges, timer.ElapsedMillis());
+    }
+
+    timer.Start();
+    bool written = false;
+    if (out_format != FORMAT_BIN)
+        written = WriteText(files[1].c_str(), out_format, graph);
+    else if (graph.nodes <= 0x7fffffffll && graph.num_edges <= 0x7fffffffll)
+        written = WriteBinaryCsr<int, int>(files[1].c_str(), graph, quiet);
+    else
+        written = WriteBinaryCsr<long long, long long>(files[1].c_str(), graph, quiet);
+    timer.Stop();
+    if (!written) return 1;
+    if (!quiet)
+        printf("wrote %s (%.1f ms)\n", files[1].c_str(), timer.ElapsedMillis());
+    return 0;
+}
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
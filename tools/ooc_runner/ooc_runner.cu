@@ -0,0 +1,525 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * ooc_runner.cu
+ *
+ * @brief Runs BFS, PageRank or CC on graphs larger than memory: writes a
+ * graph as a block file, or runs a primitive over a block file within a
+ * memory budget and reports the I/O it took.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// Utilities and correctness-checking
+#include <gunrock/util/test_utils.cuh>
+
+// Info and graph loading
+#include <gunrock/app/enactor_base.cuh>
+
+// Out-of-core graph and primitives
+#include <gunrock/block_graph.cuh>
+#include <gunrock/app/bfs/bfs_ooc.cuh>
+#include <gunrock/app/pr/pr_ooc.cuh>
+#include <gunrock/app/cc/cc_ooc.cuh>
+
+// In-memory references
+#include <gunrock/edge_list.cuh>
+#include <gunrock/app/bfs/bfs_host.cuh>
+#include <gunrock/app/pr/pr_host.cuh>
+#include <gunrock/app/cc/cc_host.cuh>
+
+using namespace gunrock;
+using namespace gunrock::app;
+using namespace gunrock::util;
+
+/******************************************************************************
+ * Housekeeping Routines
+ ******************************************************************************/
+void Usage()
+{
+    printf(
+        "ooc_runner <graph-type> [graph-type-arguments] --write-blocks=<file>\n"
+        "ooc_runner market <matrix-market-file-name> --write-blocks=<file> --stream\n"
+        "ooc_runner blocks <block-file> [--algo=<bfs|pr|cc>]\n"
+        "Graph type and graph type arguments:\n"
+        "    market <matrix-market-file-name>\n"
+        "    rmat / rgg / smallworld, as in the test drivers\n"
+        "    blocks <block-file>, written by --write-blocks\n\n"
+        "Optional arguments:\n"
+        "[--undirected]            Treat the graph as undirected (symmetric);\n"
+        "                          cc needs a symmetric block file.\n"
+        "[--edge-value]            Store the edge values in the block file.\n"
+        "[--block-size=<KB>]       Adjacency per block when writing (Default: 1024).\n"
+        "[--stream]                Write the blocks of a MARKET file in passes over\n"
+        "                          it, holding --memory-budget of edges at a time;\n"
+        "                          without it the whole graph is loaded first, so\n"
+        "                          it must fit in memory. Pattern files get no\n"
+        "                          synthetic weights.\n"
+        "[--algo=<bfs|pr|cc>]      Primitive to run on a block file (Default: bfs).\n"
+        "[--memory-budget=<MB>]    Memory for cached blocks, or for the edges of a\n"
+        "                          pass of --stream (Default: 256).\n"
+        "[--io-threads=<n>]        Threads reading blocks ahead (Default: 4).\n"
+        "[--src=<Vertex-ID|randomize|largestdegree>]\n"
+        "                          Source of bfs (Default: 0).\n"
+        "[--delta=<delta>]         Damping factor of pr (Default: 0.85).\n"
+        "[--error=<error>]         Smallest rank change pr pushes (Default: 0.01).\n"
+        "[--max-iter=<n>]          Maximum iterations of pr (Default: 50).\n"
+        "[--normalized]            Ranks of pr sum to 1.\n"
+        "[--validate]              Check the result against the in-memory\n"
+        "                          BFS / PageRank / CC of the whole graph; when\n"
+        "                          writing, check the block file against it\n"
+        "                          (which loads the whole graph, even with --stream).\n"
+        "[--quiet]                 No output (unless --json is specified).\n"
+        "[--json]                  Output JSON-format statistics to STDOUT.\n"
+        "[--jsonfile=<name>]       Output JSON-format statistics to file <name>\n"
+    );
+}
+
+/**
+ * @brief Copies the edges of a block graph into a CSR.
+ */
+template <typename VertexId, typename SizeT>
+struct CopyEdgeOp
+{
+    VertexId *column_indices;
+
+    void operator()(SizeT e, VertexId from, VertexId to)
+    {
+        column_indices[e] = to;
+    }
+};
+
+/**
+ * @brief Counts the edges of a block graph that differ from a CSR.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+struct CompareEdgeOp
+{
+    const Csr<VertexId, SizeT, Value> *graph;
+    SizeT                              num_errors;  // updated atomically
+
+    void operator()(SizeT e, VertexId from, VertexId to)
+    {
+        if (graph -> column_indices[e] != to)
+            __sync_fetch_and_add(&num_errors, (SizeT)1);
+    }
+};
+
+/**
+ * @brief Reads a whole block graph into a CSR, for the references.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+void LoadBlocks(
+    BlockGraph<VertexId, SizeT, Value> &blocks,
+    Csr<VertexId, SizeT, Value>        &graph)
+{
+    BlockIoStats stats = blocks.stats;  // the primitive's I/O is reported
+    graph.template FromScratch<false, false>(blocks.nodes, blocks.edges);
+    memcpy(graph.row_offsets, blocks.row_offsets, sizeof(SizeT) * (blocks.nodes + 1));
+    CopyEdgeOp<VertexId, SizeT> copy;
+    copy.column_indices = graph.column_indices;
+    blocks.ForAllEdges(copy);
+    blocks.stats = stats;
+}
+
+/**
+ * @brief Counts the differences between a block file and a CSR: every edge
+ * must be at the position of the CSR.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+SizeT ValidateBlocks(
+    const Csr<VertexId, SizeT, Value> &graph,
+    const char                        *file_name)
+{
+    BlockGraph<VertexId, SizeT, Value> blocks;
+    CompareEdgeOp<VertexId, SizeT, Value> compare;
+    compare.graph      = &graph;
+    compare.num_errors = 0;
+    if (blocks.Open(file_name, (size_t)64 << 20, 2) != 0) return 1;
+    if (blocks.nodes != graph.nodes || blocks.edges != graph.edges) return 1;
+    for (SizeT v = 0; v <= graph.nodes; v++)
+        if (blocks.row_offsets[v] != graph.row_offsets[v])
+            compare.num_errors ++;
+    blocks.ForAllEdges(compare);
+    return compare.num_errors;
+}
+
+/**
+ * @brief Reports the validation of a written block file.
+ *
+ * \return 0 if it passed, 1 otherwise.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+int ReportValidation(
+    Info<VertexId, SizeT, Value> *info,
+    const std::string            &file_name,
+    SizeT                         num_errors,
+    bool                          quiet)
+{
+    info -> info["validation_errors"] = (int64_t)num_errors;
+    if (num_errors != 0)
+    {
+        fprintf(stderr, "Validation of %s: FAIL (%lld errors)\n",
+            file_name.c_str(), (long long)num_errors);
+        return 1;
+    }
+    if (!quiet) printf("Validation of %s: PASS\n", file_name.c_str());
+    return 0;
+}
+
+/**
+ * @brief Writes the graph loaded by info as a block file; the whole graph
+ * is in memory.
+ */
+template <
+    typename VertexId,
+    typename SizeT,
+    typename Value>
+int WriteBlocks(Info<VertexId, SizeT, Value> *info, CommandLineArgs &args)
+{
+    std::string file_name;
+    long long   block_kb = 1024;
+    bool        quiet    = args.CheckCmdLineFlag("quiet");
+    args.GetCmdLineArgument("write-blocks", file_name);
+    args.GetCmdLineArgument("block-size"  , block_kb);
+
+    CpuTimer timer;
+    timer.Start();
+    int retval = WriteBlockGraph(*(info -> csr_ptr), file_name.c_str(),
+        (size_t)block_kb << 10, info -> info["edge_value"].get_bool());
+    timer.Stop();
+    if (retval)
+    {
+        fprintf(stderr, "Writing %s failed: %s\n",
+            file_name.c_str(), strerror(retval));
+        return 1;
+    }
+    if (!quiet)
+        printf("Wrote %s in %.3f ms.\n", file_name.c_str(), timer.ElapsedMillis());
+    if (args.CheckCmdLineFlag("validate") && ReportValidation(info, file_name,
+            ValidateBlocks(*(info -> csr_ptr), file_name.c_str()), quiet) != 0)
+        return 1;
+    info -> info["block_file"    ] = file_name;
+    info -> info["block_size_kb" ] = (int64_t)block_kb;
+    info -> info["preprocess_time"] = timer.ElapsedMillis();
+    info -> CollectInfo();
+    return 0;
+}
+
+/**
+ * @brief Writes a MARKET file as a block file in passes over it, without
+ * loading the graph.
+ */
+template <
+    typename VertexId,
+    typename SizeT,
+    typename Value>
+int StreamBlocks(CommandLineArgs &args, const char *market_file)
+{
+    std::string file_name;
+    long long   block_kb    = 1024;
+    long long   budget_mb   = 256;
+    bool        quiet       = args.CheckCmdLineFlag("quiet");
+    bool        undirected  = args.CheckCmdLineFlag("undirected");
+    bool        with_values = args.CheckCmdLineFlag("edge-value");
+    args.GetCmdLineArgument("write-blocks" , file_name);
+    args.GetCmdLineArgument("block-size"   , block_kb);
+    args.GetCmdLineArgument("memory-budget", budget_mb);
+
+    graphio::MarketEdgeStream stream;
+    if (stream.Open(market_file) != 0)
+    {
+        fprintf(stderr, "Reading %s failed: %s\n",
+            market_file, stream.error.c_str());
+        return 1;
+    }
+    if (with_values && stream.pattern)
+    {
+        fprintf(stderr, "%s has no edge values; --stream does not "
+            "synthesize weights.\n", market_file);
+        return 1;
+    }
+
+    CpuTimer timer;
+    timer.Start();
+    int retval = StreamBlockGraph<VertexId, SizeT, Value>(stream,
+        file_name.c_str(), (size_t)block_kb << 10, (size_t)budget_mb << 20,
+        with_values, undirected);
+    timer.Stop();
+    stream.Close();
+    if (retval)
+    {
+        fprintf(stderr, "Writing %s failed: %s\n",
+            file_name.c_str(), strerror(retval));
+        return 1;
+    }
+    if (!quiet)
+        printf("Wrote %s in %.3f ms.\n", file_name.c_str(), timer.ElapsedMillis());
+
+    // the in-memory graph is loaded only to validate against it; otherwise
+    // Info sees the row offsets of the block file
+    Csr<VertexId, SizeT, Value> csr(false);
+    BlockGraph<VertexId, SizeT, Value> blocks;
+    Info<VertexId, SizeT, Value> *info = new Info<VertexId, SizeT, Value>;
+    info -> info["undirected"] = undirected;
+    info -> info["edge_value"] = with_values;
+    if (args.CheckCmdLineFlag("validate"))
+    {
+        info -> Init("BlockWriter", args, csr);
+        retval = ReportValidation(info, file_name,
+            ValidateBlocks(csr, file_name.c_str()), quiet);
+    } else if (blocks.Open(file_name.c_str(), (size_t)1 << 20, 1) == 0) {
+        blocks.Skeleton(csr);
+        info -> csr_ptr = &csr;
+        info -> InitBase("BlockWriter", args);
+        info -> info["num_vertices"] = (int64_t)blocks.nodes;
+        info -> info["num_edges"   ] = (int64_t)blocks.edges;
+    } else retval = 1;
+    if (retval == 0)
+    {
+        info -> info["block_file"    ] = file_name;
+        info -> info["block_size_kb" ] = (int64_t)block_kb;
+        info -> info["preprocess_time"] = timer.ElapsedMillis();
+        info -> CollectInfo();
+    }
+
+    // the row offsets of a skeleton belong to the block graph
+    if (csr.row_offsets == blocks.row_offsets) csr.row_offsets = NULL;
+    delete info; info = NULL;
+    return retval;
+}
+
+/**
+ * @brief Runs a primitive over a block file.
+ */
+template <
+    typename VertexId,
+    typename SizeT,
+    typename Value>
+int RunBlocks(CommandLineArgs &args, const char *file_name)
+{
+    typedef Csr<VertexId, SizeT, Value> GraphT;
+    std::string algo        = "bfs";
+    long long   budget_mb   = 256;
+    int         io_threads  = 4;
+    bool        quiet       = args.CheckCmdLineFlag("quiet");
+    args.GetCmdLineArgument("algo"         , algo);
+    args.GetCmdLineArgument("memory-budget", budget_mb);
+    args.GetCmdLineArgument("io-threads"   , io_threads);
+
+    BlockGraph<VertexId, SizeT, Value> graph;
+    int retval = graph.Open(file_name, (size_t)budget_mb << 20, io_threads);
+    if (retval)
+    {
+        fprintf(stderr, "Opening %s failed: %s\n", file_name, strerror(retval));
+        return 1;
+    }
+
+    // Info sees the row offsets only, for sources and degree statistics
+    GraphT skeleton(false);
+    graph.Skeleton(skeleton);
+    Info<VertexId, SizeT, Value> *info = new Info<VertexId, SizeT, Value>;
+    info -> info["undirected"] = args.CheckCmdLineFlag("undirected");
+    info -> csr_ptr = &skeleton;
+    info -> InitBase(algo == "pr" ? "PageRank" :
+        (algo == "cc" ? "CC" : "BFS"), args);
+    info -> info["num_vertices"] = (int64_t)graph.nodes;
+    info -> info["num_edges"   ] = (int64_t)graph.edges;
+
+    VertexId src = info -> info["source_vertex"].get_int64();
+    if (algo == "bfs" && (src < 0 || src >= graph.nodes))
+    {
+        fprintf(stderr, "Invalid source %lld, the graph has %lld vertices.\n",
+            (long long)src, (long long)graph.nodes);
+        skeleton.row_offsets = NULL;
+        delete info; info = NULL;
+        return 1;
+    }
+
+    bool      validate   = args.CheckCmdLineFlag("validate");
+    SizeT     num_errors = 0;
+    CpuTimer  timer;
+    SizeT     visits = 0;
+    timer.Start();
+    if (algo == "pr")
+    {
+        Value *rank = (Value*) malloc(sizeof(Value) * graph.nodes);
+        SizeT iterations = pr::BlockPageRank(graph, rank,
+            (Value)info -> info["delta"].get_real(),
+            (Value)info -> info["error"].get_real(),
+            (SizeT)info -> info["max_iteration"].get_int(),
+            info -> info["normalized"].get_bool(), &visits);
+        timer.Stop();
+        info -> info["search_depth"] = (int64_t)iterations;
+        if (!quiet) printf("PageRank: %lld iterations.\n", (long long)iterations);
+        if (validate)
+        {
+            // the unpushed changes leave each rank within about
+            // error / (1 - delta) per unit of initial rank it gathered of the
+            // fixed point, which a tighter in-memory run approximates
+            Csr<VertexId, SizeT, Value> csr(false);
+            EdgeList<VertexId, SizeT, Value> edge_list;
+            LoadBlocks(graph, csr);
+            edge_list.FromCsr(csr);
+            bool   normalized = info -> info["normalized"].get_bool();
+            Value  delta      = info -> info["delta"].get_real();
+            Value  error      = info -> info["error"].get_real();
+            Value  init       = normalized ? (Value)1.0 / graph.nodes : (Value)1.0;
+            Value *ref_rank   = (Value*) malloc(sizeof(Value) * graph.nodes);
+            pr::HostPageRankPush(edge_list, ref_rank, delta, error / 100,
+                (SizeT)1000, normalized);
+            for (SizeT v = 0; v < graph.nodes; v++)
+            {
+                Value tolerance = 2 * error / (1 - delta) *
+                    std::max(ref_rank[v] / init, (Value)1);
+                if (fabs(rank[v] - ref_rank[v]) > tolerance) num_errors ++;
+            }
+            free(ref_rank); ref_rank = NULL;
+        }
+        free(rank); rank = NULL;
+    } else if (algo == "cc") {
+        VertexId *component_ids = (VertexId*) malloc(sizeof(VertexId) * graph.nodes);
+        SizeT num_components = cc::BlockCC(graph, component_ids);
+        timer.Stop();
+        visits = graph.num_blocks;
+        info -> info["num_components"] = (int64_t)num_components;
+        if (!quiet) printf("CC: %lld components.\n", (long long)num_components);
+        if (validate)
+        {
+            // both label every vertex by the smallest vertex of its component
+            Csr<VertexId, SizeT, Value> csr(false);
+            EdgeList<VertexId, SizeT, Value> edge_list;
+            LoadBlocks(graph, csr);
+            edge_list.FromCsr(csr);
+            VertexId *ref_ids = (VertexId*) malloc(sizeof(VertexId) * graph.nodes);
+            num_errors = cc::HostCC(edge_list, ref_ids) != num_components;
+            for (SizeT v = 0; v < graph.nodes; v++)
+                if (component_ids[v] != ref_ids[v]) num_errors ++;
+            free(ref_ids); ref_ids = NULL;
+        }
+        free(component_ids); component_ids = NULL;
+    } else {
+        VertexId *labels = (VertexId*) malloc(sizeof(VertexId) * graph.nodes);
+        VertexId  depth  = bfs::BlockBFS(graph, src, labels, &visits);
+        timer.Stop();
+        info -> info["search_depth"] = (int64_t)depth;
+        if (!quiet) printf("BFS: search depth %lld.\n", (long long)depth);
+        if (validate)
+        {
+            Csr<VertexId, SizeT, Value> csr(false), inv_csr(false);
+            LoadBlocks(graph, csr);
+            bool undirected = info -> info["undirected"].get_bool();
+            if (!undirected)
+                inv_csr.template CsrToCsc<Coo<VertexId, Value> >(inv_csr, csr);
+            VertexId *ref_labels = (VertexId*) malloc(sizeof(VertexId) * graph.nodes);
+            bfs::HostVertexSubsetBFS(csr, undirected ? NULL : &inv_csr,
+                src, ref_labels);
+            for (SizeT v = 0; v < graph.nodes; v++)
+                if (labels[v] != ref_labels[v]) num_errors ++;
+            free(ref_labels); ref_labels = NULL;
+        }
+        free(labels); labels = NULL;
+    }
+
+    json_spirit::mObject io;
+    graph.stats.ToJson(io);
+    io["num_blocks"    ] = (int64_t)graph.num_blocks;
+    io["blocks_visited"] = (int64_t)visits;
+    io["memory_budget" ] = (int64_t)graph.memory_budget;
+    io["io_threads"    ] = io_threads;
+    info -> info["ooc_io"      ] = io;
+    if (validate)
+    {
+        info -> info["validation_errors"] = (int64_t)num_errors;
+        if (num_errors != 0)
+            fprintf(stderr, "Validation: FAIL (%lld vertices differ from the "
+                "in-memory %s)\n", (long long)num_errors, algo.c_str());
+        else if (!quiet) printf("Validation: PASS\n");
+    }
+    info -> info["elapsed"     ] = timer.ElapsedMillis();
+    info -> info["block_file"  ] = std::string(file_name);
+    if (!quiet)
+        printf("Elapsed: %.3f ms, %lld of %lld block visits read, %lld bytes.\n",
+            timer.ElapsedMillis(), graph.stats.blocks_read, (long long)visits,
+            graph.stats.bytes_read);
+    info -> CollectInfo();
+
+    // the row offsets belong to the block graph
+    skeleton.row_offsets = NULL;
+    delete info; info = NULL;
+    return num_errors == 0 ? 0 : 1;
+}
+
+/******************************************************************************
+* Main
+******************************************************************************/
+
+int main(int argc, char** argv)
+{
+    CommandLineArgs args(argc, argv);
+    int graph_args = argc - args.ParsedArgc() - 1;
+    if (argc < 2 || graph_args < 1 || args.CheckCmdLineFlag("help"))
+    {
+        Usage();
+        return 1;
+    }
+
+    typedef int   VertexId;  // Use int as the vertex identifier
+    typedef float Value;     // Use float as the value type
+    typedef int   SizeT;     // Use int as the graph size type
+
+    std::string graph_type = argv[1];
+    if (graph_type == "blocks")
+    {
+        if (graph_args < 2)
+        {
+            Usage();
+            return 1;
+        }
+        return RunBlocks<VertexId, SizeT, Value>(args, argv[2]);
+    }
+    if (!args.CheckCmdLineFlag("write-blocks"))
+    {
+        Usage();
+        return 1;
+    }
+    if (args.CheckCmdLineFlag("stream"))
+    {
+        if (graph_type != "market" || graph_args < 2)
+        {
+            Usage();
+            return 1;
+        }
+        return StreamBlocks<VertexId, SizeT, Value>(args, argv[2]);
+    }
+
+    Csr<VertexId, SizeT, Value> csr(false);  // graph we process on
+    Info<VertexId, SizeT, Value> *info = new Info<VertexId, SizeT, Value>;
+
+    // graph construction or generation related parameters
+    info->info["undirected"] = args.CheckCmdLineFlag("undirected");
+    info->info["edge_value"] = args.CheckCmdLineFlag("edge-value");
+
+    info->Init("BlockWriter", args, csr);  // initialize Info structure
+    int retval = WriteBlocks<VertexId, SizeT, Value>(info, args);
+    delete info; info = NULL;
+    return retval;
+}
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
@@ -0,0 +1,258 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * partition_sim.cu
+ *
+ * @brief Predicts multi-GPU makespan and idle time of a partitioned
+ * traversal on the host, for choosing partitioner and partition count.
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Utilities and correctness-checking
+#include <gunrock/util/test_utils.cuh>
+
+// Info and graph loading
+#include <gunrock/app/enactor_base.cuh>
+
+// Partitioners
+#include <gunrock/app/rp/rp_partitioner.cuh>
+#include <gunrock/app/cp/cp_partitioner.cuh>
+#include <gunrock/app/brp/brp_partitioner.cuh>
+#include <gunrock/app/metisp/metis_partitioner.cuh>
+#include <gunrock/app/sp/sp_partitioner.cuh>
+
+// Simulator
+#include <gunrock/app/sim/partition_sim.cuh>
+
+using namespace gunrock;
+using namespace gunrock::app;
+using namespace gunrock::util;
+
+/******************************************************************************
+ * Housekeeping Routines
+ ******************************************************************************/
+void Usage()
+{
+    printf(
+        "partition_sim <graph-type> [graph-type-arguments]\n"
+        "Graph type and graph type arguments:\n"
+        "    market <matrix-market-file-name>\n"
+        "    rmat / rgg / smallworld, as in the test drivers\n\n"
+        "Optional arguments:\n"
+        "[--undirected]            Treat the graph as undirected (symmetric).\n"
+        "[--src=<Vertex-ID|randomize|largestdegree>]\n"
+        "                          Source of the traced traversal (Default: 0).\n"
+        "[--partition-method=<m1,m2,...>]\n"
+        "                          Partitioners to compare: random, static,\n"
+        "                          biasrandom, cluster, metis (Default: random).\n"
+        "[--num-parts=<n1,n2,...>] Partition counts to compare (Default: 2,4).\n"
+        "[--sim-primitive=<bfs|sssp|pr>]\n"
+        "                          Traversal to replay (Default: bfs).\n"
+        "[--sim-pr-iterations=<n>] Iterations replayed for pr (Default: 50).\n"
+        "[--sim-compute-rate=<r>]  Edges visited per us per GPU (Default: 1000).\n"
+        "[--sim-vertex-rate=<r>]   Vertices processed per us per GPU (Default: 4000).\n"
+        "[--sim-overhead=<us>]     Fixed cost per iteration (Default: 20).\n"
+        "[--sim-bandwidth=<B/us>]  Bandwidth of one peer link (Default: 10000).\n"
+        "[--sim-link-latency=<us>] Setup cost of one transfer (Default: 10).\n"
+        "[--sim-shared-bus]        All transfers share one link.\n"
+        "[--sim-repeat-us=<us>]    Microseconds per repeat of the\n"
+        "                          --*-latency knobs (Default: 1).\n"
+        "[--partition-seed=<seed>] Partition seed.\n"
+        "[--json]                  Output JSON-format statistics to STDOUT.\n"
+        "[--jsonfile=<name>]       Output JSON-format statistics to file <name>\n"
+    );
+}
+
+/**
+ * @brief Partitions the graph with one method and simulates the traversal.
+ *
+ * @param[in] info Info structure holding the graph and parameters.
+ * @param[in] parameters Simulator cost model.
+ * @param[in] partition_method Partitioner name.
+ * @param[in] num_parts Number of partitions.
+ * @param[in] primitive Traversal to replay.
+ * @param[in] pr_iterations Iterations replayed for all-active primitives.
+ * @param[out] result Simulation result.
+ *
+ * \return cudaError_t object indicates the success of the partitioning.
+ */
+template <
+    typename VertexId,
+    typename SizeT,
+    typename Value>
+cudaError_t Simulate(
+    Info<VertexId, SizeT, Value> *info,
+    sim::SimParameters           &parameters,
+    std::string                   partition_method,
+    int                           num_parts,
+    std::string                   primitive,
+    int                           pr_iterations,
+    sim::SimResult               &result)
+{
+    typedef Csr<VertexId, SizeT, Value> GraphT;
+    cudaError_t retval    = cudaSuccess;
+    GraphT     *graph     = info -> csr_ptr;
+    VertexId    src       = info -> info["source_vertex"].get_int64();
+    float       par_factor= info -> info["partition_factor"].get_real();
+    int         par_seed  = info -> info["partition_seed"].get_int();
+    PartitionerBase<VertexId, SizeT, Value> *partitioner = NULL;
+
+    GraphT     *sub_graphs           = NULL;
+    int       **partition_tables     = NULL;
+    VertexId  **convertion_tables    = NULL;
+    VertexId  **original_vertexes    = NULL;
+    SizeT     **in_counter           = NULL;
+    SizeT     **out_offsets          = NULL;
+    SizeT     **out_counter          = NULL;
+    SizeT     **backward_offsets     = NULL;
+    int       **backward_partitions  = NULL;
+    VertexId  **backward_convertions = NULL;
+
+    if      (partition_method == "random")
+        partitioner = new rp::RandomPartitioner     <VertexId, SizeT, Value>
+            (*graph, num_parts);
+    else if (partition_method == "metis")
+        partitioner = new metisp::MetisPartitioner  <VertexId, SizeT, Value>
+            (*graph, num_parts);
+    else if (partition_method == "static")
+        partitioner = new sp::StaticPartitioner     <VertexId, SizeT, Value>
+            (*graph, num_parts);
+    else if (partition_method == "cluster")
+        partitioner = new cp::ClusterPartitioner    <VertexId, SizeT, Value>
+            (*graph, num_parts);
+    else if (partition_method == "biasrandom")
+        partitioner = new brp::BiasRandomPartitioner<VertexId, SizeT, Value>
+            (*graph, num_parts);
+    else return util::GRError(cudaErrorInvalidValue,
+        "partition_method invalid", __FILE__, __LINE__);
+
+    if (retval = partitioner -> Partition(
+        sub_graphs,
+        partition_tables,
+        convertion_tables,
+        original_vertexes,
+        in_counter,
+        out_offsets,
+        out_counter,
+        backward_offsets,
+        backward_partitions,
+        backward_convertions,
+        par_factor,
+        par_seed)) return retval;
+
+    sim::SimTrace<VertexId, SizeT, Value> trace;
+    if (primitive == "sssp")
+        trace.FromSSSP(*graph, partition_tables[0], num_parts, src);
+    else if (primitive == "pr")
+        trace.FromCounters(sub_graphs, out_counter, num_parts, pr_iterations);
+    else trace.FromBFS (*graph, partition_tables[0], num_parts, src);
+
+    sim::Simulator simulator(parameters);
+    simulator.Run(trace, result);
+
+    delete partitioner; partitioner = NULL;
+    return retval;
+}
+
+template <
+    typename VertexId,
+    typename SizeT,
+    typename Value>
+int RunSimulations(Info<VertexId, SizeT, Value> *info, CommandLineArgs &args)
+{
+    std::vector<std::string> methods;
+    std::vector<int        > num_parts;
+    std::string              primitive = "bfs";
+    int                      pr_iterations = 50;
+    double                   repeat_us = 1.0;
+    sim::SimParameters       parameters;
+    json_spirit::mArray      results;
+
+    methods  .push_back("random");
+    num_parts.push_back(2);
+    num_parts.push_back(4);
+    args.GetCmdLineArguments<std::string>("partition-method", methods);
+    args.GetCmdLineArguments<int        >("num-parts"       , num_parts);
+    args.GetCmdLineArgument("sim-primitive"     , primitive);
+    args.GetCmdLineArgument("sim-pr-iterations" , pr_iterations);
+    args.GetCmdLineArgument("sim-compute-rate"  , parameters.compute_rate);
+    args.GetCmdLineArgument("sim-vertex-rate"   , parameters.vertex_rate);
+    args.GetCmdLineArgument("sim-overhead"      , parameters.iteration_overhead);
+    args.GetCmdLineArgument("sim-bandwidth"     , parameters.link_bandwidth);
+    args.GetCmdLineArgument("sim-link-latency"  , parameters.link_latency);
+    args.GetCmdLineArgument("sim-repeat-us"     , repeat_us);
+    parameters.shared_bus       = args.CheckCmdLineFlag("sim-shared-bus");
+    parameters.bytes_per_vertex = sizeof(VertexId);
+    if (primitive == "sssp" || primitive == "pr")
+        parameters.bytes_per_vertex += sizeof(Value);
+    parameters.FromInfo(info -> info, repeat_us);
+
+    for (size_t m = 0; m < methods.size(); m++)
+    for (size_t n = 0; n < num_parts.size(); n++)
+    {
+        sim::SimResult result;
+        json_spirit::mObject entry;
+        char name[128];
+        if (Simulate(info, parameters, methods[m], num_parts[n],
+            primitive, pr_iterations, result)) return 1;
+
+        sprintf(name, "%s x %d", methods[m].c_str(), num_parts[n]);
+        result.Print(name);
+        entry["partition_method"] = methods[m];
+        entry["num_parts"       ] = num_parts[n];
+        result.ToJson(entry, "");
+        results.push_back(entry);
+    }
+    info -> info["sim_primitive"] = primitive;
+    info -> info["sim_results"  ] = results;
+    info -> CollectInfo();
+    return 0;
+}
+
+/******************************************************************************
+* Main
+******************************************************************************/
+
+int main(int argc, char** argv)
+{
+    CommandLineArgs args(argc, argv);
+    int graph_args = argc - args.ParsedArgc() - 1;
+    if (argc < 2 || graph_args < 1 || args.CheckCmdLineFlag("help"))
+    {
+        Usage();
+        return 1;
+    }
+
+    typedef int VertexId;  // Use int as the vertex identifier
+    typedef int Value;     // Use int as the value type
+    typedef int SizeT;     // Use int as the graph size type
+
+    Csr<VertexId, SizeT, Value> csr(false);  // graph we process on
+    Info<VertexId, SizeT, Value> *info = new Info<VertexId, SizeT, Value>;
+
+    // graph construction or generation related parameters
+    info->info["undirected"] = args.CheckCmdLineFlag("undirected");
+    std::string primitive = "bfs";
+    args.GetCmdLineArgument("sim-primitive", primitive);
+    info->info["edge_value"] = (primitive == "sssp");
+
+    info->Init("PartitionSim", args, csr);  // initialize Info structure
+    int retval = RunSimulations<VertexId, SizeT, Value>(info, args);
+    delete info; info = NULL;
+    return retval;
+}
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
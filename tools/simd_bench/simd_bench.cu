@@ -0,0 +1,258 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * simd_bench.cu
+ *
+ * @brief Times the host neighbor-list SIMD kernels at every instruction
+ * set level the CPU supports, on the neighbor lists of a graph.
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// Utilities and correctness-checking
+#include <gunrock/util/test_utils.cuh>
+#include <gunrock/util/simd_utils.cuh>
+
+// Info and graph loading
+#include <gunrock/app/enactor_base.cuh>
+
+using namespace gunrock;
+using namespace gunrock::app;
+using namespace gunrock::util;
+using namespace gunrock::util::simd;
+
+/******************************************************************************
+ * Housekeeping Routines
+ ******************************************************************************/
+void Usage()
+{
+    printf(
+        "simd_bench <graph-type> [graph-type-arguments]\n"
+        "Graph type and graph type arguments:\n"
+        "    market <matrix-market-file-name>\n"
+        "    rmat / rgg / smallworld, as in the test drivers\n\n"
+        "Optional arguments:\n"
+        "[--undirected]            Treat the graph as undirected (symmetric).\n"
+        "[--num-repeats=<n>]       Runs per kernel, the fastest is reported\n"
+        "                          (Default: 3).\n"
+        "[--json]                  Output JSON-format statistics to STDOUT.\n"
+        "[--jsonfile=<name>]       Output JSON-format statistics to file <name>\n"
+    );
+}
+
+enum BenchKernel {
+    BENCH_GATHER_FIND  = 0,
+    BENCH_GATHER_COUNT = 1,
+    BENCH_GATHER_MIN   = 2,
+    BENCH_INTERSECT    = 3,
+    BENCH_TEST_AND_SET = 4,
+    BENCH_GATHER_ROWS  = 5,
+    NUM_BENCH_KERNELS  = 6,
+};
+
+#define BENCH_ROW_WIDTH 32  // floats per row of the row gather
+
+const char* BenchKernelName(int kernel)
+{
+    static const char* names[] = {
+        "gather_find", "gather_count", "gather_min",
+        "intersect", "test_and_set", "gather_rows"};
+    return names[kernel];
+}
+
+/**
+ * @brief Runs one kernel over all neighbor lists at the active level.
+ *
+ * \return Checksum of the kernel results, equal across levels.
+ */
+template <typename VertexId, typename SizeT, typename Value>
+long long RunKernel(
+    int                                kernel,
+    const Csr<VertexId, SizeT, Value> &graph,
+    const VertexId                    *labels,
+    unsigned int                      *bitmap,
+    VertexId                          *output,
+    const float                       *rows)
+{
+    long long checksum = 0;
+    const SizeT    *row_offsets    = graph.row_offsets;
+    const VertexId *column_indices = graph.column_indices;
+
+    if (kernel == BENCH_TEST_AND_SET)
+        memset(bitmap, 0, sizeof(unsigned int) * (graph.nodes / 32 + 1));
+    for (SizeT v = 0; v < graph.nodes; v++)
+    {
+        const VertexId *neighbors = column_indices + row_offsets[v];
+        SizeT degree = row_offsets[v+1] - row_offsets[v];
+        switch (kernel)
+        {
+        case BENCH_GATHER_FIND:
+            checksum += GatherFind(neighbors, (SizeT)0, degree,
+                labels, (VertexId)0, GATHER_EQUAL);
+            break;
+        case BENCH_GATHER_COUNT:
+            checksum += GatherCount(neighbors, degree,
+                labels, (VertexId)3, GATHER_GREATER);
+            break;
+        case BENCH_GATHER_MIN:
+            checksum += GatherMin(neighbors, degree,
+                labels, (VertexId)8, (VertexId)0);
+            break;
+        case BENCH_INTERSECT:
+            for (SizeT e = 0; e < degree; e++)
+            {
+                VertexId u = neighbors[e];
+                if (u >= v) break;
+                checksum += IntersectCount(neighbors, degree,
+                    column_indices + row_offsets[u],
+                    row_offsets[u+1] - row_offsets[u]);
+            }
+            break;
+        case BENCH_TEST_AND_SET:
+            checksum += TestAndSet(neighbors, degree, bitmap, output);
+            break;
+        case BENCH_GATHER_ROWS:
+        {
+            // small integer rows, so the sums are exact at every level
+            float sum[BENCH_ROW_WIDTH] = {0};
+            GatherAddRows(neighbors, degree, rows, (SizeT)BENCH_ROW_WIDTH, sum);
+            for (int j = 0; j < BENCH_ROW_WIDTH; j++)
+                checksum += (long long)sum[j];
+            break;
+        }
+        }
+    }
+    return checksum;
+}
+
+template <
+    typename VertexId,
+    typename SizeT,
+    typename Value>
+int RunBenchmarks(Info<VertexId, SizeT, Value> *info, CommandLineArgs &args)
+{
+    Csr<VertexId, SizeT, Value> &graph = *(info -> csr_ptr);
+    int num_repeats = 3;
+    args.GetCmdLineArgument("num-repeats", num_repeats);
+
+    // the intersection kernel needs sorted, duplicate-free neighbor lists
+    SizeT *row_offsets = (SizeT*) malloc(sizeof(SizeT) * (graph.nodes + 1));
+    row_offsets[0] = 0;
+    for (SizeT v = 0; v < graph.nodes; v++)
+    {
+        VertexId *begin = graph.column_indices + graph.row_offsets[v];
+        VertexId *end   = graph.column_indices + graph.row_offsets[v+1];
+        std::sort(begin, end);
+        SizeT degree = std::unique(begin, end) - begin;
+        memmove(graph.column_indices + row_offsets[v], begin,
+            sizeof(VertexId) * degree);
+        row_offsets[v+1] = row_offsets[v] + degree;
+    }
+    memcpy(graph.row_offsets, row_offsets, sizeof(SizeT) * (graph.nodes + 1));
+    graph.edges = row_offsets[graph.nodes];
+    free(row_offsets); row_offsets = NULL;
+
+    VertexId     *labels = (VertexId*) malloc(sizeof(VertexId) * graph.nodes);
+    VertexId     *output = (VertexId*) malloc(sizeof(VertexId) * (graph.nodes + 1));
+    unsigned int *bitmap = (unsigned int*) malloc(
+        sizeof(unsigned int) * (graph.nodes / 32 + 1));
+    float        *rows   = (float*) malloc(
+        sizeof(float) * ((size_t)graph.nodes * BENCH_ROW_WIDTH + 1));
+    for (SizeT v = 0; v < graph.nodes; v++)
+    {
+        labels[v] = (VertexId)((v * 2654435761u) >> 7) & 7;
+        for (int j = 0; j < BENCH_ROW_WIDTH; j++)
+            rows[(size_t)v * BENCH_ROW_WIDTH + j] = (float)((v + j) & 7);
+    }
+
+    SimdLevel detected = DetectSimdLevel();
+    json_spirit::mArray results;
+    printf("%-14s", "kernel");
+    for (int level = SIMD_SCALAR; level <= detected; level++)
+        printf(" %12s", SimdLevelName((SimdLevel)level));
+    printf("   (msec)\n");
+
+    for (int kernel = 0; kernel < NUM_BENCH_KERNELS; kernel++)
+    {
+        long long scalar_checksum = 0;
+        printf("%-14s", BenchKernelName(kernel));
+        for (int level = SIMD_SCALAR; level <= detected; level++)
+        {
+            json_spirit::mObject entry;
+            CpuTimer timer;
+            double   best = -1;
+            long long checksum = 0;
+            SetSimdLevel((SimdLevel)level);
+            for (int repeat = 0; repeat < num_repeats; repeat++)
+            {
+                timer.Start();
+                checksum = RunKernel(kernel, graph, labels, bitmap, output, rows);
+                timer.Stop();
+                if (best < 0 || timer.ElapsedMillis() < best)
+                    best = timer.ElapsedMillis();
+            }
+            if (level == SIMD_SCALAR) scalar_checksum = checksum;
+            printf(" %12.3f%s", best, checksum == scalar_checksum ? "" : "!");
+            entry["kernel"  ] = BenchKernelName(kernel);
+            entry["level"   ] = SimdLevelName((SimdLevel)level);
+            entry["time"    ] = best;
+            entry["checksum"] = (int64_t)checksum;
+            entry["correct" ] = (checksum == scalar_checksum);
+            results.push_back(entry);
+        }
+        printf("\n");
+    }
+    SetSimdLevel(detected);
+
+    free(labels); labels = NULL;
+    free(output); output = NULL;
+    free(bitmap); bitmap = NULL;
+    free(rows  ); rows   = NULL;
+    info -> info["simd_level"  ] = SimdLevelName(detected);
+    info -> info["simd_results"] = results;
+    info -> CollectInfo();
+    return 0;
+}
+
+/******************************************************************************
+* Main
+******************************************************************************/
+
+int main(int argc, char** argv)
+{
+    CommandLineArgs args(argc, argv);
+    int graph_args = argc - args.ParsedArgc() - 1;
+    if (argc < 2 || graph_args < 1 || args.CheckCmdLineFlag("help"))
+    {
+        Usage();
+        return 1;
+    }
+
+    typedef int VertexId;  // Use int as the vertex identifier
+    typedef int Value;     // Use int as the value type
+    typedef int SizeT;     // Use int as the graph size type
+
+    Csr<VertexId, SizeT, Value> csr(false);  // graph we process on
+    Info<VertexId, SizeT, Value> *info = new Info<VertexId, SizeT, Value>;
+
+    info->info["undirected"] = args.CheckCmdLineFlag("undirected");
+    info->Init("SimdBench", args, csr);  // initialize Info structure
+    int retval = RunBenchmarks<VertexId, SizeT, Value>(info, args);
+    delete info; info = NULL;
+    return retval;
+}
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End:
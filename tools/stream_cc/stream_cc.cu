@@ -0,0 +1,220 @@
+// ----------------------------------------------------------------
+// Gunrock -- Fast and Efficient GPU Graph Library
+// ----------------------------------------------------------------
+// This source code is distributed under the terms of LICENSE.TXT
+// in the root directory of this source distribution.
+// ----------------------------------------------------------------
+
+/**
+ * @file
+ * stream_cc.cu
+ *
+ * @brief Connected components of a MARKET file, computed while it is
+ * parsed, without building the graph: writes the component of each
+ * vertex, the component sizes, and the largest component's edges.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+// Utilities
+#include <gunrock/util/test_utils.cuh>
+
+// Streaming connected components
+#include <gunrock/app/cc/cc_stream.cuh>
+
+using namespace gunrock;
+using namespace gunrock::app::cc;
+using namespace gunrock::util;
+
+/******************************************************************************
+ * Housekeeping Routines
+ ******************************************************************************/
+void Usage()
+{
+    printf(
+        "stream_cc <matrix-market-file> [--labels=<file>] [--sizes=<file>]\n"
+        "          [--largest=<file>]\n"
+        "The input may be gzip, bzip2 or zstd compressed; edges are taken as\n"
+        "undirected.\n\n"
+        "Optional arguments:\n"
+        "[--labels=<file>]         Write \"vertex component\" pairs, 0-based; a\n"
+        "                          component is named by its smallest vertex.\n"
+        "[--sizes=<file>]          Write \"component size\" pairs.\n"
+        "[--largest=<file>]        Write the edges of the largest component as\n"
+        "                          a Matrix-Market file, vertices renumbered in\n"
+        "                          ID order; takes a second pass over the input.\n"
+        "[--threads=<n>]           Parsing threads (Default: all).\n"
+        "[--quiet]                 No output other than errors.\n"
+    );
+}
+
+typedef long long VertexId;
+typedef long long SizeT;
+
+/**
+ * @brief Writes one formatted line per index, blocks of lines formatted by
+ * all threads, then written in order.
+ */
+template <typename LineOp>
+bool WriteLines(const char *file_name, const char *header, SizeT num_lines,
+    LineOp line_of)
+{
+    FILE *out = fopen(file_name, "w");
+    if (out == NULL)
+    {
+        fprintf(stderr, "Cannot write %s\n", file_name);
+        return false;
+    }
+    fputs(header, out);
+    const SizeT block = 1 << 20;  // lines per thread per round
+    int num_threads = omp_get_max_threads();
+    std::vector<std::string> buffers(num_threads);
+    for (SizeT round = 0; round < num_lines; round += block * num_threads)
+    {
+        #pragma omp parallel num_threads(num_threads)
+        {
+            int thread_num = omp_get_thread_num();
+            SizeT begin = round + block * thread_num;
+            SizeT end   = std::min(begin + block, num_lines);
+            std::string &buffer = buffers[thread_num];
+            char line[96];
+            buffer.clear();
+            for (SizeT i = begin; i < end; i++)
+            {
+                int length = line_of(i, line);
+                if (length > 0) buffer.append(line, length);
+            }
+        }
+        for (int t = 0; t < num_threads; t++)
+            fwrite(buffers[t].data(), 1, buffers[t].size(), out);
+    }
+    fclose(out);
+    return true;
+}
+
+struct LabelLineOp
+{
+    const VertexId *component_ids;
+    int operator()(SizeT v, char *line) const
+    {
+        return sprintf(line, "%lld %lld\n", v, component_ids[v]);
+    }
+};
+
+struct SizeLineOp
+{
+    const VertexId *component_ids;
+    const SizeT    *component_sizes;
+    int operator()(SizeT v, char *line) const
+    {
+        if (component_ids[v] != v) return 0;
+        return sprintf(line, "%lld %lld\n", v, component_sizes[v]);
+    }
+};
+
+struct EdgeLineOp
+{
+    const Coo<VertexId, double> *coo;
+    bool pattern;
+    int operator()(SizeT e, char *line) const
+    {
+        if (pattern)
+            return sprintf(line, "%lld %lld\n", coo[e].row + 1, coo[e].col + 1);
+        return sprintf(line, "%lld %lld %.9g\n", coo[e].row + 1, coo[e].col + 1,
+            coo[e].val);
+    }
+};
+
+/******************************************************************************
+* Main
+******************************************************************************/
+
+int main(int argc, char** argv)
+{
+    CommandLineArgs args(argc, argv);
+    if (argc < 2 || strncmp(argv[1], "--", 2) == 0 || args.CheckCmdLineFlag("help"))
+    {
+        Usage();
+        return 1;
+    }
+
+    bool quiet = args.CheckCmdLineFlag("quiet");
+    int  num_threads = 0;
+    std::string labels_file = "", sizes_file = "", largest_file = "";
+    args.GetCmdLineArgument("labels" , labels_file );
+    args.GetCmdLineArgument("sizes"  , sizes_file  );
+    args.GetCmdLineArgument("largest", largest_file);
+    args.GetCmdLineArgument("threads", num_threads );
+
+    StreamCC<VertexId, SizeT> stream_cc;
+    CpuTimer timer;
+    timer.Start();
+    if (stream_cc.Run(argv[1], quiet, num_threads) != 0) return 1;
+    timer.Stop();
+    if (!quiet)
+        printf("%s: %lld vertices, %lld edges, %lld components, largest %lld"
+            " vertices (%.1f ms)\n", argv[1], stream_cc.nodes, stream_cc.edges,
+            stream_cc.num_components, stream_cc.largest_size,
+            timer.ElapsedMillis());
+
+    if (labels_file != "")
+    {
+        LabelLineOp line_of;
+        line_of.component_ids = stream_cc.component_ids;
+        if (!WriteLines(labels_file.c_str(), "# vertex component (0-based)\n",
+            stream_cc.nodes, line_of)) return 1;
+    }
+    if (sizes_file != "")
+    {
+        SizeLineOp line_of;
+        line_of.component_ids   = stream_cc.component_ids;
+        line_of.component_sizes = stream_cc.component_sizes;
+        if (!WriteLines(sizes_file.c_str(), "# component size\n",
+            stream_cc.nodes, line_of)) return 1;
+    }
+    if (largest_file != "")
+    {
+        // edges as stored, so a symmetric input stays symmetric
+        timer.Start();
+        Coo<VertexId, double> *coo = NULL;
+        SizeT coo_edges = 0;
+        bool pattern = stream_cc.stream.pattern;
+        int  retval  = pattern ?
+            stream_cc.ExtractLargest<false>(coo, coo_edges) :
+            stream_cc.ExtractLargest<true >(coo, coo_edges);
+        if (retval != 0)
+        {
+            if (coo) free(coo);
+            return 1;
+        }
+        char header[256];
+        sprintf(header, "%%%%MatrixMarket matrix coordinate %s %s\n%lld %lld %lld\n",
+            pattern ? "pattern" : "real",
+            !stream_cc.stream.symmetric ? "general" :
+            (stream_cc.stream.skew ? "skew-symmetric" : "symmetric"),
+            stream_cc.largest_size, stream_cc.largest_size, coo_edges);
+        EdgeLineOp line_of;
+        line_of.coo     = coo;
+        line_of.pattern = pattern;
+        bool written = WriteLines(largest_file.c_str(), header, coo_edges, line_of);
+        free(coo); coo = NULL;
+        timer.Stop();
+        if (!written) return 1;
+        if (!quiet)
+            printf("wrote %s: %lld vertices, %lld edges (%.1f ms)\n",
+                largest_file.c_str(), stream_cc.largest_size, coo_edges,
+                timer.ElapsedMillis());
+    }
+    return 0;
+}
+
+// Leave this at the end of the file
+// Local Variables:
+// mode:c++
+// c-file-style: "NVIDIA"
+// End: